@@ -5,16 +5,974 @@
 #include <furi_hal_usb_hid.h>
 #include <gui/view_dispatcher.h>
 #include <notification/notification_messages.h>
+#include <dialogs/dialogs.h>
+#include <storage/storage.h>
 
 typedef enum {
     BunnyConnectSubmenuIndexConnect,
     BunnyConnectSubmenuIndexTerminal,
     BunnyConnectSubmenuIndexKeyboard,
+    BunnyConnectSubmenuIndexSnippets,
+    BunnyConnectSubmenuIndexSendFile,
+    BunnyConnectSubmenuIndexYmodemSend,
+    BunnyConnectSubmenuIndexYmodemReceive,
     BunnyConnectSubmenuIndexConfig,
     BunnyConnectSubmenuInfo,
+    BunnyConnectSubmenuIndexDashboard,
+    BunnyConnectSubmenuIndexHistogram,
+    BunnyConnectSubmenuIndexStats,
     BunnyConnectSubmenuIndexExit,
 } BunnyConnectSubmenuIndex;
 
+typedef enum {
+    BunnyConnectConfigIndexBaudRate,
+    BunnyConnectConfigIndexFlowControl,
+    BunnyConnectConfigIndexUsbPower,
+    BunnyConnectConfigIndexAutoEnumerate,
+    BunnyConnectConfigIndexRoute,
+    BunnyConnectConfigIndexCdcLineEnding,
+    BunnyConnectConfigIndexHidLineEnding,
+    BunnyConnectConfigIndexFileMode,
+    BunnyConnectConfigIndexFileRoute,
+    BunnyConnectConfigIndexFileChunk,
+    BunnyConnectConfigIndexFilePacing,
+    BunnyConnectConfigIndexFileLineDelay,
+    BunnyConnectConfigIndexYmodemMode,
+    BunnyConnectConfigIndexAutoConnect,
+    BunnyConnectConfigIndexMemoryBudget,
+    BunnyConnectConfigIndexTrace,
+    BunnyConnectConfigIndexTraceSave,
+    BunnyConnectConfigIndexTimestamps,
+    BunnyConnectConfigIndexTabLogs,
+    BunnyConnectConfigIndexRecord,
+    BunnyConnectConfigIndexReplay,
+    BunnyConnectConfigIndexReplayFast,
+    BunnyConnectConfigIndexBench,
+} BunnyConnectConfigIndex;
+
+#define TRANSFER_TICK_MS     250
+#define USB_READY_TIMEOUT_MS 3000
+#define LINK_STATUS_MS       500
+#define STATS_TICK_MS        1000
+#define STATS_LINE_SIZE      384
+#define RESEND_CHUNK_SIZE    64
+// Worker runs link supervision, which can reset USB, plus logging and tab
+// writes on top of the receive path. 1 KiB left no margin for those.
+#define WORKER_STACK_SIZE 2048
+
+static const uint16_t bunnyconnect_chunk_sizes[] = {16, 64, 256, 512};
+static const uint16_t bunnyconnect_chunk_delays[] = {0, 5, 20, 50, 100};
+static const uint16_t bunnyconnect_line_delays[] = {0, 10, 50, 100, 250, 500};
+
+// Session buffer sizes per memory budget, the terminal view copy matches the CDC tab
+// and the other tabs take a share of scrollback on top
+static const struct {
+    uint16_t scrollback;
+    uint16_t rx;
+} bunnyconnect_budgets[BunnyConnectMemoryBudgetCount] = {
+    [BunnyConnectMemoryBudgetSmall] = {1024, 256},
+    [BunnyConnectMemoryBudgetDefault] = {2048, 512},
+    [BunnyConnectMemoryBudgetLarge] = {8192, 512},
+};
+
+#define SESSION_ARENA_SLACK 16 // Alignment padding
+
+static const char* const bunnyconnect_welcome_text = "BunnyConnect Terminal\n";
+
+// Step to the value after current in a table, wrapping around
+static uint16_t bunnyconnect_config_next(const uint16_t* values, size_t count, uint16_t current) {
+    for(size_t i = 0; i < count; i++) {
+        if(values[i] == current) return values[(i + 1) % count];
+    }
+    return values[0];
+}
+
+static const char* const bunnyconnect_info_text = "BunnyConnect v1.0\n\n"
+                                                  "USB CDC Terminal App\n"
+                                                  "Made by C0d3-5t3w\n\n"
+                                                  "Features:\n"
+                                                  "- USB CDC Communication\n"
+                                                  "- Terminal Interface\n"
+                                                  "- Custom Keyboard\n"
+                                                  "- USB Power Control\n\n"
+                                                  "Use Connect to establish\n"
+                                                  "USB CDC connection with\n"
+                                                  "external devices.\n\n"
+                                                  "Press Back to return.";
+
+// Picked line or word, as positions in the active tab's ring or the filter index
+static bool bunnyconnect_resend_locate(BunnyConnectApp* app, BunnyConnectResendSpan* span) {
+    BunnyConnectScrollback* scrollback =
+        bunnyconnect_tabs_get_scrollback(app->tabs, bunnyconnect_tabs_get_active(app->tabs));
+    BunnyConnectResendSpan line;
+
+    bool found = app->filter_shown ?
+                     bunnyconnect_filter_get_line(
+                         app->filter, app->resend_line, &line.start, &line.len) :
+                     bunnyconnect_resend_find_line(
+                         scrollback, app->resend_head, app->resend_line, &line);
+    return found && bunnyconnect_resend_find_field(scrollback, &line, app->resend_field, span);
+}
+
+// Status bar while picking: what OK would send, read from the ring
+static void bunnyconnect_resend_status(BunnyConnectApp* app, char* status, size_t size) {
+    BunnyConnectResendSpan span;
+    if(!bunnyconnect_resend_locate(app, &span)) {
+        strlcpy(status, "Line overwritten", size);
+        return;
+    }
+
+    int prefix = app->resend_field ? snprintf(status, size, "W%u> ", app->resend_field) :
+                                     snprintf(status, size, "> ");
+    size_t len = MIN(span.len, size - 1 - prefix);
+    BunnyConnectScrollback* scrollback =
+        bunnyconnect_tabs_get_scrollback(app->tabs, bunnyconnect_tabs_get_active(app->tabs));
+    uint8_t held = 0;
+    if(!bunnyconnect_scrollback_read(scrollback, span.start, (uint8_t*)status + prefix, len)) {
+        len = 0;
+    }
+    len = bunnyconnect_stamp_unescape((uint8_t*)status + prefix, len, &held);
+    status[prefix + len] = '\0';
+}
+
+// Status bar: tab name, then link state, reconnect time and bytes waiting for the link
+static void bunnyconnect_terminal_status_update(BunnyConnectApp* app) {
+    char status[BUNNYCONNECT_TERMINAL_STATUS_SIZE];
+    if(!app->terminal) return;
+
+    if(app->state != BunnyConnectStateConnected || !app->link || !app->output || !app->tabs) {
+        bunnyconnect_terminal_set_status(app->terminal, "Disconnected");
+        return;
+    }
+
+    if(app->resend_active) {
+        bunnyconnect_resend_status(app, status, sizeof(status));
+        bunnyconnect_terminal_set_status(app->terminal, status);
+        return;
+    }
+
+    BunnyConnectTabId tab = bunnyconnect_tabs_get_active(app->tabs);
+    if(app->filter_shown) {
+        snprintf(
+            status,
+            sizeof(status),
+            "%s ~%s  %u lines",
+            bunnyconnect_tabs_name(tab),
+            bunnyconnect_filter_get_pattern(app->filter),
+            bunnyconnect_filter_get_count(app->filter));
+        bunnyconnect_terminal_set_status(app->terminal, status);
+        return;
+    }
+    if(tab != BunnyConnectTabCdc) {
+        BunnyConnectTabStats stats;
+        bunnyconnect_tabs_get_stats(app->tabs, tab, &stats);
+        if(tab == BunnyConnectTabUart && !app->serial_handle) {
+            snprintf(status, sizeof(status), "UART  USART busy");
+        } else if(tab == BunnyConnectTabUart) {
+            snprintf(
+                status, sizeof(status), "UART %lu  %lu B", app->config.baud_rate, stats.rx_bytes);
+        } else {
+            snprintf(
+                status, sizeof(status), "LOOP  %lu B  %lu sends", stats.rx_bytes, stats.rx_chunks);
+        }
+        bunnyconnect_terminal_set_status(app->terminal, status);
+        return;
+    }
+
+    BunnyConnectLinkStatus link;
+    BunnyConnectOutputStats queue;
+    bunnyconnect_link_get_status(app->link, &link);
+    bunnyconnect_output_get_stats(app->output, BunnyConnectOutputCdc, &queue);
+
+    if(link.state == BunnyConnectLinkStateUp) {
+        snprintf(
+            status,
+            sizeof(status),
+            "CDC Up  Q %u B  rc %lu ms",
+            queue.depth,
+            link.reconnect_ms);
+    } else {
+        snprintf(
+            status,
+            sizeof(status),
+            "CDC %s #%lu  Q %u B  %lu.%lus",
+            bunnyconnect_link_state_name(link.state),
+            link.attempts,
+            queue.depth,
+            link.down_ms / 1000,
+            link.down_ms % 1000 / 100);
+    }
+    bunnyconnect_terminal_set_status(app->terminal, status);
+}
+
+static size_t bunnyconnect_session_size(BunnyConnectMemoryBudget budget) {
+    return bunnyconnect_tabs_size(bunnyconnect_budgets[budget].scrollback) +
+           bunnyconnect_budgets[budget].scrollback + bunnyconnect_budgets[budget].rx +
+           INPUT_BUFFER_SIZE + SESSION_ARENA_SLACK;
+}
+
+static void bunnyconnect_info_arena(BunnyConnectApp* app, FuriString* text) {
+    const char* budget = bunnyconnect_config_memory_budget_name(app->config.memory_budget);
+    if(!app->arena) {
+        furi_string_cat_printf(
+            text,
+            "\n\nSession arena: none\n %s budget, %u B on connect",
+            budget,
+            bunnyconnect_session_size(app->config.memory_budget));
+        return;
+    }
+
+    furi_string_cat_printf(
+        text,
+        "\n\nSession arena %u/%u B\n (%s on connect)",
+        bunnyconnect_arena_get_used(app->arena),
+        bunnyconnect_arena_get_capacity(app->arena),
+        budget);
+    for(size_t i = 0; i < bunnyconnect_arena_get_region_count(app->arena); i++) {
+        BunnyConnectArenaRegion region;
+        bunnyconnect_arena_get_region(app->arena, i, &region);
+        furi_string_cat_printf(
+            text,
+            "\n%s %u B\n @%u peak %u B",
+            region.name,
+            region.size,
+            region.offset,
+            region.high_water);
+    }
+}
+
+static void bunnyconnect_info_update(BunnyConnectApp* app) {
+    FuriString* text = furi_string_alloc_set_str(bunnyconnect_info_text);
+    bunnyconnect_info_arena(app, text);
+
+    if(app->output) {
+        static const char* const names[BunnyConnectOutputCount] = {"CDC", "HID"};
+        furi_string_cat_str(text, "\n\nOutput queues:");
+        for(size_t i = 0; i < BunnyConnectOutputCount; i++) {
+            BunnyConnectOutputStats stats;
+            bunnyconnect_output_get_stats(app->output, i, &stats);
+            furi_string_cat_printf(
+                text,
+                "\n%s %u/%u max %u\n %lu B/s sent %lu drop %lu",
+                names[i],
+                stats.depth,
+                stats.capacity,
+                stats.high_water,
+                stats.drain_rate,
+                stats.bytes_sent,
+                stats.bytes_dropped);
+        }
+
+        furi_string_cat_str(text, "\nTabs:");
+        for(size_t i = 0; i < BunnyConnectTabCount; i++) {
+            BunnyConnectTabStats tab_stats;
+            bunnyconnect_tabs_get_stats(app->tabs, i, &tab_stats);
+            furi_string_cat_printf(
+                text,
+                "\n%s %lu B in %lu",
+                bunnyconnect_tabs_name(i),
+                tab_stats.rx_bytes,
+                tab_stats.rx_chunks);
+        }
+
+        BunnyConnectPowerStats power_stats;
+        bunnyconnect_power_get_stats(&power_stats);
+        furi_string_cat_printf(
+            text,
+            "\nUSB switch %lu ms (%s)\nUSB ready %lu ms, %s, DTR %s"
+            "\nFirst byte %lu ms after launch",
+            power_stats.enable_ms,
+            power_stats.warm ? "warm" : "cold",
+            app->usb_ready_ms,
+            bunnyconnect_cdc_is_connected(app->cdc) ? "configured" : "suspended",
+            bunnyconnect_cdc_is_dtr(app->cdc) ? "on" : "off",
+            app->first_byte_ms);
+        if(app->worker_thread) {
+            FuriThreadId worker = furi_thread_get_id(app->worker_thread);
+            furi_string_cat_printf(
+                text,
+                "\nWorker stack %lu/%u B used",
+                WORKER_STACK_SIZE - furi_thread_get_stack_space(worker),
+                WORKER_STACK_SIZE);
+        }
+
+        BunnyConnectLinkStatus link_status;
+        bunnyconnect_link_get_status(app->link, &link_status);
+        furi_string_cat_printf(
+            text,
+            "\nLink %s drops %lu\n last outage %lu ms",
+            bunnyconnect_link_state_name(link_status.state),
+            link_status.drops,
+            link_status.reconnect_ms);
+
+        BunnyConnectCdcStats cdc_stats;
+        bunnyconnect_cdc_get_stats(app->cdc, &cdc_stats);
+        furi_string_cat_printf(
+            text,
+            "\nUSB pkts %lu full %lu ZLP %lu",
+            cdc_stats.packets_sent,
+            cdc_stats.full_packets,
+            cdc_stats.zlp_sent);
+        if(app->config.flow_control != BunnyConnectFlowControlNone) {
+            furi_string_cat_printf(
+                text,
+                "\nFlow %s pauses %lu%s\n stop %lu us resume %lu us",
+                bunnyconnect_cdc_flow_control_name(app->config.flow_control),
+                cdc_stats.flow_pauses,
+                bunnyconnect_cdc_is_paused(app->cdc) ? " (held)" : "",
+                cdc_stats.stop_latency_us,
+                cdc_stats.resume_latency_us);
+        }
+    }
+
+    widget_reset(app->info_widget);
+    widget_add_text_scroll_element(
+        app->info_widget, 0, 0, 128, 64, furi_string_get_cstr(text));
+    furi_string_free(text);
+}
+
+// Persist config menu changes, called when leaving the menu and on exit
+static void bunnyconnect_config_commit(BunnyConnectApp* app) {
+    if(!app->config_dirty) return;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(bunnyconnect_config_save(storage, &app->config)) {
+        app->config_dirty = false;
+    }
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void bunnyconnect_config_update_label(BunnyConnectApp* app, uint32_t index) {
+    char label[32];
+
+    switch(index) {
+    case BunnyConnectConfigIndexFlowControl:
+        snprintf(
+            label,
+            sizeof(label),
+            "Flow Control: %s",
+            bunnyconnect_cdc_flow_control_name(app->config.flow_control));
+        break;
+    case BunnyConnectConfigIndexRoute:
+        snprintf(
+            label,
+            sizeof(label),
+            "Route: %s",
+            bunnyconnect_output_route_name(app->config.output_route));
+        break;
+    case BunnyConnectConfigIndexCdcLineEnding:
+        snprintf(
+            label,
+            sizeof(label),
+            "CDC EOL: %s",
+            bunnyconnect_output_line_ending_name(app->config.line_ending[BunnyConnectOutputCdc]));
+        break;
+    case BunnyConnectConfigIndexHidLineEnding:
+        snprintf(
+            label,
+            sizeof(label),
+            "HID EOL: %s",
+            bunnyconnect_output_line_ending_name(app->config.line_ending[BunnyConnectOutputHid]));
+        break;
+    case BunnyConnectConfigIndexFileMode:
+        snprintf(
+            label,
+            sizeof(label),
+            "File Mode: %s",
+            bunnyconnect_sendfile_mode_name(app->config.sendfile.mode));
+        break;
+    case BunnyConnectConfigIndexFileRoute:
+        snprintf(
+            label,
+            sizeof(label),
+            "File Route: %s",
+            bunnyconnect_output_route_name(app->config.sendfile.route));
+        break;
+    case BunnyConnectConfigIndexFileChunk:
+        snprintf(label, sizeof(label), "File Chunk: %u B", app->config.sendfile.chunk_size);
+        break;
+    case BunnyConnectConfigIndexFilePacing:
+        snprintf(
+            label, sizeof(label), "Chunk Delay: %u ms", app->config.sendfile.chunk_delay_ms);
+        break;
+    case BunnyConnectConfigIndexFileLineDelay:
+        snprintf(label, sizeof(label), "Line Delay: %u ms", app->config.sendfile.line_delay_ms);
+        break;
+    case BunnyConnectConfigIndexYmodemMode:
+        snprintf(
+            label, sizeof(label), "YMODEM RX: %s", app->config.ymodem_streaming ? "1K-g" : "1K");
+        break;
+    case BunnyConnectConfigIndexAutoConnect:
+        snprintf(
+            label, sizeof(label), "Auto Connect: %s", app->config.auto_connect ? "ON" : "OFF");
+        break;
+    case BunnyConnectConfigIndexMemoryBudget:
+        snprintf(
+            label,
+            sizeof(label),
+            "Memory: %s",
+            bunnyconnect_config_memory_budget_name(app->config.memory_budget));
+        break;
+    case BunnyConnectConfigIndexTrace:
+        snprintf(
+            label, sizeof(label), "Trace: %s", bunnyconnect_trace_is_enabled() ? "ON" : "OFF");
+        break;
+    case BunnyConnectConfigIndexTraceSave:
+        strlcpy(label, "Save Trace to SD", sizeof(label));
+        break;
+    case BunnyConnectConfigIndexTimestamps:
+        snprintf(label, sizeof(label), "Timestamps: %s", app->config.timestamps ? "ON" : "OFF");
+        break;
+    case BunnyConnectConfigIndexTabLogs:
+        strlcpy(label, "Save Tab Logs", sizeof(label));
+        break;
+    case BunnyConnectConfigIndexRecord:
+        snprintf(label, sizeof(label), "Record: %s", app->capture ? "ON" : "OFF");
+        break;
+    case BunnyConnectConfigIndexReplay:
+        strlcpy(label, "Replay Capture 1x", sizeof(label));
+        break;
+    case BunnyConnectConfigIndexReplayFast:
+        strlcpy(label, "Replay Capture Fast", sizeof(label));
+        break;
+    case BunnyConnectConfigIndexBench:
+        strlcpy(label, "Run Benchmark", sizeof(label));
+        break;
+    default:
+        return;
+    }
+
+    submenu_change_item_label(app->config_menu, index, label);
+}
+
+static void bunnyconnect_trace_flush(BunnyConnectApp* app) {
+    size_t records = 0;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool saved = bunnyconnect_trace_save(storage, BUNNYCONNECT_TRACE_PATH, &records);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!saved) {
+        bunnyconnect_show_error_popup(
+            app, bunnyconnect_trace_is_enabled() ? "Trace write failed" : "Enable Trace first");
+        return;
+    }
+    FURI_LOG_I(TAG, "Trace saved, %u records", records);
+    notification_message(app->notifications, &sequence_success);
+}
+
+// Each tab's scrollback as plain text, overwriting the previous logs
+static void bunnyconnect_tabs_flush(BunnyConnectApp* app) {
+    if(!app->tabs) {
+        bunnyconnect_show_error_popup(app, "Not connected");
+        return;
+    }
+
+    size_t logs = 0;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool saved =
+        bunnyconnect_tabs_save_logs(app->tabs, storage, app->config.timestamps, &logs);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!saved) {
+        bunnyconnect_show_error_popup(app, "Log write failed");
+        return;
+    }
+    FURI_LOG_I(TAG, "Tab logs saved, %u files", logs);
+    notification_message(app->notifications, &sequence_success);
+}
+
+// Timed app mutex acquire, the wait feeds the mutex_wait_us counter
+static void bunnyconnect_lock(BunnyConnectApp* app) {
+    uint32_t start = furi_hal_cortex_timer_get(0).start;
+    furi_mutex_acquire(app->mutex, FuriWaitForever);
+    bunnyconnect_counters_add(
+        BunnyConnectCounterMutexWaitUs,
+        (furi_hal_cortex_timer_get(0).start - start) /
+            furi_hal_cortex_instructions_per_microsecond());
+}
+
+static bool bunnyconnect_bench_append(Storage* storage, const char* line, size_t len) {
+    FURI_LOG_I(TAG, "%.*s", (int)(len - MIN(len, 2)), line);
+    File* file = storage_file_alloc(storage);
+    bool saved = storage_file_open(file, BUNNYCONNECT_BENCH_PATH, FSAM_WRITE, FSOM_OPEN_APPEND) &&
+                 storage_file_write(file, line, len) == len;
+    storage_file_close(file);
+    storage_file_free(file);
+    return saved;
+}
+
+// Time the hot paths and snapshot the fixed frames, then append one BCBENCH
+// line and a BCFRAME line per frame to SD, the baseline to diff changes against
+static void bunnyconnect_bench(BunnyConnectApp* app) {
+    uint32_t ns_per_op[BunnyConnectBenchCount];
+    if(!bunnyconnect_bench_run(app->gui, ns_per_op)) {
+        bunnyconnect_show_error_popup(app, "Not enough memory\nfor the benchmark");
+        return;
+    }
+
+    BunnyConnectBenchFrameResult frames[BunnyConnectBenchFrameCount];
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool saved = bunnyconnect_bench_frames(app->gui, storage, BUNNYCONNECT_FRAMES_PATH, frames);
+
+    char line[BUNNYCONNECT_BENCH_LINE_SIZE];
+    size_t len = bunnyconnect_bench_format(
+        ns_per_op, furi_get_tick() - app->launch_tick, line, sizeof(line));
+    saved = saved && bunnyconnect_bench_append(storage, line, len);
+    for(size_t i = 0; i < BunnyConnectBenchFrameCount && saved; i++) {
+        len = bunnyconnect_bench_frame_format(i, &frames[i], line, sizeof(line));
+        saved = bunnyconnect_bench_append(storage, line, len);
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    if(!saved) {
+        bunnyconnect_show_error_popup(app, "Benchmark write failed");
+        return;
+    }
+    notification_message(app->notifications, &sequence_success);
+}
+
+// Detach the capture from the worker and save it
+static bool bunnyconnect_capture_stop(BunnyConnectApp* app) {
+    BunnyConnectCapture* capture = app->capture;
+    if(!capture) return true;
+
+    bunnyconnect_lock(app);
+    app->capture = NULL;
+    furi_mutex_release(app->mutex);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool saved = bunnyconnect_capture_save(capture, storage, BUNNYCONNECT_CAPTURE_PATH);
+    furi_record_close(RECORD_STORAGE);
+    bunnyconnect_capture_free(capture);
+    return saved;
+}
+
+// False if it showed an error popup in place of Config
+static bool bunnyconnect_record_toggle(BunnyConnectApp* app) {
+    if(app->capture) {
+        if(!bunnyconnect_capture_stop(app)) {
+            bunnyconnect_show_error_popup(app, "Capture write failed");
+            return false;
+        }
+        notification_message(app->notifications, &sequence_success);
+        return true;
+    }
+    if(app->state != BunnyConnectStateConnected) {
+        bunnyconnect_show_error_popup(app, "Connect first");
+        return false;
+    }
+    if(app->replay) {
+        bunnyconnect_show_error_popup(app, "Replay running");
+        return false;
+    }
+
+    BunnyConnectCapture* capture = bunnyconnect_capture_alloc(BUNNYCONNECT_CAPTURE_SIZE);
+    if(!capture) {
+        bunnyconnect_show_error_popup(app, "Not enough memory\nto record");
+        return false;
+    }
+    bunnyconnect_lock(app);
+    app->capture = capture;
+    furi_mutex_release(app->mutex);
+    return true;
+}
+
+static void bunnyconnect_replay_release(BunnyConnectApp* app) {
+    BunnyConnectReplay* replay = app->replay;
+
+    bunnyconnect_lock(app);
+    app->replay = NULL;
+    furi_mutex_release(app->mutex);
+
+    bunnyconnect_replay_free(replay);
+}
+
+// Feed the saved capture through the worker in place of CDC, ends in ReplayDone
+static void bunnyconnect_replay_start(BunnyConnectApp* app, bool fast) {
+    if(app->state != BunnyConnectStateConnected) {
+        bunnyconnect_show_error_popup(app, "Connect first");
+        return;
+    }
+    if(app->replay || app->capture || app->sendfile || app->ymodem) {
+        bunnyconnect_show_error_popup(app, "Busy, stop the\nrecording or transfer");
+        return;
+    }
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    BunnyConnectReplay* replay =
+        bunnyconnect_replay_load(storage, BUNNYCONNECT_CAPTURE_PATH, fast);
+    furi_record_close(RECORD_STORAGE);
+    if(!replay) {
+        bunnyconnect_show_error_popup(app, "No capture on SD,\nrecord one first");
+        return;
+    }
+
+    uint32_t values[BunnyConnectCounterCount];
+    bunnyconnect_counters_snapshot(values);
+    app->replay_renders = values[BunnyConnectCounterRefreshRendered];
+
+    // Recorded input belongs to the terminal, start there
+    bunnyconnect_view_show(app, BunnyConnectViewTerminal);
+    bunnyconnect_lock(app);
+    app->replay = replay;
+    furi_mutex_release(app->mutex);
+}
+
+static void bunnyconnect_replay_finish(BunnyConnectApp* app) {
+    if(!app->replay) return;
+
+    BunnyConnectReplayResult result;
+    bool match = bunnyconnect_replay_get_result(app->replay, &result);
+    bunnyconnect_replay_release(app);
+
+    uint32_t values[BunnyConnectCounterCount];
+    bunnyconnect_counters_snapshot(values);
+    result.renders = values[BunnyConnectCounterRefreshRendered] - app->replay_renders;
+
+    char line[BUNNYCONNECT_REPLAY_LINE_SIZE];
+    size_t len = bunnyconnect_replay_format(&result, line, sizeof(line));
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bunnyconnect_bench_append(storage, line, len);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!match) {
+        bunnyconnect_show_error_popup(app, "Replay state differs\nfrom the capture");
+        return;
+    }
+    notification_message(app->notifications, &sequence_success);
+}
+
+static void bunnyconnect_config_callback(void* context, uint32_t index) {
+    BunnyConnectApp* app = context;
+    if(!app) return;
+
+    switch(index) {
+    case BunnyConnectConfigIndexFlowControl:
+        app->config.flow_control = (app->config.flow_control + 1) % BunnyConnectFlowControlCount;
+        if(app->cdc) {
+            bunnyconnect_cdc_set_flow_control(app->cdc, app->config.flow_control);
+        }
+        break;
+    case BunnyConnectConfigIndexRoute:
+        app->config.output_route = (app->config.output_route + 1) % BunnyConnectOutputRouteCount;
+        if(app->output) {
+            bunnyconnect_output_set_route(app->output, app->config.output_route);
+        }
+        break;
+    case BunnyConnectConfigIndexCdcLineEnding:
+    case BunnyConnectConfigIndexHidLineEnding: {
+        BunnyConnectOutputDestination destination = index == BunnyConnectConfigIndexCdcLineEnding ?
+                                                        BunnyConnectOutputCdc :
+                                                        BunnyConnectOutputHid;
+        app->config.line_ending[destination] =
+            (app->config.line_ending[destination] + 1) % BunnyConnectLineEndingCount;
+        if(app->output) {
+            bunnyconnect_output_set_line_ending(
+                app->output, destination, app->config.line_ending[destination]);
+        }
+        break;
+    }
+    case BunnyConnectConfigIndexFileMode:
+        app->config.sendfile.mode =
+            (app->config.sendfile.mode + 1) % BunnyConnectSendFileModeCount;
+        break;
+    case BunnyConnectConfigIndexFileRoute:
+        app->config.sendfile.route =
+            (app->config.sendfile.route + 1) % BunnyConnectOutputRouteCount;
+        break;
+    case BunnyConnectConfigIndexFileChunk:
+        app->config.sendfile.chunk_size = bunnyconnect_config_next(
+            bunnyconnect_chunk_sizes,
+            COUNT_OF(bunnyconnect_chunk_sizes),
+            app->config.sendfile.chunk_size);
+        break;
+    case BunnyConnectConfigIndexFilePacing:
+        app->config.sendfile.chunk_delay_ms = bunnyconnect_config_next(
+            bunnyconnect_chunk_delays,
+            COUNT_OF(bunnyconnect_chunk_delays),
+            app->config.sendfile.chunk_delay_ms);
+        break;
+    case BunnyConnectConfigIndexFileLineDelay:
+        app->config.sendfile.line_delay_ms = bunnyconnect_config_next(
+            bunnyconnect_line_delays,
+            COUNT_OF(bunnyconnect_line_delays),
+            app->config.sendfile.line_delay_ms);
+        break;
+    case BunnyConnectConfigIndexYmodemMode:
+        app->config.ymodem_streaming = !app->config.ymodem_streaming;
+        break;
+    case BunnyConnectConfigIndexAutoConnect:
+        app->config.auto_connect = !app->config.auto_connect;
+        break;
+    case BunnyConnectConfigIndexMemoryBudget:
+        // Applies to the next session, the current arena keeps its layout
+        app->config.memory_budget =
+            (app->config.memory_budget + 1) % BunnyConnectMemoryBudgetCount;
+        break;
+    case BunnyConnectConfigIndexTrace:
+        // Debug aid, not saved
+        bunnyconnect_trace_set_enabled(!bunnyconnect_trace_is_enabled());
+        bunnyconnect_config_update_label(app, index);
+        return;
+    case BunnyConnectConfigIndexTraceSave:
+        bunnyconnect_trace_flush(app);
+        return;
+    case BunnyConnectConfigIndexTimestamps:
+        // Lines already in the rings keep their stamps, or lack of them
+        app->config.timestamps = !app->config.timestamps;
+        app->stamps_shown = app->config.timestamps;
+        if(app->tabs) bunnyconnect_tabs_set_stamping(app->tabs, app->config.timestamps);
+        break;
+    case BunnyConnectConfigIndexTabLogs:
+        bunnyconnect_tabs_flush(app);
+        return;
+    case BunnyConnectConfigIndexRecord:
+        if(bunnyconnect_record_toggle(app) && app->config_menu) {
+            bunnyconnect_config_update_label(app, index);
+        }
+        return;
+    case BunnyConnectConfigIndexReplay:
+    case BunnyConnectConfigIndexReplayFast:
+        bunnyconnect_replay_start(app, index == BunnyConnectConfigIndexReplayFast);
+        return;
+    case BunnyConnectConfigIndexBench:
+        bunnyconnect_bench(app);
+        return;
+    default:
+        return;
+    }
+    app->config_dirty = true;
+
+    bunnyconnect_config_update_label(app, index);
+}
+
+static void bunnyconnect_snippets_submenu_callback(void* context, uint32_t index) {
+    BunnyConnectApp* app = context;
+    if(!app || !app->view_dispatcher) return;
+
+    app->snippet_selected = index;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventSnippetSend);
+}
+
+static void bunnyconnect_snippets_open(BunnyConnectApp* app) {
+    if(!app->snippets) {
+        app->snippets = bunnyconnect_snippets_alloc();
+    }
+
+    if(!bunnyconnect_snippets_sync(app->snippets)) {
+        bunnyconnect_show_error_popup(app, "Snippet storage\nunavailable");
+        return;
+    }
+
+    size_t count = bunnyconnect_snippets_get_count(app->snippets);
+    if(count == 0) {
+        bunnyconnect_show_error_popup(app, "No snippets in\napps_data/bunnyconnect");
+        return;
+    }
+
+    submenu_reset(app->snippets_menu);
+    submenu_set_header(app->snippets_menu, "Snippets");
+    for(size_t i = 0; i < count; i++) {
+        submenu_add_item(
+            app->snippets_menu,
+            bunnyconnect_snippets_get_name(app->snippets, i),
+            i,
+            bunnyconnect_snippets_submenu_callback,
+            app);
+    }
+
+    bunnyconnect_view_show(app, BunnyConnectViewSnippets);
+}
+
+static void bunnyconnect_sendfile_done_callback(void* context) {
+    BunnyConnectApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventSendFileDone);
+}
+
+static void bunnyconnect_stats_timer_callback(void* context) {
+    BunnyConnectApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventStatsTick);
+}
+
+static void bunnyconnect_stats_dump_callback(void* context) {
+    BunnyConnectApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventStatsDump);
+}
+
+static void bunnyconnect_histogram_dump_callback(void* context) {
+    BunnyConnectApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventHistogramDump);
+}
+
+static void bunnyconnect_transfer_timer_callback(void* context) {
+    BunnyConnectApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventTransferTick);
+}
+
+// Check the link is up and let the user pick a file into transfer_path
+static bool bunnyconnect_transfer_pick(BunnyConnectApp* app) {
+    if(!app->usb_cdc_connected || !app->output) {
+        bunnyconnect_show_error_popup(app, "Not connected");
+        return false;
+    }
+
+    DialogsFileBrowserOptions options;
+    dialog_file_browser_set_basic_options(&options, "*", NULL);
+    options.base_path = STORAGE_EXT_PATH_PREFIX;
+    options.hide_dot_files = true;
+
+    DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
+    bool selected =
+        dialog_file_browser_show(dialogs, app->transfer_path, app->transfer_path, &options);
+    furi_record_close(RECORD_DIALOGS);
+    return selected;
+}
+
+static void bunnyconnect_transfer_show(BunnyConnectApp* app, const char* header) {
+    const char* path = furi_string_get_cstr(app->transfer_path);
+    const char* name = strrchr(path, '/');
+    bunnyconnect_progress_reset(app->progress, header, name ? name + 1 : path);
+    furi_timer_start(app->transfer_timer, furi_ms_to_ticks(TRANSFER_TICK_MS));
+
+    bunnyconnect_view_show(app, BunnyConnectViewProgress);
+}
+
+static void bunnyconnect_sendfile_open(BunnyConnectApp* app) {
+    if(!bunnyconnect_transfer_pick(app)) return;
+
+    if(app->config.sendfile.route == BunnyConnectOutputRouteBoth) {
+        FileInfo info;
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        FS_Error error =
+            storage_common_stat(storage, furi_string_get_cstr(app->transfer_path), &info);
+        furi_record_close(RECORD_STORAGE);
+        if(error == FSE_OK && info.size > BUNNYCONNECT_SENDFILE_BOTH_MAX) {
+            static char text[48]; // The popup keeps the pointer
+            snprintf(
+                text,
+                sizeof(text),
+                "CDC+HID takes files\nup to %u B, pick one",
+                BUNNYCONNECT_SENDFILE_BOTH_MAX);
+            bunnyconnect_show_error_popup(app, text);
+            return;
+        }
+    }
+
+    app->sendfile = bunnyconnect_sendfile_start(
+        app->output,
+        furi_string_get_cstr(app->transfer_path),
+        &app->config.sendfile,
+        bunnyconnect_sendfile_done_callback,
+        app);
+    if(!app->sendfile) {
+        bunnyconnect_show_error_popup(app, "Cannot open file");
+        return;
+    }
+
+    bunnyconnect_transfer_show(app, "Sending File");
+}
+
+// Wait for the transfer to end, show its final status and release it
+static void bunnyconnect_sendfile_finish(BunnyConnectApp* app) {
+    if(!app->sendfile) return;
+
+    furi_timer_stop(app->transfer_timer);
+    bunnyconnect_sendfile_stop(app->sendfile);
+
+    BunnyConnectSendFileStatus status;
+    bunnyconnect_sendfile_get_status(app->sendfile, &status);
+    bunnyconnect_sendfile_free(app->sendfile);
+    app->sendfile = NULL;
+
+    const char* result = "Done";
+    if(status.state == BunnyConnectSendFileStateCancelled) {
+        result = "Cancelled";
+    } else if(status.state == BunnyConnectSendFileStateError) {
+        result = "Read error";
+    }
+    bunnyconnect_progress_update(app->progress, status.sent, status.total, status.rate, result);
+    notification_message(
+        app->notifications,
+        status.state == BunnyConnectSendFileStateDone ? &sequence_success : &sequence_error);
+}
+
+static void bunnyconnect_ymodem_done_callback(void* context) {
+    BunnyConnectApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventYmodemDone);
+}
+
+static void bunnyconnect_ymodem_open(BunnyConnectApp* app, bool send) {
+    BunnyConnectYmodem* ymodem;
+
+    if(send) {
+        if(!bunnyconnect_transfer_pick(app)) return;
+        ymodem = bunnyconnect_ymodem_send_start(
+            app->output,
+            furi_string_get_cstr(app->transfer_path),
+            bunnyconnect_ymodem_done_callback,
+            app);
+        if(!ymodem) {
+            bunnyconnect_show_error_popup(app, "Cannot open file");
+            return;
+        }
+    } else {
+        if(!app->usb_cdc_connected || !app->output) {
+            bunnyconnect_show_error_popup(app, "Not connected");
+            return;
+        }
+        ymodem = bunnyconnect_ymodem_receive_start(
+            app->output, app->config.ymodem_streaming, bunnyconnect_ymodem_done_callback, app);
+        furi_string_set_str(app->transfer_path, "Waiting for sender");
+    }
+
+    // XON/XOFF bytes are valid file data, the session must see them
+    if(app->config.flow_control == BunnyConnectFlowControlXonXoff) {
+        bunnyconnect_cdc_set_flow_control(app->cdc, BunnyConnectFlowControlNone);
+    }
+
+    // From here on the worker hands received data to the session
+    bunnyconnect_lock(app);
+    app->ymodem = ymodem;
+    furi_mutex_release(app->mutex);
+
+    bunnyconnect_transfer_show(app, send ? "YMODEM Send" : "YMODEM Receive");
+}
+
+static void bunnyconnect_ymodem_release(BunnyConnectApp* app) {
+    BunnyConnectYmodem* ymodem = app->ymodem;
+
+    bunnyconnect_lock(app);
+    app->ymodem = NULL;
+    furi_mutex_release(app->mutex);
+
+    bunnyconnect_ymodem_free(ymodem);
+    if(app->cdc) {
+        bunnyconnect_cdc_set_flow_control(app->cdc, app->config.flow_control);
+    }
+}
+
+static void bunnyconnect_ymodem_finish(BunnyConnectApp* app) {
+    if(!app->ymodem) return;
+
+    furi_timer_stop(app->transfer_timer);
+    bunnyconnect_ymodem_stop(app->ymodem);
+
+    BunnyConnectYmodemStatus status;
+    bunnyconnect_ymodem_get_status(app->ymodem, &status);
+    bunnyconnect_ymodem_release(app);
+
+    const char* result = "Done";
+    if(status.state == BunnyConnectYmodemStateCancelled) {
+        result = "Cancelled";
+    } else if(status.state == BunnyConnectYmodemStateError) {
+        result = status.error;
+    }
+    bunnyconnect_progress_update(app->progress, status.done, status.total, status.rate, result);
+    notification_message(
+        app->notifications,
+        status.state == BunnyConnectYmodemStateDone ? &sequence_success : &sequence_error);
+}
+
 static void bunnyconnect_submenu_callback(void* context, uint32_t index) {
     BunnyConnectApp* app = context;
     if(!app || !app->view_dispatcher) return;
@@ -24,29 +982,49 @@ static void bunnyconnect_submenu_callback(void* context, uint32_t index) {
         view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventConnect);
         break;
     case BunnyConnectSubmenuIndexTerminal:
-        if(app->text_box) {
-            app->current_view = BunnyConnectViewTerminal;
-            view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewTerminal);
-        }
+        bunnyconnect_view_show(app, BunnyConnectViewTerminal);
         break;
     case BunnyConnectSubmenuIndexKeyboard:
-        if(app->custom_keyboard) {
-            app->current_view = BunnyConnectViewCustomKeyboard;
-            view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewCustomKeyboard);
+        // Typed text lives in the session arena
+        if(!app->input_buffer) {
+            bunnyconnect_show_error_popup(app, "Not connected");
+            break;
         }
+        bunnyconnect_view_show(app, BunnyConnectViewCustomKeyboard);
         break;
-    case BunnyConnectSubmenuIndexConfig:
-        if(app->config_menu) {
-            app->current_view = BunnyConnectViewConfig;
-            view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewConfig);
+    case BunnyConnectSubmenuIndexSnippets:
+        if(bunnyconnect_view_ensure(app, BunnyConnectViewSnippets)) {
+            bunnyconnect_snippets_open(app);
         }
         break;
-    case BunnyConnectSubmenuInfo:
-        if(app->info_widget) {
-            app->current_view = BunnyConnectViewInfo;
-            view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewInfo);
+    case BunnyConnectSubmenuIndexSendFile:
+        if(!app->sendfile && !app->ymodem &&
+           bunnyconnect_view_ensure(app, BunnyConnectViewProgress)) {
+            bunnyconnect_sendfile_open(app);
+        }
+        break;
+    case BunnyConnectSubmenuIndexYmodemSend:
+    case BunnyConnectSubmenuIndexYmodemReceive:
+        if(!app->sendfile && !app->ymodem &&
+           bunnyconnect_view_ensure(app, BunnyConnectViewProgress)) {
+            bunnyconnect_ymodem_open(app, index == BunnyConnectSubmenuIndexYmodemSend);
         }
         break;
+    case BunnyConnectSubmenuIndexConfig:
+        bunnyconnect_view_show(app, BunnyConnectViewConfig);
+        break;
+    case BunnyConnectSubmenuInfo:
+        bunnyconnect_view_show(app, BunnyConnectViewInfo);
+        break;
+    case BunnyConnectSubmenuIndexDashboard:
+        bunnyconnect_view_show(app, BunnyConnectViewDashboard);
+        break;
+    case BunnyConnectSubmenuIndexHistogram:
+        bunnyconnect_view_show(app, BunnyConnectViewHistogram);
+        break;
+    case BunnyConnectSubmenuIndexStats:
+        bunnyconnect_view_show(app, BunnyConnectViewStats);
+        break;
     case BunnyConnectSubmenuIndexExit:
         view_dispatcher_stop(app->view_dispatcher);
         break;
@@ -60,81 +1038,426 @@ static void bunnyconnect_keyboard_callback(void* context) {
     view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventKeyboardDone);
 }
 
+// GUI thread: copy the active tab's newest scrollback into the terminal, the worker is
+// never blocked
+static void bunnyconnect_terminal_refresh(BunnyConnectApp* app) {
+    atomic_store(&app->refresh_pending, false);
+    if(!app->terminal || !app->tabs || app->resend_active) return;
+
+    // The index follows the shown tab even while not applied, so toggling it is instant
+    BunnyConnectTabId tab = bunnyconnect_tabs_get_active(app->tabs);
+    if(app->filter) {
+        bunnyconnect_filter_update(app->filter, bunnyconnect_tabs_get_scrollback(app->tabs, tab));
+    }
+
+    size_t size;
+    char* text = bunnyconnect_terminal_text_acquire(app->terminal, &size);
+    if(!text) return;
+    // Filtered lines start whole, with their own absolute marker
+    bool cut = false;
+    size_t shown = app->filter_shown ?
+                       bunnyconnect_filter_render(app->filter, text, size) :
+                       bunnyconnect_tabs_snapshot(app->tabs, tab, text, size, &cut);
+    shown = bunnyconnect_stamp_render(text, shown, size, app->stamps_shown, cut);
+    bunnyconnect_terminal_text_commit(app->terminal);
+    bunnyconnect_counters_add(BunnyConnectCounterRefreshRendered, 1);
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceSnapshot, shown);
+    bunnyconnect_arena_mark(app->arena, app->terminal_text, shown + 1);
+}
+
+// Point the terminal at the session copy, or detach it when there is no session
+static void bunnyconnect_terminal_attach(BunnyConnectApp* app) {
+    if(!app->terminal) return;
+
+    app->resend_active = false; // A new buffer ends a line pick
+    bunnyconnect_terminal_set_buffer(app->terminal, app->terminal_text, app->scrollback_size);
+    bunnyconnect_terminal_refresh(app);
+}
+
+static void bunnyconnect_filter_keyboard_callback(void* context) {
+    BunnyConnectApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventFilterDone);
+}
+
+// The keyboard edits a copy, Back leaves the pattern as it was
+static void bunnyconnect_filter_edit(BunnyConnectApp* app) {
+    if(!bunnyconnect_view_ensure(app, BunnyConnectViewCustomKeyboard)) return;
+
+    strlcpy(
+        app->filter_edit, bunnyconnect_filter_get_pattern(app->filter), sizeof(app->filter_edit));
+    bunnyconnect_keyboard_set_header_text(app->custom_keyboard, "Filter, * ? glob:");
+    bunnyconnect_keyboard_set_result_callback(
+        app->custom_keyboard,
+        bunnyconnect_filter_keyboard_callback,
+        app,
+        app->filter_edit,
+        sizeof(app->filter_edit),
+        false);
+    bunnyconnect_view_show(app, BunnyConnectViewCustomKeyboard);
+}
+
+// OK in the terminal toggles the filter, a long press or no pattern yet edits it
+static void bunnyconnect_terminal_filter_callback(void* context, bool edit) {
+    BunnyConnectApp* app = context;
+    if(!app->filter) {
+        app->filter = bunnyconnect_filter_alloc();
+    }
+
+    if(edit || bunnyconnect_filter_get_pattern(app->filter)[0] == '\0') {
+        bunnyconnect_filter_edit(app);
+        return;
+    }
+    app->filter_shown = !app->filter_shown;
+    bunnyconnect_terminal_attach(app);
+    bunnyconnect_terminal_status_update(app);
+}
+
+// Left/Right in the terminal: show another tab from the top of its own ring
+static void bunnyconnect_terminal_tab_callback(void* context, bool next) {
+    BunnyConnectApp* app = context;
+    if(!app->tabs) return;
+
+    bunnyconnect_tabs_step(app->tabs, next);
+    bunnyconnect_terminal_attach(app);
+    bunnyconnect_terminal_status_update(app);
+}
+
+// Long Left/Right: show or hide line times, lines keep their stamps either way
+static void bunnyconnect_terminal_stamp_callback(void* context) {
+    BunnyConnectApp* app = context;
+    app->stamps_shown = !app->stamps_shown;
+    bunnyconnect_terminal_attach(app);
+}
+
+// Also takes the keyboard back from a filter edit
+static void bunnyconnect_keyboard_attach(BunnyConnectApp* app) {
+    if(!app->custom_keyboard) return;
+
+    bunnyconnect_keyboard_set_header_text(app->custom_keyboard, "Enter command:");
+    bunnyconnect_keyboard_set_result_callback(
+        app->custom_keyboard,
+        bunnyconnect_keyboard_callback,
+        app,
+        app->input_buffer,
+        app->input_buffer ? INPUT_BUFFER_SIZE : 0,
+        true);
+}
+
+// One heap block per connection, nothing on the receive path allocates
+static bool bunnyconnect_session_alloc(BunnyConnectApp* app) {
+    BunnyConnectMemoryBudget budget = app->config.memory_budget;
+
+    app->arena = bunnyconnect_arena_alloc(bunnyconnect_session_size(budget));
+    if(!app->arena) return false;
+
+    app->scrollback_size = bunnyconnect_budgets[budget].scrollback;
+    app->rx_size = bunnyconnect_budgets[budget].rx;
+    app->tabs = bunnyconnect_tabs_alloc(app->arena, app->scrollback_size);
+    bunnyconnect_tabs_set_stamping(app->tabs, app->config.timestamps);
+    app->stamps_shown = app->config.timestamps;
+    app->terminal_text = bunnyconnect_arena_carve(app->arena, "view", app->scrollback_size);
+    app->rx_buffer = bunnyconnect_arena_carve(app->arena, "rx", app->rx_size);
+    app->input_buffer = bunnyconnect_arena_carve(app->arena, "input", INPUT_BUFFER_SIZE);
+    atomic_store(&app->refresh_pending, false);
+
+    bunnyconnect_scrollback_write(
+        bunnyconnect_tabs_get_scrollback(app->tabs, BunnyConnectTabCdc),
+        (const uint8_t*)bunnyconnect_welcome_text,
+        strlen(bunnyconnect_welcome_text));
+
+    bunnyconnect_terminal_attach(app);
+    bunnyconnect_keyboard_attach(app);
+
+    FURI_LOG_I(
+        TAG,
+        "Session arena %u B (%s budget)",
+        bunnyconnect_arena_get_capacity(app->arena),
+        bunnyconnect_config_memory_budget_name(budget));
+    return true;
+}
+
+// Worker must be stopped, views are detached before the arena goes away
+static void bunnyconnect_session_free(BunnyConnectApp* app) {
+    if(!app->arena) return;
+
+    app->tabs = NULL;
+    app->terminal_text = NULL;
+    if(app->filter) {
+        bunnyconnect_filter_reset(app->filter);
+    }
+    app->rx_buffer = NULL;
+    app->input_buffer = NULL;
+    bunnyconnect_terminal_attach(app);
+    bunnyconnect_keyboard_attach(app);
+
+    for(size_t i = 0; i < bunnyconnect_arena_get_region_count(app->arena); i++) {
+        BunnyConnectArenaRegion region;
+        bunnyconnect_arena_get_region(app->arena, i, &region);
+        FURI_LOG_I(TAG, "Arena %s: %u/%u B", region.name, region.high_water, region.size);
+    }
+
+    bunnyconnect_arena_free(app->arena);
+    app->arena = NULL;
+    app->scrollback_size = 0;
+    app->rx_size = 0;
+}
+
+// Runs on the worker thread: track the link, hold output while it is down
+static void bunnyconnect_link_supervise(BunnyConnectApp* app, uint32_t* status_tick) {
+    bool was_up = bunnyconnect_link_is_up(app->link);
+    uint32_t now = furi_get_tick();
+
+    BunnyConnectLinkAction action = bunnyconnect_link_update(
+        app->link,
+        bunnyconnect_cdc_is_connected(app->cdc),
+        bunnyconnect_cdc_is_dtr(app->cdc),
+        now);
+    if(action == BunnyConnectLinkActionReset) {
+        bunnyconnect_power_reset_usb();
+    }
+
+    bool is_up = bunnyconnect_link_is_up(app->link);
+    if(is_up != was_up) {
+        bunnyconnect_output_set_online(app->output, is_up);
+    }
+
+    if(is_up != was_up || now - *status_tick >= furi_ms_to_ticks(LINK_STATUS_MS)) {
+        *status_tick = now;
+        view_dispatcher_send_custom_event(
+            app->view_dispatcher, BunnyConnectCustomEventLinkStatus);
+    }
+}
+
+// Worker: append the rx buffer to a tab and post one refresh if the tab is shown
+static size_t bunnyconnect_tab_receive(BunnyConnectApp* app, BunnyConnectTabId tab, size_t len) {
+    // Snapshots are strings, a NUL would hide everything after it. Stamp lead
+    // bytes are kept, the tab doubles them in the ring.
+    size_t kept = 0;
+    for(size_t i = 0; i < len; i++) {
+        uint8_t c = app->rx_buffer[i];
+        if(c != '\0') app->rx_buffer[kept++] = c;
+    }
+
+    // Lock-free append, the oldest output is overwritten when full
+    bool shown = bunnyconnect_tabs_append(app->tabs, tab, (uint8_t*)app->rx_buffer, kept);
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceAppend, kept);
+
+    // One refresh in flight at a time, the snapshot picks up everything since
+    if(shown) {
+        bunnyconnect_counters_add(BunnyConnectCounterRefreshRequested, 1);
+        if(!atomic_exchange(&app->refresh_pending, true)) {
+            BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceRefreshPost, 0);
+            view_dispatcher_send_custom_event(
+                app->view_dispatcher, BunnyConnectCustomEventRefreshScreen);
+        }
+    }
+    return kept;
+}
+
 int32_t bunnyconnect_worker_thread(void* context) {
     BunnyConnectApp* app = context;
+    uint32_t status_tick = furi_get_tick();
+    bool replay_finished = false;
+    bool replay_fast = false;
 
     while(app->is_running) {
         if(app->state == BunnyConnectStateConnected && app->usb_cdc_connected) {
-            // Check for incoming USB CDC data using correct API
-            size_t bytes_received = furi_hal_cdc_receive(
-                app->usb_cdc_port, (uint8_t*)app->rx_buffer, RX_BUFFER_SIZE - 1);
+            bunnyconnect_link_supervise(app, &status_tick);
+
+            // A replay stands in for CDC, its chunks take the same path from here on
+            size_t bytes_received = 0;
+            if(app->replay) {
+                bunnyconnect_lock(app);
+                if(app->replay) {
+                    bytes_received = bunnyconnect_replay_next(
+                        app->replay, (uint8_t*)app->rx_buffer, app->rx_size, &replay_finished);
+                    replay_fast = bunnyconnect_replay_is_fast(app->replay);
+                }
+                furi_mutex_release(app->mutex);
+            } else {
+                bytes_received = bunnyconnect_usb_cdc_receive(
+                    app->usb_cdc_port, (uint8_t*)app->rx_buffer, app->rx_size);
+            }
+            if(bytes_received > 0) {
+                bunnyconnect_arena_mark(app->arena, app->rx_buffer, bytes_received);
+                bunnyconnect_counters_add(BunnyConnectCounterRxBytes, bytes_received);
+                bunnyconnect_counters_add(BunnyConnectCounterRxChunks, 1);
+                BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceRxChunk, bytes_received);
+                bunnyconnect_histogram_rx_chunk(bytes_received);
+            }
+            if(bytes_received > 0 && app->capture) {
+                bunnyconnect_lock(app);
+                if(app->capture) {
+                    bunnyconnect_capture_rx(
+                        app->capture, (uint8_t*)app->rx_buffer, bytes_received);
+                }
+                furi_mutex_release(app->mutex);
+            }
+
+            // A YMODEM session takes the raw stream, flow control bytes included.
+            // The mutex is only taken while one is set, it guards the release.
+            if(bytes_received > 0 && app->ymodem) {
+                bunnyconnect_lock(app);
+                if(app->ymodem) {
+                    bunnyconnect_ymodem_feed(
+                        app->ymodem, (uint8_t*)app->rx_buffer, bytes_received);
+                    bytes_received = 0;
+                }
+                furi_mutex_release(app->mutex);
+            }
 
+            // Flow control bytes are consumed here, not shown
             if(bytes_received > 0) {
-                // Null terminate received data
-                app->rx_buffer[bytes_received] = '\0';
-
-                // Update terminal buffer
-                if(furi_mutex_acquire(app->mutex, 100) == FuriStatusOk) {
-                    // Use safe string append instead of strncat
-                    if(!safe_append_string(
-                           app->terminal_buffer, app->rx_buffer, TERMINAL_BUFFER_SIZE)) {
-                        // Buffer full, clear some space by shifting content
-                        size_t current_len = strlen(app->terminal_buffer);
-                        if(current_len > TERMINAL_BUFFER_SIZE / 2) {
-                            // Move second half to beginning
-                            size_t move_start = current_len / 2;
-                            memmove(
-                                app->terminal_buffer,
-                                app->terminal_buffer + move_start,
-                                current_len - move_start + 1);
-                            // Try append again
-                            safe_append_string(
-                                app->terminal_buffer, app->rx_buffer, TERMINAL_BUFFER_SIZE);
-                        }
+                bytes_received =
+                    bunnyconnect_cdc_filter_rx(app->cdc, (uint8_t*)app->rx_buffer, bytes_received);
+            }
+
+            if(bytes_received > 0) {
+                if(!app->first_byte_ms) {
+                    app->first_byte_ms = furi_get_tick() - app->launch_tick;
+                    FURI_LOG_I(TAG, "First byte %lu ms after launch", app->first_byte_ms);
+                }
+
+                size_t len = bunnyconnect_tab_receive(app, BunnyConnectTabCdc, bytes_received);
+
+                // Final state digest, compared between a capture and its replay
+                if(app->capture || app->replay) {
+                    bunnyconnect_lock(app);
+                    if(app->capture) {
+                        bunnyconnect_capture_appended(
+                            app->capture, (uint8_t*)app->rx_buffer, len);
+                    }
+                    if(app->replay) {
+                        bunnyconnect_replay_appended(app->replay, (uint8_t*)app->rx_buffer, len);
                     }
+                    furi_mutex_release(app->mutex);
+                }
+            }
+
+            if(replay_finished) {
+                replay_finished = false;
+                view_dispatcher_send_custom_event(
+                    app->view_dispatcher, BunnyConnectCustomEventReplayDone);
+            }
+
+            // The UART tab fills in the background, the CDC chunk is done with rx_buffer
+            if(app->uart_rx) {
+                size_t uart_len =
+                    furi_stream_buffer_receive(app->uart_rx, app->rx_buffer, app->rx_size, 0);
+                if(uart_len > 0) bunnyconnect_tab_receive(app, BunnyConnectTabUart, uart_len);
+            }
+        }
+
+        // A fast replay only yields, so the pipeline runs flat out
+        if(replay_fast) {
+            furi_thread_yield();
+        } else {
+            furi_delay_ms(10);
+        }
+        replay_fast = false;
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Worker stack %lu/%u B used",
+        WORKER_STACK_SIZE - furi_thread_get_stack_space(furi_thread_get_current_id()),
+        WORKER_STACK_SIZE);
+    return 0;
+}
+
+// USART interrupt: pass bytes to the worker, dropped while it falls behind
+static void bunnyconnect_uart_rx_callback(
+    FuriHalSerialHandle* handle,
+    FuriHalSerialRxEvent event,
+    void* context) {
+    BunnyConnectApp* app = context;
+    if(event & FuriHalSerialRxEventData) {
+        uint8_t data = furi_hal_serial_async_rx(handle);
+        furi_stream_buffer_send(app->uart_rx, &data, 1, 0);
+    }
+}
 
-                    // Trigger UI update
-                    uint32_t event = BunnyConnectCustomEventRefreshScreen;
-                    furi_message_queue_put(app->event_queue, &event, 0);
+// The UART tab listens at the configured baud rate, the USART may belong to someone else
+static void bunnyconnect_uart_open(BunnyConnectApp* app) {
+    app->serial_handle = furi_hal_serial_control_acquire(FuriHalSerialIdUsart);
+    if(!app->serial_handle) {
+        FURI_LOG_W(TAG, "USART busy, UART tab stays empty");
+        return;
+    }
 
-                    furi_mutex_release(app->mutex);
-                }
-            }
-        }
+    app->uart_rx = furi_stream_buffer_alloc(app->rx_size, 1);
+    furi_hal_serial_init(app->serial_handle, app->config.baud_rate);
+    furi_hal_serial_async_rx_start(
+        app->serial_handle, bunnyconnect_uart_rx_callback, app, false);
+    FURI_LOG_I(TAG, "UART tab on USART at %lu baud", app->config.baud_rate);
+}
 
-        furi_delay_ms(10);
-    }
+// Worker must be stopped
+static void bunnyconnect_uart_close(BunnyConnectApp* app) {
+    if(!app->serial_handle) return;
 
-    return 0;
+    furi_hal_serial_async_rx_stop(app->serial_handle);
+    furi_hal_serial_deinit(app->serial_handle);
+    furi_hal_serial_control_release(app->serial_handle);
+    app->serial_handle = NULL;
+    furi_stream_buffer_free(app->uart_rx);
+    app->uart_rx = NULL;
 }
 
 static bool bunnyconnect_serial_init(BunnyConnectApp* app) {
     if(!app) return false;
 
+    uint32_t start = furi_get_tick();
+
+    if(!bunnyconnect_session_alloc(app)) {
+        FURI_LOG_E(TAG, "No memory for session buffers");
+        return false;
+    }
+
     // Initialize USB power and CDC
     bunnyconnect_power_init();
 
+    // Register CDC callbacks before enumeration so no state event is missed
+    app->usb_cdc_port = 0; // Use first CDC port
+    app->cdc = bunnyconnect_cdc_alloc(app->usb_cdc_port);
+
     // Enable USB power if configured
     if(app->config.usb_power_enabled) {
         if(!bunnyconnect_power_set_usb_enabled(true)) {
             FURI_LOG_E(TAG, "Failed to enable USB power");
+            bunnyconnect_cdc_free(app->cdc);
+            app->cdc = NULL;
             bunnyconnect_power_deinit();
+            bunnyconnect_session_free(app);
             return false;
         }
+    }
 
-        // Wait for USB enumeration and device detection
-        furi_delay_ms(2000);
-
-        // Check if USB device is connected
-        if(!bunnyconnect_power_is_usb_connected()) {
-            FURI_LOG_W(TAG, "USB device not detected, but continuing anyway");
-        }
+    // Returns as soon as the host configures the interface
+    if(!bunnyconnect_cdc_wait_ready(app->cdc, false, furi_ms_to_ticks(USB_READY_TIMEOUT_MS))) {
+        FURI_LOG_W(TAG, "USB host did not configure CDC, continuing anyway");
     }
+    app->usb_ready_ms = furi_get_tick() - start;
+    FURI_LOG_I(
+        TAG,
+        "USB ready in %lu ms (DTR %s), %lu ms after launch",
+        app->usb_ready_ms,
+        bunnyconnect_cdc_is_dtr(app->cdc) ? "on" : "off",
+        furi_get_tick() - app->launch_tick);
 
     // Initialize CDC communication
-    app->usb_cdc_port = 0; // Use first CDC port
     app->usb_cdc_connected = true;
 
+    // Start output queues with the configured routing
+    bunnyconnect_cdc_set_flow_control(app->cdc, app->config.flow_control);
+    app->output = bunnyconnect_output_alloc(app->cdc);
+    app->link = bunnyconnect_link_alloc();
+    bunnyconnect_output_set_route(app->output, app->config.output_route);
+    for(size_t i = 0; i < BunnyConnectOutputCount; i++) {
+        bunnyconnect_output_set_line_ending(app->output, i, app->config.line_ending[i]);
+    }
+    bunnyconnect_uart_open(app);
+
     FURI_LOG_I(
         TAG,
         "USB CDC connection established (baud: %lu, power: %s)",
@@ -144,44 +1467,267 @@ static bool bunnyconnect_serial_init(BunnyConnectApp* app) {
     return true;
 }
 
-static void bunnyconnect_serial_deinit(BunnyConnectApp* app) {
+static bool bunnyconnect_send_text(BunnyConnectApp* app, const char* text, size_t len) {
+    // Queue the text for CDC and/or HID, workers drain it in the background
+    if(!app->usb_cdc_connected || !app->output) return false;
+    // A running file transfer owns the queues until it ends
+    if(app->sendfile || app->ymodem) return false;
+
+    if(!bunnyconnect_output_send(app->output, (const uint8_t*)text, len, true)) return false;
+
+    // The GUI thread is the loopback tab's only producer
+    if(bunnyconnect_tabs_append(app->tabs, BunnyConnectTabLoopback, (const uint8_t*)text, len)) {
+        bunnyconnect_terminal_refresh(app);
+    }
+    return true;
+}
+
+// Queue the picked line for one destination a chunk at a time from the ring. The room
+// for all of it is checked first, so the target never gets part of a line.
+static bool bunnyconnect_resend_send(
+    BunnyConnectApp* app,
+    BunnyConnectOutputDestination destination) {
+    if(!app->usb_cdc_connected || !app->output) return false;
+    if(app->sendfile || app->ymodem) return false;
+
+    BunnyConnectResendSpan span;
+    if(!bunnyconnect_resend_locate(app, &span) || !span.len) return false;
+    // Unescaping only shortens the line, the ring length is an upper bound
+    if(!bunnyconnect_output_has_space(app->output, destination, span.len, true)) {
+        FURI_LOG_W(TAG, "Output queue too full for a %lu B line", span.len);
+        return false;
+    }
+
+    BunnyConnectScrollback* scrollback =
+        bunnyconnect_tabs_get_scrollback(app->tabs, bunnyconnect_tabs_get_active(app->tabs));
+    uint8_t chunk[RESEND_CHUNK_SIZE];
+    uint8_t held = 0;
+    bool sent = true;
+    for(uint32_t pos = span.start; pos != span.start + span.len;) {
+        size_t len = MIN(span.start + span.len - pos, sizeof(chunk));
+        // Lapped by new data halfway, the part queued is still ended as a line
+        if(!bunnyconnect_scrollback_read(scrollback, pos, chunk, len)) {
+            if(pos == span.start) return false;
+            FURI_LOG_W(TAG, "Line overwritten while resending");
+            sent = false;
+            break;
+        }
+        pos += len;
+        len = bunnyconnect_stamp_unescape(chunk, len, &held);
+        if(!bunnyconnect_output_send_to(app->output, destination, chunk, len, false)) {
+            return false;
+        }
+        bunnyconnect_tabs_append(app->tabs, BunnyConnectTabLoopback, chunk, len);
+    }
+    return bunnyconnect_output_send_to(app->output, destination, NULL, 0, true) && sent;
+}
+
+// Long Down in the terminal picks a line, Left/Right narrow it to a word and OK or a
+// long OK sends it to CDC or types it over HID
+static void bunnyconnect_terminal_select_callback(
+    void* context,
+    BunnyConnectTerminalSelectEvent event,
+    size_t line) {
+    BunnyConnectApp* app = context;
+    if(!app->tabs) return;
+
+    app->resend_line = line;
+    switch(event) {
+    case BunnyConnectTerminalSelectStart: {
+        // Lines are counted from the head the view was drawn up to
+        uint32_t tail;
+        bunnyconnect_terminal_refresh(app);
+        bunnyconnect_scrollback_get_window(
+            bunnyconnect_tabs_get_scrollback(app->tabs, bunnyconnect_tabs_get_active(app->tabs)),
+            &tail,
+            &app->resend_head);
+        app->resend_active = true;
+        app->resend_field = 0;
+        break;
+    }
+    case BunnyConnectTerminalSelectMove:
+        app->resend_field = 0;
+        break;
+    case BunnyConnectTerminalSelectFieldPrev:
+        if(app->resend_field > 0) app->resend_field--;
+        break;
+    case BunnyConnectTerminalSelectFieldNext: {
+        BunnyConnectResendSpan span;
+        app->resend_field++;
+        if(!bunnyconnect_resend_locate(app, &span)) app->resend_field--;
+        break;
+    }
+    case BunnyConnectTerminalSelectSendCdc:
+    case BunnyConnectTerminalSelectSendHid: {
+        bool sent = bunnyconnect_resend_send(
+            app,
+            event == BunnyConnectTerminalSelectSendHid ? BunnyConnectOutputHid :
+                                                         BunnyConnectOutputCdc);
+        notification_message(app->notifications, sent ? &sequence_success : &sequence_error);
+        app->resend_active = false;
+        bunnyconnect_terminal_refresh(app);
+        break;
+    }
+    case BunnyConnectTerminalSelectEnd:
+        app->resend_active = false;
+        bunnyconnect_terminal_refresh(app);
+        break;
+    }
+    bunnyconnect_terminal_status_update(app);
+}
+
+// One sample per StatsTick from the counters, nothing on the data path
+static void bunnyconnect_dashboard_update(BunnyConnectApp* app) {
+    uint32_t values[BunnyConnectCounterCount];
+    bunnyconnect_counters_snapshot(values);
+    uint32_t now = furi_get_tick();
+
+    BunnyConnectDashboardSample sample = {
+        .interval_ms = now - app->stats_tick,
+        .rx_bytes = values[BunnyConnectCounterRxBytes],
+        .tx_bytes = values[BunnyConnectCounterTxBytes],
+        .link_bytes_per_s = app->config.baud_rate / 10, // 8N1
+        .connected = app->link && bunnyconnect_link_is_up(app->link),
+        .battery = furi_hal_power_get_pct(),
+        .charging = furi_hal_power_is_charging(),
+    };
+    app->stats_tick = now;
+
+    if(app->output) {
+        BunnyConnectOutputStats hid;
+        bunnyconnect_output_get_stats(app->output, BunnyConnectOutputHid, &hid);
+        sample.hid_depth = hid.depth;
+        sample.hid_capacity = hid.capacity;
+    }
+    bunnyconnect_dashboard_push(app->dashboard, &sample);
+}
+
+// Dumps go straight into the CDC queue, no routing or line ending applied
+static bool bunnyconnect_dump_ready(BunnyConnectApp* app) {
+    if(!app->usb_cdc_connected || !app->output) {
+        bunnyconnect_show_error_popup(app, "Not connected");
+        return false;
+    }
+    // The transfer thread writes the same queue
+    if(app->sendfile || app->ymodem) {
+        notification_message(app->notifications, &sequence_error);
+        return false;
+    }
+    return true;
+}
+
+static bool bunnyconnect_dump_line(BunnyConnectApp* app, const char* line, size_t len) {
+    return bunnyconnect_output_write(
+               app->output, BunnyConnectOutputCdc, (const uint8_t*)line, len, 0) == len;
+}
+
+// One BCSTATS line with every counter
+static void bunnyconnect_stats_dump(BunnyConnectApp* app) {
+    if(!bunnyconnect_dump_ready(app)) return;
+
+    uint32_t values[BunnyConnectCounterCount];
+    char line[STATS_LINE_SIZE];
+    bunnyconnect_counters_snapshot(values);
+    size_t len = bunnyconnect_counters_format(
+        values, furi_get_tick() - app->launch_tick, line, sizeof(line));
+    bool queued = bunnyconnect_dump_line(app, line, len);
+    notification_message(app->notifications, queued ? &sequence_success : &sequence_error);
+}
+
+// One BCHIST line per histogram
+static void bunnyconnect_histogram_dump(BunnyConnectApp* app) {
+    if(!bunnyconnect_dump_ready(app)) return;
+
+    uint32_t counts[BUNNYCONNECT_HISTOGRAM_BUCKETS];
+    char line[STATS_LINE_SIZE];
+    bool queued = true;
+    for(size_t i = 0; i < BunnyConnectHistogramCount && queued; i++) {
+        bunnyconnect_histogram_snapshot(i, counts);
+        size_t len = bunnyconnect_histogram_format(
+            i, counts, furi_get_tick() - app->launch_tick, line, sizeof(line));
+        queued = bunnyconnect_dump_line(app, line, len);
+    }
+    notification_message(app->notifications, queued ? &sequence_success : &sequence_error);
+}
+
+static void bunnyconnect_serial_deinit(BunnyConnectApp* app, bool release_usb) {
     if(!app) return;
 
     app->usb_cdc_connected = false;
 
-    // Turn off USB power
-    bunnyconnect_power_deinit();
+    // The file transfer writes into the output queues, end it first
+    if(app->sendfile) {
+        furi_timer_stop(app->transfer_timer);
+        bunnyconnect_sendfile_free(app->sendfile);
+        app->sendfile = NULL;
+    }
+    if(app->ymodem) {
+        furi_timer_stop(app->transfer_timer);
+        bunnyconnect_ymodem_release(app);
+    }
+    // Keep what was recorded, a replay without its worker just ends
+    bunnyconnect_capture_stop(app);
+    if(app->replay) {
+        bunnyconnect_replay_release(app);
+    }
 
-    FURI_LOG_I(TAG, "USB CDC connection and power disabled");
+    // Stop output workers before USB goes away
+    if(app->output) {
+        bunnyconnect_output_free(app->output);
+        app->output = NULL;
+    }
+    if(app->link) {
+        bunnyconnect_link_free(app->link);
+        app->link = NULL;
+    }
+    if(app->cdc) {
+        bunnyconnect_cdc_free(app->cdc);
+        app->cdc = NULL;
+    }
+    bunnyconnect_uart_close(app);
+
+    // Disconnect keeps the interface enumerated so the next Connect is warm,
+    // exit hands USB back to the interface that was active before the app
+    if(release_usb) {
+        bunnyconnect_power_deinit();
+        FURI_LOG_I(TAG, "USB CDC connection and power disabled");
+    } else {
+        FURI_LOG_I(TAG, "USB CDC connection closed, interface kept");
+    }
+    bunnyconnect_session_free(app);
+    bunnyconnect_terminal_status_update(app);
 }
 
-bool bunnyconnect_custom_event_callback(void* context, uint32_t event) {
-    BunnyConnectApp* app = context;
-    if(!app) return false;
+// Defined with the other view lifecycle helpers below
+static void bunnyconnect_view_release(BunnyConnectApp* app, BunnyConnectViewId id);
 
+static bool bunnyconnect_custom_event_handle(BunnyConnectApp* app, uint32_t event) {
     switch(event) {
     case BunnyConnectCustomEventConnect:
         FURI_LOG_I(TAG, "Connect event");
+        if(app->state == BunnyConnectStateConnected) {
+            // Already up, a second session would leak the first
+            bunnyconnect_view_show(app, BunnyConnectViewTerminal);
+            return true;
+        }
         if(bunnyconnect_serial_init(app)) {
             app->state = BunnyConnectStateConnected;
 
             // Start worker thread
             app->worker_thread = furi_thread_alloc();
             furi_thread_set_name(app->worker_thread, "BunnyWorker");
-            furi_thread_set_stack_size(app->worker_thread, 1024);
+            furi_thread_set_stack_size(app->worker_thread, WORKER_STACK_SIZE);
             furi_thread_set_context(app->worker_thread, app);
             furi_thread_set_callback(app->worker_thread, bunnyconnect_worker_thread);
             furi_thread_start(app->worker_thread);
 
+            bunnyconnect_terminal_status_update(app);
             notification_message(app->notifications, &sequence_success);
         } else {
             bunnyconnect_show_error_popup(app, "Failed to connect");
         }
 
-        if(app->text_box) {
-            app->current_view = BunnyConnectViewTerminal;
-            view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewTerminal);
-        }
+        bunnyconnect_view_show(app, BunnyConnectViewTerminal);
         return true;
 
     case BunnyConnectCustomEventDisconnect:
@@ -197,66 +1743,156 @@ bool bunnyconnect_custom_event_callback(void* context, uint32_t event) {
             app->is_running = true;
         }
 
-        bunnyconnect_serial_deinit(app);
+        bunnyconnect_serial_deinit(app, false);
         return true;
 
     case BunnyConnectCustomEventKeyboardDone:
         FURI_LOG_I(TAG, "Keyboard done event");
-        if(app->input_buffer[0] != '\0') {
-            // Send the text via USB CDC if connected
-            if(app->usb_cdc_connected) {
-                size_t len = strlen(app->input_buffer);
-                furi_hal_cdc_send(app->usb_cdc_port, (uint8_t*)app->input_buffer, len);
-
-                // Add newline
-                uint8_t newline = '\n';
-                furi_hal_cdc_send(app->usb_cdc_port, &newline, 1);
-
-                // Also send via HID for computer input
-                for(size_t i = 0; i < len; i++) {
-                    uint16_t key = HID_ASCII_TO_KEY(app->input_buffer[i]);
-                    if(key != HID_KEYBOARD_NONE) {
-                        furi_hal_hid_kb_press(key);
-                        furi_delay_ms(10);
-                        furi_hal_hid_kb_release(key);
-                        furi_delay_ms(10);
-                    }
-                }
-                // Send enter key via HID
-                furi_hal_hid_kb_press(HID_KEYBOARD_RETURN);
-                furi_delay_ms(10);
-                furi_hal_hid_kb_release(HID_KEYBOARD_RETURN);
-            }
+        if(app->input_buffer && app->input_buffer[0] != '\0') {
+            size_t len = strlen(app->input_buffer);
+            bunnyconnect_arena_mark(app->arena, app->input_buffer, len + 1);
+            bunnyconnect_send_text(app, app->input_buffer, len);
 
             // Clear buffer
             memset(app->input_buffer, 0, INPUT_BUFFER_SIZE);
         }
 
         if(app->main_menu) {
-            app->current_view = BunnyConnectViewMainMenu;
-            view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewMainMenu);
+            bunnyconnect_view_show(app, BunnyConnectViewMainMenu);
+        }
+        return true;
+
+    case BunnyConnectCustomEventSnippetSend:
+        if(app->snippets) {
+            if(!app->usb_cdc_connected) {
+                bunnyconnect_show_error_popup(app, "Not connected");
+                return true;
+            }
+
+            size_t len = 0;
+            char* body = bunnyconnect_snippets_load(app->snippets, app->snippet_selected, &len);
+            if(body) {
+                FURI_LOG_I(TAG, "Sending snippet %lu (%u bytes)", app->snippet_selected, len);
+                bool queued = bunnyconnect_send_text(app, body, len);
+                free(body);
+                notification_message(
+                    app->notifications, queued ? &sequence_success : &sequence_error);
+            } else {
+                bunnyconnect_show_error_popup(app, "Snippet changed,\nreopen library");
+            }
+        }
+        return true;
+
+    case BunnyConnectCustomEventTransferTick:
+        if(app->sendfile) {
+            BunnyConnectSendFileStatus status;
+            bunnyconnect_sendfile_get_status(app->sendfile, &status);
+            bunnyconnect_progress_update(
+                app->progress, status.sent, status.total, status.rate, "Back to cancel");
+        } else if(app->ymodem) {
+            BunnyConnectYmodemStatus status;
+            bunnyconnect_ymodem_get_status(app->ymodem, &status);
+            if(status.name[0] != '\0') {
+                bunnyconnect_progress_set_name(app->progress, status.name);
+            }
+            bunnyconnect_progress_update(
+                app->progress,
+                status.done,
+                status.total,
+                status.rate,
+                status.streaming ? "YMODEM-g, Back to cancel" : "Back to cancel");
         }
         return true;
 
+    case BunnyConnectCustomEventSendFileDone:
+        bunnyconnect_sendfile_finish(app);
+        return true;
+
+    case BunnyConnectCustomEventYmodemDone:
+        bunnyconnect_ymodem_finish(app);
+        return true;
+
+    case BunnyConnectCustomEventFilterDone:
+        bunnyconnect_filter_set_pattern(app->filter, app->filter_edit);
+        app->filter_shown = true;
+        bunnyconnect_keyboard_attach(app);
+        bunnyconnect_view_show(app, BunnyConnectViewTerminal);
+        bunnyconnect_terminal_attach(app);
+        bunnyconnect_terminal_status_update(app);
+        return true;
+
     case BunnyConnectCustomEventRefreshScreen:
-        if(app->text_box && app->terminal_buffer) {
-            if(furi_mutex_acquire(app->mutex, 100) == FuriStatusOk) {
-                text_box_set_text(app->text_box, app->terminal_buffer);
-                text_box_set_focus(app->text_box, TextBoxFocusEnd);
-                furi_mutex_release(app->mutex);
+        bunnyconnect_terminal_refresh(app);
+        return true;
+
+    case BunnyConnectCustomEventConfigRelease:
+        // Config may have been shown again before the event came round
+        if(app->current_view != BunnyConnectViewConfig) {
+            bunnyconnect_view_release(app, BunnyConnectViewConfig);
+        }
+        return true;
+
+    case BunnyConnectCustomEventLinkStatus:
+        bunnyconnect_terminal_status_update(app);
+        return true;
+
+    case BunnyConnectCustomEventStatsTick:
+        if(app->stats) {
+            uint32_t values[BunnyConnectCounterCount];
+            bunnyconnect_counters_snapshot(values);
+            bunnyconnect_stats_update(app->stats, values);
+        }
+        if(app->dashboard) {
+            bunnyconnect_dashboard_update(app);
+        }
+        if(app->histview) {
+            uint32_t counts[BUNNYCONNECT_HISTOGRAM_BUCKETS];
+            for(size_t i = 0; i < BunnyConnectHistogramCount; i++) {
+                bunnyconnect_histogram_snapshot(i, counts);
+                bunnyconnect_histview_update(app->histview, i, counts);
             }
         }
         return true;
 
+    case BunnyConnectCustomEventStatsDump:
+        bunnyconnect_stats_dump(app);
+        return true;
+
+    case BunnyConnectCustomEventHistogramDump:
+        bunnyconnect_histogram_dump(app);
+        return true;
+
+    case BunnyConnectCustomEventReplayDone:
+        bunnyconnect_replay_finish(app);
+        return true;
+
     default:
         return false;
     }
 }
 
+bool bunnyconnect_custom_event_callback(void* context, uint32_t event) {
+    BunnyConnectApp* app = context;
+    if(!app) return false;
+
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceEventBegin, event);
+    bool handled = bunnyconnect_custom_event_handle(app, event);
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceEventEnd, event);
+    return handled;
+}
+
 bool bunnyconnect_navigation_callback(void* context) {
     BunnyConnectApp* app = context;
     if(!app || !app->view_dispatcher) return false;
 
+    if(app->current_view == BunnyConnectViewConfig) {
+        bunnyconnect_config_commit(app);
+    }
+    // Back from a filter edit leaves the pattern as it was
+    if(app->current_view == BunnyConnectViewCustomKeyboard) {
+        bunnyconnect_keyboard_attach(app);
+    }
+
     // Use tracked current view instead of querying view dispatcher
     switch(app->current_view) {
     case BunnyConnectViewMainMenu:
@@ -266,42 +1902,29 @@ bool bunnyconnect_navigation_callback(void* context) {
     case BunnyConnectViewTerminal:
     case BunnyConnectViewConfig:
     case BunnyConnectViewCustomKeyboard:
+    case BunnyConnectViewSnippets:
+    case BunnyConnectViewProgress:
+        // Back cancels a running transfer
+        bunnyconnect_sendfile_finish(app);
+        bunnyconnect_ymodem_finish(app);
+        // fall through
     case BunnyConnectViewPopup:
     case BunnyConnectViewInfo:
+    case BunnyConnectViewStats:
+    case BunnyConnectViewDashboard:
+    case BunnyConnectViewHistogram:
         // Return to main menu from any submenu/view
-        app->current_view = BunnyConnectViewMainMenu;
-        view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewMainMenu);
+        bunnyconnect_view_show(app, BunnyConnectViewMainMenu);
         return true; // Consume the back event
 
     default:
         // For any unknown view, return to main menu
-        app->current_view = BunnyConnectViewMainMenu;
-        view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewMainMenu);
+        bunnyconnect_view_show(app, BunnyConnectViewMainMenu);
         return true;
     }
 }
 
-static bool bunnyconnect_setup_views(BunnyConnectApp* app) {
-    if(!app || !app->view_dispatcher) return false;
-
-    // Initialize with default USB settings
-    app->config.usb_power_enabled = true; // Enable USB power by default
-    app->config.auto_enumerate = true; // Auto-enumerate as CDC device
-
-    // Initialize terminal buffer with welcome message
-    const char* welcome_msg = "BunnyConnect Terminal\nReady for connection...\n";
-    size_t msg_len = strlen(welcome_msg);
-    if(msg_len < TERMINAL_BUFFER_SIZE) {
-        memcpy(app->terminal_buffer, welcome_msg, msg_len + 1);
-    }
-
-    // Main menu
-    app->main_menu = submenu_alloc();
-    if(!app->main_menu) {
-        FURI_LOG_E(TAG, "Failed to allocate main menu");
-        return false;
-    }
-
+static void bunnyconnect_main_menu_fill(BunnyConnectApp* app) {
     submenu_add_item(
         app->main_menu,
         "Connect",
@@ -320,6 +1943,30 @@ static bool bunnyconnect_setup_views(BunnyConnectApp* app) {
         BunnyConnectSubmenuIndexKeyboard,
         bunnyconnect_submenu_callback,
         app);
+    submenu_add_item(
+        app->main_menu,
+        "Snippets",
+        BunnyConnectSubmenuIndexSnippets,
+        bunnyconnect_submenu_callback,
+        app);
+    submenu_add_item(
+        app->main_menu,
+        "Send File",
+        BunnyConnectSubmenuIndexSendFile,
+        bunnyconnect_submenu_callback,
+        app);
+    submenu_add_item(
+        app->main_menu,
+        "YMODEM Send",
+        BunnyConnectSubmenuIndexYmodemSend,
+        bunnyconnect_submenu_callback,
+        app);
+    submenu_add_item(
+        app->main_menu,
+        "YMODEM Receive",
+        BunnyConnectSubmenuIndexYmodemReceive,
+        bunnyconnect_submenu_callback,
+        app);
     submenu_add_item(
         app->main_menu,
         "Config",
@@ -328,93 +1975,270 @@ static bool bunnyconnect_setup_views(BunnyConnectApp* app) {
         app);
     submenu_add_item(
         app->main_menu, "Info", BunnyConnectSubmenuInfo, bunnyconnect_submenu_callback, app);
+    submenu_add_item(
+        app->main_menu,
+        "Dashboard",
+        BunnyConnectSubmenuIndexDashboard,
+        bunnyconnect_submenu_callback,
+        app);
+    submenu_add_item(
+        app->main_menu,
+        "RX Histograms",
+        BunnyConnectSubmenuIndexHistogram,
+        bunnyconnect_submenu_callback,
+        app);
+    submenu_add_item(
+        app->main_menu,
+        "Stats",
+        BunnyConnectSubmenuIndexStats,
+        bunnyconnect_submenu_callback,
+        app);
     submenu_add_item(
         app->main_menu, "Exit", BunnyConnectSubmenuIndexExit, bunnyconnect_submenu_callback, app);
+}
+
+static void bunnyconnect_config_menu_fill(BunnyConnectApp* app) {
+    submenu_add_item(
+        app->config_menu, "Baud Rate: 115200", BunnyConnectConfigIndexBaudRate, NULL, app);
+    submenu_add_item(
+        app->config_menu,
+        "",
+        BunnyConnectConfigIndexFlowControl,
+        bunnyconnect_config_callback,
+        app);
+    submenu_add_item(
+        app->config_menu, "USB Power: ON", BunnyConnectConfigIndexUsbPower, NULL, app);
+    submenu_add_item(
+        app->config_menu, "Auto Enumerate: ON", BunnyConnectConfigIndexAutoEnumerate, NULL, app);
+    submenu_add_item(
+        app->config_menu, "", BunnyConnectConfigIndexRoute, bunnyconnect_config_callback, app);
+    submenu_add_item(
+        app->config_menu,
+        "",
+        BunnyConnectConfigIndexCdcLineEnding,
+        bunnyconnect_config_callback,
+        app);
+    submenu_add_item(
+        app->config_menu,
+        "",
+        BunnyConnectConfigIndexHidLineEnding,
+        bunnyconnect_config_callback,
+        app);
+    for(uint32_t i = BunnyConnectConfigIndexFileMode; i <= BunnyConnectConfigIndexBench; i++) {
+        submenu_add_item(app->config_menu, "", i, bunnyconnect_config_callback, app);
+    }
+    for(uint32_t i = 0; i <= BunnyConnectConfigIndexBench; i++) {
+        bunnyconnect_config_update_label(app, i);
+    }
+}
+
+// Views cheap to rebuild are freed on leaving them, the rest stay once created
+static bool bunnyconnect_view_is_transient(BunnyConnectViewId id) {
+    return id == BunnyConnectViewConfig || id == BunnyConnectViewInfo ||
+           id == BunnyConnectViewPopup || id == BunnyConnectViewStats ||
+           id == BunnyConnectViewDashboard || id == BunnyConnectViewHistogram;
+}
+
+static void bunnyconnect_log_heap(const char* phase) {
+    FURI_LOG_D(
+        TAG,
+        "Heap %s: free %u, min %u, max block %u",
+        phase,
+        memmgr_get_free_heap(),
+        memmgr_get_minimum_free_heap(),
+        memmgr_heap_get_max_free_block());
+}
+
+bool bunnyconnect_view_ensure(BunnyConnectApp* app, BunnyConnectViewId id) {
+    View* view = NULL;
+
+    switch(id) {
+    case BunnyConnectViewMainMenu:
+        if(app->main_menu) return true;
+        app->main_menu = submenu_alloc();
+        bunnyconnect_main_menu_fill(app);
+        view = submenu_get_view(app->main_menu);
+        break;
+
+    case BunnyConnectViewTerminal:
+        if(app->terminal) return true;
+        app->terminal = bunnyconnect_terminal_alloc();
+        bunnyconnect_terminal_set_tab_callback(
+            app->terminal, bunnyconnect_terminal_tab_callback, app);
+        bunnyconnect_terminal_set_filter_callback(
+            app->terminal, bunnyconnect_terminal_filter_callback, app);
+        bunnyconnect_terminal_set_stamp_callback(
+            app->terminal, bunnyconnect_terminal_stamp_callback, app);
+        bunnyconnect_terminal_set_select_callback(
+            app->terminal, bunnyconnect_terminal_select_callback, app);
+        bunnyconnect_terminal_attach(app);
+        bunnyconnect_terminal_status_update(app);
+        view = bunnyconnect_terminal_get_view(app->terminal);
+        break;
+
+    case BunnyConnectViewConfig:
+        if(app->config_menu) return true;
+        app->config_menu = submenu_alloc();
+        bunnyconnect_config_menu_fill(app);
+        view = submenu_get_view(app->config_menu);
+        break;
+
+    case BunnyConnectViewSnippets:
+        if(app->snippets_menu) return true;
+        // Filled from the library when opened
+        app->snippets_menu = submenu_alloc();
+        view = submenu_get_view(app->snippets_menu);
+        break;
+
+    case BunnyConnectViewInfo:
+        if(app->info_widget) return true;
+        // Text is filled in by bunnyconnect_info_update on every visit
+        app->info_widget = widget_alloc();
+        view = widget_get_view(app->info_widget);
+        break;
+
+    case BunnyConnectViewCustomKeyboard:
+        if(app->custom_keyboard) return true;
+        app->custom_keyboard = bunnyconnect_keyboard_alloc();
+        bunnyconnect_keyboard_attach(app);
+        view = bunnyconnect_keyboard_get_view(app->custom_keyboard);
+        break;
+
+    case BunnyConnectViewProgress:
+        if(app->progress) return true;
+        app->progress = bunnyconnect_progress_alloc();
+        view = bunnyconnect_progress_get_view(app->progress);
+        break;
+
+    case BunnyConnectViewPopup:
+        if(app->popup) return true;
+        app->popup = popup_alloc();
+        view = popup_get_view(app->popup);
+        break;
+
+    case BunnyConnectViewStats:
+        if(app->stats) return true;
+        app->stats = bunnyconnect_stats_alloc();
+        bunnyconnect_stats_set_dump_callback(app->stats, bunnyconnect_stats_dump_callback, app);
+        view = bunnyconnect_stats_get_view(app->stats);
+        break;
+
+    case BunnyConnectViewDashboard:
+        if(app->dashboard) return true;
+        app->dashboard = bunnyconnect_dashboard_alloc();
+        view = bunnyconnect_dashboard_get_view(app->dashboard);
+        break;
 
-    view_dispatcher_add_view(
-        app->view_dispatcher, BunnyConnectViewMainMenu, submenu_get_view(app->main_menu));
+    case BunnyConnectViewHistogram:
+        if(app->histview) return true;
+        app->histview = bunnyconnect_histview_alloc();
+        bunnyconnect_histview_set_dump_callback(
+            app->histview, bunnyconnect_histogram_dump_callback, app);
+        view = bunnyconnect_histview_get_view(app->histview);
+        break;
 
-    // Terminal
-    app->text_box = text_box_alloc();
-    if(!app->text_box) {
-        FURI_LOG_E(TAG, "Failed to allocate text box");
+    default:
         return false;
     }
-    text_box_set_font(app->text_box, TextBoxFontText);
-    text_box_set_text(app->text_box, app->terminal_buffer);
-    view_dispatcher_add_view(
-        app->view_dispatcher, BunnyConnectViewTerminal, text_box_get_view(app->text_box));
 
-    // Config menu
-    app->config_menu = submenu_alloc();
-    if(!app->config_menu) {
-        FURI_LOG_E(TAG, "Failed to allocate config menu");
-        return false;
+    view_dispatcher_add_view(app->view_dispatcher, id, view);
+    FURI_LOG_D(TAG, "View %d created", id);
+    bunnyconnect_log_heap("after view");
+    return true;
+}
+
+static void bunnyconnect_view_release(BunnyConnectApp* app, BunnyConnectViewId id) {
+    switch(id) {
+    case BunnyConnectViewConfig:
+        if(!app->config_menu) return;
+        view_dispatcher_remove_view(app->view_dispatcher, id);
+        submenu_free(app->config_menu);
+        app->config_menu = NULL;
+        break;
+    case BunnyConnectViewInfo:
+        if(!app->info_widget) return;
+        view_dispatcher_remove_view(app->view_dispatcher, id);
+        widget_free(app->info_widget);
+        app->info_widget = NULL;
+        break;
+    case BunnyConnectViewPopup:
+        if(!app->popup) return;
+        view_dispatcher_remove_view(app->view_dispatcher, id);
+        popup_free(app->popup);
+        app->popup = NULL;
+        break;
+    case BunnyConnectViewStats:
+        if(!app->stats) return;
+        furi_timer_stop(app->stats_timer);
+        view_dispatcher_remove_view(app->view_dispatcher, id);
+        bunnyconnect_stats_free(app->stats);
+        app->stats = NULL;
+        break;
+    case BunnyConnectViewDashboard:
+        if(!app->dashboard) return;
+        furi_timer_stop(app->stats_timer);
+        view_dispatcher_remove_view(app->view_dispatcher, id);
+        bunnyconnect_dashboard_free(app->dashboard);
+        app->dashboard = NULL;
+        break;
+    case BunnyConnectViewHistogram:
+        if(!app->histview) return;
+        furi_timer_stop(app->stats_timer);
+        view_dispatcher_remove_view(app->view_dispatcher, id);
+        bunnyconnect_histview_free(app->histview);
+        app->histview = NULL;
+        break;
+    default:
+        return;
     }
-    submenu_add_item(app->config_menu, "Baud Rate: 115200", 0, NULL, app);
-    submenu_add_item(app->config_menu, "Flow Control: Off", 1, NULL, app);
-    submenu_add_item(app->config_menu, "USB Power: ON", 2, NULL, app);
-    submenu_add_item(app->config_menu, "Auto Enumerate: ON", 3, NULL, app);
-    view_dispatcher_add_view(
-        app->view_dispatcher, BunnyConnectViewConfig, submenu_get_view(app->config_menu));
-
-    // Info widget
-    app->info_widget = widget_alloc();
-    if(!app->info_widget) {
-        FURI_LOG_E(TAG, "Failed to allocate info widget");
-        return false;
+    FURI_LOG_D(TAG, "View %d released", id);
+}
+
+void bunnyconnect_view_show(BunnyConnectApp* app, BunnyConnectViewId id) {
+    if(!bunnyconnect_view_ensure(app, id)) return;
+    if(id == BunnyConnectViewInfo) {
+        bunnyconnect_info_update(app);
+    } else if(
+        (id == BunnyConnectViewStats || id == BunnyConnectViewDashboard ||
+         id == BunnyConnectViewHistogram) &&
+        app->current_view != id) {
+        app->stats_tick = furi_get_tick();
+        view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventStatsTick);
+        furi_timer_start(app->stats_timer, furi_ms_to_ticks(STATS_TICK_MS));
     }
-    widget_add_text_scroll_element(
-        app->info_widget,
-        0,
-        0,
-        128,
-        64,
-        "BunnyConnect v1.0\n\n"
-        "USB CDC Terminal App\n"
-        "Made by C0d3-5t3w\n\n"
-        "Features:\n"
-        "- USB CDC Communication\n"
-        "- Terminal Interface\n"
-        "- Custom Keyboard\n"
-        "- USB Power Control\n\n"
-        "Use Connect to establish\n"
-        "USB CDC connection with\n"
-        "external devices.\n\n"
-        "Press Back to return.");
-    view_dispatcher_add_view(
-        app->view_dispatcher, BunnyConnectViewInfo, widget_get_view(app->info_widget));
-
-    // Custom keyboard
-    app->custom_keyboard = bunnyconnect_keyboard_alloc();
-    if(!app->custom_keyboard) {
-        FURI_LOG_E(TAG, "Failed to allocate custom keyboard");
-        return false;
+
+    BunnyConnectViewId previous = app->current_view;
+    app->current_view = id;
+    if(app->capture) {
+        bunnyconnect_capture_set_input(app->capture, id == BunnyConnectViewTerminal);
     }
-    bunnyconnect_keyboard_set_header_text(app->custom_keyboard, "Enter command:");
-    bunnyconnect_keyboard_set_result_callback(
-        app->custom_keyboard,
-        bunnyconnect_keyboard_callback,
-        app,
-        app->input_buffer,
-        INPUT_BUFFER_SIZE,
-        true);
-    view_dispatcher_add_view(
-        app->view_dispatcher,
-        BunnyConnectViewCustomKeyboard,
-        bunnyconnect_keyboard_get_view(app->custom_keyboard));
-
-    // Popup
-    app->popup = popup_alloc();
-    if(!app->popup) {
-        FURI_LOG_E(TAG, "Failed to allocate popup");
-        return false;
+    view_dispatcher_switch_to_view(app->view_dispatcher, id);
+
+    if(previous == id || !bunnyconnect_view_is_transient(previous)) return;
+    if(previous == BunnyConnectViewConfig) {
+        // Config items switch views from inside the submenu callback, the
+        // submenu is freed from the event loop once that has returned
+        view_dispatcher_send_custom_event(
+            app->view_dispatcher, BunnyConnectCustomEventConfigRelease);
+    } else {
+        bunnyconnect_view_release(app, previous);
     }
-    view_dispatcher_add_view(
-        app->view_dispatcher, BunnyConnectViewPopup, popup_get_view(app->popup));
+}
 
-    view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewMainMenu);
-    app->current_view = BunnyConnectViewMainMenu;
+static bool bunnyconnect_setup_views(BunnyConnectApp* app) {
+    if(!app || !app->view_dispatcher) return false;
+
+    app->transfer_timer =
+        furi_timer_alloc(bunnyconnect_transfer_timer_callback, FuriTimerTypePeriodic, app);
+    app->stats_timer =
+        furi_timer_alloc(bunnyconnect_stats_timer_callback, FuriTimerTypePeriodic, app);
+
+    // Only the main menu is needed to draw the first frame, the rest on first use
+    if(!bunnyconnect_view_ensure(app, BunnyConnectViewMainMenu)) {
+        FURI_LOG_E(TAG, "Failed to allocate main menu");
+        return false;
+    }
+    bunnyconnect_view_show(app, BunnyConnectViewMainMenu);
 
     FURI_LOG_I(TAG, "Views setup successfully");
     return true;
@@ -427,11 +2251,27 @@ int32_t bunnyconnect_app_run(BunnyConnectApp* app) {
     }
 
     FURI_LOG_I(TAG, "Starting app");
+    uint32_t views_start = furi_get_tick();
+    bunnyconnect_log_heap("after alloc");
+
+    // Start enumeration now so the host configures us while views are built,
+    // the Connect event then takes the warm path
+    if(app->config.auto_connect && app->config.usb_power_enabled) {
+        bunnyconnect_power_init();
+        bunnyconnect_power_set_usb_enabled(true);
+    }
 
     if(!bunnyconnect_setup_views(app)) {
         FURI_LOG_E(TAG, "Failed to setup views");
+        bunnyconnect_power_deinit();
         return -1;
     }
+    FURI_LOG_I(
+        TAG,
+        "Startup: alloc %lu ms, views %lu ms",
+        views_start - app->launch_tick,
+        furi_get_tick() - views_start);
+    bunnyconnect_log_heap("after views");
 
     view_dispatcher_set_event_callback_context(app->view_dispatcher, app);
     view_dispatcher_set_custom_event_callback(
@@ -441,11 +2281,17 @@ int32_t bunnyconnect_app_run(BunnyConnectApp* app) {
 
     view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewMainMenu);
 
+    // Handled first thing in the loop, lands in the terminal once connected
+    if(app->config.auto_connect) {
+        view_dispatcher_send_custom_event(app->view_dispatcher, BunnyConnectCustomEventConnect);
+    }
+
     FURI_LOG_I(TAG, "Running view dispatcher");
     view_dispatcher_run(app->view_dispatcher);
 
     // Cleanup critical resources once the view dispatcher is stopped
     FURI_LOG_I(TAG, "View dispatcher stopped, cleaning up critical app resources");
+    bunnyconnect_log_heap("at exit");
 
     // Stop and free the worker thread
     if(app->worker_thread) {
@@ -457,7 +2303,8 @@ int32_t bunnyconnect_app_run(BunnyConnectApp* app) {
 
     // Deinitialize serial communication and related power management
     // This should be safe to call even if a connection was not fully established
-    bunnyconnect_serial_deinit(app);
+    bunnyconnect_serial_deinit(app, true);
+    bunnyconnect_config_commit(app);
 
     FURI_LOG_I(TAG, "App finished");
     return 0;
@@ -3,6 +3,7 @@
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
 #include <notification/notification_messages.h>
+#include <storage/storage.h>
 
 static bool bunnyconnect_app_custom_event_callback(void* context, uint32_t event) {
     furi_assert(context);
@@ -58,15 +59,14 @@ BunnyConnectApp* bunnyconnect_app_alloc(void) {
     }
 
     memset(app, 0, sizeof(BunnyConnectApp));
-
-    // Initialize config with defaults
-    strncpy(app->config.device_name, "BunnyConnect", sizeof(app->config.device_name) - 1);
-    app->config.baud_rate = 115200;
-    app->config.auto_connect = false;
-    app->config.flow_control = false;
-    app->config.data_bits = 8;
-    app->config.stop_bits = 1;
-    app->config.parity = 0;
+    app->launch_tick = furi_get_tick();
+    bunnyconnect_counters_reset();
+    bunnyconnect_histogram_reset();
+
+    // Saved config in one read, defaults if there is none
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bunnyconnect_config_load(storage, &app->config);
+    furi_record_close(RECORD_STORAGE);
     app->state = BunnyConnectStateDisconnected;
     app->current_view = BunnyConnectViewMainMenu;
     app->is_running = true;
@@ -110,24 +110,14 @@ BunnyConnectApp* bunnyconnect_app_alloc(void) {
         return NULL;
     }
 
-    // Allocate text string
-    app->text_string = furi_string_alloc();
-    if(!app->text_string) {
-        FURI_LOG_E(TAG, "Failed to allocate text string");
+    // Allocate file transfer path, starts browsing from the SD root
+    app->transfer_path = furi_string_alloc_set_str(STORAGE_EXT_PATH_PREFIX);
+    if(!app->transfer_path) {
+        FURI_LOG_E(TAG, "Failed to allocate file path");
         bunnyconnect_app_free(app);
         return NULL;
     }
 
-    // Allocate terminal buffer
-    app->terminal_buffer = malloc(TERMINAL_BUFFER_SIZE);
-    if(!app->terminal_buffer) {
-        FURI_LOG_E(TAG, "Failed to allocate terminal buffer");
-        bunnyconnect_app_free(app);
-        return NULL;
-    }
-    memset(app->terminal_buffer, 0, TERMINAL_BUFFER_SIZE);
-    app->terminal_buffer_position = 0;
-
     // Set up view dispatcher callbacks
     view_dispatcher_set_event_callback_context(app->view_dispatcher, app);
     view_dispatcher_set_custom_event_callback(
@@ -165,14 +155,18 @@ void bunnyconnect_app_free(BunnyConnectApp* app) {
             view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewMainMenu);
             submenu_free(app->main_menu);
         }
-        if(app->text_box) {
+        if(app->terminal) {
             view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewTerminal);
-            text_box_free(app->text_box);
+            bunnyconnect_terminal_free(app->terminal);
         }
         if(app->config_menu) {
             view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewConfig);
             submenu_free(app->config_menu);
         }
+        if(app->snippets_menu) {
+            view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewSnippets);
+            submenu_free(app->snippets_menu);
+        }
         if(app->custom_keyboard) {
             view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewCustomKeyboard);
             bunnyconnect_keyboard_free(app->custom_keyboard);
@@ -181,12 +175,60 @@ void bunnyconnect_app_free(BunnyConnectApp* app) {
             view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewPopup);
             popup_free(app->popup);
         }
+        if(app->info_widget) {
+            view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewInfo);
+            widget_free(app->info_widget);
+        }
+        if(app->progress) {
+            view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewProgress);
+            bunnyconnect_progress_free(app->progress);
+        }
+        if(app->stats) {
+            view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewStats);
+            bunnyconnect_stats_free(app->stats);
+        }
+        if(app->dashboard) {
+            view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewDashboard);
+            bunnyconnect_dashboard_free(app->dashboard);
+        }
+        if(app->histview) {
+            view_dispatcher_remove_view(app->view_dispatcher, BunnyConnectViewHistogram);
+            bunnyconnect_histview_free(app->histview);
+        }
         view_dispatcher_free(app->view_dispatcher);
     }
 
-    // Free terminal buffer
-    if(app->terminal_buffer) {
-        free(app->terminal_buffer);
+    // Free file transfer
+    if(app->sendfile) {
+        bunnyconnect_sendfile_free(app->sendfile);
+    }
+    if(app->ymodem) {
+        bunnyconnect_ymodem_free(app->ymodem);
+    }
+    if(app->transfer_timer) {
+        furi_timer_free(app->transfer_timer);
+    }
+    if(app->stats_timer) {
+        furi_timer_free(app->stats_timer);
+    }
+    if(app->transfer_path) {
+        furi_string_free(app->transfer_path);
+    }
+
+    // Every thread that records is stopped by now
+    bunnyconnect_trace_free();
+
+    // Free snippet library
+    if(app->snippets) {
+        bunnyconnect_snippets_free(app->snippets);
+    }
+    if(app->filter) {
+        bunnyconnect_filter_free(app->filter);
+    }
+
+    // Views are gone, nothing points into the session arena anymore
+    if(app->arena) {
+        bunnyconnect_arena_free(app->arena);
     }
 
     // Free mutex
@@ -199,11 +241,6 @@ void bunnyconnect_app_free(BunnyConnectApp* app) {
         furi_message_queue_free(app->event_queue);
     }
 
-    // Free strings
-    if(app->text_string) {
-        furi_string_free(app->text_string);
-    }
-
     // Close records
     if(app->gui) {
         furi_record_close(RECORD_GUI);
@@ -216,16 +253,15 @@ void bunnyconnect_app_free(BunnyConnectApp* app) {
 }
 
 void bunnyconnect_show_error_popup(BunnyConnectApp* app, const char* message) {
-    if(!app || !message || !app->popup) return;
+    if(!app || !message) return;
 
     FURI_LOG_E(TAG, "Error: %s", message);
+    if(!app->view_dispatcher || !bunnyconnect_view_ensure(app, BunnyConnectViewPopup)) return;
 
     popup_set_context(app->popup, app);
     popup_set_header(app->popup, "Error", 64, 10, AlignCenter, AlignTop);
     popup_set_text(app->popup, message, 64, 32, AlignCenter, AlignCenter);
     popup_set_timeout(app->popup, 3000);
 
-    if(app->view_dispatcher) {
-        view_dispatcher_switch_to_view(app->view_dispatcher, BunnyConnectViewPopup);
-    }
+    bunnyconnect_view_show(app, BunnyConnectViewPopup);
 }
@@ -6,7 +6,32 @@
 #include "lib/bunnyconnect_helpers.h"
 #include "lib/bunnyconnect_draw.h"
 #include "lib/bunnyconnect_power.h"
-
+#include "lib/bunnyconnect_snippets.h"
+#include "lib/bunnyconnect_cdc.h"
+#include "lib/bunnyconnect_output.h"
+#include "lib/bunnyconnect_sendfile.h"
+#include "lib/bunnyconnect_progress.h"
+#include "lib/bunnyconnect_ymodem.h"
+#include "lib/bunnyconnect_usb.h"
+#include "lib/bunnyconnect_link.h"
+#include "lib/bunnyconnect_terminal.h"
+#include "lib/bunnyconnect_config.h"
+#include "lib/bunnyconnect_arena.h"
+#include "lib/bunnyconnect_scrollback.h"
+#include "lib/bunnyconnect_tabs.h"
+#include "lib/bunnyconnect_filter.h"
+#include "lib/bunnyconnect_stamp.h"
+#include "lib/bunnyconnect_resend.h"
+#include "lib/bunnyconnect_counters.h"
+#include "lib/bunnyconnect_stats.h"
+#include "lib/bunnyconnect_dashboard.h"
+#include "lib/bunnyconnect_histogram.h"
+#include "lib/bunnyconnect_histview.h"
+#include "lib/bunnyconnect_trace.h"
+#include "lib/bunnyconnect_bench.h"
+#include "lib/bunnyconnect_replay.h"
+
+#include <stdatomic.h>
 #include <furi.h>
 #include <furi_hal.h>
 #include <furi_hal_serial.h>
@@ -26,19 +51,21 @@
 extern "C" {
 #endif
 
-#define TAG                  "BunnyConnect"
-#define TERMINAL_BUFFER_SIZE 2048
-#define INPUT_BUFFER_SIZE    256
-#define RX_BUFFER_SIZE       512
-#define TX_BUFFER_SIZE       512
+#define TAG               "BunnyConnect"
+#define INPUT_BUFFER_SIZE 256
 
 typedef enum {
     BunnyConnectViewMainMenu,
     BunnyConnectViewTerminal,
     BunnyConnectViewCustomKeyboard,
+    BunnyConnectViewSnippets,
     BunnyConnectViewConfig,
     BunnyConnectViewInfo,
+    BunnyConnectViewProgress,
     BunnyConnectViewPopup,
+    BunnyConnectViewStats,
+    BunnyConnectViewDashboard,
+    BunnyConnectViewHistogram,
 } BunnyConnectViewId;
 
 typedef enum {
@@ -55,20 +82,19 @@ typedef enum {
     BunnyConnectCustomEventConnectionFailed,
     BunnyConnectCustomEventTogglePower,
     BunnyConnectCustomEventConfigSave,
+    BunnyConnectCustomEventSnippetSend,
+    BunnyConnectCustomEventTransferTick,
+    BunnyConnectCustomEventSendFileDone,
+    BunnyConnectCustomEventYmodemDone,
+    BunnyConnectCustomEventLinkStatus,
+    BunnyConnectCustomEventStatsTick,
+    BunnyConnectCustomEventStatsDump,
+    BunnyConnectCustomEventReplayDone,
+    BunnyConnectCustomEventHistogramDump,
+    BunnyConnectCustomEventFilterDone,
+    BunnyConnectCustomEventConfigRelease,
 } BunnyConnectCustomEvent;
 
-typedef struct {
-    char device_name[32];
-    uint32_t baud_rate;
-    bool auto_connect;
-    bool flow_control;
-    uint8_t data_bits;
-    uint8_t stop_bits;
-    uint8_t parity;
-    bool usb_power_enabled; // Enable USB power output
-    bool auto_enumerate; // Auto-enumerate as CDC device
-} BunnyConnectConfig;
-
 struct BunnyConnectApp {
     Gui* gui;
     ViewDispatcher* view_dispatcher;
@@ -76,25 +102,30 @@ struct BunnyConnectApp {
     // Views
     Submenu* main_menu;
     Submenu* config_menu;
-    TextBox* text_box;
+    Submenu* snippets_menu;
+    BunnyConnectTerminal* terminal;
     BunnyConnectKeyboard* custom_keyboard;
     Popup* popup;
     Widget* info_widget;
+    BunnyConnectProgress* progress;
+    BunnyConnectStats* stats;
+    BunnyConnectDashboard* dashboard;
+    BunnyConnectHistView* histview;
+    FuriTimer* stats_timer; // Runs while the stats, dashboard or histogram view is shown
+    uint32_t stats_tick; // Last StatsTick, dashboard rates are taken over the gap
 
     NotificationApp* notifications;
 
-    // Serial communication - using generic handle since control API may not be available
+    // USART for the UART tab, acquired on connect when no one else holds it
     FuriHalSerialHandle* serial_handle;
+    FuriStreamBuffer* uart_rx; // USART interrupt to worker
     BunnyConnectState state;
     BunnyConnectConfig config;
+    bool config_dirty; // Changed in the config menu since the last save
 
     // View tracking
     BunnyConnectViewId current_view;
 
-    // Terminal
-    char* terminal_buffer;
-    size_t terminal_buffer_position;
-
     // Threading and synchronization
     FuriThread* worker_thread;
     FuriMutex* mutex;
@@ -107,15 +138,57 @@ struct BunnyConnectApp {
     // USB CDC communication
     bool usb_cdc_connected;
     uint8_t usb_cdc_port; // CDC port number (0 for single CDC)
-
-    FuriString* text_string;
-    char input_buffer[INPUT_BUFFER_SIZE];
-    char rx_buffer[RX_BUFFER_SIZE];
-    char tx_buffer[TX_BUFFER_SIZE];
+    uint32_t usb_ready_ms; // Connect to host-configured, last connect
+    uint32_t launch_tick;
+    uint32_t first_byte_ms; // Launch to first received byte, 0 until then
+
+    // Packetized CDC transmitter and per-destination output queues, alive while connected
+    BunnyConnectCdc* cdc;
+    BunnyConnectOutput* output;
+    BunnyConnectLink* link; // Updated by the worker, read by the UI
+
+    // Snippet library, loaded on first open
+    BunnyConnectSnippets* snippets;
+    uint32_t snippet_selected;
+
+    // File transfer, exclusive with other sends while set
+    BunnyConnectSendFile* sendfile;
+    BunnyConnectYmodem* ymodem; // Set and cleared under mutex, worker feeds it under mutex
+    FuriTimer* transfer_timer;
+    FuriString* transfer_path;
+
+    // Session record and replay, set and cleared under mutex, the worker uses them under mutex
+    BunnyConnectCapture* capture;
+    BunnyConnectReplay* replay; // Stands in for CDC RX while set
+    uint32_t replay_renders; // Refreshes rendered before the replay started
+
+    // Session buffers, carved from one arena on connect and freed on disconnect
+    BunnyConnectArena* arena;
+    BunnyConnectTabs* tabs; // One ring per transport, GUI thread snapshots the active one
+    size_t scrollback_size;
+    char* terminal_text; // Terminal view copy, same size as scrollback
+    atomic_bool refresh_pending; // RefreshScreen posted and not yet handled
+
+    // Line filter over the shown tab, allocated on first use and kept across sessions
+    BunnyConnectFilter* filter;
+    bool filter_shown; // Terminal shows the matching lines only
+    char filter_edit[BUNNYCONNECT_FILTER_PATTERN_SIZE]; // Keyboard edits a copy
+    bool stamps_shown; // Terminal prefixes lines with their arrival time
+
+    // Line resend, the terminal holds still while a line is picked
+    bool resend_active;
+    uint32_t resend_head; // Ring head when the pick started
+    size_t resend_line; // Lines up from the last one shown
+    size_t resend_field; // 0 for the whole line, else the nth word
+    char* rx_buffer;
+    size_t rx_size;
+    char* input_buffer; // INPUT_BUFFER_SIZE
 };
 
 // Function declarations
 void bunnyconnect_show_error_popup(BunnyConnectApp* app, const char* message);
+bool bunnyconnect_view_ensure(BunnyConnectApp* app, BunnyConnectViewId id);
+void bunnyconnect_view_show(BunnyConnectApp* app, BunnyConnectViewId id);
 bool bunnyconnect_custom_event_callback(void* context, uint32_t event);
 bool bunnyconnect_navigation_callback(void* context);
 int32_t bunnyconnect_worker_thread(void* context);
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_ARENA_REGIONS_MAX 8
+
+typedef struct {
+    const char* name;
+    size_t offset; // From the start of the arena
+    size_t size;
+    size_t high_water; // Largest use reported with bunnyconnect_arena_mark
+} BunnyConnectArenaRegion;
+
+typedef struct BunnyConnectArena BunnyConnectArena;
+
+/**
+ * @brief Allocate arena, one heap block for all regions
+ *
+ * @param capacity Bytes available to bunnyconnect_arena_carve
+ * @return BunnyConnectArena instance, NULL if the heap has no room
+ */
+BunnyConnectArena* bunnyconnect_arena_alloc(size_t capacity);
+
+/**
+ * @brief Free arena and every region carved from it
+ *
+ * @param arena BunnyConnectArena instance
+ */
+void bunnyconnect_arena_free(BunnyConnectArena* arena);
+
+/**
+ * @brief Carve a zeroed, word aligned region
+ *
+ * Regions live until the arena is freed. Running out of space is a layout
+ * bug, so it crashes instead of returning NULL.
+ *
+ * @param arena BunnyConnectArena instance
+ * @param name Region name for the layout report, must outlive the arena
+ * @param size Region size in bytes
+ * @return Region start
+ */
+void* bunnyconnect_arena_carve(BunnyConnectArena* arena, const char* name, size_t size);
+
+/**
+ * @brief Report how much of a region is in use, keeps the high-water mark
+ *
+ * Cheap enough for every received chunk. Each region should have one writer.
+ *
+ * @param arena BunnyConnectArena instance
+ * @param region Region start returned by bunnyconnect_arena_carve
+ * @param used Bytes in use
+ */
+void bunnyconnect_arena_mark(BunnyConnectArena* arena, const void* region, size_t used);
+
+/**
+ * @brief Get arena capacity
+ *
+ * @param arena BunnyConnectArena instance
+ * @return Capacity in bytes
+ */
+size_t bunnyconnect_arena_get_capacity(BunnyConnectArena* arena);
+
+/**
+ * @brief Get bytes carved so far, alignment padding included
+ *
+ * @param arena BunnyConnectArena instance
+ * @return Used bytes
+ */
+size_t bunnyconnect_arena_get_used(BunnyConnectArena* arena);
+
+/**
+ * @brief Get number of carved regions
+ *
+ * @param arena BunnyConnectArena instance
+ * @return Region count
+ */
+size_t bunnyconnect_arena_get_region_count(BunnyConnectArena* arena);
+
+/**
+ * @brief Get a region description
+ *
+ * @param arena BunnyConnectArena instance
+ * @param index Region index, in carve order
+ * @param region Region output
+ */
+void bunnyconnect_arena_get_region(
+    BunnyConnectArena* arena,
+    size_t index,
+    BunnyConnectArenaRegion* region);
+
+#ifdef __cplusplus
+}
+#endif
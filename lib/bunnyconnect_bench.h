@@ -0,0 +1,121 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/gui.h>
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_BENCH_PATH      APP_DATA_PATH("bench.txt")
+#define BUNNYCONNECT_BENCH_LINE_SIZE 160
+#define BUNNYCONNECT_FRAMES_PATH     APP_DATA_PATH("frames")
+
+// Names are part of the BCBENCH line, append only
+typedef enum {
+    BunnyConnectBenchAppend, // 64 byte scrollback write
+    BunnyConnectBenchSnapshot, // Full 4 KiB scrollback copy
+    BunnyConnectBenchHidEncode, // ASCII to HID usage, one character
+    BunnyConnectBenchKeyboardEdit, // Insert or backspace mid-line
+    BunnyConnectBenchDrawTerminal, // Terminal draw callback, full screen of text
+    BunnyConnectBenchCount,
+} BunnyConnectBenchCase;
+
+/**
+ * @brief Time every case on the device, best of three rounds
+ *
+ * Runs on the calling thread with a scratch arena, so it does not touch the
+ * session. The draw case takes the screen through direct draw and is
+ * reported as 0 without a GUI. Blocks for well under a second.
+ *
+ * @param gui Gui record for the draw case, may be NULL
+ * @param ns_per_op Results, BunnyConnectBenchCount entries
+ * @return false if the scratch arena does not fit in the heap
+ */
+bool bunnyconnect_bench_run(Gui* gui, uint32_t* ns_per_op);
+
+/**
+ * @brief Get short case name, as used in the BCBENCH line
+ *
+ * @param bench Case
+ * @return Static name, "?" if out of range
+ */
+const char* bunnyconnect_bench_name(BunnyConnectBenchCase bench);
+
+/**
+ * @brief Format results as one "BCBENCH v=1 up_ms=... name=ns ...\r\n" line
+ *
+ * @param ns_per_op Results from bunnyconnect_bench_run
+ * @param uptime_ms Milliseconds since app start
+ * @param out Output buffer, NUL terminated
+ * @param size Output buffer size, BUNNYCONNECT_BENCH_LINE_SIZE fits all
+ * @return Line length, terminator excluded
+ */
+size_t bunnyconnect_bench_format(
+    const uint32_t* ns_per_op,
+    uint32_t uptime_ms,
+    char* out,
+    size_t size);
+
+// Fixed model states drawn by bunnyconnect_bench_frames, names are file names
+typedef enum {
+    BunnyConnectBenchFrameTerminalEmpty, // Status bar only
+    BunnyConnectBenchFrameTerminalFull, // 4 KiB of wrapped text
+    BunnyConnectBenchFrameKeyboard, // Short text, default layout
+    BunnyConnectBenchFrameKeyboardLong, // Text wider than the field
+    BunnyConnectBenchFrameWidgets, // Every bunnyconnect_draw helper
+    BunnyConnectBenchFrameCount,
+} BunnyConnectBenchFrame;
+
+typedef struct {
+    uint32_t draw_us; // Fastest of three draws
+    uint32_t ink; // Pixels set
+    uint32_t hash; // FNV-1a of the framebuffer
+} BunnyConnectBenchFrameResult;
+
+/**
+ * @brief Draw each fixed state, time it and save the frame as PBM
+ *
+ * Frames go to <dir>/<name>.pbm, 128x64 binary PBM. The hash changes with
+ * any pixel, so a draw change shows up by diffing BCFRAME lines, and the
+ * PBM shows what changed.
+ *
+ * @param gui Gui record, the screen is taken through direct draw
+ * @param storage Storage record
+ * @param dir Output directory, created if missing
+ * @param results Per-frame results, BunnyConnectBenchFrameCount entries
+ * @return false if memory ran out or a frame could not be written
+ */
+bool bunnyconnect_bench_frames(
+    Gui* gui,
+    Storage* storage,
+    const char* dir,
+    BunnyConnectBenchFrameResult* results);
+
+/**
+ * @brief Get frame name
+ *
+ * @param frame Frame
+ * @return Static name, "?" if out of range
+ */
+const char* bunnyconnect_bench_frame_name(BunnyConnectBenchFrame frame);
+
+/**
+ * @brief Format one "BCFRAME v=1 name=... us=... ink=... hash=...\r\n" line
+ *
+ * @param frame Frame
+ * @param result Its result
+ * @param out Output buffer, NUL terminated
+ * @param size Output buffer size
+ * @return Line length, terminator excluded
+ */
+size_t bunnyconnect_bench_frame_format(
+    BunnyConnectBenchFrame frame,
+    const BunnyConnectBenchFrameResult* result,
+    char* out,
+    size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal_usb_cdc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_CDC_TX_RING_SIZE 1024 // Must be a power of two
+#define BUNNYCONNECT_CDC_XON          0x11
+#define BUNNYCONNECT_CDC_XOFF         0x13
+
+typedef enum {
+    BunnyConnectFlowControlNone,
+    BunnyConnectFlowControlXonXoff, // XON/XOFF bytes in the RX stream
+    BunnyConnectFlowControlDtrRts, // Host RTS on the CDC port gates CDC TX, the UART has none
+    BunnyConnectFlowControlCount,
+} BunnyConnectFlowControl;
+
+typedef struct {
+    uint32_t bytes_sent;
+    uint32_t packets_sent;
+    uint32_t full_packets; // Packets of exactly CDC_DATA_SZ bytes
+    uint32_t zlp_sent; // Zero-length packets terminating a full transfer
+    uint32_t flow_pauses; // Times the peer asked us to stop
+    uint32_t stop_latency_us; // Pause request to TX idle, worst case
+    uint32_t resume_latency_us; // Resume request to next packet, worst case
+} BunnyConnectCdcStats;
+
+typedef struct BunnyConnectCdc BunnyConnectCdc;
+
+/**
+ * @brief Allocate CDC transmitter and register endpoint callbacks
+ *
+ * Writes are coalesced in a ring and sent as full USB packets. The ring is
+ * drained from the TX-complete callback, so only the first packet of a burst
+ * is sent from the caller's thread.
+ *
+ * @param port CDC interface number
+ * @return BunnyConnectCdc instance
+ */
+BunnyConnectCdc* bunnyconnect_cdc_alloc(uint8_t port);
+
+/**
+ * @brief Unregister callbacks and free CDC transmitter
+ *
+ * @param cdc BunnyConnectCdc instance
+ */
+void bunnyconnect_cdc_free(BunnyConnectCdc* cdc);
+
+/**
+ * @brief Queue data for transmission
+ *
+ * Starts a transfer right away if the endpoint is idle. Must be called from a
+ * single thread.
+ *
+ * @param cdc BunnyConnectCdc instance
+ * @param data Data to send
+ * @param size Data size in bytes
+ * @param timeout Ticks to wait for ring space
+ * @return size_t bytes queued
+ */
+size_t bunnyconnect_cdc_write(
+    BunnyConnectCdc* cdc,
+    const uint8_t* data,
+    size_t size,
+    uint32_t timeout);
+
+/**
+ * @brief Select flow control mode
+ *
+ * @param cdc BunnyConnectCdc instance
+ * @param mode Flow control mode
+ */
+void bunnyconnect_cdc_set_flow_control(BunnyConnectCdc* cdc, BunnyConnectFlowControl mode);
+
+/**
+ * @brief Apply and strip in-band flow control from received data
+ *
+ * In XON/XOFF mode the control bytes pause or resume TX and are removed from
+ * the buffer. Other modes leave the data untouched.
+ *
+ * @param cdc BunnyConnectCdc instance
+ * @param data Received data, filtered in place
+ * @param size Received size in bytes
+ * @return size_t remaining data size
+ */
+size_t bunnyconnect_cdc_filter_rx(BunnyConnectCdc* cdc, uint8_t* data, size_t size);
+
+/**
+ * @brief Wait until the host has configured the interface
+ *
+ * Driven by the CDC state and control line callbacks, returns as soon as the
+ * condition holds.
+ *
+ * @param cdc BunnyConnectCdc instance
+ * @param dtr Also wait for the host to raise DTR (port opened)
+ * @param timeout Ticks to wait
+ * @return true if ready, false on timeout
+ */
+bool bunnyconnect_cdc_wait_ready(BunnyConnectCdc* cdc, bool dtr, uint32_t timeout);
+
+/**
+ * @brief Check if the host has the interface configured and not suspended
+ *
+ * @param cdc BunnyConnectCdc instance
+ * @return true if configured
+ */
+bool bunnyconnect_cdc_is_connected(BunnyConnectCdc* cdc);
+
+/**
+ * @brief Check if the host holds DTR, i.e. a program has the port open
+ *
+ * @param cdc BunnyConnectCdc instance
+ * @return true if DTR is set
+ */
+bool bunnyconnect_cdc_is_dtr(BunnyConnectCdc* cdc);
+
+/**
+ * @brief Check if TX is paused by flow control
+ *
+ * @param cdc BunnyConnectCdc instance
+ * @return true if paused
+ */
+bool bunnyconnect_cdc_is_paused(BunnyConnectCdc* cdc);
+
+/**
+ * @brief Get display name of a flow control mode
+ *
+ * @param mode Flow control mode
+ * @return const char* name
+ */
+const char* bunnyconnect_cdc_flow_control_name(BunnyConnectFlowControl mode);
+
+/**
+ * @brief Get number of bytes waiting in the TX ring
+ *
+ * @param cdc BunnyConnectCdc instance
+ * @return size_t queued bytes
+ */
+size_t bunnyconnect_cdc_get_pending(BunnyConnectCdc* cdc);
+
+/**
+ * @brief Get CDC transmit statistics
+ *
+ * @param cdc BunnyConnectCdc instance
+ * @param stats Statistics output
+ */
+void bunnyconnect_cdc_get_stats(BunnyConnectCdc* cdc, BunnyConnectCdcStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include "bunnyconnect_cdc.h"
+#include "bunnyconnect_output.h"
+#include "bunnyconnect_sendfile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_CONFIG_PATH      APP_DATA_PATH("config.bin")
+#define BUNNYCONNECT_CONFIG_TEXT_PATH APP_DATA_PATH("config.txt")
+
+// Session memory, mostly terminal scrollback, takes effect on the next connect
+typedef enum {
+    BunnyConnectMemoryBudgetSmall,
+    BunnyConnectMemoryBudgetDefault,
+    BunnyConnectMemoryBudgetLarge,
+    BunnyConnectMemoryBudgetCount,
+} BunnyConnectMemoryBudget;
+
+typedef struct {
+    char device_name[32];
+    uint32_t baud_rate;
+    bool auto_connect; // Connect on launch
+    BunnyConnectFlowControl flow_control;
+    uint8_t data_bits;
+    uint8_t stop_bits;
+    uint8_t parity;
+    bool usb_power_enabled; // Enable USB power output
+    bool auto_enumerate; // Auto-enumerate as CDC device
+    BunnyConnectOutputRoute output_route; // Where submitted text goes
+    BunnyConnectLineEnding line_ending[BunnyConnectOutputCount]; // Per destination
+    BunnyConnectSendFileSettings sendfile; // Send File pacing and routing
+    bool ymodem_streaming; // Ask senders for YMODEM-g
+    bool timestamps; // Stamp scrollback lines with their arrival time
+    BunnyConnectMemoryBudget memory_budget; // Session arena size
+} BunnyConnectConfig;
+
+typedef enum {
+    BunnyConnectConfigSourceDefaults,
+    BunnyConnectConfigSourceBinary,
+    BunnyConnectConfigSourceText,
+} BunnyConnectConfigSource;
+
+/**
+ * @brief Fill config with defaults
+ *
+ * @param config Config to fill
+ */
+void bunnyconnect_config_defaults(BunnyConnectConfig* config);
+
+/**
+ * @brief Load config from SD
+ *
+ * The binary record is read in a single call. If it is missing, corrupt
+ * or from another version, the text file is parsed instead, so hand edits
+ * apply after deleting config.bin. Fields that are absent or out of range
+ * keep their defaults.
+ *
+ * @param storage Storage record
+ * @param config Config output, defaults are applied first
+ * @return BunnyConnectConfigSource where the config came from
+ */
+BunnyConnectConfigSource bunnyconnect_config_load(Storage* storage, BunnyConnectConfig* config);
+
+/**
+ * @brief Save config as binary record and as text file
+ *
+ * @param storage Storage record
+ * @param config Config to save
+ * @return true if the binary record was written
+ */
+bool bunnyconnect_config_save(Storage* storage, const BunnyConnectConfig* config);
+
+/**
+ * @brief Get memory budget name
+ *
+ * @param budget Memory budget
+ * @return Display name
+ */
+const char* bunnyconnect_config_memory_budget_name(BunnyConnectMemoryBudget budget);
+
+#ifdef __cplusplus
+}
+#endif
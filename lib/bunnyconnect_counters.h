@@ -0,0 +1,82 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    BunnyConnectCounterRxBytes,
+    BunnyConnectCounterRxChunks,
+    BunnyConnectCounterRxDropped, // USB receive buffer overflow
+    BunnyConnectCounterTxBytes, // Handed to the CDC transmitter
+    BunnyConnectCounterTxChunks,
+    BunnyConnectCounterTxDropped, // Output queue overflow, all destinations
+    BunnyConnectCounterMutexWaitUs,
+    BunnyConnectCounterRefreshRequested, // Received chunks that asked for a redraw
+    BunnyConnectCounterRefreshRendered, // Terminal snapshots taken
+    BunnyConnectCounterHidKeys,
+    BunnyConnectCounterCdcQueuePeak, // Gauge, bytes
+    BunnyConnectCounterHidQueuePeak, // Gauge, bytes
+    BunnyConnectCounterCount,
+} BunnyConnectCounter;
+
+/**
+ * @brief Add to a counter
+ *
+ * Lock-free and safe from any thread or interrupt.
+ *
+ * @param counter Counter to add to
+ * @param value Amount
+ */
+void bunnyconnect_counters_add(BunnyConnectCounter counter, uint32_t value);
+
+/**
+ * @brief Raise a gauge to value if it is higher
+ *
+ * @param counter Gauge to update
+ * @param value Observed value
+ */
+void bunnyconnect_counters_max(BunnyConnectCounter counter, uint32_t value);
+
+/**
+ * @brief Zero all counters
+ */
+void bunnyconnect_counters_reset(void);
+
+/**
+ * @brief Read all counters, each one atomically
+ *
+ * @param values Output, BunnyConnectCounterCount entries
+ */
+void bunnyconnect_counters_snapshot(uint32_t* values);
+
+/**
+ * @brief Get the machine-readable counter name
+ *
+ * @param counter Counter
+ * @return Name such as "rx_bytes"
+ */
+const char* bunnyconnect_counters_name(BunnyConnectCounter counter);
+
+/**
+ * @brief Format a snapshot as one line of key=value pairs
+ *
+ * The line starts with "BCSTATS v=1 up_ms=<uptime>" and ends in CRLF.
+ *
+ * @param values Snapshot from bunnyconnect_counters_snapshot
+ * @param uptime_ms Milliseconds since launch
+ * @param out Output buffer, NUL terminated
+ * @param size Output buffer size
+ * @return Line length, terminator excluded
+ */
+size_t bunnyconnect_counters_format(
+    const uint32_t* values,
+    uint32_t uptime_ms,
+    char* out,
+    size_t size);
+
+#ifdef __cplusplus
+}
+#endif
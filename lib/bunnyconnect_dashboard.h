@@ -0,0 +1,60 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BunnyConnectDashboard BunnyConnectDashboard;
+
+typedef struct {
+    uint32_t interval_ms; // Since the previous sample
+    uint32_t rx_bytes; // Running totals, rates come from the change
+    uint32_t tx_bytes;
+    uint32_t link_bytes_per_s; // Link capacity for utilisation, 0 if unknown
+    bool connected;
+    uint8_t battery; // Percent
+    bool charging;
+    size_t hid_depth; // HID queue bytes waiting
+    size_t hid_capacity;
+} BunnyConnectDashboardSample;
+
+/** Allocate dashboard view
+ *
+ * RX and TX rate sparklines, link utilisation as signal bars, connection
+ * state, battery and HID queue depth. Only changes when a sample is pushed.
+ *
+ * @return     BunnyConnectDashboard instance
+ */
+BunnyConnectDashboard* bunnyconnect_dashboard_alloc(void);
+
+/** Free dashboard view
+ *
+ * @param      dashboard  BunnyConnectDashboard instance
+ */
+void bunnyconnect_dashboard_free(BunnyConnectDashboard* dashboard);
+
+/** Get dashboard view
+ *
+ * @param      dashboard  BunnyConnectDashboard instance
+ *
+ * @return     View instance that can be used for embedding
+ */
+View* bunnyconnect_dashboard_get_view(BunnyConnectDashboard* dashboard);
+
+/** Add a sample to the history and redraw
+ *
+ * The first sample only primes the totals.
+ *
+ * @param      dashboard  BunnyConnectDashboard instance
+ * @param      sample     Current totals and state
+ */
+void bunnyconnect_dashboard_push(
+    BunnyConnectDashboard* dashboard,
+    const BunnyConnectDashboardSample* sample);
+
+#ifdef __cplusplus
+}
+#endif
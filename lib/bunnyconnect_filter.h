@@ -0,0 +1,107 @@
+#pragma once
+
+#include <furi.h>
+#include "bunnyconnect_scrollback.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_FILTER_PATTERN_SIZE 32
+#define BUNNYCONNECT_FILTER_LINES        128 // Power of two, newest matches kept
+
+typedef struct BunnyConnectFilter BunnyConnectFilter;
+
+/**
+ * @brief Allocate a line filter with an empty pattern
+ *
+ * Keeps the stream positions of complete lines in one scrollback ring that
+ * match the pattern. GUI thread only, like scrollback snapshots.
+ *
+ * @return BunnyConnectFilter instance
+ */
+BunnyConnectFilter* bunnyconnect_filter_alloc(void);
+
+/**
+ * @brief Free filter
+ *
+ * @param filter BunnyConnectFilter instance
+ */
+void bunnyconnect_filter_free(BunnyConnectFilter* filter);
+
+/**
+ * @brief Set the pattern and forget the index, the next update rescans the ring
+ *
+ * Case-insensitive. Without * or ? the pattern matches anywhere in a line,
+ * with them it has to match the whole line, e.g. "*boot*ok".
+ *
+ * @param filter BunnyConnectFilter instance
+ * @param pattern Pattern, empty matches nothing
+ */
+void bunnyconnect_filter_set_pattern(BunnyConnectFilter* filter, const char* pattern);
+
+/**
+ * @brief Get the pattern
+ *
+ * @param filter BunnyConnectFilter instance
+ * @return Pattern, empty if unset
+ */
+const char* bunnyconnect_filter_get_pattern(BunnyConnectFilter* filter);
+
+/**
+ * @brief Forget the index and the ring it refers to, e.g. before the ring is freed
+ *
+ * @param filter BunnyConnectFilter instance
+ */
+void bunnyconnect_filter_reset(BunnyConnectFilter* filter);
+
+/**
+ * @brief Scan what arrived since the last update and drop overwritten lines
+ *
+ * Only new bytes are read, a different ring than last time is scanned from
+ * its oldest byte.
+ *
+ * @param filter BunnyConnectFilter instance
+ * @param scrollback Ring to index
+ */
+void bunnyconnect_filter_update(BunnyConnectFilter* filter, BunnyConnectScrollback* scrollback);
+
+/**
+ * @brief Get the number of indexed lines
+ *
+ * @param filter BunnyConnectFilter instance
+ * @return Matching lines still in the ring
+ */
+size_t bunnyconnect_filter_get_count(BunnyConnectFilter* filter);
+
+/**
+ * @brief Get the stream position of an indexed line
+ *
+ * @param filter BunnyConnectFilter instance
+ * @param back Lines up from the newest match
+ * @param start Position of the line text, stamp markers skipped
+ * @param len Line length, newline excluded
+ * @return false if there are not that many matches
+ */
+bool bunnyconnect_filter_get_line(
+    BunnyConnectFilter* filter,
+    size_t back,
+    uint32_t* start,
+    uint32_t* len);
+
+/**
+ * @brief Copy the newest matching lines as a string, oldest first
+ *
+ * Lines overwritten since the last update are left out. A stamped line is
+ * led by an absolute marker, for bunnyconnect_stamp_render.
+ *
+ * @param filter BunnyConnectFilter instance
+ * @param out Output buffer, NUL terminated
+ * @param size Output buffer size
+ * @return Bytes copied, terminator excluded
+ */
+size_t bunnyconnect_filter_render(BunnyConnectFilter* filter, char* out, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
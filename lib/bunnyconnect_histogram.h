@@ -0,0 +1,86 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bucket 0 holds 0, bucket n holds [2^(n-1), 2^n), the last one everything above
+#define BUNNYCONNECT_HISTOGRAM_BUCKETS 24
+
+typedef enum {
+    BunnyConnectHistogramRxSize, // Bytes per CDC chunk
+    BunnyConnectHistogramRxGap, // Microseconds since the previous chunk
+    BunnyConnectHistogramCount,
+} BunnyConnectHistogram;
+
+/**
+ * @brief Record one received chunk in both RX histograms
+ *
+ * Single writer, the worker. O(1), no allocation or lock. The gap is
+ * measured with the cycle counter against the previous call, the first
+ * chunk after a reset only sets the reference.
+ *
+ * @param size Chunk size in bytes
+ */
+void bunnyconnect_histogram_rx_chunk(size_t size);
+
+/**
+ * @brief Clear all histograms
+ */
+void bunnyconnect_histogram_reset(void);
+
+/**
+ * @brief Copy one histogram, readers may run alongside the writer
+ *
+ * @param histogram Histogram to read
+ * @param counts Output, BUNNYCONNECT_HISTOGRAM_BUCKETS entries
+ */
+void bunnyconnect_histogram_snapshot(BunnyConnectHistogram histogram, uint32_t* counts);
+
+/**
+ * @brief Get short histogram name, as used in the BCHIST line
+ *
+ * @param histogram Histogram
+ * @return Static name, "?" if out of range
+ */
+const char* bunnyconnect_histogram_name(BunnyConnectHistogram histogram);
+
+/**
+ * @brief Get the exclusive upper bound of a bucket
+ *
+ * @param bucket Bucket index
+ * @return 2^bucket, UINT32_MAX for the last bucket
+ */
+uint32_t bunnyconnect_histogram_bucket_limit(size_t bucket);
+
+/**
+ * @brief Find the bucket holding a percentile
+ *
+ * @param counts Histogram counts
+ * @param percent Percentile, 0-100
+ * @return Bucket index, 0 for an empty histogram
+ */
+size_t bunnyconnect_histogram_percentile(const uint32_t* counts, uint8_t percent);
+
+/**
+ * @brief Format a histogram as "BCHIST v=1 up_ms=... name=... counts=c0,c1,...\r\n"
+ *
+ * @param histogram Histogram the counts belong to
+ * @param counts Histogram counts
+ * @param uptime_ms Milliseconds since app start
+ * @param out Output buffer, NUL terminated
+ * @param size Output buffer size
+ * @return Line length, terminator excluded, truncated lines lack the CRLF
+ */
+size_t bunnyconnect_histogram_format(
+    BunnyConnectHistogram histogram,
+    const uint32_t* counts,
+    uint32_t uptime_ms,
+    char* out,
+    size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/view.h>
+#include "bunnyconnect_histogram.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BunnyConnectHistView BunnyConnectHistView;
+typedef void (*BunnyConnectHistViewCallback)(void* context);
+
+/** Allocate histogram view
+ *
+ * One histogram per page as log2 bars with p50 and p99. Left/Right switch
+ * pages, OK calls the dump callback.
+ *
+ * @return     BunnyConnectHistView instance
+ */
+BunnyConnectHistView* bunnyconnect_histview_alloc(void);
+
+/** Free histogram view
+ *
+ * @param      histview  BunnyConnectHistView instance
+ */
+void bunnyconnect_histview_free(BunnyConnectHistView* histview);
+
+/** Get histogram view
+ *
+ * @param      histview  BunnyConnectHistView instance
+ *
+ * @return     View instance that can be used for embedding
+ */
+View* bunnyconnect_histview_get_view(BunnyConnectHistView* histview);
+
+/** Set callback for OK
+ *
+ * @param      histview  BunnyConnectHistView instance
+ * @param      callback  Called from the GUI input handler
+ * @param      context   Callback context
+ */
+void bunnyconnect_histview_set_dump_callback(
+    BunnyConnectHistView* histview,
+    BunnyConnectHistViewCallback callback,
+    void* context);
+
+/** Show new counts for one histogram
+ *
+ * @param      histview   BunnyConnectHistView instance
+ * @param      histogram  Histogram the counts belong to
+ * @param      counts     BUNNYCONNECT_HISTOGRAM_BUCKETS entries
+ */
+void bunnyconnect_histview_update(
+    BunnyConnectHistView* histview,
+    BunnyConnectHistogram histogram,
+    const uint32_t* counts);
+
+#ifdef __cplusplus
+}
+#endif
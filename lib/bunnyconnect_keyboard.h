@@ -117,6 +117,38 @@ void bunnyconnect_keyboard_send_key(BunnyConnectKeyboard* keyboard, uint16_t key
  */
 void bunnyconnect_keyboard_send_string(BunnyConnectKeyboard* keyboard, const char* string);
 
+/** Run the draw callback on a canvas outside the view port
+ *
+ * For timing and snapshotting the draw path on a direct draw canvas.
+ *
+ * @param      keyboard  BunnyConnectKeyboard instance
+ * @param      canvas    Canvas to draw on
+ */
+void bunnyconnect_keyboard_render(BunnyConnectKeyboard* keyboard, Canvas* canvas);
+
+/** Insert a character at the cursor
+ *
+ * Plain text editing shared by the keyboard view and the benchmark, needs
+ * no view or GUI.
+ *
+ * @param      text    NUL terminated text
+ * @param      size    Text buffer size in bytes
+ * @param      cursor  Insert position, advanced past the new character
+ * @param      c       Character to insert
+ *
+ * @return     true if inserted, false when the buffer is full
+ */
+bool bunnyconnect_keyboard_text_insert(char* text, size_t size, size_t* cursor, char c);
+
+/** Delete the character before the cursor
+ *
+ * @param      text    NUL terminated text
+ * @param      cursor  Cursor position, moved back by one
+ *
+ * @return     true if a character was deleted
+ */
+bool bunnyconnect_keyboard_text_backspace(char* text, size_t* cursor);
+
 #ifdef __cplusplus
 }
 #endif
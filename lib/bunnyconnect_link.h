@@ -0,0 +1,90 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_LINK_BACKOFF_MIN_MS 250
+#define BUNNYCONNECT_LINK_BACKOFF_MAX_MS 8000
+
+typedef enum {
+    BunnyConnectLinkStateUp,
+    BunnyConnectLinkStateDown, // Host configured, port closed (DTR dropped)
+    BunnyConnectLinkStateReconnecting, // Not configured, re-enumerating with backoff
+} BunnyConnectLinkState;
+
+typedef enum {
+    BunnyConnectLinkActionNone,
+    BunnyConnectLinkActionReset, // Backoff expired, re-enumerate USB
+} BunnyConnectLinkAction;
+
+typedef struct {
+    BunnyConnectLinkState state;
+    uint32_t drops; // Times the link went down
+    uint32_t attempts; // Resets in the current outage
+    uint32_t backoff_ms; // Wait before the next reset
+    uint32_t down_ms; // Length of the current outage, 0 while up
+    uint32_t reconnect_ms; // Length of the last outage
+} BunnyConnectLinkStatus;
+
+typedef struct BunnyConnectLink BunnyConnectLink;
+
+/**
+ * @brief Allocate link supervisor, starts in the up state
+ *
+ * @return BunnyConnectLink instance
+ */
+BunnyConnectLink* bunnyconnect_link_alloc(void);
+
+/**
+ * @brief Free link supervisor
+ *
+ * @param link BunnyConnectLink instance
+ */
+void bunnyconnect_link_free(BunnyConnectLink* link);
+
+/**
+ * @brief Feed the current USB state, call periodically from one thread
+ *
+ * Losing the configuration means unplug or a stuck host and asks for USB
+ * resets with doubling backoff. DTR falling after it was seen high means the
+ * target closed its port; that only holds output until DTR returns.
+ *
+ * @param link BunnyConnectLink instance
+ * @param configured Host has the CDC interface configured
+ * @param dtr Host holds DTR
+ * @param now Current tick
+ * @return BunnyConnectLinkAction for the caller to perform
+ */
+BunnyConnectLinkAction
+    bunnyconnect_link_update(BunnyConnectLink* link, bool configured, bool dtr, uint32_t now);
+
+/**
+ * @brief Check if output may flow
+ *
+ * @param link BunnyConnectLink instance
+ * @return true if the link is up
+ */
+bool bunnyconnect_link_is_up(BunnyConnectLink* link);
+
+/**
+ * @brief Get link status
+ *
+ * @param link BunnyConnectLink instance
+ * @param status Status output
+ */
+void bunnyconnect_link_get_status(BunnyConnectLink* link, BunnyConnectLinkStatus* status);
+
+/**
+ * @brief Get short state name
+ *
+ * @param state Link state
+ * @return const char* name
+ */
+const char* bunnyconnect_link_state_name(BunnyConnectLinkState state);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <furi.h>
+#include "bunnyconnect_cdc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_OUTPUT_CDC_QUEUE_SIZE 1024
+#define BUNNYCONNECT_OUTPUT_HID_QUEUE_SIZE 512
+#define BUNNYCONNECT_OUTPUT_LINE_ENDING_MAX 2 // CRLF
+
+typedef enum {
+    BunnyConnectOutputCdc,
+    BunnyConnectOutputHid,
+    BunnyConnectOutputCount,
+} BunnyConnectOutputDestination;
+
+typedef enum {
+    BunnyConnectOutputRouteBoth,
+    BunnyConnectOutputRouteCdc,
+    BunnyConnectOutputRouteHid,
+    BunnyConnectOutputRouteCount,
+} BunnyConnectOutputRoute;
+
+typedef enum {
+    BunnyConnectLineEndingLf,
+    BunnyConnectLineEndingCr,
+    BunnyConnectLineEndingCrLf,
+    BunnyConnectLineEndingNone,
+    BunnyConnectLineEndingCount,
+} BunnyConnectLineEnding;
+
+typedef struct {
+    size_t depth; // Bytes waiting in the queue
+    size_t capacity; // Queue size in bytes
+    size_t high_water; // Deepest the queue has been
+    uint32_t bytes_sent;
+    uint32_t bytes_dropped; // Rejected because the queue was full
+    uint32_t drain_rate; // Bytes per second over the last second
+} BunnyConnectOutputStats;
+
+typedef struct BunnyConnectOutput BunnyConnectOutput;
+
+/**
+ * @brief Allocate output router and start one worker per destination
+ *
+ * @param cdc CDC transmitter used by the CDC destination
+ * @return BunnyConnectOutput instance
+ */
+BunnyConnectOutput* bunnyconnect_output_alloc(BunnyConnectCdc* cdc);
+
+/**
+ * @brief Stop workers and free output router
+ *
+ * Data still queued is discarded.
+ *
+ * @param output BunnyConnectOutput instance
+ */
+void bunnyconnect_output_free(BunnyConnectOutput* output);
+
+/**
+ * @brief Select which destinations receive submitted data
+ *
+ * @param output BunnyConnectOutput instance
+ * @param route Routing setting
+ */
+void bunnyconnect_output_set_route(BunnyConnectOutput* output, BunnyConnectOutputRoute route);
+
+/**
+ * @brief Set line ending appended to lines for a destination
+ *
+ * @param output BunnyConnectOutput instance
+ * @param destination Destination to configure
+ * @param line_ending Line ending policy
+ */
+void bunnyconnect_output_set_line_ending(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    BunnyConnectLineEnding line_ending);
+
+/**
+ * @brief Queue data for every routed destination without blocking
+ *
+ * Must be called from a single thread.
+ *
+ * @param output BunnyConnectOutput instance
+ * @param data Data to send
+ * @param size Data size in bytes
+ * @param line Append the destination line ending after data
+ * @return true if every routed destination queued all bytes, a destination
+ *         without room for data and line ending queues none of them
+ */
+bool bunnyconnect_output_send(
+    BunnyConnectOutput* output,
+    const uint8_t* data,
+    size_t size,
+    bool line);
+
+/**
+ * @brief Queue data for one destination without blocking, whatever the route
+ *
+ * Same rules as bunnyconnect_output_send, e.g. for a line picked to go to
+ * CDC or HID only.
+ *
+ * @param output BunnyConnectOutput instance
+ * @param destination Destination queue
+ * @param data Data to send, may be NULL if size is 0
+ * @param size Data size in bytes
+ * @param line Append the destination line ending after data
+ * @return true if all bytes were accepted
+ */
+bool bunnyconnect_output_send_to(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    const uint8_t* data,
+    size_t size,
+    bool line);
+
+/**
+ * @brief Check a send to one destination fits its queue whole
+ *
+ * Only the worker draining the queue runs meanwhile, so a send from the
+ * calling thread right after is not cut short.
+ *
+ * @param output BunnyConnectOutput instance
+ * @param destination Destination queue
+ * @param size Data size in bytes
+ * @param line Count the destination line ending after data
+ * @return true if the queue has room for all of it
+ */
+bool bunnyconnect_output_has_space(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    size_t size,
+    bool line);
+
+/**
+ * @brief Queue data for one destination, waiting for queue space
+ *
+ * Meant for bulk producers such as file streaming. Must not run concurrently
+ * with bunnyconnect_output_send.
+ *
+ * @param output BunnyConnectOutput instance
+ * @param destination Destination queue
+ * @param data Data to send
+ * @param size Data size in bytes
+ * @param timeout Ticks to wait for queue space
+ * @return size_t bytes queued
+ */
+size_t bunnyconnect_output_write(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    const uint8_t* data,
+    size_t size,
+    uint32_t timeout);
+
+/**
+ * @brief Hold or release CDC output while the link is down
+ *
+ * While offline, queued CDC data is kept and new data is queued up to the
+ * queue capacity, then dropped and counted. It flushes once back online.
+ *
+ * @param output BunnyConnectOutput instance
+ * @param online false to hold CDC output
+ */
+void bunnyconnect_output_set_online(BunnyConnectOutput* output, bool online);
+
+/**
+ * @brief Check if a routing setting includes a destination
+ *
+ * @param route Routing setting
+ * @param destination Destination to check
+ * @return true if routed
+ */
+bool bunnyconnect_output_route_has(
+    BunnyConnectOutputRoute route,
+    BunnyConnectOutputDestination destination);
+
+/**
+ * @brief Get queue statistics for a destination
+ *
+ * @param output BunnyConnectOutput instance
+ * @param destination Destination to query
+ * @param stats Statistics output
+ */
+void bunnyconnect_output_get_stats(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    BunnyConnectOutputStats* stats);
+
+/**
+ * @brief Get display name of a routing setting
+ *
+ * @param route Routing setting
+ * @return const char* name
+ */
+const char* bunnyconnect_output_route_name(BunnyConnectOutputRoute route);
+
+/**
+ * @brief Get display name of a line ending policy
+ *
+ * @param line_ending Line ending policy
+ * @return const char* name
+ */
+const char* bunnyconnect_output_line_ending_name(BunnyConnectLineEnding line_ending);
+
+#ifdef __cplusplus
+}
+#endif
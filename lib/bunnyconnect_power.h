@@ -8,19 +8,35 @@
 extern "C" {
 #endif
 
+typedef struct {
+    uint32_t enable_ms; // Last switch to the app interface
+    uint32_t restore_ms; // Last hand-back to the previous interface on exit
+    bool warm; // Last enable found the app interface already active
+} BunnyConnectPowerStats;
+
 /**
  * @brief Initialize USB power management
+ *
+ * The first call after deinit remembers the USB interface active before the
+ * app, later calls in the same session keep it.
  */
 void bunnyconnect_power_init(void);
 
 /**
  * @brief Deinitialize USB power management
+ *
+ * Restores the interface captured by bunnyconnect_power_init, or turns USB
+ * off again if it was off then. Does nothing if the app interface was never
+ * set, e.g. the app exits without connecting.
  */
 void bunnyconnect_power_deinit(void);
 
 /**
  * @brief Enable/disable USB power output
- * 
+ *
+ * Enabling is a no-op when the app interface is already active. Disabling
+ * turns USB off.
+ *
  * @param enabled Power state
  * @return true if successful, false otherwise
  */
@@ -40,6 +56,20 @@ bool bunnyconnect_power_is_usb_enabled(void);
  */
 bool bunnyconnect_power_is_usb_connected(void);
 
+/**
+ * @brief Re-enumerate the app interface, used to recover a lost link
+ *
+ * @return true if the app interface was active and got reset
+ */
+bool bunnyconnect_power_reset_usb(void);
+
+/**
+ * @brief Get USB switch timings
+ *
+ * @param stats Stats output
+ */
+void bunnyconnect_power_get_stats(BunnyConnectPowerStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
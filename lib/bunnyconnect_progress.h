@@ -0,0 +1,70 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BunnyConnectProgress BunnyConnectProgress;
+
+/** Allocate transfer progress view
+ *
+ * Shows a header, file name, progress bar, byte count, rate and a status
+ * line for long-running transfers.
+ *
+ * @return     BunnyConnectProgress instance
+ */
+BunnyConnectProgress* bunnyconnect_progress_alloc(void);
+
+/** Free transfer progress view
+ *
+ * @param      progress  BunnyConnectProgress instance
+ */
+void bunnyconnect_progress_free(BunnyConnectProgress* progress);
+
+/** Get progress view
+ *
+ * @param      progress  BunnyConnectProgress instance
+ *
+ * @return     View instance that can be used for embedding
+ */
+View* bunnyconnect_progress_get_view(BunnyConnectProgress* progress);
+
+/** Reset progress and set header and file name
+ *
+ * @param      progress  BunnyConnectProgress instance
+ * @param      header    Header text, must stay valid while shown
+ * @param      name      File name, copied
+ */
+void bunnyconnect_progress_reset(
+    BunnyConnectProgress* progress,
+    const char* header,
+    const char* name);
+
+/** Replace the file name
+ *
+ * @param      progress  BunnyConnectProgress instance
+ * @param      name      File name, copied
+ */
+void bunnyconnect_progress_set_name(BunnyConnectProgress* progress, const char* name);
+
+/** Update progress
+ *
+ * @param      progress  BunnyConnectProgress instance
+ * @param      done      Bytes transferred
+ * @param      total     Total bytes, 0 if unknown
+ * @param      rate      Bytes per second
+ * @param      status    Status text, must stay valid while shown
+ */
+void bunnyconnect_progress_update(
+    BunnyConnectProgress* progress,
+    uint32_t done,
+    uint32_t total,
+    uint32_t rate,
+    const char* status);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_CAPTURE_PATH     APP_DATA_PATH("capture.bin")
+#define BUNNYCONNECT_CAPTURE_SIZE     (16 * 1024) // RAM held while recording
+#define BUNNYCONNECT_REPLAY_LINE_SIZE 128
+
+typedef struct BunnyConnectCapture BunnyConnectCapture;
+typedef struct BunnyConnectReplay BunnyConnectReplay;
+
+typedef struct {
+    bool fast; // As fast as possible instead of 1x
+    uint32_t elapsed_ms; // First to last record
+    uint32_t rx_chunks;
+    uint32_t rx_bytes; // Appended to the scrollback
+    uint32_t inputs; // Input events published
+    uint32_t digest; // FNV-1a of the appended bytes
+    uint32_t expected_digest; // From the capture
+    uint32_t expected_bytes;
+    uint32_t renders; // Terminal refreshes, filled in by the caller
+} BunnyConnectReplayResult;
+
+/**
+ * @brief Start recording into RAM
+ *
+ * Takes timestamped RX chunks from the worker and input events from the
+ * input service. Recording stops silently when the buffer is full, the
+ * saved file is marked truncated.
+ *
+ * @param capacity Buffer size in bytes
+ * @return BunnyConnectCapture instance, NULL if the heap has no room
+ */
+BunnyConnectCapture* bunnyconnect_capture_alloc(size_t capacity);
+
+/**
+ * @brief Stop recording and free
+ *
+ * @param capture BunnyConnectCapture instance
+ */
+void bunnyconnect_capture_free(BunnyConnectCapture* capture);
+
+/**
+ * @brief Choose whether input events are recorded
+ *
+ * Only input the terminal sees should be recorded, so replay does not walk
+ * through menus. Off after alloc.
+ *
+ * @param capture BunnyConnectCapture instance
+ * @param enabled true to record input events
+ */
+void bunnyconnect_capture_set_input(BunnyConnectCapture* capture, bool enabled);
+
+/**
+ * @brief Record a received chunk as it came from CDC
+ *
+ * @param capture BunnyConnectCapture instance
+ * @param data Received bytes
+ * @param len Number of bytes
+ */
+void bunnyconnect_capture_rx(BunnyConnectCapture* capture, const uint8_t* data, size_t len);
+
+/**
+ * @brief Fold bytes appended to the scrollback into the final state digest
+ *
+ * @param capture BunnyConnectCapture instance
+ * @param data Appended bytes
+ * @param len Number of bytes
+ */
+void bunnyconnect_capture_appended(BunnyConnectCapture* capture, const uint8_t* data, size_t len);
+
+/**
+ * @brief Write the recording and the final state digest to SD
+ *
+ * @param capture BunnyConnectCapture instance
+ * @param storage Storage record
+ * @param path Output path
+ * @return true on success
+ */
+bool bunnyconnect_capture_save(BunnyConnectCapture* capture, Storage* storage, const char* path);
+
+/**
+ * @brief Load a capture for replay, the clock starts now
+ *
+ * @param storage Storage record
+ * @param path Capture path
+ * @param fast true to replay as fast as possible
+ * @return BunnyConnectReplay instance, NULL if missing or malformed
+ */
+BunnyConnectReplay* bunnyconnect_replay_load(Storage* storage, const char* path, bool fast);
+
+/**
+ * @brief Free replay
+ *
+ * @param replay BunnyConnectReplay instance
+ */
+void bunnyconnect_replay_free(BunnyConnectReplay* replay);
+
+/**
+ * @brief Get the next RX chunk that is due, publishing due input events
+ *
+ * Called by the worker in place of the CDC read. Chunks keep their recorded
+ * boundaries unless larger than the buffer.
+ *
+ * @param replay BunnyConnectReplay instance
+ * @param out RX buffer
+ * @param size RX buffer size
+ * @param finished Set once, on the call after the last record
+ * @return Bytes placed in out, 0 if nothing is due
+ */
+size_t bunnyconnect_replay_next(
+    BunnyConnectReplay* replay,
+    uint8_t* out,
+    size_t size,
+    bool* finished);
+
+/**
+ * @brief Check if replaying as fast as possible
+ *
+ * @param replay BunnyConnectReplay instance
+ * @return true in fast mode
+ */
+bool bunnyconnect_replay_is_fast(BunnyConnectReplay* replay);
+
+/**
+ * @brief Fold bytes appended to the scrollback into the digest
+ *
+ * @param replay BunnyConnectReplay instance
+ * @param data Appended bytes
+ * @param len Number of bytes
+ */
+void bunnyconnect_replay_appended(BunnyConnectReplay* replay, const uint8_t* data, size_t len);
+
+/**
+ * @brief Get timing and the final state compared with the capture
+ *
+ * @param replay BunnyConnectReplay instance
+ * @param result Output, renders left at 0
+ * @return true if the replay reached the same final state
+ */
+bool bunnyconnect_replay_get_result(BunnyConnectReplay* replay, BunnyConnectReplayResult* result);
+
+/**
+ * @brief Format a result as one "BCREPLAY v=1 mode=... ms=... match=...\r\n" line
+ *
+ * @param result Replay result
+ * @param out Output buffer, NUL terminated
+ * @param size Output buffer size
+ * @return Line length, terminator excluded
+ */
+size_t bunnyconnect_replay_format(const BunnyConnectReplayResult* result, char* out, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <furi.h>
+#include "bunnyconnect_scrollback.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Part of a line in a scrollback ring, as stream positions
+typedef struct {
+    uint32_t start;
+    uint32_t len;
+} BunnyConnectResendSpan;
+
+/**
+ * @brief Find a line by counting back from a stream position
+ *
+ * Reads the ring in small chunks from the end, nothing is copied out. Line
+ * 0 is the last one before head, a line still waiting for its newline
+ * included. Stamp markers ahead of the text are left out, a line cut by the
+ * tail of the ring starts at the tail. Lead bytes in the text stay doubled,
+ * see bunnyconnect_stamp_unescape.
+ *
+ * @param scrollback Ring to search, GUI thread only
+ * @param head Position to count from, e.g. the head when the view froze
+ * @param back Lines up from the last one
+ * @param line Line text output
+ * @return false if there are not that many lines or they were overwritten
+ */
+bool bunnyconnect_resend_find_line(
+    BunnyConnectScrollback* scrollback,
+    uint32_t head,
+    size_t back,
+    BunnyConnectResendSpan* line);
+
+/**
+ * @brief Narrow a line to one of its words
+ *
+ * Words are separated by spaces and tabs.
+ *
+ * @param scrollback Ring holding the line
+ * @param line Line text, a trailing CR is dropped
+ * @param field 0 for the whole line, else the nth word counted from 1
+ * @param span Field output
+ * @return false if the line has fewer words or was overwritten
+ */
+bool bunnyconnect_resend_find_field(
+    BunnyConnectScrollback* scrollback,
+    const BunnyConnectResendSpan* line,
+    size_t field,
+    BunnyConnectResendSpan* span);
+
+#ifdef __cplusplus
+}
+#endif
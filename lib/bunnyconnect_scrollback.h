@@ -0,0 +1,106 @@
+#pragma once
+
+#include <furi.h>
+#include "bunnyconnect_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_SCROLLBACK_OVERHEAD 32 // Ring state ahead of the data
+
+typedef struct BunnyConnectScrollback BunnyConnectScrollback;
+
+/**
+ * @brief Carve scrollback ring from an arena
+ *
+ * Single producer, single consumer and no locks: the receive worker writes,
+ * the GUI thread takes snapshots. The oldest bytes are overwritten when the
+ * ring is full. Lives until the arena is freed.
+ *
+ * The ring state and data share one region, BUNNYCONNECT_SCROLLBACK_OVERHEAD
+ * bytes more than the capacity.
+ *
+ * @param arena Session arena
+ * @param name Region name for the layout report
+ * @param capacity Ring size, power of two
+ * @return BunnyConnectScrollback instance
+ */
+BunnyConnectScrollback* bunnyconnect_scrollback_alloc(
+    BunnyConnectArena* arena,
+    const char* name,
+    size_t capacity);
+
+/**
+ * @brief Append received bytes, producer only
+ *
+ * Never blocks and never fails. Data longer than the ring keeps its tail.
+ *
+ * @param scrollback BunnyConnectScrollback instance
+ * @param data Bytes to append
+ * @param len Number of bytes
+ */
+void bunnyconnect_scrollback_write(
+    BunnyConnectScrollback* scrollback,
+    const uint8_t* data,
+    size_t len);
+
+/**
+ * @brief Copy the newest bytes as a string, consumer only
+ *
+ * Wait-free: bytes the producer overwrote during the copy are cut from the
+ * front instead of retrying, so the result is always a consistent tail of
+ * the stream.
+ *
+ * @param scrollback BunnyConnectScrollback instance
+ * @param out Output buffer, NUL terminated
+ * @param out_size Output buffer size
+ * @return Bytes copied, terminator excluded
+ */
+size_t bunnyconnect_scrollback_snapshot(
+    BunnyConnectScrollback* scrollback,
+    char* out,
+    size_t out_size);
+
+/**
+ * @brief Get the stream positions the ring holds, consumer only
+ *
+ * Positions count bytes ever written and wrap at 2^32, compare them by
+ * difference. Bytes from tail up to head can be read until the producer
+ * writes past them.
+ *
+ * @param scrollback BunnyConnectScrollback instance
+ * @param tail Oldest held position output
+ * @param head Next position to be written output
+ */
+void bunnyconnect_scrollback_get_window(
+    BunnyConnectScrollback* scrollback,
+    uint32_t* tail,
+    uint32_t* head);
+
+/**
+ * @brief Copy bytes from a stream position, consumer only
+ *
+ * @param scrollback BunnyConnectScrollback instance
+ * @param pos First position, within the last window
+ * @param out Output buffer
+ * @param len Number of bytes, pos + len must not pass head
+ * @return false if any of them was overwritten before or during the copy
+ */
+bool bunnyconnect_scrollback_read(
+    BunnyConnectScrollback* scrollback,
+    uint32_t pos,
+    uint8_t* out,
+    size_t len);
+
+/**
+ * @brief Get bytes currently held, up to the capacity
+ *
+ * @param scrollback BunnyConnectScrollback instance
+ * @return Bytes available to a snapshot
+ */
+size_t bunnyconnect_scrollback_get_fill(BunnyConnectScrollback* scrollback);
+
+#ifdef __cplusplus
+}
+#endif
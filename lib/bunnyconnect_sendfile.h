@@ -0,0 +1,104 @@
+#pragma once
+
+#include <furi.h>
+#include "bunnyconnect_output.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_SENDFILE_PREFETCH_SIZE 2048
+#define BUNNYCONNECT_SENDFILE_READ_SIZE     512
+// Route Both shares one sender, a file must fit the HID queue or CDC waits on HID typing
+#define BUNNYCONNECT_SENDFILE_BOTH_MAX BUNNYCONNECT_OUTPUT_HID_QUEUE_SIZE
+
+typedef enum {
+    BunnyConnectSendFileModeChunks, // Fixed-size chunks with a delay between them
+    BunnyConnectSendFileModeLines, // One line at a time with a delay after each
+    BunnyConnectSendFileModeCount,
+} BunnyConnectSendFileMode;
+
+typedef enum {
+    BunnyConnectSendFileStateIdle,
+    BunnyConnectSendFileStateRunning,
+    BunnyConnectSendFileStateDone,
+    BunnyConnectSendFileStateCancelled,
+    BunnyConnectSendFileStateError,
+} BunnyConnectSendFileState;
+
+typedef struct {
+    BunnyConnectSendFileMode mode;
+    BunnyConnectOutputRoute route; // Destinations the file is streamed to
+    uint16_t chunk_size; // Bytes per chunk in chunk mode
+    uint16_t chunk_delay_ms; // Pause after each chunk
+    uint16_t line_delay_ms; // Pause after each line in line mode
+} BunnyConnectSendFileSettings;
+
+typedef struct {
+    BunnyConnectSendFileState state;
+    uint32_t sent;
+    uint32_t total;
+    uint32_t rate; // Average bytes per second since start
+} BunnyConnectSendFileStatus;
+
+typedef void (*BunnyConnectSendFileCallback)(void* context);
+
+typedef struct BunnyConnectSendFile BunnyConnectSendFile;
+
+/**
+ * @brief Start streaming a file from SD
+ *
+ * A reader thread prefetches the file into a buffer while a sender thread
+ * paces it into the output queues, so SD latency does not stall the link.
+ *
+ * @param output Output router the file is written to
+ * @param path File path on SD
+ * @param settings Pacing and routing settings, copied
+ * @param callback Called from the sender thread when the transfer ends
+ * @param context Callback context
+ * @return BunnyConnectSendFile instance, NULL if the file cannot be opened
+ */
+BunnyConnectSendFile* bunnyconnect_sendfile_start(
+    BunnyConnectOutput* output,
+    const char* path,
+    const BunnyConnectSendFileSettings* settings,
+    BunnyConnectSendFileCallback callback,
+    void* context);
+
+/**
+ * @brief Cancel the transfer if running and wait for its threads
+ *
+ * Status stays readable until the instance is freed.
+ *
+ * @param sendfile BunnyConnectSendFile instance
+ */
+void bunnyconnect_sendfile_stop(BunnyConnectSendFile* sendfile);
+
+/**
+ * @brief Stop the transfer and free the instance
+ *
+ * @param sendfile BunnyConnectSendFile instance
+ */
+void bunnyconnect_sendfile_free(BunnyConnectSendFile* sendfile);
+
+/**
+ * @brief Get transfer status
+ *
+ * @param sendfile BunnyConnectSendFile instance
+ * @param status Status output
+ */
+void bunnyconnect_sendfile_get_status(
+    BunnyConnectSendFile* sendfile,
+    BunnyConnectSendFileStatus* status);
+
+/**
+ * @brief Get display name of a send mode
+ *
+ * @param mode Send mode
+ * @return const char* name
+ */
+const char* bunnyconnect_sendfile_mode_name(BunnyConnectSendFileMode mode);
+
+#ifdef __cplusplus
+}
+#endif
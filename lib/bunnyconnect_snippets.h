@@ -0,0 +1,85 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include "bunnyconnect_output.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_SNIPPETS_PATH       APP_DATA_PATH("snippets")
+#define BUNNYCONNECT_SNIPPETS_INDEX_PATH APP_DATA_PATH("snippets.idx")
+#define BUNNYCONNECT_SNIPPETS_EXTENSION  ".txt"
+#define BUNNYCONNECT_SNIPPETS_NAME_SIZE  32
+#define BUNNYCONNECT_SNIPPETS_MAX_FILES  64
+#define BUNNYCONNECT_SNIPPETS_MAX        512
+// A snippet is queued in one send with its line ending, it must fit the HID queue,
+// the smaller one, while it is empty
+#define BUNNYCONNECT_SNIPPETS_MAX_LENGTH \
+    (BUNNYCONNECT_OUTPUT_HID_QUEUE_SIZE - BUNNYCONNECT_OUTPUT_LINE_ENDING_MAX)
+
+typedef struct BunnyConnectSnippets BunnyConnectSnippets;
+
+/**
+ * @brief Allocate snippet library
+ *
+ * Snippets live in BUNNYCONNECT_SNIPPETS_PATH as text files. A line starting
+ * with "## " begins a new named snippet; text before the first header forms a
+ * snippet named after the file.
+ *
+ * @return BunnyConnectSnippets instance
+ */
+BunnyConnectSnippets* bunnyconnect_snippets_alloc(void);
+
+/**
+ * @brief Free snippet library
+ *
+ * @param snippets BunnyConnectSnippets instance
+ */
+void bunnyconnect_snippets_free(BunnyConnectSnippets* snippets);
+
+/**
+ * @brief Load the on-SD index and refresh it incrementally
+ *
+ * Only files whose size or timestamp differ from the index are parsed again.
+ * The index is rewritten when anything changed.
+ *
+ * @param snippets BunnyConnectSnippets instance
+ * @return true if the library is usable, false on storage error
+ */
+bool bunnyconnect_snippets_sync(BunnyConnectSnippets* snippets);
+
+/**
+ * @brief Get number of indexed snippets
+ *
+ * @param snippets BunnyConnectSnippets instance
+ * @return size_t snippet count
+ */
+size_t bunnyconnect_snippets_get_count(BunnyConnectSnippets* snippets);
+
+/**
+ * @brief Get snippet name
+ *
+ * @param snippets BunnyConnectSnippets instance
+ * @param index snippet index
+ * @return const char* snippet name, NULL if index is out of range
+ */
+const char* bunnyconnect_snippets_get_name(BunnyConnectSnippets* snippets, size_t index);
+
+/**
+ * @brief Read snippet body from SD
+ *
+ * The body is verified against the indexed hash; a mismatch marks the index
+ * stale so the next sync reparses the file.
+ *
+ * @param snippets BunnyConnectSnippets instance
+ * @param index snippet index
+ * @param length receives body length in bytes
+ * @return char* null-terminated body to be freed by caller, NULL on error
+ */
+char* bunnyconnect_snippets_load(BunnyConnectSnippets* snippets, size_t index, size_t* length);
+
+#ifdef __cplusplus
+}
+#endif
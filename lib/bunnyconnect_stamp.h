@@ -0,0 +1,191 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Line stamps travel in the scrollback stream ahead of the first byte of a
+// line: a lead byte, then 6 bits per byte with the top bit set, 0x40 on all
+// but the last byte. A lead byte that is text is written twice.
+#define BUNNYCONNECT_STAMP_DELTA   0x1E // ms since the previous stamped line
+#define BUNNYCONNECT_STAMP_ABS     0x1D // ms since the session started
+#define BUNNYCONNECT_STAMP_PAYLOAD 0x80 // Set on every byte after the lead
+#define BUNNYCONNECT_STAMP_MAX     6 // Bytes in the longest marker
+#define BUNNYCONNECT_STAMP_PREFIX  10 // Rendered "sssss.mmm ", at least two markers long
+
+#define BUNNYCONNECT_STAMP_DELTA_MAX ((1UL << 18) - 1) // Three payload bytes
+#define BUNNYCONNECT_STAMP_ABS_MAX   ((1UL << 30) - 1) // Five payload bytes
+
+/**
+ * @brief Check for a marker lead byte
+ *
+ * @param c Byte
+ * @return true for BUNNYCONNECT_STAMP_DELTA or BUNNYCONNECT_STAMP_ABS
+ */
+bool bunnyconnect_stamp_is_lead(uint8_t c);
+
+#define BUNNYCONNECT_STAMP_NO_LINE SIZE_MAX
+
+typedef struct {
+    uint32_t ms; // Time of the current line, valid if known
+    bool known;
+    uint8_t lead; // Marker being parsed, 0 outside one
+    uint32_t value;
+} BunnyConnectStampClock;
+
+/**
+ * @brief Encode a marker
+ *
+ * Values are cut to BUNNYCONNECT_STAMP_DELTA_MAX or _ABS_MAX, producers
+ * add an absolute marker when a delta would be cut.
+ *
+ * @param lead BUNNYCONNECT_STAMP_DELTA or BUNNYCONNECT_STAMP_ABS
+ * @param ms Value
+ * @param out Output, BUNNYCONNECT_STAMP_MAX bytes
+ * @return Bytes written
+ */
+size_t bunnyconnect_stamp_encode(uint8_t lead, uint32_t ms, uint8_t* out);
+
+/**
+ * @brief Feed one stream byte to a clock
+ *
+ * Markers move the clock, a delta only while it is known. Of a doubled
+ * lead byte the first is taken as a marker byte and the second as text.
+ *
+ * @param clock Clock, zeroed to start unknown
+ * @param c Byte
+ * @return true if the byte belongs to a marker and is not text
+ */
+bool bunnyconnect_stamp_clock_feed(BunnyConnectStampClock* clock, uint8_t c);
+
+/**
+ * @brief Collapse doubled lead bytes into text, in place
+ *
+ * Stream bytes can be fed a chunk at a time, held carries a pair the chunk
+ * end cut in half.
+ *
+ * @param data Stream bytes without markers
+ * @param len Number of bytes
+ * @param held Lead byte waiting for its double, zeroed to start
+ * @return New length
+ */
+size_t bunnyconnect_stamp_unescape(uint8_t* data, size_t len, uint8_t* held);
+
+/**
+ * @brief Turn a snapshot with markers into text, in place
+ *
+ * Doubled lead bytes become one. Hidden stamps are just removed. Shown
+ * stamps become a "sssss.mmm " prefix on every line, "    -.--- " where the
+ * time is unknown, and the oldest lines are dropped to make room. Times
+ * before the first absolute marker are worked out backwards from it.
+ *
+ * @param text Snapshot, NUL terminated
+ * @param len Snapshot length
+ * @param size Buffer size
+ * @param show true to prefix lines with their time
+ * @param cut true if the snapshot can start inside a marker, its leading
+ *            payload bytes are then dropped
+ * @return New length, terminator excluded
+ */
+size_t bunnyconnect_stamp_render(char* text, size_t len, size_t size, bool show, bool cut);
+
+// Markers at the start of one line
+typedef struct {
+    bool stamped;
+    bool has_delta;
+    bool has_abs;
+    uint32_t delta;
+    uint32_t abs;
+} BunnyConnectStampLine;
+
+// Line times while walking a stream front to back
+typedef struct {
+    size_t line; // Index of the next line
+    size_t base_line; // Timed backwards from a later marker, or BUNNYCONNECT_STAMP_NO_LINE
+    uint32_t base_ms;
+    uint32_t ms;
+    bool known;
+} BunnyConnectStampWalk;
+
+// A stream rendered a chunk at a time, see bunnyconnect_stamp_stream_render
+typedef struct {
+    bool show;
+    bool skip; // Payload bytes a cut marker may have left at the start
+    bool text; // Past the markers of the line in progress
+    uint8_t lead; // Marker in progress, or a lead that may yet be text
+    bool payload; // The marker in progress has payload bytes
+    uint32_t value;
+    uint8_t held; // Text lead whose double is still to come
+    BunnyConnectStampLine line; // Markers of the line in progress
+    BunnyConnectStampWalk walk;
+    size_t chain; // Scan only: first line of the delta chain
+    uint32_t chain_sum;
+    bool found; // Scan only: the base line is known
+} BunnyConnectStampStream;
+
+/**
+ * @brief Start rendering a stream in chunks
+ *
+ * Gives the same text as bunnyconnect_stamp_render over the whole stream
+ * without a buffer that holds it. Times before the first absolute marker
+ * need a scan over the stream first, the render then starts over.
+ *
+ * @param stream Stream state
+ * @param show true to prefix lines with their time
+ * @param cut true if the stream can start inside a marker
+ */
+void bunnyconnect_stamp_stream_init(BunnyConnectStampStream* stream, bool show, bool cut);
+
+/**
+ * @brief Look for the first absolute marker ahead of the render
+ *
+ * Only worth doing while showing, it stops taking bytes once the marker is
+ * found.
+ *
+ * @param stream Stream state
+ * @param data Stream bytes
+ * @param len Number of bytes
+ */
+void bunnyconnect_stamp_stream_scan(
+    BunnyConnectStampStream* stream,
+    const uint8_t* data,
+    size_t len);
+
+/**
+ * @brief Go back to the start of the stream for the render
+ *
+ * @param stream Stream state
+ * @param keep_base false if the render does not start where the scan did
+ * @param cut true if the render can start inside a marker
+ */
+void bunnyconnect_stamp_stream_restart(
+    BunnyConnectStampStream* stream,
+    bool keep_base,
+    bool cut);
+
+/**
+ * @brief Render the next chunk of the stream
+ *
+ * Stops early when out is full, the bytes left go in the next call.
+ *
+ * @param stream Stream state
+ * @param data Stream bytes
+ * @param len Number of bytes
+ * @param out Text output, not NUL terminated
+ * @param size Output size, more than BUNNYCONNECT_STAMP_PREFIX + 1
+ * @param used Stream bytes taken
+ * @return Text bytes written
+ */
+size_t bunnyconnect_stamp_stream_render(
+    BunnyConnectStampStream* stream,
+    const uint8_t* data,
+    size_t len,
+    char* out,
+    size_t size,
+    size_t* used);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/view.h>
+#include "bunnyconnect_counters.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BunnyConnectStats BunnyConnectStats;
+typedef void (*BunnyConnectStatsCallback)(void* context);
+
+/** Allocate stats view
+ *
+ * Lists every counter with its value and change per update. Up/Down
+ * scroll, OK calls the dump callback.
+ *
+ * @return     BunnyConnectStats instance
+ */
+BunnyConnectStats* bunnyconnect_stats_alloc(void);
+
+/** Free stats view
+ *
+ * @param      stats  BunnyConnectStats instance
+ */
+void bunnyconnect_stats_free(BunnyConnectStats* stats);
+
+/** Get stats view
+ *
+ * @param      stats  BunnyConnectStats instance
+ *
+ * @return     View instance that can be used for embedding
+ */
+View* bunnyconnect_stats_get_view(BunnyConnectStats* stats);
+
+/** Set callback for OK
+ *
+ * @param      stats     BunnyConnectStats instance
+ * @param      callback  Called from the GUI input handler
+ * @param      context   Callback context
+ */
+void bunnyconnect_stats_set_dump_callback(
+    BunnyConnectStats* stats,
+    BunnyConnectStatsCallback callback,
+    void* context);
+
+/** Show new counter values, deltas are taken against the previous update
+ *
+ * @param      stats   BunnyConnectStats instance
+ * @param      values  Snapshot, BunnyConnectCounterCount entries
+ */
+void bunnyconnect_stats_update(BunnyConnectStats* stats, const uint32_t* values);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include "bunnyconnect_arena.h"
+#include "bunnyconnect_scrollback.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_TABS_LOG_DIR APP_DATA_PATH("logs")
+
+typedef enum {
+    BunnyConnectTabCdc, // USB CDC, the worker's main receive path
+    BunnyConnectTabUart, // USART on the GPIO header
+    BunnyConnectTabLoopback, // Everything sent, as queued
+    BunnyConnectTabCount,
+} BunnyConnectTabId;
+
+typedef struct {
+    uint32_t rx_bytes;
+    uint32_t rx_chunks;
+} BunnyConnectTabStats;
+
+typedef struct BunnyConnectTabs BunnyConnectTabs;
+
+/**
+ * @brief Arena bytes bunnyconnect_tabs_alloc carves
+ *
+ * CDC gets the whole scrollback of the memory budget, UART half of it and
+ * loopback a quarter.
+ *
+ * @param scrollback Scrollback size of the memory budget, power of two
+ * @return Bytes including ring state
+ */
+size_t bunnyconnect_tabs_size(size_t scrollback);
+
+/**
+ * @brief Carve one scrollback ring per tab from the session arena
+ *
+ * Each ring has one producer: the receive worker for CDC and UART, the
+ * GUI thread for loopback. The GUI thread snapshots the active tab only,
+ * inactive tabs keep filling their rings. Lives until the arena is freed.
+ *
+ * @param arena Session arena
+ * @param scrollback Scrollback size of the memory budget, power of two
+ * @return BunnyConnectTabs instance, CDC active
+ */
+BunnyConnectTabs* bunnyconnect_tabs_alloc(BunnyConnectArena* arena, size_t scrollback);
+
+/**
+ * @brief Get tab name, also names its ring in the arena layout
+ *
+ * @param id Tab id
+ * @return Short upper case name
+ */
+const char* bunnyconnect_tabs_name(BunnyConnectTabId id);
+
+/**
+ * @brief Append received bytes to a tab, producer of that tab only
+ *
+ * Never blocks. Counts bytes and chunks per tab. While stamping, every line
+ * that starts here gets a time marker ahead of its first byte. Stamp lead
+ * bytes in the data are doubled whether stamping or not.
+ *
+ * @param tabs BunnyConnectTabs instance
+ * @param id Tab id
+ * @param data Bytes to append, no NULs
+ * @param len Number of bytes
+ * @return true if the tab is active and the terminal needs a refresh
+ */
+bool bunnyconnect_tabs_append(
+    BunnyConnectTabs* tabs,
+    BunnyConnectTabId id,
+    const uint8_t* data,
+    size_t len);
+
+/**
+ * @brief Get a tab's ring, for snapshots on the GUI thread
+ *
+ * @param tabs BunnyConnectTabs instance
+ * @param id Tab id
+ * @return BunnyConnectScrollback instance
+ */
+BunnyConnectScrollback*
+    bunnyconnect_tabs_get_scrollback(BunnyConnectTabs* tabs, BunnyConnectTabId id);
+
+/**
+ * @brief Copy a tab's newest bytes as a string, GUI thread
+ *
+ * As bunnyconnect_scrollback_snapshot, and tells whether the copy can start
+ * inside a stamp marker, for bunnyconnect_stamp_render. Only a ring that
+ * held markers and lost its oldest bytes, or a copy cut to size, can.
+ *
+ * @param tabs BunnyConnectTabs instance
+ * @param id Tab id
+ * @param out Output buffer, NUL terminated
+ * @param size Output buffer size
+ * @param cut Set if the copy can start inside a marker
+ * @return Bytes copied, terminator excluded
+ */
+size_t bunnyconnect_tabs_snapshot(
+    BunnyConnectTabs* tabs,
+    BunnyConnectTabId id,
+    char* out,
+    size_t size,
+    bool* cut);
+
+/**
+ * @brief Turn line stamps on or off for every tab
+ *
+ * Producers pick the change up with their next append, the first stamped
+ * line after it carries an absolute time.
+ *
+ * @param tabs BunnyConnectTabs instance
+ * @param stamping true to stamp new lines
+ */
+void bunnyconnect_tabs_set_stamping(BunnyConnectTabs* tabs, bool stamping);
+
+/**
+ * @brief Get the tab the terminal shows
+ *
+ * @param tabs BunnyConnectTabs instance
+ * @return Active tab id
+ */
+BunnyConnectTabId bunnyconnect_tabs_get_active(BunnyConnectTabs* tabs);
+
+/**
+ * @brief Make the next or previous tab active, wrapping around
+ *
+ * Only the active index changes, no ring is copied.
+ *
+ * @param tabs BunnyConnectTabs instance
+ * @param next true for the next tab, false for the previous one
+ * @return New active tab id
+ */
+BunnyConnectTabId bunnyconnect_tabs_step(BunnyConnectTabs* tabs, bool next);
+
+/**
+ * @brief Get a tab's counters
+ *
+ * @param tabs BunnyConnectTabs instance
+ * @param id Tab id
+ * @param stats Counters output
+ */
+void bunnyconnect_tabs_get_stats(
+    BunnyConnectTabs* tabs,
+    BunnyConnectTabId id,
+    BunnyConnectTabStats* stats);
+
+/**
+ * @brief Write every tab's scrollback to its log, e.g. logs/uart.log
+ *
+ * Runs on the GUI thread, producers keep writing meanwhile. Each ring is
+ * read and written out in small chunks, bytes the producer overwrites
+ * before they are read are skipped. Empty tabs are skipped. Line stamps are
+ * written as "sssss.mmm " prefixes or left out.
+ *
+ * @param tabs BunnyConnectTabs instance
+ * @param storage Storage record
+ * @param stamps true to prefix lines with their time
+ * @param saved Number of logs written, may be NULL
+ * @return true if every non-empty tab was written
+ */
+bool bunnyconnect_tabs_save_logs(
+    BunnyConnectTabs* tabs,
+    Storage* storage,
+    bool stamps,
+    size_t* saved);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_TERMINAL_STATUS_SIZE 40
+
+typedef struct BunnyConnectTerminal BunnyConnectTerminal;
+typedef void (*BunnyConnectTerminalTabCallback)(void* context, bool next);
+typedef void (*BunnyConnectTerminalFilterCallback)(void* context, bool edit);
+typedef void (*BunnyConnectTerminalStampCallback)(void* context);
+
+typedef enum {
+    BunnyConnectTerminalSelectStart, // Long Down picked the last line
+    BunnyConnectTerminalSelectMove, // Up/Down picked another line
+    BunnyConnectTerminalSelectFieldPrev, // Left
+    BunnyConnectTerminalSelectFieldNext, // Right
+    BunnyConnectTerminalSelectSendCdc, // OK, ends the pick
+    BunnyConnectTerminalSelectSendHid, // Long OK, ends the pick
+    BunnyConnectTerminalSelectEnd, // Back
+} BunnyConnectTerminalSelectEvent;
+
+typedef void (*BunnyConnectTerminalSelectCallback)(
+    void* context,
+    BunnyConnectTerminalSelectEvent event,
+    size_t line);
+
+/**
+ * @brief Allocate terminal view: a status bar over word-wrapped text
+ *
+ * Follows the end of the text until the user scrolls up with Up/Down.
+ * Left/Right call the tab callback, a long Left/Right the stamp callback and
+ * OK the filter callback. A long Down starts picking a line, highlighted
+ * until it is sent or Back is pressed, the select callback gets those keys
+ * meanwhile. Shows only the status bar until a text buffer is attached.
+ *
+ * @return     BunnyConnectTerminal instance
+ */
+BunnyConnectTerminal* bunnyconnect_terminal_alloc(void);
+
+/**
+ * @brief Free terminal view
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ */
+void bunnyconnect_terminal_free(BunnyConnectTerminal* terminal);
+
+/**
+ * @brief Get terminal view
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ * @return     View instance that can be used for embedding
+ */
+View* bunnyconnect_terminal_get_view(BunnyConnectTerminal* terminal);
+
+/**
+ * @brief Attach the buffer the shown text is kept in, or detach with NULL
+ *
+ * The buffer is cleared and stays owned by the caller, detach it before
+ * freeing. A line pick in progress ends without a callback.
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ * @param      buffer    Text storage, NULL to detach
+ * @param      size      Buffer size, including the terminator
+ */
+void bunnyconnect_terminal_set_buffer(BunnyConnectTerminal* terminal, char* buffer, size_t size);
+
+/**
+ * @brief Lock the attached buffer to update the shown text in place
+ *
+ * Must be followed by bunnyconnect_terminal_text_commit unless it returns
+ * NULL. The text has to stay NUL terminated.
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ * @param      size      Buffer size output
+ * @return     Buffer, NULL while detached
+ */
+char* bunnyconnect_terminal_text_acquire(BunnyConnectTerminal* terminal, size_t* size);
+
+/**
+ * @brief Unlock the buffer and redraw
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ */
+void bunnyconnect_terminal_text_commit(BunnyConnectTerminal* terminal);
+
+/**
+ * @brief Set callback for Left/Right
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ * @param      callback  Called from the GUI input handler, next is true for Right
+ * @param      context   Callback context
+ */
+void bunnyconnect_terminal_set_tab_callback(
+    BunnyConnectTerminal* terminal,
+    BunnyConnectTerminalTabCallback callback,
+    void* context);
+
+/**
+ * @brief Set callback for OK
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ * @param      callback  Called from the GUI input handler, edit is true for a long press
+ * @param      context   Callback context
+ */
+void bunnyconnect_terminal_set_filter_callback(
+    BunnyConnectTerminal* terminal,
+    BunnyConnectTerminalFilterCallback callback,
+    void* context);
+
+/**
+ * @brief Set callback for a long Left/Right
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ * @param      callback  Called from the GUI input handler
+ * @param      context   Callback context
+ */
+void bunnyconnect_terminal_set_stamp_callback(
+    BunnyConnectTerminal* terminal,
+    BunnyConnectTerminalStampCallback callback,
+    void* context);
+
+/**
+ * @brief Set callback for picking a line
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ * @param      callback  Called from the GUI input handler, line counts up from the
+ *                       last line of the text
+ * @param      context   Callback context
+ */
+void bunnyconnect_terminal_set_select_callback(
+    BunnyConnectTerminal* terminal,
+    BunnyConnectTerminalSelectCallback callback,
+    void* context);
+
+/**
+ * @brief Set status bar text
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ * @param      status    Status line, truncated to fit
+ */
+void bunnyconnect_terminal_set_status(BunnyConnectTerminal* terminal, const char* status);
+
+/**
+ * @brief Run the draw callback on a canvas outside the view port
+ *
+ * For timing the draw path, e.g. on a direct draw canvas.
+ *
+ * @param      terminal  BunnyConnectTerminal instance
+ * @param      canvas    Canvas to draw on
+ */
+void bunnyconnect_terminal_render(BunnyConnectTerminal* terminal, Canvas* canvas);
+
+#ifdef __cplusplus
+}
+#endif
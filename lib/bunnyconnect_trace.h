@@ -0,0 +1,105 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Build-time switch, 0 compiles every trace point out
+#ifndef BUNNYCONNECT_TRACE
+#define BUNNYCONNECT_TRACE 1
+#endif
+
+#define BUNNYCONNECT_TRACE_PATH    APP_DATA_PATH("trace.bin")
+#define BUNNYCONNECT_TRACE_RECORDS 1024 // Power of two, 8 bytes each
+
+// Ids are part of the file format, append only
+typedef enum {
+    BunnyConnectTraceRxChunk, // Worker got a CDC chunk, arg bytes
+    BunnyConnectTraceAppend, // Chunk in the scrollback ring, arg bytes
+    BunnyConnectTraceRefreshPost, // Worker posted RefreshScreen
+    BunnyConnectTraceEventBegin, // Custom event callback, arg event
+    BunnyConnectTraceEventEnd, // arg event
+    BunnyConnectTraceSnapshot, // Terminal copied the ring, arg bytes
+    BunnyConnectTraceDrawBegin, // Draw callback, arg BunnyConnectTraceView
+    BunnyConnectTraceDrawEnd, // arg BunnyConnectTraceView
+    BunnyConnectTraceHidPress, // HID report sent, arg key
+    BunnyConnectTraceHidRelease, // arg key
+    BunnyConnectTraceCdcTx, // Packet handed to USB, arg bytes
+    BunnyConnectTraceEventCount,
+} BunnyConnectTraceEvent;
+
+typedef enum {
+    BunnyConnectTraceViewTerminal,
+    BunnyConnectTraceViewStats,
+    BunnyConnectTraceViewProgress,
+    BunnyConnectTraceViewKeyboard,
+    BunnyConnectTraceViewDashboard,
+    BunnyConnectTraceViewHistogram,
+} BunnyConnectTraceView;
+
+typedef struct {
+    uint32_t cycles; // DWT cycle counter
+    uint16_t event; // BunnyConnectTraceEvent
+    uint16_t arg;
+} BunnyConnectTraceRecord;
+
+/**
+ * @brief Start or stop recording
+ *
+ * The ring is allocated on first enable and kept until
+ * bunnyconnect_trace_free, so trace points never see it disappear.
+ *
+ * @param enabled true to record
+ */
+void bunnyconnect_trace_set_enabled(bool enabled);
+
+/**
+ * @brief Check if recording
+ *
+ * @return true while enabled
+ */
+bool bunnyconnect_trace_is_enabled(void);
+
+/**
+ * @brief Append a record, oldest records are overwritten
+ *
+ * Safe from any thread or interrupt. A flag test when disabled, otherwise
+ * one atomic increment and three stores. Use BUNNYCONNECT_TRACE_EVENT so
+ * trace points vanish from builds without tracing.
+ *
+ * @param event Event id
+ * @param arg Event argument, truncated to 16 bits
+ */
+void bunnyconnect_trace_record(BunnyConnectTraceEvent event, uint32_t arg);
+
+/**
+ * @brief Write the ring to SD, oldest record first
+ *
+ * Recording pauses while the file is written.
+ *
+ * @param storage Storage record
+ * @param path Output path
+ * @param records Number of records written, may be NULL
+ * @return true on success
+ */
+bool bunnyconnect_trace_save(Storage* storage, const char* path, size_t* records);
+
+/**
+ * @brief Stop recording and free the ring, call once no trace point can run
+ */
+void bunnyconnect_trace_free(void);
+
+#if BUNNYCONNECT_TRACE
+#define BUNNYCONNECT_TRACE_EVENT(event, arg) bunnyconnect_trace_record(event, arg)
+#else
+#define BUNNYCONNECT_TRACE_EVENT(event, arg) \
+    do {                                     \
+    } while(0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
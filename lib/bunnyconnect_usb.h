@@ -0,0 +1,94 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal_usb.h>
+#include <furi_hal_usb_cdc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_USB_VID 0x0483
+#define BUNNYCONNECT_USB_PID 0x5742
+
+/**
+ * @brief Composite USB interface: CDC ACM serial plus HID boot keyboard
+ *
+ * Both functions enumerate together, so terminal I/O and keystroke injection
+ * work at the same time without switching USB modes. Pass to
+ * furi_hal_usb_set_config.
+ */
+extern FuriHalUsbInterface bunnyconnect_usb_composite;
+
+/**
+ * @brief Set CDC callbacks, same contract as furi_hal_cdc_set_callbacks
+ *
+ * The state and control line callbacks are called right away if the host
+ * has already configured the interface.
+ *
+ * @param if_num CDC interface number, only 0 exists
+ * @param callbacks Callbacks, NULL to clear
+ * @param context Callback context
+ */
+void bunnyconnect_usb_cdc_set_callbacks(uint8_t if_num, CdcCallbacks* callbacks, void* context);
+
+/**
+ * @brief Get CDC control line state set by the host
+ *
+ * @param if_num CDC interface number
+ * @return uint8_t CdcCtrlLine bits
+ */
+uint8_t bunnyconnect_usb_cdc_get_ctrl_line_state(uint8_t if_num);
+
+/**
+ * @brief Send one CDC packet, wait for tx_ep_callback before the next one
+ *
+ * @param if_num CDC interface number
+ * @param buffer Data to send
+ * @param size Data size, at most CDC_DATA_SZ, 0 sends a ZLP
+ */
+void bunnyconnect_usb_cdc_send(uint8_t if_num, uint8_t* buffer, uint16_t size);
+
+/**
+ * @brief Take received CDC data without blocking
+ *
+ * @param if_num CDC interface number
+ * @param buffer Output buffer
+ * @param size Output buffer size
+ * @return int32_t bytes received
+ */
+int32_t bunnyconnect_usb_cdc_receive(uint8_t if_num, uint8_t* buffer, uint16_t size);
+
+/**
+ * @brief Check if the HID keyboard is configured and not suspended
+ *
+ * @return true if reports can be sent
+ */
+bool bunnyconnect_usb_hid_is_connected(void);
+
+/**
+ * @brief Press a key, same key codes as furi_hal_hid_kb_press
+ *
+ * @param key HID key code with modifier bits
+ * @return true if the report was sent
+ */
+bool bunnyconnect_usb_hid_kb_press(uint16_t key);
+
+/**
+ * @brief Release a key
+ *
+ * @param key HID key code with modifier bits
+ * @return true if the report was sent
+ */
+bool bunnyconnect_usb_hid_kb_release(uint16_t key);
+
+/**
+ * @brief Release all keys
+ *
+ * @return true if the report was sent
+ */
+bool bunnyconnect_usb_hid_kb_release_all(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include "bunnyconnect_output.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BUNNYCONNECT_YMODEM_RECEIVE_PATH APP_DATA_PATH("received")
+#define BUNNYCONNECT_YMODEM_NAME_SIZE    64
+
+typedef enum {
+    BunnyConnectYmodemStateRunning,
+    BunnyConnectYmodemStateDone,
+    BunnyConnectYmodemStateCancelled, // Cancelled locally or by the peer
+    BunnyConnectYmodemStateError,
+} BunnyConnectYmodemState;
+
+typedef struct {
+    BunnyConnectYmodemState state;
+    bool streaming; // YMODEM-g negotiated, no per-block ACK
+    uint32_t files; // Files completed
+    uint32_t done; // Bytes of the current file
+    uint32_t total; // Size of the current file, 0 if unknown
+    uint32_t rate; // Average bytes per second since start
+    uint32_t blocks;
+    uint32_t retries; // Blocks sent or requested again
+    char name[BUNNYCONNECT_YMODEM_NAME_SIZE];
+    const char* error; // Reason for BunnyConnectYmodemStateError
+} BunnyConnectYmodemStatus;
+
+typedef void (*BunnyConnectYmodemCallback)(void* context);
+
+typedef struct BunnyConnectYmodem BunnyConnectYmodem;
+
+/**
+ * @brief Start sending a file with YMODEM-1K
+ *
+ * The peer picks the variant: 'C' runs CRC mode with an ACK per block, 'G'
+ * runs YMODEM-g streaming. Data goes out raw through the CDC output queue.
+ *
+ * @param output Output router used for the CDC link
+ * @param path File path on SD
+ * @param callback Called from the transfer thread when the session ends
+ * @param context Callback context
+ * @return BunnyConnectYmodem instance, NULL if the file cannot be opened
+ */
+BunnyConnectYmodem* bunnyconnect_ymodem_send_start(
+    BunnyConnectOutput* output,
+    const char* path,
+    BunnyConnectYmodemCallback callback,
+    void* context);
+
+/**
+ * @brief Start receiving a YMODEM batch into BUNNYCONNECT_YMODEM_RECEIVE_PATH
+ *
+ * @param output Output router used for the CDC link
+ * @param streaming Request YMODEM-g instead of YMODEM-1K with ACKs
+ * @param callback Called from the transfer thread when the session ends
+ * @param context Callback context
+ * @return BunnyConnectYmodem instance
+ */
+BunnyConnectYmodem* bunnyconnect_ymodem_receive_start(
+    BunnyConnectOutput* output,
+    bool streaming,
+    BunnyConnectYmodemCallback callback,
+    void* context);
+
+/**
+ * @brief Pass received link data to the transfer
+ *
+ * Call from the RX thread for everything received while the session runs.
+ *
+ * @param ymodem BunnyConnectYmodem instance
+ * @param data Received data
+ * @param size Data size in bytes
+ */
+void bunnyconnect_ymodem_feed(BunnyConnectYmodem* ymodem, const uint8_t* data, size_t size);
+
+/**
+ * @brief Cancel the session if running and wait for its thread
+ *
+ * The peer is sent a CAN sequence. Status stays readable until freed.
+ *
+ * @param ymodem BunnyConnectYmodem instance
+ */
+void bunnyconnect_ymodem_stop(BunnyConnectYmodem* ymodem);
+
+/**
+ * @brief Stop the session and free the instance
+ *
+ * @param ymodem BunnyConnectYmodem instance
+ */
+void bunnyconnect_ymodem_free(BunnyConnectYmodem* ymodem);
+
+/**
+ * @brief Get session status
+ *
+ * @param ymodem BunnyConnectYmodem instance
+ * @param status Status output
+ */
+void bunnyconnect_ymodem_get_status(BunnyConnectYmodem* ymodem, BunnyConnectYmodemStatus* status);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,87 @@
+#include "../lib/bunnyconnect_arena.h"
+#include <furi.h>
+
+#define TAG "BunnyArena"
+
+#define ARENA_ALIGN sizeof(uint32_t)
+
+struct BunnyConnectArena {
+    size_t capacity;
+    size_t used;
+    size_t region_count;
+    BunnyConnectArenaRegion regions[BUNNYCONNECT_ARENA_REGIONS_MAX];
+    uint8_t data[];
+};
+
+BunnyConnectArena* bunnyconnect_arena_alloc(size_t capacity) {
+    // Checked up front, a failed malloc on the Flipper does not return
+    if(sizeof(BunnyConnectArena) + capacity > memmgr_heap_get_max_free_block()) {
+        FURI_LOG_E(TAG, "No heap block for %u B", capacity);
+        return NULL;
+    }
+
+    BunnyConnectArena* arena = malloc(sizeof(BunnyConnectArena) + capacity);
+    memset(arena, 0, sizeof(BunnyConnectArena));
+    arena->capacity = capacity;
+    return arena;
+}
+
+void bunnyconnect_arena_free(BunnyConnectArena* arena) {
+    furi_assert(arena);
+    free(arena);
+}
+
+void* bunnyconnect_arena_carve(BunnyConnectArena* arena, const char* name, size_t size) {
+    furi_assert(arena);
+    furi_assert(name);
+
+    size_t offset = (arena->used + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    furi_check(arena->region_count < BUNNYCONNECT_ARENA_REGIONS_MAX);
+    furi_check(offset + size <= arena->capacity);
+
+    BunnyConnectArenaRegion* region = &arena->regions[arena->region_count++];
+    region->name = name;
+    region->offset = offset;
+    region->size = size;
+    region->high_water = 0;
+    arena->used = offset + size;
+
+    memset(arena->data + offset, 0, size);
+    return arena->data + offset;
+}
+
+void bunnyconnect_arena_mark(BunnyConnectArena* arena, const void* region, size_t used) {
+    furi_assert(arena);
+
+    size_t offset = (const uint8_t*)region - arena->data;
+    for(size_t i = 0; i < arena->region_count; i++) {
+        if(arena->regions[i].offset != offset) continue;
+        if(used > arena->regions[i].high_water) arena->regions[i].high_water = used;
+        return;
+    }
+}
+
+size_t bunnyconnect_arena_get_capacity(BunnyConnectArena* arena) {
+    furi_assert(arena);
+    return arena->capacity;
+}
+
+size_t bunnyconnect_arena_get_used(BunnyConnectArena* arena) {
+    furi_assert(arena);
+    return arena->used;
+}
+
+size_t bunnyconnect_arena_get_region_count(BunnyConnectArena* arena) {
+    furi_assert(arena);
+    return arena->region_count;
+}
+
+void bunnyconnect_arena_get_region(
+    BunnyConnectArena* arena,
+    size_t index,
+    BunnyConnectArenaRegion* region) {
+    furi_assert(arena);
+    furi_assert(region);
+    furi_check(index < arena->region_count);
+    *region = arena->regions[index];
+}
@@ -0,0 +1,362 @@
+#include "../lib/bunnyconnect_bench.h"
+#include "../lib/bunnyconnect_arena.h"
+#include "../lib/bunnyconnect_scrollback.h"
+#include "../lib/bunnyconnect_terminal.h"
+#include "../lib/bunnyconnect_keyboard.h"
+#include "../lib/bunnyconnect_helpers.h"
+#include "../lib/bunnyconnect_draw.h"
+#include <furi.h>
+#include <furi_hal_cortex.h>
+#include <storage/storage.h>
+
+#define TAG "BunnyBench"
+
+#define BENCH_FORMAT_VERSION 1
+#define BENCH_ROUNDS         3
+#define BENCH_RING_SIZE      4096
+#define BENCH_ARENA_SLACK    96 // Ring state and alignment
+#define BENCH_CHUNK_SIZE     64
+#define BENCH_LINE_SIZE      128
+#define BENCH_EDIT_RUN       64 // Inserts, then as many backspaces
+#define FRAME_WIDTH          128
+#define FRAME_HEIGHT         64
+#define FRAME_SIZE           (FRAME_WIDTH * FRAME_HEIGHT / 8)
+#define FRAME_PATH_SIZE      64
+
+typedef struct {
+    BunnyConnectScrollback* scrollback;
+    BunnyConnectTerminal* terminal;
+    Canvas* canvas;
+    char* text; // BENCH_RING_SIZE + 1, snapshot target
+    char* screen; // BENCH_RING_SIZE + 1, terminal buffer
+    uint8_t chunk[BENCH_CHUNK_SIZE];
+    char line[BENCH_LINE_SIZE];
+    size_t cursor;
+    volatile uint32_t sink; // Keeps pure cases from being optimized out
+} BenchContext;
+
+typedef void (*BenchOp)(BenchContext* ctx, uint32_t iteration);
+
+typedef struct {
+    const char* name;
+    uint32_t iterations;
+    BenchOp op;
+} BenchCase;
+
+// Printable lines of mixed length, like a shell session, not terminated
+static void bench_fill_text(char* out, size_t len) {
+    for(size_t i = 0; i < len; i++) {
+        out[i] = (i % 29 == 28) ? '\n' : (char)(' ' + (i * 7) % 95);
+    }
+}
+
+static void bench_append(BenchContext* ctx, uint32_t iteration) {
+    UNUSED(iteration);
+    bunnyconnect_scrollback_write(ctx->scrollback, ctx->chunk, sizeof(ctx->chunk));
+}
+
+static void bench_snapshot(BenchContext* ctx, uint32_t iteration) {
+    UNUSED(iteration);
+    ctx->sink += bunnyconnect_scrollback_snapshot(ctx->scrollback, ctx->text, BENCH_RING_SIZE + 1);
+}
+
+static void bench_hid_encode(BenchContext* ctx, uint32_t iteration) {
+    ctx->sink += bunnyconnect_char_to_hid_key(ctx->chunk[iteration % BENCH_CHUNK_SIZE]);
+}
+
+static void bench_keyboard_edit(BenchContext* ctx, uint32_t iteration) {
+    if((iteration / BENCH_EDIT_RUN) % 2 == 0) {
+        bunnyconnect_keyboard_text_insert(ctx->line, sizeof(ctx->line), &ctx->cursor, 'a');
+    } else {
+        bunnyconnect_keyboard_text_backspace(ctx->line, &ctx->cursor);
+    }
+}
+
+static void bench_draw_terminal(BenchContext* ctx, uint32_t iteration) {
+    UNUSED(iteration);
+    bunnyconnect_terminal_render(ctx->terminal, ctx->canvas);
+}
+
+static const BenchCase bench_cases[BunnyConnectBenchCount] = {
+    [BunnyConnectBenchAppend] = {"append_64", 1024, bench_append},
+    [BunnyConnectBenchSnapshot] = {"snapshot_4k", 64, bench_snapshot},
+    [BunnyConnectBenchHidEncode] = {"hid_char", 4096, bench_hid_encode},
+    [BunnyConnectBenchKeyboardEdit] = {"kbd_edit", 4 * BENCH_EDIT_RUN, bench_keyboard_edit},
+    [BunnyConnectBenchDrawTerminal] = {"draw_term", 16, bench_draw_terminal},
+};
+
+// Fastest round in ns per call, the indirect call is part of the figure
+static uint32_t bench_time(BenchContext* ctx, const BenchCase* bench) {
+    uint32_t best = UINT32_MAX;
+    for(size_t round = 0; round < BENCH_ROUNDS; round++) {
+        uint32_t start = furi_hal_cortex_timer_get(0).start; // DWT cycle counter
+        for(uint32_t i = 0; i < bench->iterations; i++) {
+            bench->op(ctx, i);
+        }
+        best = MIN(best, furi_hal_cortex_timer_get(0).start - start);
+    }
+
+    uint64_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+    return (uint64_t)best * 1000 / (cycles_per_us * bench->iterations);
+}
+
+bool bunnyconnect_bench_run(Gui* gui, uint32_t* ns_per_op) {
+    furi_assert(ns_per_op);
+    memset(ns_per_op, 0, sizeof(uint32_t) * BunnyConnectBenchCount);
+
+    BunnyConnectArena* arena = bunnyconnect_arena_alloc(
+        BENCH_RING_SIZE + BENCH_ARENA_SLACK + 2 * (BENCH_RING_SIZE + 1));
+    if(!arena) {
+        FURI_LOG_W(TAG, "No room for the scratch arena");
+        return false;
+    }
+
+    BenchContext* ctx = malloc(sizeof(BenchContext));
+    memset(ctx, 0, sizeof(BenchContext));
+    ctx->scrollback = bunnyconnect_scrollback_alloc(arena, "bench ring", BENCH_RING_SIZE);
+    ctx->text = bunnyconnect_arena_carve(arena, "bench text", BENCH_RING_SIZE + 1);
+    ctx->screen = bunnyconnect_arena_carve(arena, "bench screen", BENCH_RING_SIZE + 1);
+
+    bench_fill_text((char*)ctx->chunk, BENCH_CHUNK_SIZE);
+    memset(ctx->line, 'x', BENCH_LINE_SIZE / 2 - 1);
+    ctx->cursor = BENCH_LINE_SIZE / 4;
+
+    for(size_t i = 0; i < BunnyConnectBenchCount; i++) {
+        if(i == BunnyConnectBenchDrawTerminal) continue;
+        ns_per_op[i] = bench_time(ctx, &bench_cases[i]);
+    }
+
+    // Draw a full ring of text, the worst case for line wrapping
+    if(gui) {
+        ctx->terminal = bunnyconnect_terminal_alloc();
+        bunnyconnect_terminal_set_buffer(ctx->terminal, ctx->screen, BENCH_RING_SIZE + 1);
+        bunnyconnect_terminal_set_status(ctx->terminal, "Benchmark");
+        size_t size;
+        char* screen = bunnyconnect_terminal_text_acquire(ctx->terminal, &size);
+        bunnyconnect_scrollback_snapshot(ctx->scrollback, screen, size);
+        bunnyconnect_terminal_text_commit(ctx->terminal);
+
+        ctx->canvas = gui_direct_draw_acquire(gui);
+        ns_per_op[BunnyConnectBenchDrawTerminal] =
+            bench_time(ctx, &bench_cases[BunnyConnectBenchDrawTerminal]);
+        gui_direct_draw_release(gui);
+
+        bunnyconnect_terminal_set_buffer(ctx->terminal, NULL, 0);
+        bunnyconnect_terminal_free(ctx->terminal);
+    }
+
+    free(ctx);
+    bunnyconnect_arena_free(arena);
+    return true;
+}
+
+const char* bunnyconnect_bench_name(BunnyConnectBenchCase bench) {
+    return bench < BunnyConnectBenchCount ? bench_cases[bench].name : "?";
+}
+
+size_t bunnyconnect_bench_format(
+    const uint32_t* ns_per_op,
+    uint32_t uptime_ms,
+    char* out,
+    size_t size) {
+    furi_assert(ns_per_op);
+    furi_assert(out);
+    furi_assert(size > 0);
+
+    int len = snprintf(out, size, "BCBENCH v=%d up_ms=%lu", BENCH_FORMAT_VERSION, uptime_ms);
+    for(size_t i = 0; i < BunnyConnectBenchCount && len >= 0 && (size_t)len < size; i++) {
+        len += snprintf(out + len, size - len, " %s=%lu", bench_cases[i].name, ns_per_op[i]);
+    }
+    if(len >= 0 && (size_t)len < size) {
+        len += snprintf(out + len, size - len, "\r\n");
+    }
+    return len < 0 ? 0 : MIN((size_t)len, size - 1);
+}
+
+typedef struct {
+    BunnyConnectTerminal* terminal;
+    BunnyConnectKeyboard* keyboard;
+} FrameContext;
+
+typedef void (*FrameDraw)(FrameContext* ctx, Canvas* canvas);
+
+static void frame_draw_terminal(FrameContext* ctx, Canvas* canvas) {
+    bunnyconnect_terminal_render(ctx->terminal, canvas);
+}
+
+static void frame_draw_keyboard(FrameContext* ctx, Canvas* canvas) {
+    bunnyconnect_keyboard_render(ctx->keyboard, canvas);
+}
+
+static void frame_draw_widgets(FrameContext* ctx, Canvas* canvas) {
+    UNUSED(ctx);
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontSecondary);
+    bunnyconnect_draw_logo(canvas, 2, 2);
+    bunnyconnect_draw_connection_status(canvas, true, 20, 4);
+    bunnyconnect_draw_connection_status(canvas, false, 30, 4);
+    bunnyconnect_draw_signal_strength(canvas, 75, 44, 2);
+    bunnyconnect_draw_battery_status(canvas, 60, true, 100, 2);
+    bunnyconnect_draw_loading_animation(canvas, 3, 60, 30);
+    bunnyconnect_draw_menu_item(canvas, "Connect", true, 2, 28);
+    bunnyconnect_draw_menu_item(canvas, "Config", false, 2, 40);
+}
+
+static const char* const frame_names[BunnyConnectBenchFrameCount] = {
+    [BunnyConnectBenchFrameTerminalEmpty] = "terminal_empty",
+    [BunnyConnectBenchFrameTerminalFull] = "terminal_full",
+    [BunnyConnectBenchFrameKeyboard] = "keyboard",
+    [BunnyConnectBenchFrameKeyboardLong] = "keyboard_long",
+    [BunnyConnectBenchFrameWidgets] = "widgets",
+};
+
+// Put the views in the state each frame shows
+static FrameDraw frame_prepare(
+    FrameContext* ctx,
+    BunnyConnectBenchFrame frame,
+    char* screen,
+    char* line) {
+    switch(frame) {
+    case BunnyConnectBenchFrameTerminalEmpty:
+        bunnyconnect_terminal_set_buffer(ctx->terminal, screen, BENCH_RING_SIZE + 1);
+        return frame_draw_terminal;
+    case BunnyConnectBenchFrameTerminalFull: {
+        size_t size;
+        char* text = bunnyconnect_terminal_text_acquire(ctx->terminal, &size);
+        bench_fill_text(text, size - 1);
+        text[size - 1] = '\0';
+        bunnyconnect_terminal_text_commit(ctx->terminal);
+        return frame_draw_terminal;
+    }
+    case BunnyConnectBenchFrameKeyboard:
+        strlcpy(line, "echo hello", BENCH_LINE_SIZE);
+        bunnyconnect_keyboard_set_result_callback(
+            ctx->keyboard, NULL, NULL, line, BENCH_LINE_SIZE, false);
+        return frame_draw_keyboard;
+    case BunnyConnectBenchFrameKeyboardLong:
+        bench_fill_text(line, BENCH_LINE_SIZE / 2);
+        for(size_t i = 0; i < BENCH_LINE_SIZE / 2; i++) {
+            if(line[i] == '\n') line[i] = ' ';
+        }
+        line[BENCH_LINE_SIZE / 2] = '\0';
+        bunnyconnect_keyboard_set_result_callback(
+            ctx->keyboard, NULL, NULL, line, BENCH_LINE_SIZE, false);
+        return frame_draw_keyboard;
+    default:
+        return frame_draw_widgets;
+    }
+}
+
+// Canvas pages are 8 rows of vertical bytes, PBM rows are packed MSB first
+static bool frame_save_pbm(Storage* storage, const char* path, const uint8_t* frame) {
+    static const char header[] = "P4\n128 64\n";
+    uint8_t row[FRAME_WIDTH / 8];
+
+    File* file = storage_file_alloc(storage);
+    bool success = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                   storage_file_write(file, header, sizeof(header) - 1) == sizeof(header) - 1;
+    for(size_t y = 0; y < FRAME_HEIGHT && success; y++) {
+        memset(row, 0, sizeof(row));
+        for(size_t x = 0; x < FRAME_WIDTH; x++) {
+            if(frame[(y / 8) * FRAME_WIDTH + x] & (1 << (y % 8))) {
+                row[x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+        success = storage_file_write(file, row, sizeof(row)) == sizeof(row);
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    return success;
+}
+
+static void frame_measure(const uint8_t* frame, BunnyConnectBenchFrameResult* result) {
+    uint32_t hash = 2166136261UL;
+    uint32_t ink = 0;
+    for(size_t i = 0; i < FRAME_SIZE; i++) {
+        hash = (hash ^ frame[i]) * 16777619UL;
+        ink += __builtin_popcount(frame[i]);
+    }
+    result->hash = hash;
+    result->ink = ink;
+}
+
+bool bunnyconnect_bench_frames(
+    Gui* gui,
+    Storage* storage,
+    const char* dir,
+    BunnyConnectBenchFrameResult* results) {
+    furi_assert(gui);
+    furi_assert(storage);
+    furi_assert(dir);
+    furi_assert(results);
+    memset(results, 0, sizeof(BunnyConnectBenchFrameResult) * BunnyConnectBenchFrameCount);
+
+    char* screen = malloc(BENCH_RING_SIZE + 1);
+    char* line = malloc(BENCH_LINE_SIZE);
+    uint8_t* frame = malloc(FRAME_SIZE);
+    FrameContext ctx = {
+        .terminal = bunnyconnect_terminal_alloc(),
+        .keyboard = bunnyconnect_keyboard_alloc(),
+    };
+    bunnyconnect_terminal_set_status(ctx.terminal, "Connected 115200");
+    bunnyconnect_keyboard_set_header_text(ctx.keyboard, "Send text");
+
+    uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+    char path[FRAME_PATH_SIZE];
+    bool success = storage_simply_mkdir(storage, dir);
+
+    for(size_t i = 0; i < BunnyConnectBenchFrameCount && success; i++) {
+        FrameDraw draw = frame_prepare(&ctx, i, screen, line);
+
+        // Hold the screen only while drawing, SD writes happen after release
+        Canvas* canvas = gui_direct_draw_acquire(gui);
+        uint32_t best = UINT32_MAX;
+        for(size_t round = 0; round < BENCH_ROUNDS; round++) {
+            uint32_t start = furi_hal_cortex_timer_get(0).start;
+            draw(&ctx, canvas);
+            best = MIN(best, furi_hal_cortex_timer_get(0).start - start);
+        }
+        furi_check(canvas_get_buffer_size(canvas) == FRAME_SIZE);
+        memcpy(frame, canvas_get_buffer(canvas), FRAME_SIZE);
+        gui_direct_draw_release(gui);
+
+        results[i].draw_us = best / cycles_per_us;
+        frame_measure(frame, &results[i]);
+        snprintf(path, sizeof(path), "%s/%s.pbm", dir, frame_names[i]);
+        success = frame_save_pbm(storage, path, frame);
+        if(!success) FURI_LOG_E(TAG, "Failed to write %s", path);
+    }
+
+    bunnyconnect_terminal_set_buffer(ctx.terminal, NULL, 0);
+    bunnyconnect_terminal_free(ctx.terminal);
+    bunnyconnect_keyboard_free(ctx.keyboard);
+    free(frame);
+    free(line);
+    free(screen);
+    return success;
+}
+
+const char* bunnyconnect_bench_frame_name(BunnyConnectBenchFrame frame) {
+    return frame < BunnyConnectBenchFrameCount ? frame_names[frame] : "?";
+}
+
+size_t bunnyconnect_bench_frame_format(
+    BunnyConnectBenchFrame frame,
+    const BunnyConnectBenchFrameResult* result,
+    char* out,
+    size_t size) {
+    furi_assert(result);
+    furi_assert(out);
+    furi_assert(size > 0);
+
+    int len = snprintf(
+        out,
+        size,
+        "BCFRAME v=%d name=%s us=%lu ink=%lu hash=%08lx\r\n",
+        BENCH_FORMAT_VERSION,
+        bunnyconnect_bench_frame_name(frame),
+        result->draw_us,
+        result->ink,
+        result->hash);
+    return len < 0 ? 0 : MIN((size_t)len, size - 1);
+}
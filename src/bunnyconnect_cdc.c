@@ -0,0 +1,334 @@
+#include "../lib/bunnyconnect_cdc.h"
+#include "../lib/bunnyconnect_usb.h"
+#include <furi.h>
+#include <furi_hal_usb_cdc.h>
+#include <furi_hal_cortex.h>
+
+#define TAG "BunnyCdc"
+
+#define CDC_TX_RING_MASK     (BUNNYCONNECT_CDC_TX_RING_SIZE - 1)
+#define CDC_EVENT_TX_SPACE   (1UL << 0)
+#define CDC_EVENT_CONFIGURED (1UL << 1) // Set while the host has the interface configured
+#define CDC_EVENT_DTR        (1UL << 2) // Set while the host holds DTR, i.e. has the port open
+
+_Static_assert(
+    (BUNNYCONNECT_CDC_TX_RING_SIZE & CDC_TX_RING_MASK) == 0,
+    "CDC TX ring size must be a power of two");
+
+struct BunnyConnectCdc {
+    uint8_t port;
+    CdcCallbacks callbacks;
+    FuriEventFlag* events;
+
+    uint8_t ring[BUNNYCONNECT_CDC_TX_RING_SIZE];
+    volatile uint32_t head; // Advanced by the writer
+    volatile uint32_t tail; // Advanced by the TX path
+
+    uint8_t packet[CDC_DATA_SZ];
+    uint16_t packet_size;
+    volatile bool tx_busy;
+
+    volatile bool connected;
+    volatile uint8_t ctrl_line;
+
+    BunnyConnectFlowControl flow_control;
+    volatile bool paused;
+    volatile uint32_t pause_start; // Cycle counter at pause request, 0 once measured
+    volatile uint32_t resume_start; // Cycle counter at resume request, 0 once measured
+
+    BunnyConnectCdcStats stats;
+};
+
+static const char* const cdc_flow_control_names[BunnyConnectFlowControlCount] = {
+    [BunnyConnectFlowControlNone] = "Off",
+    [BunnyConnectFlowControlXonXoff] = "XON/XOFF",
+    [BunnyConnectFlowControlDtrRts] = "DTR/RTS (CDC)",
+};
+
+static inline uint32_t cdc_cycles(void) {
+    return furi_hal_cortex_timer_get(0).start;
+}
+
+static uint32_t cdc_elapsed_us(uint32_t start) {
+    return (cdc_cycles() - start) / furi_hal_cortex_instructions_per_microsecond();
+}
+
+// Called with tx_busy held, either by the writer to start a burst or from the
+// TX-complete callback to continue it
+static void cdc_tx_next(BunnyConnectCdc* cdc) {
+    uint32_t pending = cdc->head - cdc->tail;
+
+    if(pending == 0) {
+        if(cdc->packet_size == CDC_DATA_SZ) {
+            // Transfer ended on a packet boundary, terminate it for the host
+            cdc->packet_size = 0;
+            cdc->stats.zlp_sent++;
+            bunnyconnect_usb_cdc_send(cdc->port, cdc->packet, 0);
+        } else {
+            cdc->resume_start = 0;
+            cdc->tx_busy = false;
+        }
+        return;
+    }
+
+    if(cdc->paused) {
+        // Packet in flight has drained, stay idle until resumed
+        if(cdc->pause_start) {
+            uint32_t latency = cdc_elapsed_us(cdc->pause_start);
+            if(latency > cdc->stats.stop_latency_us) cdc->stats.stop_latency_us = latency;
+            cdc->pause_start = 0;
+        }
+        cdc->tx_busy = false;
+        return;
+    }
+
+    if(cdc->resume_start) {
+        uint32_t latency = cdc_elapsed_us(cdc->resume_start);
+        if(latency > cdc->stats.resume_latency_us) cdc->stats.resume_latency_us = latency;
+        cdc->resume_start = 0;
+    }
+
+    uint16_t size = pending < CDC_DATA_SZ ? pending : CDC_DATA_SZ;
+    uint32_t offset = cdc->tail & CDC_TX_RING_MASK;
+    uint32_t first = BUNNYCONNECT_CDC_TX_RING_SIZE - offset;
+    if(first >= size) {
+        memcpy(cdc->packet, &cdc->ring[offset], size);
+    } else {
+        memcpy(cdc->packet, &cdc->ring[offset], first);
+        memcpy(cdc->packet + first, cdc->ring, size - first);
+    }
+    cdc->tail += size;
+
+    cdc->packet_size = size;
+    cdc->stats.bytes_sent += size;
+    cdc->stats.packets_sent++;
+    if(size == CDC_DATA_SZ) cdc->stats.full_packets++;
+
+    bunnyconnect_usb_cdc_send(cdc->port, cdc->packet, size);
+    furi_event_flag_set(cdc->events, CDC_EVENT_TX_SPACE);
+}
+
+static void cdc_tx_kick(BunnyConnectCdc* cdc) {
+    bool start = false;
+
+    FURI_CRITICAL_ENTER();
+    if(!cdc->tx_busy) {
+        cdc->tx_busy = true;
+        start = true;
+    }
+    FURI_CRITICAL_EXIT();
+
+    if(start) cdc_tx_next(cdc);
+}
+
+static void cdc_flow_pause(BunnyConnectCdc* cdc) {
+    if(cdc->paused) return;
+
+    cdc->pause_start = cdc_cycles() | 1;
+    cdc->paused = true;
+    cdc->stats.flow_pauses++;
+
+    // Nothing in flight means TX is already stopped
+    if(!cdc->tx_busy) {
+        cdc->pause_start = 0;
+    }
+}
+
+static void cdc_flow_resume(BunnyConnectCdc* cdc) {
+    if(!cdc->paused) return;
+
+    cdc->resume_start = cdc_cycles() | 1;
+    cdc->paused = false;
+    cdc_tx_kick(cdc);
+}
+
+static void cdc_tx_ep_callback(void* context) {
+    BunnyConnectCdc* cdc = context;
+    cdc_tx_next(cdc);
+}
+
+static void cdc_state_callback(void* context, uint8_t state) {
+    BunnyConnectCdc* cdc = context;
+
+    if(state == CdcStateDisconnected) {
+        // Unplugged or suspended, packet in flight will never complete
+        cdc->connected = false;
+        cdc->ctrl_line = 0;
+        furi_event_flag_clear(cdc->events, CDC_EVENT_CONFIGURED | CDC_EVENT_DTR);
+
+        cdc->tail = cdc->head;
+        cdc->packet_size = 0;
+        cdc->tx_busy = false;
+        furi_event_flag_set(cdc->events, CDC_EVENT_TX_SPACE);
+    } else {
+        // A kick that raced the disconnect left TX marked busy, start clean
+        cdc->tail = cdc->head;
+        cdc->packet_size = 0;
+        cdc->tx_busy = false;
+        cdc->connected = true;
+        furi_event_flag_set(cdc->events, CDC_EVENT_CONFIGURED);
+    }
+}
+
+static void cdc_ctrl_line_callback(void* context, uint8_t state) {
+    BunnyConnectCdc* cdc = context;
+
+    cdc->ctrl_line = state;
+    if(state & CdcCtrlLineDTR) {
+        furi_event_flag_set(cdc->events, CDC_EVENT_DTR);
+    } else {
+        furi_event_flag_clear(cdc->events, CDC_EVENT_DTR);
+    }
+
+    if(cdc->flow_control != BunnyConnectFlowControlDtrRts) return;
+
+    // Host RTS drives our CTS
+    if(state & CdcCtrlLineRTS) {
+        cdc_flow_resume(cdc);
+    } else {
+        cdc_flow_pause(cdc);
+    }
+}
+
+BunnyConnectCdc* bunnyconnect_cdc_alloc(uint8_t port) {
+    BunnyConnectCdc* cdc = malloc(sizeof(BunnyConnectCdc));
+    memset(cdc, 0, sizeof(BunnyConnectCdc));
+
+    cdc->port = port;
+    cdc->events = furi_event_flag_alloc();
+    cdc->callbacks.tx_ep_callback = cdc_tx_ep_callback;
+    cdc->callbacks.state_callback = cdc_state_callback;
+    cdc->callbacks.ctrl_line_callback = cdc_ctrl_line_callback;
+
+    // Reports the current state right away if the interface is already up
+    bunnyconnect_usb_cdc_set_callbacks(cdc->port, &cdc->callbacks, cdc);
+
+    return cdc;
+}
+
+void bunnyconnect_cdc_free(BunnyConnectCdc* cdc) {
+    if(!cdc) return;
+
+    bunnyconnect_usb_cdc_set_callbacks(cdc->port, NULL, NULL);
+    furi_event_flag_free(cdc->events);
+
+    FURI_LOG_D(
+        TAG,
+        "TX %lu bytes in %lu packets (%lu full, %lu ZLP)",
+        cdc->stats.bytes_sent,
+        cdc->stats.packets_sent,
+        cdc->stats.full_packets,
+        cdc->stats.zlp_sent);
+
+    free(cdc);
+}
+
+size_t bunnyconnect_cdc_write(
+    BunnyConnectCdc* cdc,
+    const uint8_t* data,
+    size_t size,
+    uint32_t timeout) {
+    furi_assert(cdc);
+    size_t written = 0;
+
+    while(written < size) {
+        // Nothing can drain the ring until the host configures us again
+        if(!cdc->connected) break;
+
+        uint32_t space = BUNNYCONNECT_CDC_TX_RING_SIZE - (cdc->head - cdc->tail);
+        if(space == 0) {
+            furi_event_flag_clear(cdc->events, CDC_EVENT_TX_SPACE);
+            // TX path may have freed space between the check and the clear
+            if(cdc->head - cdc->tail < BUNNYCONNECT_CDC_TX_RING_SIZE) continue;
+            uint32_t flags = furi_event_flag_wait(
+                cdc->events, CDC_EVENT_TX_SPACE, FuriFlagWaitAny, timeout);
+            if(flags & FuriFlagError) break;
+            continue;
+        }
+
+        uint32_t size_left = size - written;
+        uint32_t chunk = space < size_left ? space : size_left;
+        uint32_t offset = cdc->head & CDC_TX_RING_MASK;
+        uint32_t first = BUNNYCONNECT_CDC_TX_RING_SIZE - offset;
+        if(first >= chunk) {
+            memcpy(&cdc->ring[offset], data + written, chunk);
+        } else {
+            memcpy(&cdc->ring[offset], data + written, first);
+            memcpy(cdc->ring, data + written + first, chunk - first);
+        }
+        cdc->head += chunk;
+        written += chunk;
+
+        cdc_tx_kick(cdc);
+    }
+
+    return written;
+}
+
+void bunnyconnect_cdc_set_flow_control(BunnyConnectCdc* cdc, BunnyConnectFlowControl mode) {
+    furi_assert(cdc);
+    furi_assert(mode < BunnyConnectFlowControlCount);
+
+    cdc->flow_control = mode;
+    if(mode == BunnyConnectFlowControlDtrRts) {
+        cdc_ctrl_line_callback(cdc, bunnyconnect_usb_cdc_get_ctrl_line_state(cdc->port));
+    } else {
+        cdc_flow_resume(cdc);
+    }
+}
+
+size_t bunnyconnect_cdc_filter_rx(BunnyConnectCdc* cdc, uint8_t* data, size_t size) {
+    furi_assert(cdc);
+    if(cdc->flow_control != BunnyConnectFlowControlXonXoff) return size;
+
+    size_t kept = 0;
+    for(size_t i = 0; i < size; i++) {
+        if(data[i] == BUNNYCONNECT_CDC_XOFF) {
+            cdc_flow_pause(cdc);
+        } else if(data[i] == BUNNYCONNECT_CDC_XON) {
+            cdc_flow_resume(cdc);
+        } else {
+            data[kept++] = data[i];
+        }
+    }
+    return kept;
+}
+
+bool bunnyconnect_cdc_wait_ready(BunnyConnectCdc* cdc, bool dtr, uint32_t timeout) {
+    furi_assert(cdc);
+
+    uint32_t flags = CDC_EVENT_CONFIGURED | (dtr ? CDC_EVENT_DTR : 0);
+    uint32_t result = furi_event_flag_wait(
+        cdc->events, flags, FuriFlagWaitAll | FuriFlagNoClear, timeout);
+    return !(result & FuriFlagError);
+}
+
+bool bunnyconnect_cdc_is_connected(BunnyConnectCdc* cdc) {
+    furi_assert(cdc);
+    return cdc->connected;
+}
+
+bool bunnyconnect_cdc_is_dtr(BunnyConnectCdc* cdc) {
+    furi_assert(cdc);
+    return cdc->connected && (cdc->ctrl_line & CdcCtrlLineDTR);
+}
+
+bool bunnyconnect_cdc_is_paused(BunnyConnectCdc* cdc) {
+    furi_assert(cdc);
+    return cdc->paused;
+}
+
+const char* bunnyconnect_cdc_flow_control_name(BunnyConnectFlowControl mode) {
+    return mode < BunnyConnectFlowControlCount ? cdc_flow_control_names[mode] : "?";
+}
+
+size_t bunnyconnect_cdc_get_pending(BunnyConnectCdc* cdc) {
+    furi_assert(cdc);
+    return cdc->head - cdc->tail;
+}
+
+void bunnyconnect_cdc_get_stats(BunnyConnectCdc* cdc, BunnyConnectCdcStats* stats) {
+    furi_assert(cdc);
+    furi_assert(stats);
+    *stats = cdc->stats;
+}
@@ -0,0 +1,391 @@
+#include "../lib/bunnyconnect_config.h"
+#include <furi.h>
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
+
+#define TAG "BunnyConfig"
+
+#define CONFIG_MAGIC        0x46434342UL // "BCCF"
+#define CONFIG_VERSION      2
+#define CONFIG_TEXT_TYPE    "BunnyConnect Config"
+#define CONFIG_TEXT_VERSION 1
+
+#define CONFIG_FLAG_AUTO_CONNECT     (1U << 0)
+#define CONFIG_FLAG_USB_POWER        (1U << 1)
+#define CONFIG_FLAG_AUTO_ENUMERATE   (1U << 2)
+#define CONFIG_FLAG_YMODEM_STREAMING (1U << 3)
+#define CONFIG_FLAG_TIMESTAMPS       (1U << 4)
+
+// On-disk layout, independent of enum sizes and padding of BunnyConnectConfig
+typedef struct {
+    uint32_t baud_rate;
+    uint8_t flags;
+    uint8_t flow_control;
+    uint8_t data_bits;
+    uint8_t stop_bits;
+    uint8_t parity;
+    uint8_t output_route;
+    uint8_t line_ending[BunnyConnectOutputCount];
+    uint8_t file_mode;
+    uint8_t file_route;
+    uint16_t file_chunk_size;
+    uint16_t file_chunk_delay_ms;
+    uint16_t file_line_delay_ms;
+    uint8_t memory_budget;
+    char device_name[32];
+} __attribute__((packed)) ConfigRecord;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size; // sizeof(ConfigRecord)
+    uint32_t hash; // FNV-1a over the record
+    ConfigRecord record;
+} __attribute__((packed)) ConfigFile;
+
+static const char* const config_memory_budget_names[] = {
+    [BunnyConnectMemoryBudgetSmall] = "Small",
+    [BunnyConnectMemoryBudgetDefault] = "Default",
+    [BunnyConnectMemoryBudgetLarge] = "Large",
+};
+
+static uint32_t config_hash(const void* data, size_t size) {
+    // FNV-1a
+    const uint8_t* bytes = data;
+    uint32_t hash = 2166136261UL;
+    for(size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+void bunnyconnect_config_defaults(BunnyConnectConfig* config) {
+    furi_assert(config);
+    memset(config, 0, sizeof(BunnyConnectConfig));
+
+    strlcpy(config->device_name, "BunnyConnect", sizeof(config->device_name));
+    config->baud_rate = 115200;
+    config->auto_connect = false;
+    config->flow_control = BunnyConnectFlowControlNone;
+    config->data_bits = 8;
+    config->stop_bits = 1;
+    config->parity = 0;
+    config->usb_power_enabled = true;
+    config->auto_enumerate = true;
+    config->output_route = BunnyConnectOutputRouteBoth;
+    config->line_ending[BunnyConnectOutputCdc] = BunnyConnectLineEndingLf;
+    config->line_ending[BunnyConnectOutputHid] = BunnyConnectLineEndingLf;
+    config->sendfile.mode = BunnyConnectSendFileModeChunks;
+    config->sendfile.route = BunnyConnectOutputRouteCdc;
+    config->sendfile.chunk_size = 64;
+    config->sendfile.chunk_delay_ms = 0;
+    config->sendfile.line_delay_ms = 50;
+    config->ymodem_streaming = false;
+    config->timestamps = false;
+    config->memory_budget = BunnyConnectMemoryBudgetDefault;
+}
+
+// Out of range values keep the default already in config
+static void config_apply_record(BunnyConnectConfig* config, const ConfigRecord* record) {
+    if(record->baud_rate) config->baud_rate = record->baud_rate;
+    config->auto_connect = record->flags & CONFIG_FLAG_AUTO_CONNECT;
+    config->usb_power_enabled = record->flags & CONFIG_FLAG_USB_POWER;
+    config->auto_enumerate = record->flags & CONFIG_FLAG_AUTO_ENUMERATE;
+    config->ymodem_streaming = record->flags & CONFIG_FLAG_YMODEM_STREAMING;
+    config->timestamps = record->flags & CONFIG_FLAG_TIMESTAMPS;
+    if(record->flow_control < BunnyConnectFlowControlCount) {
+        config->flow_control = record->flow_control;
+    }
+    config->data_bits = record->data_bits;
+    config->stop_bits = record->stop_bits;
+    config->parity = record->parity;
+    if(record->output_route < BunnyConnectOutputRouteCount) {
+        config->output_route = record->output_route;
+    }
+    for(size_t i = 0; i < BunnyConnectOutputCount; i++) {
+        if(record->line_ending[i] < BunnyConnectLineEndingCount) {
+            config->line_ending[i] = record->line_ending[i];
+        }
+    }
+    if(record->file_mode < BunnyConnectSendFileModeCount) {
+        config->sendfile.mode = record->file_mode;
+    }
+    if(record->file_route < BunnyConnectOutputRouteCount) {
+        config->sendfile.route = record->file_route;
+    }
+    if(record->file_chunk_size) config->sendfile.chunk_size = record->file_chunk_size;
+    config->sendfile.chunk_delay_ms = record->file_chunk_delay_ms;
+    config->sendfile.line_delay_ms = record->file_line_delay_ms;
+    if(record->memory_budget < BunnyConnectMemoryBudgetCount) {
+        config->memory_budget = record->memory_budget;
+    }
+    if(record->device_name[0] != '\0') {
+        strlcpy(config->device_name, record->device_name, sizeof(config->device_name));
+    }
+}
+
+static void config_fill_record(ConfigRecord* record, const BunnyConnectConfig* config) {
+    memset(record, 0, sizeof(ConfigRecord));
+    record->baud_rate = config->baud_rate;
+    record->flags = (config->auto_connect ? CONFIG_FLAG_AUTO_CONNECT : 0) |
+                    (config->usb_power_enabled ? CONFIG_FLAG_USB_POWER : 0) |
+                    (config->auto_enumerate ? CONFIG_FLAG_AUTO_ENUMERATE : 0) |
+                    (config->ymodem_streaming ? CONFIG_FLAG_YMODEM_STREAMING : 0) |
+                    (config->timestamps ? CONFIG_FLAG_TIMESTAMPS : 0);
+    record->flow_control = config->flow_control;
+    record->data_bits = config->data_bits;
+    record->stop_bits = config->stop_bits;
+    record->parity = config->parity;
+    record->output_route = config->output_route;
+    for(size_t i = 0; i < BunnyConnectOutputCount; i++) {
+        record->line_ending[i] = config->line_ending[i];
+    }
+    record->file_mode = config->sendfile.mode;
+    record->file_route = config->sendfile.route;
+    record->file_chunk_size = config->sendfile.chunk_size;
+    record->file_chunk_delay_ms = config->sendfile.chunk_delay_ms;
+    record->file_line_delay_ms = config->sendfile.line_delay_ms;
+    record->memory_budget = config->memory_budget;
+    strlcpy(record->device_name, config->device_name, sizeof(record->device_name));
+}
+
+static bool config_load_binary(Storage* storage, ConfigRecord* record) {
+    File* file = storage_file_alloc(storage);
+    ConfigFile data;
+    bool success = false;
+
+    do {
+        if(!storage_file_open(file, BUNNYCONNECT_CONFIG_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+        if(storage_file_read(file, &data, sizeof(data)) != sizeof(data)) break;
+        if(data.magic != CONFIG_MAGIC || data.version != CONFIG_VERSION ||
+           data.size != sizeof(ConfigRecord)) {
+            FURI_LOG_W(TAG, "Config record format mismatch");
+            break;
+        }
+        if(data.hash != config_hash(&data.record, sizeof(ConfigRecord))) {
+            FURI_LOG_W(TAG, "Config record corrupt");
+            break;
+        }
+
+        *record = data.record;
+        success = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return success;
+}
+
+static bool config_save_binary(Storage* storage, const ConfigRecord* record) {
+    File* file = storage_file_alloc(storage);
+    bool success = false;
+
+    ConfigFile data = {
+        .magic = CONFIG_MAGIC,
+        .version = CONFIG_VERSION,
+        .size = sizeof(ConfigRecord),
+        .hash = config_hash(record, sizeof(ConfigRecord)),
+        .record = *record,
+    };
+
+    if(storage_file_open(file, BUNNYCONNECT_CONFIG_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        success = storage_file_write(file, &data, sizeof(data)) == sizeof(data);
+    }
+    if(!success) {
+        FURI_LOG_E(TAG, "Failed to write config record");
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return success;
+}
+
+// Keys may appear in any order, so every lookup starts from the top
+static bool config_text_u32(FlipperFormat* format, const char* key, uint32_t* value) {
+    return flipper_format_rewind(format) && flipper_format_read_uint32(format, key, value, 1);
+}
+
+static bool config_text_bool(FlipperFormat* format, const char* key, bool* value) {
+    return flipper_format_rewind(format) && flipper_format_read_bool(format, key, value, 1);
+}
+
+static bool config_load_text(Storage* storage, ConfigRecord* record) {
+    FlipperFormat* format = flipper_format_file_alloc(storage);
+    FuriString* string = furi_string_alloc();
+    bool success = false;
+
+    do {
+        uint32_t version = 0;
+        if(!flipper_format_file_open_existing(format, BUNNYCONNECT_CONFIG_TEXT_PATH)) break;
+        if(!flipper_format_read_header(format, string, &version)) break;
+        if(furi_string_cmp_str(string, CONFIG_TEXT_TYPE) != 0 ||
+           version != CONFIG_TEXT_VERSION) {
+            FURI_LOG_W(TAG, "Config text format mismatch");
+            break;
+        }
+
+        uint32_t value;
+        bool flag;
+        if(flipper_format_rewind(format) &&
+           flipper_format_read_string(format, "Device Name", string)) {
+            strlcpy(
+                record->device_name,
+                furi_string_get_cstr(string),
+                sizeof(record->device_name));
+        }
+        if(config_text_u32(format, "Baud Rate", &value)) record->baud_rate = value;
+        if(config_text_u32(format, "Flow Control", &value)) record->flow_control = value;
+        if(config_text_u32(format, "Data Bits", &value)) record->data_bits = value;
+        if(config_text_u32(format, "Stop Bits", &value)) record->stop_bits = value;
+        if(config_text_u32(format, "Parity", &value)) record->parity = value;
+        if(config_text_u32(format, "Route", &value)) record->output_route = value;
+        if(config_text_u32(format, "CDC Line Ending", &value)) {
+            record->line_ending[BunnyConnectOutputCdc] = value;
+        }
+        if(config_text_u32(format, "HID Line Ending", &value)) {
+            record->line_ending[BunnyConnectOutputHid] = value;
+        }
+        if(config_text_u32(format, "File Mode", &value)) record->file_mode = value;
+        if(config_text_u32(format, "File Route", &value)) record->file_route = value;
+        if(config_text_u32(format, "File Chunk", &value)) record->file_chunk_size = value;
+        if(config_text_u32(format, "Chunk Delay", &value)) record->file_chunk_delay_ms = value;
+        if(config_text_u32(format, "Line Delay", &value)) record->file_line_delay_ms = value;
+        if(config_text_u32(format, "Memory Budget", &value)) record->memory_budget = value;
+
+        struct {
+            const char* key;
+            uint8_t mask;
+        } flags[] = {
+            {"Auto Connect", CONFIG_FLAG_AUTO_CONNECT},
+            {"USB Power", CONFIG_FLAG_USB_POWER},
+            {"Auto Enumerate", CONFIG_FLAG_AUTO_ENUMERATE},
+            {"YMODEM Streaming", CONFIG_FLAG_YMODEM_STREAMING},
+            {"Timestamps", CONFIG_FLAG_TIMESTAMPS},
+        };
+        for(size_t i = 0; i < COUNT_OF(flags); i++) {
+            if(!config_text_bool(format, flags[i].key, &flag)) continue;
+            record->flags = flag ? (record->flags | flags[i].mask) :
+                                   (record->flags & ~flags[i].mask);
+        }
+
+        success = true;
+    } while(false);
+
+    furi_string_free(string);
+    flipper_format_free(format);
+    return success;
+}
+
+static bool config_save_text(Storage* storage, const ConfigRecord* record) {
+    FlipperFormat* format = flipper_format_file_alloc(storage);
+    bool success = false;
+
+    do {
+        if(!flipper_format_file_open_always(format, BUNNYCONNECT_CONFIG_TEXT_PATH)) break;
+        if(!flipper_format_write_header_cstr(format, CONFIG_TEXT_TYPE, CONFIG_TEXT_VERSION)) {
+            break;
+        }
+        if(!flipper_format_write_comment_cstr(
+               format, "Read only when config.bin is missing, delete it after editing")) {
+            break;
+        }
+        if(!flipper_format_write_string_cstr(format, "Device Name", record->device_name)) break;
+
+        struct {
+            const char* key;
+            uint32_t value;
+        } values[] = {
+            {"Baud Rate", record->baud_rate},
+            {"Flow Control", record->flow_control},
+            {"Data Bits", record->data_bits},
+            {"Stop Bits", record->stop_bits},
+            {"Parity", record->parity},
+            {"Route", record->output_route},
+            {"CDC Line Ending", record->line_ending[BunnyConnectOutputCdc]},
+            {"HID Line Ending", record->line_ending[BunnyConnectOutputHid]},
+            {"File Mode", record->file_mode},
+            {"File Route", record->file_route},
+            {"File Chunk", record->file_chunk_size},
+            {"Chunk Delay", record->file_chunk_delay_ms},
+            {"Line Delay", record->file_line_delay_ms},
+            {"Memory Budget", record->memory_budget},
+        };
+        size_t i;
+        for(i = 0; i < COUNT_OF(values); i++) {
+            if(!flipper_format_write_uint32(format, values[i].key, &values[i].value, 1)) break;
+        }
+        if(i < COUNT_OF(values)) break;
+
+        struct {
+            const char* key;
+            bool value;
+        } flags[] = {
+            {"Auto Connect", record->flags & CONFIG_FLAG_AUTO_CONNECT},
+            {"USB Power", record->flags & CONFIG_FLAG_USB_POWER},
+            {"Auto Enumerate", record->flags & CONFIG_FLAG_AUTO_ENUMERATE},
+            {"YMODEM Streaming", record->flags & CONFIG_FLAG_YMODEM_STREAMING},
+            {"Timestamps", record->flags & CONFIG_FLAG_TIMESTAMPS},
+        };
+        for(i = 0; i < COUNT_OF(flags); i++) {
+            if(!flipper_format_write_bool(format, flags[i].key, &flags[i].value, 1)) break;
+        }
+        if(i < COUNT_OF(flags)) break;
+
+        success = true;
+    } while(false);
+
+    flipper_format_file_close(format);
+    flipper_format_free(format);
+    return success;
+}
+
+BunnyConnectConfigSource bunnyconnect_config_load(Storage* storage, BunnyConnectConfig* config) {
+    furi_assert(storage);
+    furi_assert(config);
+
+    uint32_t start = furi_get_tick();
+    BunnyConnectConfigSource source = BunnyConnectConfigSourceDefaults;
+    ConfigRecord record;
+
+    bunnyconnect_config_defaults(config);
+    config_fill_record(&record, config);
+
+    if(config_load_binary(storage, &record)) {
+        source = BunnyConnectConfigSourceBinary;
+    } else if(config_load_text(storage, &record)) {
+        source = BunnyConnectConfigSourceText;
+    }
+    if(source != BunnyConnectConfigSourceDefaults) {
+        config_apply_record(config, &record);
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Config from %s in %lu ms",
+        source == BunnyConnectConfigSourceBinary ? "record" :
+        source == BunnyConnectConfigSourceText   ? "text" :
+                                                   "defaults",
+        furi_get_tick() - start);
+    return source;
+}
+
+bool bunnyconnect_config_save(Storage* storage, const BunnyConnectConfig* config) {
+    furi_assert(storage);
+    furi_assert(config);
+
+    ConfigRecord record;
+    config_fill_record(&record, config);
+
+    bool success = config_save_binary(storage, &record);
+    if(!config_save_text(storage, &record)) {
+        FURI_LOG_W(TAG, "Failed to write config text");
+    }
+    return success;
+}
+
+const char* bunnyconnect_config_memory_budget_name(BunnyConnectMemoryBudget budget) {
+    return budget < BunnyConnectMemoryBudgetCount ? config_memory_budget_names[budget] : "?";
+}
@@ -0,0 +1,77 @@
+#include "../lib/bunnyconnect_counters.h"
+#include <furi.h>
+#include <stdatomic.h>
+
+#define COUNTERS_FORMAT_VERSION 1
+
+static atomic_uint_least32_t counters[BunnyConnectCounterCount];
+
+static const char* const counter_names[BunnyConnectCounterCount] = {
+    [BunnyConnectCounterRxBytes] = "rx_bytes",
+    [BunnyConnectCounterRxChunks] = "rx_chunks",
+    [BunnyConnectCounterRxDropped] = "rx_dropped",
+    [BunnyConnectCounterTxBytes] = "tx_bytes",
+    [BunnyConnectCounterTxChunks] = "tx_chunks",
+    [BunnyConnectCounterTxDropped] = "tx_dropped",
+    [BunnyConnectCounterMutexWaitUs] = "mutex_wait_us",
+    [BunnyConnectCounterRefreshRequested] = "refresh_req",
+    [BunnyConnectCounterRefreshRendered] = "refresh_done",
+    [BunnyConnectCounterHidKeys] = "hid_keys",
+    [BunnyConnectCounterCdcQueuePeak] = "cdc_q_peak",
+    [BunnyConnectCounterHidQueuePeak] = "hid_q_peak",
+};
+
+void bunnyconnect_counters_add(BunnyConnectCounter counter, uint32_t value) {
+    furi_assert(counter < BunnyConnectCounterCount);
+    atomic_fetch_add_explicit(&counters[counter], value, memory_order_relaxed);
+}
+
+void bunnyconnect_counters_max(BunnyConnectCounter counter, uint32_t value) {
+    furi_assert(counter < BunnyConnectCounterCount);
+    uint32_t current = atomic_load_explicit(&counters[counter], memory_order_relaxed);
+    while(value > current && !atomic_compare_exchange_weak_explicit(
+                                 &counters[counter],
+                                 &current,
+                                 value,
+                                 memory_order_relaxed,
+                                 memory_order_relaxed)) {
+    }
+}
+
+void bunnyconnect_counters_reset(void) {
+    for(size_t i = 0; i < BunnyConnectCounterCount; i++) {
+        atomic_store_explicit(&counters[i], 0, memory_order_relaxed);
+    }
+}
+
+void bunnyconnect_counters_snapshot(uint32_t* values) {
+    furi_assert(values);
+    for(size_t i = 0; i < BunnyConnectCounterCount; i++) {
+        values[i] = atomic_load_explicit(&counters[i], memory_order_relaxed);
+    }
+}
+
+const char* bunnyconnect_counters_name(BunnyConnectCounter counter) {
+    return counter < BunnyConnectCounterCount ? counter_names[counter] : "?";
+}
+
+size_t bunnyconnect_counters_format(
+    const uint32_t* values,
+    uint32_t uptime_ms,
+    char* out,
+    size_t size) {
+    furi_assert(values);
+    furi_assert(out);
+    furi_assert(size > 0);
+
+    int len = snprintf(out, size, "BCSTATS v=%d up_ms=%lu", COUNTERS_FORMAT_VERSION, uptime_ms);
+    for(size_t i = 0; i < BunnyConnectCounterCount && len >= 0 && (size_t)len < size; i++) {
+        len += snprintf(out + len, size - len, " %s=%lu", counter_names[i], values[i]);
+    }
+    if(len >= 0 && (size_t)len < size) {
+        len += snprintf(out + len, size - len, "\r\n");
+    }
+
+    // Truncated lines still end cleanly, the rig rejects them by the missing CRLF
+    return len < 0 ? 0 : MIN((size_t)len, size - 1);
+}
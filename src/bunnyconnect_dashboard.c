@@ -0,0 +1,166 @@
+#include "../lib/bunnyconnect_dashboard.h"
+#include "../lib/bunnyconnect_draw.h"
+#include "../lib/bunnyconnect_trace.h"
+#include <furi.h>
+
+#define DASHBOARD_HISTORY       64 // Samples, one pixel column each
+#define DASHBOARD_HEADER_HEIGHT 12
+#define DASHBOARD_BAND_HEIGHT   22
+#define DASHBOARD_GRAPH_X       (128 - DASHBOARD_HISTORY)
+
+struct BunnyConnectDashboard {
+    View* view;
+};
+
+typedef struct {
+    uint32_t rx_rate[DASHBOARD_HISTORY]; // Bytes per second, ring
+    uint32_t tx_rate[DASHBOARD_HISTORY];
+    size_t head; // Next slot
+    size_t count;
+    uint32_t rx_total;
+    uint32_t tx_total;
+    bool primed;
+    bool connected;
+    uint8_t utilisation; // Percent
+    uint8_t battery;
+    bool charging;
+    size_t hid_depth;
+    size_t hid_capacity;
+    uint8_t frame; // Activity spinner, advances while data moves
+} BunnyConnectDashboardModel;
+
+static void dashboard_format_rate(char* out, size_t size, uint32_t rate) {
+    if(rate < 1000) {
+        snprintf(out, size, "%lu B/s", rate);
+    } else {
+        snprintf(out, size, "%lu.%luk/s", rate / 1000, (rate % 1000) / 100);
+    }
+}
+
+// Label and current rate on the left, history scaled to its peak on the right
+static void dashboard_draw_band(
+    Canvas* canvas,
+    BunnyConnectDashboardModel* model,
+    const uint32_t* rates,
+    const char* label,
+    int32_t top) {
+    char text[16];
+    size_t newest = (model->head + DASHBOARD_HISTORY - 1) % DASHBOARD_HISTORY;
+    uint32_t current = model->count ? rates[newest] : 0;
+    uint32_t peak = 1;
+    for(size_t i = 0; i < model->count; i++) {
+        peak = MAX(peak, rates[i]);
+    }
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 0, top + 9, label);
+    canvas_set_font(canvas, FontSecondary);
+    dashboard_format_rate(text, sizeof(text), current);
+    canvas_draw_str(canvas, 0, top + 19, text);
+
+    int32_t bottom = top + DASHBOARD_BAND_HEIGHT - 2;
+    int32_t height = DASHBOARD_BAND_HEIGHT - 3;
+    canvas_draw_line(canvas, DASHBOARD_GRAPH_X, bottom + 1, 127, bottom + 1);
+
+    // Oldest sample on the left, the newest in the last column
+    size_t first = (model->head + DASHBOARD_HISTORY - model->count) % DASHBOARD_HISTORY;
+    int32_t x = 128 - model->count;
+    for(size_t i = 0; i < model->count; i++, x++) {
+        uint32_t rate = rates[(first + i) % DASHBOARD_HISTORY];
+        int32_t bar = (uint64_t)rate * height / peak;
+        if(bar > 0) canvas_draw_line(canvas, x, bottom, x, bottom - bar + 1);
+    }
+}
+
+static void bunnyconnect_dashboard_draw_callback(Canvas* canvas, void* _model) {
+    BunnyConnectDashboardModel* model = _model;
+    char text[24];
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawBegin, BunnyConnectTraceViewDashboard);
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontSecondary);
+
+    // Header: link, utilisation bars, battery
+    bunnyconnect_draw_connection_status(canvas, model->connected, 1, 2);
+    canvas_draw_str(canvas, 11, 9, model->connected ? "Link up" : "Link down");
+    snprintf(text, sizeof(text), "%u%%", model->utilisation);
+    canvas_draw_str_aligned(canvas, 82, 9, AlignRight, AlignBottom, text);
+    bunnyconnect_draw_signal_strength(canvas, model->utilisation, 85, 6);
+    bunnyconnect_draw_battery_status(canvas, model->battery, model->charging, 115, 3);
+    canvas_draw_line(canvas, 0, DASHBOARD_HEADER_HEIGHT - 1, 127, DASHBOARD_HEADER_HEIGHT - 1);
+
+    dashboard_draw_band(canvas, model, model->rx_rate, "RX", DASHBOARD_HEADER_HEIGHT);
+    dashboard_draw_band(
+        canvas, model, model->tx_rate, "TX", DASHBOARD_HEADER_HEIGHT + DASHBOARD_BAND_HEIGHT);
+
+    // Footer: HID queue and activity
+    snprintf(text, sizeof(text), "HID q %u/%u", model->hid_depth, model->hid_capacity);
+    bunnyconnect_draw_loading_animation(canvas, model->frame, 5, 59);
+    canvas_draw_str(canvas, 12, 63, text);
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawEnd, BunnyConnectTraceViewDashboard);
+}
+
+BunnyConnectDashboard* bunnyconnect_dashboard_alloc(void) {
+    BunnyConnectDashboard* dashboard = malloc(sizeof(BunnyConnectDashboard));
+    dashboard->view = view_alloc();
+    view_set_context(dashboard->view, dashboard);
+    view_allocate_model(
+        dashboard->view, ViewModelTypeLocking, sizeof(BunnyConnectDashboardModel));
+    view_set_draw_callback(dashboard->view, bunnyconnect_dashboard_draw_callback);
+
+    with_view_model(
+        dashboard->view,
+        BunnyConnectDashboardModel * model,
+        { memset(model, 0, sizeof(BunnyConnectDashboardModel)); },
+        false);
+    return dashboard;
+}
+
+void bunnyconnect_dashboard_free(BunnyConnectDashboard* dashboard) {
+    furi_assert(dashboard);
+    view_free(dashboard->view);
+    free(dashboard);
+}
+
+View* bunnyconnect_dashboard_get_view(BunnyConnectDashboard* dashboard) {
+    furi_assert(dashboard);
+    return dashboard->view;
+}
+
+void bunnyconnect_dashboard_push(
+    BunnyConnectDashboard* dashboard,
+    const BunnyConnectDashboardSample* sample) {
+    furi_assert(dashboard);
+    furi_assert(sample);
+    with_view_model(
+        dashboard->view,
+        BunnyConnectDashboardModel * model,
+        {
+            if(model->primed && sample->interval_ms > 0) {
+                uint32_t rx = (uint64_t)(sample->rx_bytes - model->rx_total) * 1000 /
+                              sample->interval_ms;
+                uint32_t tx = (uint64_t)(sample->tx_bytes - model->tx_total) * 1000 /
+                              sample->interval_ms;
+                model->rx_rate[model->head] = rx;
+                model->tx_rate[model->head] = tx;
+                model->head = (model->head + 1) % DASHBOARD_HISTORY;
+                if(model->count < DASHBOARD_HISTORY) model->count++;
+
+                uint64_t used = (uint64_t)(rx + tx) * 100;
+                model->utilisation = sample->link_bytes_per_s ?
+                                         MIN(used / sample->link_bytes_per_s, 100U) :
+                                         0;
+                if(rx + tx > 0) model->frame++;
+            }
+            model->rx_total = sample->rx_bytes;
+            model->tx_total = sample->tx_bytes;
+            model->primed = true;
+            model->connected = sample->connected;
+            model->battery = sample->battery;
+            model->charging = sample->charging;
+            model->hid_depth = sample->hid_depth;
+            model->hid_capacity = sample->hid_capacity;
+        },
+        true);
+}
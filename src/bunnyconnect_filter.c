@@ -0,0 +1,268 @@
+#include "../lib/bunnyconnect_filter.h"
+#include "../lib/bunnyconnect_stamp.h"
+#include <furi.h>
+#include <ctype.h>
+
+#define FILTER_MASK     (BUNNYCONNECT_FILTER_LINES - 1)
+#define FILTER_LINE_MAX 128 // Bytes of a line compared against the pattern
+#define FILTER_CHUNK    32 // Bytes read from the ring at a time
+
+_Static_assert(
+    (BUNNYCONNECT_FILTER_LINES & FILTER_MASK) == 0,
+    "Filter index size must be a power of two");
+
+typedef struct {
+    uint32_t start; // Stream position
+    uint32_t len; // Newline excluded
+    uint32_t ms; // Arrival time, valid if stamped
+    bool stamped;
+} FilterLine;
+
+struct BunnyConnectFilter {
+    char pattern[BUNNYCONNECT_FILTER_PATTERN_SIZE];
+    bool glob;
+
+    // Scan state, positions in the stream of the ring below
+    BunnyConnectScrollback* scrollback;
+    uint32_t scanned; // Next position to look at
+    uint32_t line_start;
+    bool line_lost; // Its start was overwritten before the scan got there
+    size_t line_len; // Bytes in line, capped
+    char line[FILTER_LINE_MAX];
+    BunnyConnectStampClock clock;
+    bool line_stamped; // A marker led the line in progress
+
+    // Matching lines, oldest at first
+    FilterLine lines[BUNNYCONNECT_FILTER_LINES];
+    uint32_t first;
+    uint32_t count;
+};
+
+static bool filter_same(char a, char b) {
+    return tolower((unsigned char)a) == tolower((unsigned char)b);
+}
+
+// Whole-line glob, * backtracks to the last star only
+static bool filter_glob(const char* pattern, const char* text, size_t len) {
+    const char* star = NULL;
+    size_t star_text = 0;
+    size_t i = 0;
+
+    while(i < len) {
+        if(*pattern == '*') {
+            star = pattern++;
+            star_text = i;
+        } else if(*pattern && (*pattern == '?' || filter_same(*pattern, text[i]))) {
+            pattern++;
+            i++;
+        } else if(star) {
+            pattern = star + 1;
+            i = ++star_text;
+        } else {
+            return false;
+        }
+    }
+    while(*pattern == '*') {
+        pattern++;
+    }
+    return *pattern == '\0';
+}
+
+static bool filter_contains(const char* pattern, const char* text, size_t len) {
+    size_t pattern_len = strlen(pattern);
+    for(size_t i = 0; i + pattern_len <= len; i++) {
+        size_t j = 0;
+        while(j < pattern_len && filter_same(pattern[j], text[i + j])) {
+            j++;
+        }
+        if(j == pattern_len) return true;
+    }
+    return false;
+}
+
+static void filter_push(BunnyConnectFilter* filter, uint32_t start, uint32_t len) {
+    if(filter->count == BUNNYCONNECT_FILTER_LINES) {
+        filter->first++;
+        filter->count--;
+    }
+    FilterLine* line = &filter->lines[(filter->first + filter->count) & FILTER_MASK];
+    line->start = start;
+    line->len = len;
+    line->ms = filter->clock.ms;
+    line->stamped = filter->line_stamped && filter->clock.known;
+    filter->count++;
+}
+
+// Drop lines the producer has overwritten, they are the oldest
+static void filter_evict(BunnyConnectFilter* filter, uint32_t tail) {
+    while(filter->count &&
+          (int32_t)(filter->lines[filter->first & FILTER_MASK].start - tail) < 0) {
+        filter->first++;
+        filter->count--;
+    }
+}
+
+// Continue at tail, the line in progress lost its start
+static void filter_skip_to(BunnyConnectFilter* filter, uint32_t tail) {
+    filter->scanned = tail;
+    filter->line_start = tail;
+    filter->line_lost = true;
+    filter->line_len = 0;
+    memset(&filter->clock, 0, sizeof(filter->clock));
+    filter->line_stamped = false;
+    filter_evict(filter, tail);
+}
+
+static void filter_scan(BunnyConnectFilter* filter, const uint8_t* data, size_t len) {
+    for(size_t i = 0; i < len; i++) {
+        uint32_t pos = filter->scanned + i;
+        if(bunnyconnect_stamp_clock_feed(&filter->clock, data[i])) {
+            // Markers lead a line, its text starts after them. The first of a
+            // doubled lead looks the same until the second comes in.
+            if(filter->line_start == pos) filter->line_start = pos + 1;
+            if(!filter->clock.lead) filter->line_stamped = true;
+            continue;
+        }
+        if(bunnyconnect_stamp_is_lead(data[i]) && filter->line_start == pos) {
+            filter->line_start = pos - 1;
+        }
+        if(data[i] == '\n') {
+            bool match = filter->glob ?
+                             filter_glob(filter->pattern, filter->line, filter->line_len) :
+                             filter_contains(filter->pattern, filter->line, filter->line_len);
+            if(match && !filter->line_lost) {
+                filter_push(filter, filter->line_start, pos - filter->line_start);
+            }
+            filter->line_start = pos + 1;
+            filter->line_lost = false;
+            filter->line_len = 0;
+            filter->line_stamped = false;
+        } else if(data[i] != '\r' && filter->line_len < FILTER_LINE_MAX) {
+            filter->line[filter->line_len++] = data[i];
+        }
+    }
+    filter->scanned += len;
+}
+
+BunnyConnectFilter* bunnyconnect_filter_alloc(void) {
+    BunnyConnectFilter* filter = malloc(sizeof(BunnyConnectFilter));
+    memset(filter, 0, sizeof(BunnyConnectFilter));
+    return filter;
+}
+
+void bunnyconnect_filter_free(BunnyConnectFilter* filter) {
+    furi_assert(filter);
+    free(filter);
+}
+
+void bunnyconnect_filter_set_pattern(BunnyConnectFilter* filter, const char* pattern) {
+    furi_assert(filter);
+    furi_assert(pattern);
+    strlcpy(filter->pattern, pattern, sizeof(filter->pattern));
+    filter->glob = strpbrk(filter->pattern, "*?") != NULL;
+    bunnyconnect_filter_reset(filter);
+}
+
+const char* bunnyconnect_filter_get_pattern(BunnyConnectFilter* filter) {
+    furi_assert(filter);
+    return filter->pattern;
+}
+
+void bunnyconnect_filter_reset(BunnyConnectFilter* filter) {
+    furi_assert(filter);
+    filter->scrollback = NULL;
+    filter->first = 0;
+    filter->count = 0;
+}
+
+void bunnyconnect_filter_update(BunnyConnectFilter* filter, BunnyConnectScrollback* scrollback) {
+    furi_assert(filter);
+    furi_assert(scrollback);
+    if(filter->pattern[0] == '\0') return;
+
+    uint32_t tail, head;
+    bunnyconnect_scrollback_get_window(scrollback, &tail, &head);
+
+    // A new ring is scanned from its oldest byte, which only starts a line at 0
+    if(filter->scrollback != scrollback) {
+        bunnyconnect_filter_reset(filter);
+        filter->scrollback = scrollback;
+        filter_skip_to(filter, tail);
+        filter->line_lost = tail != 0;
+    } else if((int32_t)(filter->scanned - tail) < 0) {
+        filter_skip_to(filter, tail);
+    } else {
+        filter_evict(filter, tail);
+    }
+
+    uint8_t chunk[FILTER_CHUNK];
+    while(filter->scanned != head) {
+        size_t len = MIN(head - filter->scanned, sizeof(chunk));
+        if(bunnyconnect_scrollback_read(scrollback, filter->scanned, chunk, len)) {
+            filter_scan(filter, chunk, len);
+        } else {
+            // The producer lapped the scan, pick up at its new tail
+            bunnyconnect_scrollback_get_window(scrollback, &tail, &head);
+            filter_skip_to(filter, tail);
+        }
+    }
+}
+
+size_t bunnyconnect_filter_get_count(BunnyConnectFilter* filter) {
+    furi_assert(filter);
+    return filter->count;
+}
+
+bool bunnyconnect_filter_get_line(
+    BunnyConnectFilter* filter,
+    size_t back,
+    uint32_t* start,
+    uint32_t* len) {
+    furi_assert(filter);
+    furi_assert(start);
+    furi_assert(len);
+    if(!filter->scrollback || back >= filter->count) return false;
+
+    uint32_t index = filter->first + filter->count - 1 - back;
+    const FilterLine* line = &filter->lines[index & FILTER_MASK];
+    *start = line->start;
+    *len = line->len;
+    return true;
+}
+
+size_t bunnyconnect_filter_render(BunnyConnectFilter* filter, char* out, size_t size) {
+    furi_assert(filter);
+    furi_assert(out);
+    furi_assert(size > 0);
+    out[0] = '\0';
+    if(!filter->scrollback) return 0;
+
+    // Walk back from the newest match to find how many lines fit, stamped
+    // lines are copied with an absolute marker since their deltas are left out
+    uint32_t from = filter->count;
+    size_t total = 0;
+    while(from > 0) {
+        const FilterLine* line = &filter->lines[(filter->first + from - 1) & FILTER_MASK];
+        size_t line_size = line->len + 1 + (line->stamped ? BUNNYCONNECT_STAMP_MAX : 0);
+        if(total + line_size >= size) break;
+        total += line_size;
+        from--;
+    }
+
+    size_t len = 0;
+    for(uint32_t i = from; i < filter->count; i++) {
+        const FilterLine* line = &filter->lines[(filter->first + i) & FILTER_MASK];
+        size_t marker = 0;
+        if(line->stamped) {
+            marker =
+                bunnyconnect_stamp_encode(BUNNYCONNECT_STAMP_ABS, line->ms, (uint8_t*)out + len);
+        }
+        if(bunnyconnect_scrollback_read(
+               filter->scrollback, line->start, (uint8_t*)out + len + marker, line->len)) {
+            len += marker + line->len;
+            out[len++] = '\n';
+        }
+    }
+    out[len] = '\0';
+    return len;
+}
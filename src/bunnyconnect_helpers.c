@@ -1,21 +1,22 @@
 #include "../lib/bunnyconnect_helpers.h"
+#include "../lib/bunnyconnect_usb.h"
 #include <furi.h>
 #include <furi_hal_usb_hid.h>
 
 void bunnyconnect_send_key_press(uint16_t key) {
-    if(furi_hal_hid_is_connected()) {
-        furi_hal_hid_kb_press(key);
+    if(bunnyconnect_usb_hid_is_connected()) {
+        bunnyconnect_usb_hid_kb_press(key);
     }
 }
 
 void bunnyconnect_send_key_release(uint16_t key) {
-    if(furi_hal_hid_is_connected()) {
-        furi_hal_hid_kb_release(key);
+    if(bunnyconnect_usb_hid_is_connected()) {
+        bunnyconnect_usb_hid_kb_release(key);
     }
 }
 
 void bunnyconnect_send_string(const char* string) {
-    if(!string || !furi_hal_hid_is_connected()) return;
+    if(!string || !bunnyconnect_usb_hid_is_connected()) return;
 
     size_t len = strlen(string);
     for(size_t i = 0; i < len; i++) {
@@ -30,7 +31,7 @@ void bunnyconnect_send_string(const char* string) {
 }
 
 void bunnyconnect_send_enter(void) {
-    if(furi_hal_hid_is_connected()) {
+    if(bunnyconnect_usb_hid_is_connected()) {
         bunnyconnect_send_key_press(HID_KEYBOARD_RETURN);
         furi_delay_ms(10);
         bunnyconnect_send_key_release(HID_KEYBOARD_RETURN);
@@ -38,7 +39,7 @@ void bunnyconnect_send_enter(void) {
 }
 
 void bunnyconnect_send_backspace(void) {
-    if(furi_hal_hid_is_connected()) {
+    if(bunnyconnect_usb_hid_is_connected()) {
         bunnyconnect_send_key_press(HID_KEYBOARD_DELETE);
         furi_delay_ms(10);
         bunnyconnect_send_key_release(HID_KEYBOARD_DELETE);
@@ -0,0 +1,109 @@
+#include "../lib/bunnyconnect_histogram.h"
+#include <furi.h>
+#include <furi_hal_cortex.h>
+#include <stdatomic.h>
+
+#define HISTOGRAM_FORMAT_VERSION 1
+
+static atomic_uint_least32_t histograms[BunnyConnectHistogramCount]
+                                       [BUNNYCONNECT_HISTOGRAM_BUCKETS];
+static uint32_t rx_last_cycles; // Worker only
+static atomic_bool rx_primed;
+
+static const char* const histogram_names[BunnyConnectHistogramCount] = {
+    [BunnyConnectHistogramRxSize] = "rx_size",
+    [BunnyConnectHistogramRxGap] = "rx_gap_us",
+};
+
+static size_t histogram_bucket(uint32_t value) {
+    if(value == 0) return 0;
+    size_t bucket = 32 - __builtin_clz(value); // 1 -> 1, 2..3 -> 2, 4..7 -> 3
+    return MIN(bucket, (size_t)BUNNYCONNECT_HISTOGRAM_BUCKETS - 1);
+}
+
+static void histogram_add(BunnyConnectHistogram histogram, uint32_t value) {
+    atomic_fetch_add_explicit(
+        &histograms[histogram][histogram_bucket(value)], 1, memory_order_relaxed);
+}
+
+void bunnyconnect_histogram_rx_chunk(size_t size) {
+    uint32_t now = furi_hal_cortex_timer_get(0).start; // DWT cycle counter
+    histogram_add(BunnyConnectHistogramRxSize, size);
+
+    // Wraps after about a minute at 64 MHz, longer silences read as shorter
+    if(atomic_exchange_explicit(&rx_primed, true, memory_order_relaxed)) {
+        histogram_add(
+            BunnyConnectHistogramRxGap,
+            (now - rx_last_cycles) / furi_hal_cortex_instructions_per_microsecond());
+    }
+    rx_last_cycles = now;
+}
+
+void bunnyconnect_histogram_reset(void) {
+    for(size_t h = 0; h < BunnyConnectHistogramCount; h++) {
+        for(size_t i = 0; i < BUNNYCONNECT_HISTOGRAM_BUCKETS; i++) {
+            atomic_store_explicit(&histograms[h][i], 0, memory_order_relaxed);
+        }
+    }
+    atomic_store_explicit(&rx_primed, false, memory_order_relaxed);
+}
+
+void bunnyconnect_histogram_snapshot(BunnyConnectHistogram histogram, uint32_t* counts) {
+    furi_assert(histogram < BunnyConnectHistogramCount);
+    furi_assert(counts);
+    for(size_t i = 0; i < BUNNYCONNECT_HISTOGRAM_BUCKETS; i++) {
+        counts[i] = atomic_load_explicit(&histograms[histogram][i], memory_order_relaxed);
+    }
+}
+
+const char* bunnyconnect_histogram_name(BunnyConnectHistogram histogram) {
+    return histogram < BunnyConnectHistogramCount ? histogram_names[histogram] : "?";
+}
+
+uint32_t bunnyconnect_histogram_bucket_limit(size_t bucket) {
+    return bucket + 1 < BUNNYCONNECT_HISTOGRAM_BUCKETS ? 1UL << bucket : UINT32_MAX;
+}
+
+size_t bunnyconnect_histogram_percentile(const uint32_t* counts, uint8_t percent) {
+    furi_assert(counts);
+    uint64_t total = 0;
+    for(size_t i = 0; i < BUNNYCONNECT_HISTOGRAM_BUCKETS; i++) {
+        total += counts[i];
+    }
+
+    // Smallest bucket with at least percent of the samples at or below it
+    uint64_t target = (total * percent + 99) / 100;
+    uint64_t seen = 0;
+    for(size_t i = 0; i < BUNNYCONNECT_HISTOGRAM_BUCKETS; i++) {
+        seen += counts[i];
+        if(seen >= target && seen > 0) return i;
+    }
+    return 0;
+}
+
+size_t bunnyconnect_histogram_format(
+    BunnyConnectHistogram histogram,
+    const uint32_t* counts,
+    uint32_t uptime_ms,
+    char* out,
+    size_t size) {
+    furi_assert(counts);
+    furi_assert(out);
+    furi_assert(size > 0);
+
+    int len = snprintf(
+        out,
+        size,
+        "BCHIST v=%d up_ms=%lu name=%s counts=",
+        HISTOGRAM_FORMAT_VERSION,
+        uptime_ms,
+        bunnyconnect_histogram_name(histogram));
+    for(size_t i = 0; i < BUNNYCONNECT_HISTOGRAM_BUCKETS && len >= 0 && (size_t)len < size;
+        i++) {
+        len += snprintf(out + len, size - len, i ? ",%lu" : "%lu", counts[i]);
+    }
+    if(len >= 0 && (size_t)len < size) {
+        len += snprintf(out + len, size - len, "\r\n");
+    }
+    return len < 0 ? 0 : MIN((size_t)len, size - 1);
+}
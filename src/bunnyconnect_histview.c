@@ -0,0 +1,192 @@
+#include "../lib/bunnyconnect_histview.h"
+#include "../lib/bunnyconnect_trace.h"
+#include <furi.h>
+
+#define HISTVIEW_HEADER_HEIGHT 11
+#define HISTVIEW_BAR_WIDTH     5
+#define HISTVIEW_BARS_X        ((128 - BUNNYCONNECT_HISTOGRAM_BUCKETS * HISTVIEW_BAR_WIDTH) / 2)
+#define HISTVIEW_BARS_BOTTOM   45
+#define HISTVIEW_BARS_HEIGHT   (HISTVIEW_BARS_BOTTOM - HISTVIEW_HEADER_HEIGHT - 1)
+
+struct BunnyConnectHistView {
+    View* view;
+    BunnyConnectHistViewCallback callback;
+    void* context;
+};
+
+typedef struct {
+    uint32_t counts[BunnyConnectHistogramCount][BUNNYCONNECT_HISTOGRAM_BUCKETS];
+    BunnyConnectHistogram page;
+} BunnyConnectHistViewModel;
+
+static const char* const histview_titles[BunnyConnectHistogramCount] = {
+    [BunnyConnectHistogramRxSize] = "RX chunk size",
+    [BunnyConnectHistogramRxGap] = "RX chunk gap",
+};
+
+// Bucket limits are powers of two, 1024 reads as 1k or 1ms
+static void histview_format_value(
+    char* out,
+    size_t size,
+    BunnyConnectHistogram histogram,
+    uint32_t value) {
+    if(histogram == BunnyConnectHistogramRxGap) {
+        if(value < 1000) {
+            snprintf(out, size, "%luus", value);
+        } else if(value < 1000000) {
+            snprintf(out, size, "%lums", value / 1000);
+        } else {
+            snprintf(out, size, "%lus", value / 1000000);
+        }
+    } else if(value < 1024) {
+        snprintf(out, size, "%lu", value);
+    } else if(value < 1024 * 1024) {
+        snprintf(out, size, "%luk", value / 1024);
+    } else {
+        snprintf(out, size, "%luM", value / (1024 * 1024));
+    }
+}
+
+static void bunnyconnect_histview_draw_callback(Canvas* canvas, void* _model) {
+    BunnyConnectHistViewModel* model = _model;
+    const uint32_t* counts = model->counts[model->page];
+    char text[40];
+    char p50[8];
+    char p99[8];
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawBegin, BunnyConnectTraceViewHistogram);
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 9, histview_titles[model->page]);
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(canvas, 126, 9, AlignRight, AlignBottom, "OK: dump");
+    canvas_draw_line(canvas, 0, HISTVIEW_HEADER_HEIGHT - 1, 127, HISTVIEW_HEADER_HEIGHT - 1);
+
+    uint32_t peak = 1;
+    uint32_t total = 0;
+    for(size_t i = 0; i < BUNNYCONNECT_HISTOGRAM_BUCKETS; i++) {
+        peak = MAX(peak, counts[i]);
+        total += counts[i];
+    }
+
+    // Non-empty buckets get at least one pixel so rare sizes stay visible
+    canvas_draw_line(
+        canvas,
+        HISTVIEW_BARS_X,
+        HISTVIEW_BARS_BOTTOM + 1,
+        HISTVIEW_BARS_X + BUNNYCONNECT_HISTOGRAM_BUCKETS * HISTVIEW_BAR_WIDTH - 2,
+        HISTVIEW_BARS_BOTTOM + 1);
+    for(size_t i = 0; i < BUNNYCONNECT_HISTOGRAM_BUCKETS; i++) {
+        if(!counts[i]) continue;
+        uint32_t height = MAX((uint64_t)counts[i] * HISTVIEW_BARS_HEIGHT / peak, 1ULL);
+        canvas_draw_box(
+            canvas,
+            HISTVIEW_BARS_X + i * HISTVIEW_BAR_WIDTH,
+            HISTVIEW_BARS_BOTTOM - height + 1,
+            HISTVIEW_BAR_WIDTH - 1,
+            height);
+    }
+
+    // Axis labels at 1, 1k and 1M, the lower bounds of buckets 1, 11 and 21
+    static const size_t ticks[] = {1, 11, 21};
+    for(size_t i = 0; i < COUNT_OF(ticks); i++) {
+        histview_format_value(text, sizeof(text), model->page, 1UL << (ticks[i] - 1));
+        canvas_draw_str_aligned(
+            canvas,
+            HISTVIEW_BARS_X + ticks[i] * HISTVIEW_BAR_WIDTH,
+            54,
+            AlignLeft,
+            AlignBottom,
+            text);
+    }
+
+    histview_format_value(
+        p50,
+        sizeof(p50),
+        model->page,
+        bunnyconnect_histogram_bucket_limit(bunnyconnect_histogram_percentile(counts, 50)));
+    histview_format_value(
+        p99,
+        sizeof(p99),
+        model->page,
+        bunnyconnect_histogram_bucket_limit(bunnyconnect_histogram_percentile(counts, 99)));
+    snprintf(text, sizeof(text), "n=%lu p50<%s p99<%s", total, p50, p99);
+    canvas_draw_str(canvas, 2, 63, text);
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawEnd, BunnyConnectTraceViewHistogram);
+}
+
+static bool bunnyconnect_histview_input_callback(InputEvent* event, void* context) {
+    BunnyConnectHistView* histview = context;
+    furi_assert(histview);
+
+    if(event->type != InputTypeShort) return false;
+
+    if(event->key == InputKeyOk) {
+        if(histview->callback) histview->callback(histview->context);
+        return true;
+    }
+    if(event->key != InputKeyLeft && event->key != InputKeyRight) return false;
+
+    with_view_model(
+        histview->view,
+        BunnyConnectHistViewModel * model,
+        {
+            size_t step = event->key == InputKeyRight ? 1 : BunnyConnectHistogramCount - 1;
+            model->page = (model->page + step) % BunnyConnectHistogramCount;
+        },
+        true);
+    return true;
+}
+
+BunnyConnectHistView* bunnyconnect_histview_alloc(void) {
+    BunnyConnectHistView* histview = malloc(sizeof(BunnyConnectHistView));
+    histview->callback = NULL;
+    histview->context = NULL;
+    histview->view = view_alloc();
+    view_set_context(histview->view, histview);
+    view_allocate_model(histview->view, ViewModelTypeLocking, sizeof(BunnyConnectHistViewModel));
+    view_set_draw_callback(histview->view, bunnyconnect_histview_draw_callback);
+    view_set_input_callback(histview->view, bunnyconnect_histview_input_callback);
+
+    with_view_model(
+        histview->view,
+        BunnyConnectHistViewModel * model,
+        { memset(model, 0, sizeof(BunnyConnectHistViewModel)); },
+        false);
+    return histview;
+}
+
+void bunnyconnect_histview_free(BunnyConnectHistView* histview) {
+    furi_assert(histview);
+    view_free(histview->view);
+    free(histview);
+}
+
+View* bunnyconnect_histview_get_view(BunnyConnectHistView* histview) {
+    furi_assert(histview);
+    return histview->view;
+}
+
+void bunnyconnect_histview_set_dump_callback(
+    BunnyConnectHistView* histview,
+    BunnyConnectHistViewCallback callback,
+    void* context) {
+    furi_assert(histview);
+    histview->callback = callback;
+    histview->context = context;
+}
+
+void bunnyconnect_histview_update(
+    BunnyConnectHistView* histview,
+    BunnyConnectHistogram histogram,
+    const uint32_t* counts) {
+    furi_assert(histview);
+    furi_assert(histogram < BunnyConnectHistogramCount);
+    furi_assert(counts);
+    with_view_model(
+        histview->view,
+        BunnyConnectHistViewModel * model,
+        { memcpy(model->counts[histogram], counts, sizeof(model->counts[histogram])); },
+        true);
+}
@@ -1,4 +1,6 @@
 #include "../lib/bunnyconnect_keyboard.h"
+#include "../lib/bunnyconnect_usb.h"
+#include "../lib/bunnyconnect_trace.h"
 #include <gui/elements.h>
 #include <gui/modules/widget.h>
 #include <furi.h>
@@ -52,7 +54,7 @@ static const uint8_t keyboard_count = 2;
 
 #define ENTER_KEY           '\r'
 #define BACKSPACE_KEY       '\b'
-#define SWITCH_KEYBOARD_KEY 0xfe
+#define SWITCH_KEYBOARD_KEY ((char)0xfe) // Key text is a plain char, signed on the host
 
 static const BunnyConnectKeyboardKey keyboard_keys_row_1[] = {
     {'q', 1, 8},
@@ -240,6 +242,25 @@ static char char_to_uppercase(const char letter) {
     }
 }
 
+bool bunnyconnect_keyboard_text_insert(char* text, size_t size, size_t* cursor, char c) {
+    size_t len = strlen(text);
+    if(*cursor > len || len + 1 >= size) return false;
+
+    memmove(text + *cursor + 1, text + *cursor, len - *cursor + 1);
+    text[*cursor] = c;
+    (*cursor)++;
+    return true;
+}
+
+bool bunnyconnect_keyboard_text_backspace(char* text, size_t* cursor) {
+    size_t len = strlen(text);
+    if(*cursor == 0 || *cursor > len) return false;
+
+    memmove(text + *cursor - 1, text + *cursor, len - *cursor + 1);
+    (*cursor)--;
+    return true;
+}
+
 static void bunnyconnect_keyboard_backspace_cb(BunnyConnectKeyboardModel* model) {
     if(model == NULL || model->text_buffer == NULL) return;
 
@@ -248,12 +269,8 @@ static void bunnyconnect_keyboard_backspace_cb(BunnyConnectKeyboardModel* model)
             model->text_buffer[0] = 0;
         }
         model->cursor_pos = 0;
-    } else if(model->cursor_pos > 0) {
-        char* move = model->text_buffer + model->cursor_pos;
-        if(move && strlen(move) + 1 <= model->text_buffer_size - model->cursor_pos + 1) {
-            memmove(move - 1, move, strlen(move) + 1);
-            model->cursor_pos--;
-        }
+    } else {
+        bunnyconnect_keyboard_text_backspace(model->text_buffer, &model->cursor_pos);
     }
 }
 
@@ -265,6 +282,7 @@ static void bunnyconnect_keyboard_view_draw_callback(Canvas* canvas, void* _mode
 
     model->cursor_pos = model->cursor_pos > text_length ? text_length : model->cursor_pos;
     size_t cursor_pos = model->cursor_pos;
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawBegin, BunnyConnectTraceViewKeyboard);
 
     canvas_clear(canvas);
     canvas_set_color(canvas, ColorBlack);
@@ -413,6 +431,7 @@ static void bunnyconnect_keyboard_view_draw_callback(Canvas* canvas, void* _mode
             canvas, 62, 20, AlignCenter, AlignCenter, furi_string_get_cstr(model->validator_text));
         canvas_set_font(canvas, FontKeyboard);
     }
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawEnd, BunnyConnectTraceViewKeyboard);
 }
 
 static void bunnyconnect_keyboard_handle_up(
@@ -563,12 +582,8 @@ static void bunnyconnect_keyboard_handle_ok(
                     }
                     model->cursor_pos = 1;
                 } else {
-                    char* move = model->text_buffer + model->cursor_pos;
-                    if(move && model->cursor_pos + strlen(move) + 1 < model->text_buffer_size) {
-                        memmove(move + 1, move, strlen(move) + 1);
-                        model->text_buffer[model->cursor_pos] = selected;
-                        model->cursor_pos++;
-                    }
+                    bunnyconnect_keyboard_text_insert(
+                        model->text_buffer, model->text_buffer_size, &model->cursor_pos, selected);
                 }
             }
         }
@@ -827,25 +842,35 @@ void bunnyconnect_keyboard_set_header_text(BunnyConnectKeyboard* keyboard, const
         keyboard->view, BunnyConnectKeyboardModel * model, { model->header = text; }, true);
 }
 
+void bunnyconnect_keyboard_render(BunnyConnectKeyboard* keyboard, Canvas* canvas) {
+    furi_assert(keyboard);
+    furi_assert(canvas);
+    with_view_model(
+        keyboard->view,
+        BunnyConnectKeyboardModel * model,
+        { bunnyconnect_keyboard_view_draw_callback(canvas, model); },
+        false);
+}
+
 void bunnyconnect_keyboard_send_key(BunnyConnectKeyboard* keyboard, uint16_t key) {
     UNUSED(keyboard);
-    if(furi_hal_hid_is_connected()) {
-        furi_hal_hid_kb_press(key);
+    if(bunnyconnect_usb_hid_is_connected()) {
+        bunnyconnect_usb_hid_kb_press(key);
         furi_delay_ms(10);
-        furi_hal_hid_kb_release(key);
+        bunnyconnect_usb_hid_kb_release(key);
     }
 }
 
 void bunnyconnect_keyboard_send_string(BunnyConnectKeyboard* keyboard, const char* string) {
     UNUSED(keyboard);
-    if(!string || !furi_hal_hid_is_connected()) return;
+    if(!string || !bunnyconnect_usb_hid_is_connected()) return;
 
     for(size_t i = 0; i < strlen(string); i++) {
         uint16_t key = HID_ASCII_TO_KEY(string[i]);
         if(key != HID_KEYBOARD_NONE) {
-            furi_hal_hid_kb_press(key);
+            bunnyconnect_usb_hid_kb_press(key);
             furi_delay_ms(10);
-            furi_hal_hid_kb_release(key);
+            bunnyconnect_usb_hid_kb_release(key);
             furi_delay_ms(10);
         }
     }
@@ -0,0 +1,120 @@
+#include "../lib/bunnyconnect_link.h"
+#include <furi.h>
+
+#define TAG "BunnyLink"
+
+struct BunnyConnectLink {
+    volatile BunnyConnectLinkState state;
+    bool dtr_seen; // DTR went high since the link came up
+    uint32_t down_since;
+    uint32_t next_reset;
+
+    volatile uint32_t drops;
+    volatile uint32_t attempts;
+    volatile uint32_t backoff_ms;
+    volatile uint32_t down_ms;
+    volatile uint32_t reconnect_ms;
+};
+
+static const char* const link_state_names[] = {
+    [BunnyConnectLinkStateUp] = "Up",
+    [BunnyConnectLinkStateDown] = "Down",
+    [BunnyConnectLinkStateReconnecting] = "Retry",
+};
+
+static void link_go_down(BunnyConnectLink* link, BunnyConnectLinkState state, uint32_t now) {
+    link->state = state;
+    link->dtr_seen = false;
+    link->down_since = now;
+    link->down_ms = 0;
+    link->attempts = 0;
+    link->backoff_ms = BUNNYCONNECT_LINK_BACKOFF_MIN_MS;
+    link->next_reset = now + furi_ms_to_ticks(link->backoff_ms);
+    link->drops++;
+
+    FURI_LOG_W(TAG, "Link lost (%s)", link_state_names[state]);
+}
+
+BunnyConnectLink* bunnyconnect_link_alloc(void) {
+    BunnyConnectLink* link = malloc(sizeof(BunnyConnectLink));
+    memset(link, 0, sizeof(BunnyConnectLink));
+    link->state = BunnyConnectLinkStateUp;
+    return link;
+}
+
+void bunnyconnect_link_free(BunnyConnectLink* link) {
+    if(!link) return;
+    free(link);
+}
+
+BunnyConnectLinkAction
+    bunnyconnect_link_update(BunnyConnectLink* link, bool configured, bool dtr, uint32_t now) {
+    furi_assert(link);
+
+    switch(link->state) {
+    case BunnyConnectLinkStateUp:
+        if(!configured) {
+            link_go_down(link, BunnyConnectLinkStateReconnecting, now);
+        } else if(dtr) {
+            link->dtr_seen = true;
+        } else if(link->dtr_seen) {
+            link_go_down(link, BunnyConnectLinkStateDown, now);
+        }
+        return BunnyConnectLinkActionNone;
+
+    case BunnyConnectLinkStateDown:
+    case BunnyConnectLinkStateReconnecting:
+        link->down_ms = now - link->down_since;
+
+        if(configured && (dtr || link->state == BunnyConnectLinkStateReconnecting)) {
+            link->state = BunnyConnectLinkStateUp;
+            link->dtr_seen = dtr;
+            link->reconnect_ms = link->down_ms;
+            link->down_ms = 0;
+            FURI_LOG_I(
+                TAG,
+                "Link restored after %lu ms, %lu resets",
+                link->reconnect_ms,
+                link->attempts);
+            return BunnyConnectLinkActionNone;
+        }
+
+        if(!configured) {
+            link->state = BunnyConnectLinkStateReconnecting;
+            if((int32_t)(now - link->next_reset) >= 0) {
+                link->attempts++;
+                link->backoff_ms *= 2;
+                if(link->backoff_ms > BUNNYCONNECT_LINK_BACKOFF_MAX_MS) {
+                    link->backoff_ms = BUNNYCONNECT_LINK_BACKOFF_MAX_MS;
+                }
+                link->next_reset = now + furi_ms_to_ticks(link->backoff_ms);
+                return BunnyConnectLinkActionReset;
+            }
+        }
+        return BunnyConnectLinkActionNone;
+
+    default:
+        return BunnyConnectLinkActionNone;
+    }
+}
+
+bool bunnyconnect_link_is_up(BunnyConnectLink* link) {
+    furi_assert(link);
+    return link->state == BunnyConnectLinkStateUp;
+}
+
+void bunnyconnect_link_get_status(BunnyConnectLink* link, BunnyConnectLinkStatus* status) {
+    furi_assert(link);
+    furi_assert(status);
+
+    status->state = link->state;
+    status->drops = link->drops;
+    status->attempts = link->attempts;
+    status->backoff_ms = link->backoff_ms;
+    status->down_ms = link->down_ms;
+    status->reconnect_ms = link->reconnect_ms;
+}
+
+const char* bunnyconnect_link_state_name(BunnyConnectLinkState state) {
+    return state <= BunnyConnectLinkStateReconnecting ? link_state_names[state] : "?";
+}
@@ -0,0 +1,374 @@
+#include "../lib/bunnyconnect_output.h"
+#include "../lib/bunnyconnect_helpers.h"
+#include "../lib/bunnyconnect_cdc.h"
+#include "../lib/bunnyconnect_counters.h"
+#include <furi.h>
+#include <furi_hal_usb_cdc.h>
+#include <furi_hal_usb_hid.h>
+
+#define TAG "BunnyOutput"
+
+#define OUTPUT_CHUNK_SIZE       CDC_DATA_SZ
+#define OUTPUT_WORKER_POLL_MS   50
+#define OUTPUT_WORKER_STACK     1024
+#define OUTPUT_HID_KEY_DELAY    10
+#define OUTPUT_WORKER_FLAG_STOP (1UL << 0)
+
+typedef struct OutputChannel OutputChannel;
+typedef void (*OutputSink)(OutputChannel* channel, const uint8_t* data, size_t size);
+
+struct OutputChannel {
+    BunnyConnectOutput* output;
+    FuriStreamBuffer* queue;
+    FuriThread* worker;
+    OutputSink sink;
+    size_t capacity;
+
+    bool enabled;
+    BunnyConnectLineEnding line_ending;
+
+    // Written by the producer
+    size_t high_water;
+    uint32_t bytes_dropped;
+
+    // Written by the worker
+    volatile uint32_t bytes_sent;
+    volatile uint32_t drain_rate;
+    uint32_t window_start;
+    uint32_t window_bytes;
+    bool hid_last_cr;
+};
+
+struct BunnyConnectOutput {
+    OutputChannel channels[BunnyConnectOutputCount];
+    BunnyConnectCdc* cdc;
+    volatile bool cdc_online; // Cleared while the link is down, CDC queue holds data
+};
+
+static const char* const output_line_endings[BunnyConnectLineEndingCount] = {
+    [BunnyConnectLineEndingLf] = "\n",
+    [BunnyConnectLineEndingCr] = "\r",
+    [BunnyConnectLineEndingCrLf] = "\r\n",
+    [BunnyConnectLineEndingNone] = "",
+};
+
+static const char* const output_line_ending_names[BunnyConnectLineEndingCount] = {
+    [BunnyConnectLineEndingLf] = "LF",
+    [BunnyConnectLineEndingCr] = "CR",
+    [BunnyConnectLineEndingCrLf] = "CRLF",
+    [BunnyConnectLineEndingNone] = "None",
+};
+
+static const char* const output_route_names[BunnyConnectOutputRouteCount] = {
+    [BunnyConnectOutputRouteBoth] = "CDC+HID",
+    [BunnyConnectOutputRouteCdc] = "CDC",
+    [BunnyConnectOutputRouteHid] = "HID",
+};
+
+static bool output_worker_should_stop(void) {
+    return furi_thread_flags_get() & OUTPUT_WORKER_FLAG_STOP;
+}
+
+static void output_sink_cdc(OutputChannel* channel, const uint8_t* data, size_t size) {
+    bunnyconnect_counters_add(BunnyConnectCounterTxChunks, 1);
+
+    // Packetizing happens in the CDC TX ring, wait here while it is full
+    while(size > 0 && !output_worker_should_stop()) {
+        // Link down: hold this chunk, the rest stays in the bounded queue
+        if(!channel->output->cdc_online) {
+            furi_delay_ms(OUTPUT_WORKER_POLL_MS);
+            continue;
+        }
+        size_t written =
+            bunnyconnect_cdc_write(channel->output->cdc, data, size, OUTPUT_WORKER_POLL_MS);
+        // Not configured by the host, the write gives up at once: wait for it instead
+        if(written == 0) {
+            bunnyconnect_cdc_wait_ready(channel->output->cdc, false, OUTPUT_WORKER_POLL_MS);
+        }
+        data += written;
+        size -= written;
+        bunnyconnect_counters_add(BunnyConnectCounterTxBytes, written);
+    }
+}
+
+static void output_sink_hid(OutputChannel* channel, const uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size && !output_worker_should_stop(); i++) {
+        uint16_t key;
+        if(data[i] == '\r') {
+            key = HID_KEYBOARD_RETURN;
+        } else if(data[i] == '\n') {
+            // CRLF types a single Enter
+            key = channel->hid_last_cr ? HID_KEYBOARD_NONE : HID_KEYBOARD_RETURN;
+        } else {
+            key = bunnyconnect_char_to_hid_key(data[i]);
+        }
+        channel->hid_last_cr = data[i] == '\r';
+
+        if(key != HID_KEYBOARD_NONE) {
+            bunnyconnect_send_key_press(key);
+            furi_delay_ms(OUTPUT_HID_KEY_DELAY);
+            bunnyconnect_send_key_release(key);
+            furi_delay_ms(OUTPUT_HID_KEY_DELAY);
+        }
+    }
+}
+
+static int32_t output_worker_thread(void* context) {
+    OutputChannel* channel = context;
+    uint8_t buffer[OUTPUT_CHUNK_SIZE];
+    uint32_t window = furi_kernel_get_tick_frequency();
+
+    channel->window_start = furi_get_tick();
+
+    while(!output_worker_should_stop()) {
+        size_t size = furi_stream_buffer_receive(
+            channel->queue, buffer, sizeof(buffer), OUTPUT_WORKER_POLL_MS);
+
+        if(size > 0) {
+            channel->sink(channel, buffer, size);
+            channel->bytes_sent += size;
+            channel->window_bytes += size;
+        }
+
+        uint32_t elapsed = furi_get_tick() - channel->window_start;
+        if(elapsed >= window) {
+            channel->drain_rate = (uint64_t)channel->window_bytes * window / elapsed;
+            channel->window_start += elapsed;
+            channel->window_bytes = 0;
+        }
+    }
+
+    return 0;
+}
+
+static void output_channel_init(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    const char* name,
+    size_t capacity,
+    OutputSink sink) {
+    OutputChannel* channel = &output->channels[destination];
+
+    channel->output = output;
+    channel->sink = sink;
+    channel->capacity = capacity;
+    channel->enabled = true;
+    channel->line_ending = BunnyConnectLineEndingLf;
+    channel->queue = furi_stream_buffer_alloc(capacity, 1);
+
+    channel->worker = furi_thread_alloc();
+    furi_thread_set_name(channel->worker, name);
+    furi_thread_set_stack_size(channel->worker, OUTPUT_WORKER_STACK);
+    furi_thread_set_context(channel->worker, channel);
+    furi_thread_set_callback(channel->worker, output_worker_thread);
+    furi_thread_start(channel->worker);
+}
+
+static void output_channel_deinit(OutputChannel* channel) {
+    furi_thread_flags_set(furi_thread_get_id(channel->worker), OUTPUT_WORKER_FLAG_STOP);
+    furi_thread_join(channel->worker);
+    furi_thread_free(channel->worker);
+    furi_stream_buffer_free(channel->queue);
+}
+
+// Per-channel peak plus the global gauge for the stats view
+static void output_channel_track_depth(OutputChannel* channel) {
+    size_t depth = furi_stream_buffer_bytes_available(channel->queue);
+    if(depth > channel->high_water) {
+        channel->high_water = depth;
+        bunnyconnect_counters_max(
+            channel == &channel->output->channels[BunnyConnectOutputCdc] ?
+                BunnyConnectCounterCdcQueuePeak :
+                BunnyConnectCounterHidQueuePeak,
+            depth);
+    }
+}
+
+// The queue has one producer, space checked here is still there for the sends
+static bool output_channel_push(
+    OutputChannel* channel,
+    const uint8_t* data,
+    size_t size,
+    const char* line_ending) {
+    size_t total = size + strlen(line_ending);
+    if(total == 0) return true;
+
+    // All or nothing, a partial line would run into the next one
+    if(total > furi_stream_buffer_spaces_available(channel->queue)) {
+        channel->bytes_dropped += total;
+        bunnyconnect_counters_add(BunnyConnectCounterTxDropped, total);
+        return false;
+    }
+
+    if(size) furi_stream_buffer_send(channel->queue, data, size, 0);
+    if(total > size) furi_stream_buffer_send(channel->queue, line_ending, total - size, 0);
+    output_channel_track_depth(channel);
+    return true;
+}
+
+BunnyConnectOutput* bunnyconnect_output_alloc(BunnyConnectCdc* cdc) {
+    furi_assert(cdc);
+    BunnyConnectOutput* output = malloc(sizeof(BunnyConnectOutput));
+    memset(output, 0, sizeof(BunnyConnectOutput));
+    output->cdc = cdc;
+    output->cdc_online = true;
+
+    output_channel_init(
+        output,
+        BunnyConnectOutputCdc,
+        "BunnyOutCdc",
+        BUNNYCONNECT_OUTPUT_CDC_QUEUE_SIZE,
+        output_sink_cdc);
+    output_channel_init(
+        output,
+        BunnyConnectOutputHid,
+        "BunnyOutHid",
+        BUNNYCONNECT_OUTPUT_HID_QUEUE_SIZE,
+        output_sink_hid);
+
+    return output;
+}
+
+void bunnyconnect_output_free(BunnyConnectOutput* output) {
+    if(!output) return;
+
+    for(size_t i = 0; i < BunnyConnectOutputCount; i++) {
+        output_channel_deinit(&output->channels[i]);
+    }
+
+    free(output);
+}
+
+void bunnyconnect_output_set_online(BunnyConnectOutput* output, bool online) {
+    furi_assert(output);
+    output->cdc_online = online;
+}
+
+bool bunnyconnect_output_route_has(
+    BunnyConnectOutputRoute route,
+    BunnyConnectOutputDestination destination) {
+    switch(destination) {
+    case BunnyConnectOutputCdc:
+        return route != BunnyConnectOutputRouteHid;
+    case BunnyConnectOutputHid:
+        return route != BunnyConnectOutputRouteCdc;
+    default:
+        return false;
+    }
+}
+
+void bunnyconnect_output_set_route(BunnyConnectOutput* output, BunnyConnectOutputRoute route) {
+    furi_assert(output);
+    for(size_t i = 0; i < BunnyConnectOutputCount; i++) {
+        output->channels[i].enabled = bunnyconnect_output_route_has(route, i);
+    }
+}
+
+void bunnyconnect_output_set_line_ending(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    BunnyConnectLineEnding line_ending) {
+    furi_assert(output);
+    furi_assert(destination < BunnyConnectOutputCount);
+    furi_assert(line_ending < BunnyConnectLineEndingCount);
+    output->channels[destination].line_ending = line_ending;
+}
+
+static bool output_channel_send(
+    OutputChannel* channel,
+    const uint8_t* data,
+    size_t size,
+    bool line) {
+    return output_channel_push(
+        channel, data, size, line ? output_line_endings[channel->line_ending] : "");
+}
+
+bool bunnyconnect_output_send(
+    BunnyConnectOutput* output,
+    const uint8_t* data,
+    size_t size,
+    bool line) {
+    furi_assert(output);
+    bool complete = true;
+
+    for(size_t i = 0; i < BunnyConnectOutputCount; i++) {
+        OutputChannel* channel = &output->channels[i];
+        if(!channel->enabled) continue;
+        complete &= output_channel_send(channel, data, size, line);
+    }
+
+    if(!complete) {
+        FURI_LOG_W(TAG, "Output queue full, data dropped");
+    }
+    return complete;
+}
+
+bool bunnyconnect_output_send_to(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    const uint8_t* data,
+    size_t size,
+    bool line) {
+    furi_assert(output);
+    furi_assert(destination < BunnyConnectOutputCount);
+
+    bool complete = output_channel_send(&output->channels[destination], data, size, line);
+    if(!complete) {
+        FURI_LOG_W(TAG, "Output queue full, data dropped");
+    }
+    return complete;
+}
+
+bool bunnyconnect_output_has_space(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    size_t size,
+    bool line) {
+    furi_assert(output);
+    furi_assert(destination < BunnyConnectOutputCount);
+
+    OutputChannel* channel = &output->channels[destination];
+    if(line) size += strlen(output_line_endings[channel->line_ending]);
+    return size <= furi_stream_buffer_spaces_available(channel->queue);
+}
+
+size_t bunnyconnect_output_write(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    const uint8_t* data,
+    size_t size,
+    uint32_t timeout) {
+    furi_assert(output);
+    furi_assert(destination < BunnyConnectOutputCount);
+
+    OutputChannel* channel = &output->channels[destination];
+    size_t sent = furi_stream_buffer_send(channel->queue, data, size, timeout);
+
+    output_channel_track_depth(channel);
+    return sent;
+}
+
+void bunnyconnect_output_get_stats(
+    BunnyConnectOutput* output,
+    BunnyConnectOutputDestination destination,
+    BunnyConnectOutputStats* stats) {
+    furi_assert(output);
+    furi_assert(destination < BunnyConnectOutputCount);
+    furi_assert(stats);
+
+    OutputChannel* channel = &output->channels[destination];
+    stats->depth = furi_stream_buffer_bytes_available(channel->queue);
+    stats->capacity = channel->capacity;
+    stats->high_water = channel->high_water;
+    stats->bytes_sent = channel->bytes_sent;
+    stats->bytes_dropped = channel->bytes_dropped;
+    stats->drain_rate = channel->drain_rate;
+}
+
+const char* bunnyconnect_output_route_name(BunnyConnectOutputRoute route) {
+    return route < BunnyConnectOutputRouteCount ? output_route_names[route] : "?";
+}
+
+const char* bunnyconnect_output_line_ending_name(BunnyConnectLineEnding line_ending) {
+    return line_ending < BunnyConnectLineEndingCount ? output_line_ending_names[line_ending] : "?";
+}
@@ -1,32 +1,89 @@
 #include "../lib/bunnyconnect_power.h"
+#include "../lib/bunnyconnect_usb.h"
 #include <furi.h>
 #include <furi_hal_usb.h>
 #include <furi_hal_usb_cdc.h>
 
 static bool usb_power_enabled = false;
 
+// Interface active before the app took over USB, put back on deinit. NULL with
+// usb_prev_saved set means USB was off.
+static FuriHalUsbInterface* usb_prev_interface = NULL;
+static bool usb_prev_saved = false;
+static bool usb_switched = false; // The app interface was set since the capture
+
+static BunnyConnectPowerStats power_stats;
+
 void bunnyconnect_power_init(void) {
     FURI_LOG_I("BunnyPower", "Initializing USB CDC for power and communication");
-    usb_power_enabled = false;
+
+    // Called again on every Connect, only the first call sees the interface from before
+    FuriHalUsbInterface* current = furi_hal_usb_get_config();
+    if(!usb_prev_saved && current != &bunnyconnect_usb_composite) {
+        usb_prev_interface = current;
+        usb_prev_saved = true;
+        usb_switched = false;
+    }
+    usb_power_enabled = current == &bunnyconnect_usb_composite;
 }
 
 void bunnyconnect_power_deinit(void) {
-    bunnyconnect_power_set_usb_enabled(false);
-    FURI_LOG_I("BunnyPower", "USB power and communication disabled");
+    bool restore = usb_prev_saved && usb_switched;
+    usb_prev_saved = false;
+    usb_switched = false;
+    usb_power_enabled = false;
+    if(!restore) {
+        FURI_LOG_I("BunnyPower", "USB interface untouched, left as it was");
+        return;
+    }
+
+    // Hand USB back to whatever owned it before, qFlipper/CLI keep working.
+    // furi_hal_usb does not expose the active context, the stock interfaces take NULL.
+    uint32_t start = furi_get_tick();
+    furi_hal_usb_unlock();
+    if(!usb_prev_interface) {
+        furi_hal_usb_disable();
+    } else if(!furi_hal_usb_set_config(usb_prev_interface, NULL)) {
+        FURI_LOG_E("BunnyPower", "Failed to restore previous USB interface");
+        return;
+    }
+    power_stats.restore_ms = furi_get_tick() - start;
+    FURI_LOG_I(
+        "BunnyPower",
+        "USB %s in %lu ms",
+        usb_prev_interface ? "restored" : "disabled as before",
+        power_stats.restore_ms);
 }
 
 bool bunnyconnect_power_set_usb_enabled(bool enabled) {
+    uint32_t start = furi_get_tick();
+
     if(enabled) {
+        // Warm path: the composite interface is already enumerated, keep it
+        if(furi_hal_usb_get_config() == &bunnyconnect_usb_composite) {
+            usb_power_enabled = true;
+            usb_switched = true;
+            power_stats.warm = true;
+            power_stats.enable_ms = furi_get_tick() - start;
+            FURI_LOG_I("BunnyPower", "USB interface already active, skipped reconfiguration");
+            return true;
+        }
+
         // Enable USB device mode to provide power through USB port
         furi_hal_usb_unlock();
 
-        // Set to CDC mode for serial communication
-        if(furi_hal_usb_set_config(&usb_cdc_single, NULL)) {
+        // Composite CDC + HID so the terminal and keystroke injection share one link
+        if(furi_hal_usb_set_config(&bunnyconnect_usb_composite, NULL)) {
             usb_power_enabled = true;
-            FURI_LOG_I("BunnyPower", "USB CDC enabled - providing power and serial communication");
+            usb_switched = true;
+            power_stats.warm = false;
+            power_stats.enable_ms = furi_get_tick() - start;
+            FURI_LOG_I(
+                "BunnyPower",
+                "USB CDC enabled in %lu ms - providing power and serial communication",
+                power_stats.enable_ms);
 
-            // Wait for configuration to be applied
-            furi_delay_ms(500);
+            // Enumeration completes asynchronously, callers wait on CDC state events
             return true;
         } else {
             FURI_LOG_E("BunnyPower", "Failed to enable USB CDC mode");
@@ -49,3 +106,16 @@ bool bunnyconnect_power_is_usb_connected(void) {
     // Check if USB device is connected and configured
     return furi_hal_usb_get_config() != NULL && usb_power_enabled;
 }
+
+bool bunnyconnect_power_reset_usb(void) {
+    if(furi_hal_usb_get_config() != &bunnyconnect_usb_composite) return false;
+
+    furi_hal_usb_reinit();
+    FURI_LOG_I("BunnyPower", "USB re-enumeration requested");
+    return true;
+}
+
+void bunnyconnect_power_get_stats(BunnyConnectPowerStats* stats) {
+    furi_check(stats);
+    *stats = power_stats;
+}
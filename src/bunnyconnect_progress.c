@@ -0,0 +1,134 @@
+#include "../lib/bunnyconnect_progress.h"
+#include "../lib/bunnyconnect_trace.h"
+#include <gui/elements.h>
+#include <furi.h>
+
+#define PROGRESS_NAME_SIZE 32
+
+struct BunnyConnectProgress {
+    View* view;
+};
+
+typedef struct {
+    const char* header;
+    char name[PROGRESS_NAME_SIZE];
+    const char* status;
+    uint32_t done;
+    uint32_t total;
+    uint32_t rate;
+} BunnyConnectProgressModel;
+
+static void bunnyconnect_progress_format_size(char* buffer, size_t size, uint32_t bytes) {
+    if(bytes < 10 * 1024) {
+        snprintf(buffer, size, "%lu B", bytes);
+    } else {
+        snprintf(buffer, size, "%lu KB", bytes / 1024);
+    }
+}
+
+static void bunnyconnect_progress_draw_callback(Canvas* canvas, void* _model) {
+    BunnyConnectProgressModel* model = _model;
+    char done[16];
+    char total[16];
+    char line[40];
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawBegin, BunnyConnectTraceViewProgress);
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 10, model->header ? model->header : "");
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 2, 21, model->name);
+
+    float fraction = model->total ? (float)model->done / (float)model->total : 0.0f;
+    if(fraction > 1.0f) fraction = 1.0f;
+    elements_progress_bar(canvas, 2, 25, 124, fraction);
+
+    bunnyconnect_progress_format_size(done, sizeof(done), model->done);
+    if(model->total) {
+        bunnyconnect_progress_format_size(total, sizeof(total), model->total);
+        snprintf(line, sizeof(line), "%s / %s", done, total);
+    } else {
+        snprintf(line, sizeof(line), "%s", done);
+    }
+    canvas_draw_str(canvas, 2, 45, line);
+
+    snprintf(line, sizeof(line), "%lu B/s", model->rate);
+    canvas_draw_str_aligned(canvas, 126, 45, AlignRight, AlignBottom, line);
+
+    if(model->status) {
+        canvas_draw_str(canvas, 2, 57, model->status);
+    }
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawEnd, BunnyConnectTraceViewProgress);
+}
+
+BunnyConnectProgress* bunnyconnect_progress_alloc(void) {
+    BunnyConnectProgress* progress = malloc(sizeof(BunnyConnectProgress));
+    progress->view = view_alloc();
+    view_set_context(progress->view, progress);
+    view_allocate_model(progress->view, ViewModelTypeLocking, sizeof(BunnyConnectProgressModel));
+    view_set_draw_callback(progress->view, bunnyconnect_progress_draw_callback);
+
+    bunnyconnect_progress_reset(progress, "", "");
+    return progress;
+}
+
+void bunnyconnect_progress_free(BunnyConnectProgress* progress) {
+    furi_assert(progress);
+    view_free(progress->view);
+    free(progress);
+}
+
+View* bunnyconnect_progress_get_view(BunnyConnectProgress* progress) {
+    furi_assert(progress);
+    return progress->view;
+}
+
+void bunnyconnect_progress_reset(
+    BunnyConnectProgress* progress,
+    const char* header,
+    const char* name) {
+    furi_assert(progress);
+    with_view_model(
+        progress->view,
+        BunnyConnectProgressModel * model,
+        {
+            model->header = header;
+            strlcpy(model->name, name ? name : "", sizeof(model->name));
+            model->status = NULL;
+            model->done = 0;
+            model->total = 0;
+            model->rate = 0;
+        },
+        true);
+}
+
+void bunnyconnect_progress_set_name(BunnyConnectProgress* progress, const char* name) {
+    furi_assert(progress);
+    with_view_model(
+        progress->view,
+        BunnyConnectProgressModel * model,
+        { strlcpy(model->name, name, sizeof(model->name)); },
+        true);
+}
+
+void bunnyconnect_progress_update(
+    BunnyConnectProgress* progress,
+    uint32_t done,
+    uint32_t total,
+    uint32_t rate,
+    const char* status) {
+    furi_assert(progress);
+    with_view_model(
+        progress->view,
+        BunnyConnectProgressModel * model,
+        {
+            model->done = done;
+            model->total = total;
+            model->rate = rate;
+            model->status = status;
+        },
+        true);
+}
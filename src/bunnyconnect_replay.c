@@ -0,0 +1,375 @@
+#include "../lib/bunnyconnect_replay.h"
+#include <furi.h>
+#include <input/input.h>
+#include <storage/storage.h>
+
+#define TAG "BunnyReplay"
+
+#define CAPTURE_MAGIC        0x50524342UL // "BCRP"
+#define CAPTURE_VERSION      1
+#define CAPTURE_TRUNCATED    (1 << 0)
+#define CAPTURE_END_RESERVE  (sizeof(CaptureRecord) + sizeof(CaptureEnd))
+#define FNV_OFFSET_BASIS     2166136261UL
+#define FNV_PRIME            16777619UL
+
+// Ids are part of the file format, append only
+typedef enum {
+    CaptureRecordRx, // Payload: the chunk as received
+    CaptureRecordInput, // Payload: CaptureInput
+    CaptureRecordEnd, // Payload: CaptureEnd, always last
+} CaptureRecordType;
+
+// File header, followed by length bytes of records
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t length;
+} __attribute__((packed)) CaptureHeader;
+
+// Record header, followed by len bytes of payload, unaligned in the file
+typedef struct {
+    uint32_t ms; // Since recording started
+    uint16_t len;
+    uint8_t type;
+    uint8_t reserved;
+} __attribute__((packed)) CaptureRecord;
+
+typedef struct {
+    uint32_t sequence;
+    uint8_t key;
+    uint8_t type;
+} __attribute__((packed)) CaptureInput;
+
+typedef struct {
+    uint32_t rx_bytes;
+    uint32_t digest;
+} __attribute__((packed)) CaptureEnd;
+
+struct BunnyConnectCapture {
+    FuriMutex* mutex; // Worker and input service both record
+    uint8_t* buffer;
+    size_t capacity;
+    size_t used;
+    bool truncated;
+    uint32_t start_tick;
+    uint32_t rx_bytes;
+    uint32_t digest;
+    bool input_enabled;
+    FuriPubSub* input_events;
+    FuriPubSubSubscription* input_subscription;
+};
+
+struct BunnyConnectReplay {
+    uint8_t* buffer; // Records only
+    size_t length;
+    size_t offset; // Next record
+    size_t partial; // Bytes of the current RX record already handed out
+    bool fast;
+    bool done;
+    uint32_t start_tick;
+    uint32_t elapsed_ms;
+    uint32_t rx_chunks;
+    uint32_t rx_bytes;
+    uint32_t inputs;
+    uint32_t digest;
+    bool has_end;
+    CaptureEnd end;
+    FuriPubSub* input_events;
+};
+
+static uint32_t replay_fnv(uint32_t hash, const uint8_t* data, size_t len) {
+    for(size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Caller holds the mutex, the end record always has room
+static bool capture_append(
+    BunnyConnectCapture* capture,
+    CaptureRecordType type,
+    const void* payload,
+    size_t len,
+    size_t reserve) {
+    if(capture->truncated || len > UINT16_MAX ||
+       capture->used + sizeof(CaptureRecord) + len + reserve > capture->capacity) {
+        capture->truncated = true;
+        return false;
+    }
+
+    CaptureRecord record = {
+        .ms = furi_get_tick() - capture->start_tick,
+        .len = len,
+        .type = type,
+    };
+    memcpy(capture->buffer + capture->used, &record, sizeof(record));
+    memcpy(capture->buffer + capture->used + sizeof(record), payload, len);
+    capture->used += sizeof(record) + len;
+    return true;
+}
+
+static void capture_input_callback(const void* message, void* context) {
+    BunnyConnectCapture* capture = context;
+    const InputEvent* event = message;
+
+    furi_mutex_acquire(capture->mutex, FuriWaitForever);
+    if(capture->input_enabled) {
+        CaptureInput input = {
+            .sequence = event->sequence,
+            .key = event->key,
+            .type = event->type,
+        };
+        capture_append(capture, CaptureRecordInput, &input, sizeof(input), CAPTURE_END_RESERVE);
+    }
+    furi_mutex_release(capture->mutex);
+}
+
+BunnyConnectCapture* bunnyconnect_capture_alloc(size_t capacity) {
+    furi_assert(capacity > CAPTURE_END_RESERVE);
+    if(capacity > memmgr_heap_get_max_free_block()) return NULL;
+
+    BunnyConnectCapture* capture = malloc(sizeof(BunnyConnectCapture));
+    memset(capture, 0, sizeof(BunnyConnectCapture));
+    capture->buffer = malloc(capacity);
+    capture->capacity = capacity;
+    capture->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    capture->start_tick = furi_get_tick();
+    capture->digest = FNV_OFFSET_BASIS;
+    capture->input_events = furi_record_open(RECORD_INPUT_EVENTS);
+    capture->input_subscription =
+        furi_pubsub_subscribe(capture->input_events, capture_input_callback, capture);
+    FURI_LOG_I(TAG, "Recording, %u bytes", capacity);
+    return capture;
+}
+
+void bunnyconnect_capture_free(BunnyConnectCapture* capture) {
+    furi_assert(capture);
+    furi_pubsub_unsubscribe(capture->input_events, capture->input_subscription);
+    furi_record_close(RECORD_INPUT_EVENTS);
+    furi_mutex_free(capture->mutex);
+    free(capture->buffer);
+    free(capture);
+}
+
+void bunnyconnect_capture_set_input(BunnyConnectCapture* capture, bool enabled) {
+    furi_assert(capture);
+    furi_mutex_acquire(capture->mutex, FuriWaitForever);
+    capture->input_enabled = enabled;
+    furi_mutex_release(capture->mutex);
+}
+
+void bunnyconnect_capture_rx(BunnyConnectCapture* capture, const uint8_t* data, size_t len) {
+    furi_assert(capture);
+    furi_mutex_acquire(capture->mutex, FuriWaitForever);
+    capture_append(capture, CaptureRecordRx, data, len, CAPTURE_END_RESERVE);
+    furi_mutex_release(capture->mutex);
+}
+
+void bunnyconnect_capture_appended(BunnyConnectCapture* capture, const uint8_t* data, size_t len) {
+    furi_assert(capture);
+    furi_mutex_acquire(capture->mutex, FuriWaitForever);
+    // Bytes of chunks that no longer fit would never be replayed
+    if(!capture->truncated) {
+        capture->digest = replay_fnv(capture->digest, data, len);
+        capture->rx_bytes += len;
+    }
+    furi_mutex_release(capture->mutex);
+}
+
+bool bunnyconnect_capture_save(BunnyConnectCapture* capture, Storage* storage, const char* path) {
+    furi_assert(capture);
+    furi_assert(storage);
+    furi_assert(path);
+
+    furi_mutex_acquire(capture->mutex, FuriWaitForever);
+    CaptureEnd end = {.rx_bytes = capture->rx_bytes, .digest = capture->digest};
+    bool truncated = capture->truncated;
+    capture->truncated = false; // The end record has its reserve
+    capture_append(capture, CaptureRecordEnd, &end, sizeof(end), 0);
+    capture->truncated = true; // Nothing after the end record
+
+    CaptureHeader header = {
+        .magic = CAPTURE_MAGIC,
+        .version = CAPTURE_VERSION,
+        .flags = truncated ? CAPTURE_TRUNCATED : 0,
+        .length = capture->used,
+    };
+
+    File* file = storage_file_alloc(storage);
+    bool success = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                   storage_file_write(file, &header, sizeof(header)) == sizeof(header) &&
+                   storage_file_write(file, capture->buffer, capture->used) == capture->used;
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_mutex_release(capture->mutex);
+
+    if(success) {
+        FURI_LOG_I(
+            TAG,
+            "Saved %lu bytes to %s%s",
+            header.length,
+            path,
+            truncated ? ", truncated" : "");
+    } else {
+        FURI_LOG_E(TAG, "Failed to write %s", path);
+    }
+    return success;
+}
+
+BunnyConnectReplay* bunnyconnect_replay_load(Storage* storage, const char* path, bool fast) {
+    furi_assert(storage);
+    furi_assert(path);
+
+    BunnyConnectReplay* replay = NULL;
+    CaptureHeader header;
+    File* file = storage_file_alloc(storage);
+
+    do {
+        if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION) break;
+        if(header.length > storage_file_size(file) - sizeof(header)) break;
+        if(header.length > memmgr_heap_get_max_free_block()) break;
+
+        replay = malloc(sizeof(BunnyConnectReplay));
+        memset(replay, 0, sizeof(BunnyConnectReplay));
+        replay->buffer = malloc(header.length);
+        replay->length = header.length;
+        if(storage_file_read(file, replay->buffer, header.length) != header.length) {
+            free(replay->buffer);
+            free(replay);
+            replay = NULL;
+        }
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    if(!replay) {
+        FURI_LOG_E(TAG, "No valid capture at %s", path);
+        return NULL;
+    }
+
+    replay->fast = fast;
+    replay->digest = FNV_OFFSET_BASIS;
+    replay->input_events = furi_record_open(RECORD_INPUT_EVENTS);
+    replay->start_tick = furi_get_tick();
+    FURI_LOG_I(
+        TAG,
+        "Replaying %u bytes %s%s",
+        replay->length,
+        fast ? "fast" : "1x",
+        header.flags & CAPTURE_TRUNCATED ? ", truncated capture" : "");
+    return replay;
+}
+
+void bunnyconnect_replay_free(BunnyConnectReplay* replay) {
+    furi_assert(replay);
+    furi_record_close(RECORD_INPUT_EVENTS);
+    free(replay->buffer);
+    free(replay);
+}
+
+size_t bunnyconnect_replay_next(
+    BunnyConnectReplay* replay,
+    uint8_t* out,
+    size_t size,
+    bool* finished) {
+    furi_assert(replay);
+    furi_assert(out);
+    furi_assert(finished);
+    *finished = false;
+    if(replay->done) return 0;
+
+    uint32_t now = furi_get_tick() - replay->start_tick;
+    CaptureRecord record;
+
+    while(replay->offset + sizeof(record) <= replay->length) {
+        memcpy(&record, replay->buffer + replay->offset, sizeof(record));
+        const uint8_t* payload = replay->buffer + replay->offset + sizeof(record);
+        size_t next = replay->offset + sizeof(record) + record.len;
+        if(next > replay->length) break;
+        if(!replay->fast && record.ms > now) return 0;
+
+        if(record.type == CaptureRecordRx && size > 0) {
+            size_t len = MIN(size, record.len - replay->partial);
+            memcpy(out, payload + replay->partial, len);
+            replay->partial += len;
+            if(replay->partial == record.len) {
+                replay->partial = 0;
+                replay->offset = next;
+            }
+            replay->rx_chunks++;
+            return len;
+        }
+
+        if(record.type == CaptureRecordInput && record.len == sizeof(CaptureInput)) {
+            CaptureInput input;
+            memcpy(&input, payload, sizeof(input));
+            InputEvent event = {
+                .sequence = input.sequence,
+                .key = input.key,
+                .type = input.type,
+            };
+            furi_pubsub_publish(replay->input_events, &event);
+            replay->inputs++;
+        } else if(record.type == CaptureRecordEnd && record.len == sizeof(CaptureEnd)) {
+            memcpy(&replay->end, payload, sizeof(CaptureEnd));
+            replay->has_end = true;
+        }
+        replay->offset = next; // Unknown records are skipped
+    }
+
+    replay->done = true;
+    replay->elapsed_ms = now;
+    *finished = true;
+    return 0;
+}
+
+bool bunnyconnect_replay_is_fast(BunnyConnectReplay* replay) {
+    furi_assert(replay);
+    return replay->fast;
+}
+
+void bunnyconnect_replay_appended(BunnyConnectReplay* replay, const uint8_t* data, size_t len) {
+    furi_assert(replay);
+    replay->digest = replay_fnv(replay->digest, data, len);
+    replay->rx_bytes += len;
+}
+
+bool bunnyconnect_replay_get_result(BunnyConnectReplay* replay, BunnyConnectReplayResult* result) {
+    furi_assert(replay);
+    furi_assert(result);
+    *result = (BunnyConnectReplayResult){
+        .fast = replay->fast,
+        .elapsed_ms = replay->elapsed_ms,
+        .rx_chunks = replay->rx_chunks,
+        .rx_bytes = replay->rx_bytes,
+        .inputs = replay->inputs,
+        .digest = replay->digest,
+        .expected_digest = replay->end.digest,
+        .expected_bytes = replay->end.rx_bytes,
+    };
+    return replay->done && replay->has_end && replay->digest == replay->end.digest &&
+           replay->rx_bytes == replay->end.rx_bytes;
+}
+
+size_t bunnyconnect_replay_format(const BunnyConnectReplayResult* result, char* out, size_t size) {
+    furi_assert(result);
+    furi_assert(out);
+    furi_assert(size > 0);
+
+    int len = snprintf(
+        out,
+        size,
+        "BCREPLAY v=1 mode=%s ms=%lu chunks=%lu rx_bytes=%lu inputs=%lu renders=%lu "
+        "match=%d\r\n",
+        result->fast ? "fast" : "1x",
+        result->elapsed_ms,
+        result->rx_chunks,
+        result->rx_bytes,
+        result->inputs,
+        result->renders,
+        result->digest == result->expected_digest && result->rx_bytes == result->expected_bytes);
+    return len < 0 ? 0 : MIN((size_t)len, size - 1);
+}
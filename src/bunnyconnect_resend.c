@@ -0,0 +1,132 @@
+#include "../lib/bunnyconnect_resend.h"
+#include "../lib/bunnyconnect_stamp.h"
+#include <furi.h>
+
+#define RESEND_CHUNK 32 // Bytes read from the ring at a time
+
+// Start of the line ending at end, tail if there is no newline before it
+static bool resend_line_start(
+    BunnyConnectScrollback* scrollback,
+    uint32_t tail,
+    uint32_t end,
+    uint32_t* start) {
+    uint8_t chunk[RESEND_CHUNK];
+    while(end != tail) {
+        size_t len = MIN(end - tail, sizeof(chunk));
+        if(!bunnyconnect_scrollback_read(scrollback, end - len, chunk, len)) return false;
+        for(size_t i = len; i > 0; i--) {
+            if(chunk[i - 1] == '\n') {
+                *start = end - len + i;
+                return true;
+            }
+        }
+        end -= len;
+    }
+    *start = tail;
+    return true;
+}
+
+// Markers lead a line, the tail of the ring can also cut one in half
+static bool resend_skip_markers(
+    BunnyConnectScrollback* scrollback,
+    uint32_t tail,
+    BunnyConnectResendSpan* line) {
+    uint8_t lead[2 * BUNNYCONNECT_STAMP_MAX];
+    size_t len = MIN(line->len, sizeof(lead));
+    if(!bunnyconnect_scrollback_read(scrollback, line->start, lead, len)) return false;
+
+    // An unwrapped ring starts with the first byte ever written, nothing is cut
+    size_t skip = 0;
+    if(line->start == tail && tail != 0) {
+        while(skip < len && (lead[skip] & BUNNYCONNECT_STAMP_PAYLOAD)) {
+            skip++;
+        }
+    }
+    BunnyConnectStampClock clock = {0};
+    while(skip < len && bunnyconnect_stamp_clock_feed(&clock, lead[skip])) {
+        skip++;
+    }
+    // A lead given back as text closes a doubled one, both halves are text
+    if(skip < len && bunnyconnect_stamp_is_lead(lead[skip])) skip--;
+
+    line->start += skip;
+    line->len -= skip;
+    return true;
+}
+
+bool bunnyconnect_resend_find_line(
+    BunnyConnectScrollback* scrollback,
+    uint32_t head,
+    size_t back,
+    BunnyConnectResendSpan* line) {
+    furi_assert(scrollback);
+    furi_assert(line);
+
+    uint32_t tail, now;
+    bunnyconnect_scrollback_get_window(scrollback, &tail, &now);
+    if((int32_t)(head - tail) < 0) return false;
+
+    // A newline right before head ends line 0, it does not start an empty one
+    uint32_t end = head;
+    if(end != tail) {
+        uint8_t last;
+        if(!bunnyconnect_scrollback_read(scrollback, end - 1, &last, 1)) return false;
+        if(last == '\n') end--;
+    }
+
+    uint32_t start;
+    while(true) {
+        if(!resend_line_start(scrollback, tail, end, &start)) return false;
+        if(!back) break;
+        if(start == tail) return false;
+        end = start - 1;
+        back--;
+    }
+
+    line->start = start;
+    line->len = end - start;
+    return resend_skip_markers(scrollback, tail, line);
+}
+
+bool bunnyconnect_resend_find_field(
+    BunnyConnectScrollback* scrollback,
+    const BunnyConnectResendSpan* line,
+    size_t field,
+    BunnyConnectResendSpan* span) {
+    furi_assert(scrollback);
+    furi_assert(line);
+    furi_assert(span);
+
+    uint32_t end = line->start + line->len;
+    if(line->len) {
+        uint8_t last;
+        if(!bunnyconnect_scrollback_read(scrollback, end - 1, &last, 1)) return false;
+        if(last == '\r') end--;
+    }
+    span->start = line->start;
+    span->len = end - line->start;
+    if(!field) return true;
+
+    uint8_t chunk[RESEND_CHUNK];
+    size_t words = 0;
+    bool in_word = false;
+    for(uint32_t pos = line->start; pos != end;) {
+        size_t len = MIN(end - pos, sizeof(chunk));
+        if(!bunnyconnect_scrollback_read(scrollback, pos, chunk, len)) return false;
+        for(size_t i = 0; i < len; i++) {
+            bool space = chunk[i] == ' ' || chunk[i] == '\t';
+            if(!space && !in_word && ++words == field) {
+                span->start = pos + i;
+            } else if(space && in_word && words == field) {
+                span->len = pos + i - span->start;
+                return true;
+            }
+            in_word = !space;
+        }
+        pos += len;
+    }
+    if(words < field) return false;
+
+    span->len = end - span->start;
+    return true;
+}
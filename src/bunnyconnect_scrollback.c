@@ -0,0 +1,152 @@
+#include "../lib/bunnyconnect_scrollback.h"
+#include <furi.h>
+#include <stdatomic.h>
+
+// Positions count bytes ever written and wrap at 2^32, the ring index is
+// position & mask. The producer publishes reserve before overwriting and
+// head after writing, so a reader that copied [start, head) can tell from
+// reserve how much of the front was overwritten under it.
+struct BunnyConnectScrollback {
+    BunnyConnectArena* arena; // Keeps the high-water mark of data
+    uint8_t* data; // Follows the state in the same region
+    uint32_t mask;
+    atomic_uint_least32_t head; // Written and visible
+    atomic_uint_least32_t reserve; // Claimed, may be mid-write
+    atomic_bool full; // Head has passed the capacity once
+};
+
+_Static_assert(
+    sizeof(struct BunnyConnectScrollback) <= BUNNYCONNECT_SCROLLBACK_OVERHEAD,
+    "Scrollback state outgrew its overhead");
+
+BunnyConnectScrollback* bunnyconnect_scrollback_alloc(
+    BunnyConnectArena* arena,
+    const char* name,
+    size_t capacity) {
+    furi_assert(arena);
+    furi_assert(name);
+    furi_check(capacity && (capacity & (capacity - 1)) == 0);
+
+    BunnyConnectScrollback* scrollback =
+        bunnyconnect_arena_carve(arena, name, sizeof(BunnyConnectScrollback) + capacity);
+    scrollback->arena = arena;
+    scrollback->data = (uint8_t*)(scrollback + 1);
+    scrollback->mask = capacity - 1;
+    atomic_init(&scrollback->head, 0);
+    atomic_init(&scrollback->reserve, 0);
+    atomic_init(&scrollback->full, false);
+    return scrollback;
+}
+
+void bunnyconnect_scrollback_write(
+    BunnyConnectScrollback* scrollback,
+    const uint8_t* data,
+    size_t len) {
+    furi_assert(scrollback);
+    furi_assert(data);
+
+    uint32_t capacity = scrollback->mask + 1;
+    uint32_t head = atomic_load_explicit(&scrollback->head, memory_order_relaxed);
+    uint32_t end = head + len;
+    if(len > capacity) {
+        data += len - capacity;
+        len = capacity;
+    }
+    uint32_t pos = end - len;
+
+    // Readers must see the claim before any byte they copied changes
+    atomic_store_explicit(&scrollback->reserve, end, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    size_t index = pos & scrollback->mask;
+    size_t first = MIN(len, capacity - index);
+    memcpy(scrollback->data + index, data, first);
+    memcpy(scrollback->data, data + first, len - first);
+
+    bool full = atomic_load_explicit(&scrollback->full, memory_order_relaxed);
+    if(!full && (end >= capacity || end < head)) {
+        atomic_store_explicit(&scrollback->full, true, memory_order_relaxed);
+        full = true;
+    }
+    atomic_store_explicit(&scrollback->head, end, memory_order_release);
+
+    bunnyconnect_arena_mark(
+        scrollback->arena, scrollback, sizeof(BunnyConnectScrollback) + (full ? capacity : end));
+}
+
+size_t bunnyconnect_scrollback_snapshot(
+    BunnyConnectScrollback* scrollback,
+    char* out,
+    size_t out_size) {
+    furi_assert(scrollback);
+    furi_assert(out);
+    furi_assert(out_size > 0);
+
+    uint32_t capacity = scrollback->mask + 1;
+    uint32_t head = atomic_load_explicit(&scrollback->head, memory_order_acquire);
+    bool full = atomic_load_explicit(&scrollback->full, memory_order_relaxed);
+    uint32_t len = full ? capacity : MIN(head, capacity);
+    len = MIN(len, out_size - 1);
+    uint32_t start = head - len;
+
+    size_t index = start & scrollback->mask;
+    size_t first = MIN(len, capacity - index);
+    memcpy(out, scrollback->data + index, first);
+    memcpy(out + first, scrollback->data, len - first);
+
+    // Anything before reserve - capacity may have been overwritten meanwhile
+    atomic_thread_fence(memory_order_seq_cst);
+    uint32_t reserve = atomic_load_explicit(&scrollback->reserve, memory_order_relaxed);
+    uint32_t lost = reserve - capacity - start;
+    if((int32_t)lost > 0) {
+        lost = MIN(lost, len);
+        memmove(out, out + lost, len - lost);
+        len -= lost;
+    }
+
+    out[len] = '\0';
+    return len;
+}
+
+void bunnyconnect_scrollback_get_window(
+    BunnyConnectScrollback* scrollback,
+    uint32_t* tail,
+    uint32_t* head) {
+    furi_assert(scrollback);
+    furi_assert(tail);
+    furi_assert(head);
+
+    *head = atomic_load_explicit(&scrollback->head, memory_order_acquire);
+    bool full = atomic_load_explicit(&scrollback->full, memory_order_relaxed);
+    *tail = full ? *head - (scrollback->mask + 1) : 0;
+}
+
+bool bunnyconnect_scrollback_read(
+    BunnyConnectScrollback* scrollback,
+    uint32_t pos,
+    uint8_t* out,
+    size_t len) {
+    furi_assert(scrollback);
+    furi_assert(out);
+
+    uint32_t capacity = scrollback->mask + 1;
+    if(len > capacity) return false;
+
+    size_t index = pos & scrollback->mask;
+    size_t first = MIN(len, capacity - index);
+    memcpy(out, scrollback->data + index, first);
+    memcpy(out + first, scrollback->data, len - first);
+
+    // Same check as a snapshot, but the caller wants all of it or nothing
+    atomic_thread_fence(memory_order_seq_cst);
+    uint32_t reserve = atomic_load_explicit(&scrollback->reserve, memory_order_relaxed);
+    return (int32_t)(pos - (reserve - capacity)) >= 0;
+}
+
+size_t bunnyconnect_scrollback_get_fill(BunnyConnectScrollback* scrollback) {
+    furi_assert(scrollback);
+    if(atomic_load_explicit(&scrollback->full, memory_order_relaxed)) {
+        return scrollback->mask + 1;
+    }
+    return atomic_load_explicit(&scrollback->head, memory_order_relaxed);
+}
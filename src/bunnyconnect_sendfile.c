@@ -0,0 +1,268 @@
+#include "../lib/bunnyconnect_sendfile.h"
+#include <furi.h>
+#include <storage/storage.h>
+
+#define TAG "BunnySendFile"
+
+#define SENDFILE_POLL_MS      50
+#define SENDFILE_THREAD_STACK 1024
+#define SENDFILE_LINE_READ    64
+
+struct BunnyConnectSendFile {
+    BunnyConnectOutput* output;
+    BunnyConnectSendFileSettings settings;
+    BunnyConnectSendFileCallback callback;
+    void* context;
+
+    Storage* storage;
+    File* file;
+    FuriStreamBuffer* prefetch;
+    FuriThread* reader;
+    FuriThread* sender;
+
+    volatile bool cancel;
+    volatile bool reader_done;
+    volatile bool reader_error;
+
+    volatile BunnyConnectSendFileState state;
+    volatile uint32_t sent;
+    uint32_t total;
+    uint32_t start_tick;
+    volatile uint32_t end_tick;
+};
+
+static const char* const sendfile_mode_names[BunnyConnectSendFileModeCount] = {
+    [BunnyConnectSendFileModeChunks] = "Chunks",
+    [BunnyConnectSendFileModeLines] = "Lines",
+};
+
+static int32_t sendfile_reader_thread(void* context) {
+    BunnyConnectSendFile* sendfile = context;
+    uint8_t* buffer = malloc(BUNNYCONNECT_SENDFILE_READ_SIZE);
+
+    while(!sendfile->cancel) {
+        size_t read = storage_file_read(sendfile->file, buffer, BUNNYCONNECT_SENDFILE_READ_SIZE);
+        if(read == 0) {
+            sendfile->reader_error = !storage_file_eof(sendfile->file);
+            break;
+        }
+
+        size_t offset = 0;
+        while(offset < read && !sendfile->cancel) {
+            offset += furi_stream_buffer_send(
+                sendfile->prefetch, buffer + offset, read - offset, SENDFILE_POLL_MS);
+        }
+    }
+
+    free(buffer);
+    sendfile->reader_done = true;
+    return 0;
+}
+
+// Take up to size bytes from the prefetch buffer. With exact set, keep waiting
+// until size bytes arrived or the file ended.
+static size_t
+    sendfile_receive(BunnyConnectSendFile* sendfile, uint8_t* data, size_t size, bool exact) {
+    size_t received = 0;
+
+    while(received < size && !sendfile->cancel) {
+        received += furi_stream_buffer_receive(
+            sendfile->prefetch, data + received, size - received, SENDFILE_POLL_MS);
+        if(!exact && received > 0) break;
+        if(sendfile->reader_done && furi_stream_buffer_is_empty(sendfile->prefetch)) break;
+    }
+
+    return received;
+}
+
+static void sendfile_write(BunnyConnectSendFile* sendfile, const uint8_t* data, size_t size) {
+    for(size_t i = 0; i < BunnyConnectOutputCount; i++) {
+        if(!bunnyconnect_output_route_has(sendfile->settings.route, i)) continue;
+
+        size_t written = 0;
+        while(written < size && !sendfile->cancel) {
+            written += bunnyconnect_output_write(
+                sendfile->output, i, data + written, size - written, SENDFILE_POLL_MS);
+        }
+    }
+
+    sendfile->sent += size;
+}
+
+static void sendfile_send_chunks(BunnyConnectSendFile* sendfile, uint8_t* buffer) {
+    while(!sendfile->cancel) {
+        size_t size = sendfile_receive(sendfile, buffer, sendfile->settings.chunk_size, true);
+        if(size == 0) break;
+
+        sendfile_write(sendfile, buffer, size);
+        if(sendfile->settings.chunk_delay_ms) {
+            furi_delay_ms(sendfile->settings.chunk_delay_ms);
+        }
+    }
+}
+
+static void sendfile_send_lines(BunnyConnectSendFile* sendfile, uint8_t* buffer) {
+    while(!sendfile->cancel) {
+        size_t size = sendfile_receive(sendfile, buffer, SENDFILE_LINE_READ, false);
+        if(size == 0) break;
+
+        size_t start = 0;
+        for(size_t i = 0; i < size && !sendfile->cancel; i++) {
+            if(buffer[i] != '\n') continue;
+
+            sendfile_write(sendfile, buffer + start, i + 1 - start);
+            start = i + 1;
+            if(sendfile->settings.line_delay_ms) {
+                furi_delay_ms(sendfile->settings.line_delay_ms);
+            }
+        }
+
+        if(start < size) {
+            sendfile_write(sendfile, buffer + start, size - start);
+        }
+    }
+}
+
+static int32_t sendfile_sender_thread(void* context) {
+    BunnyConnectSendFile* sendfile = context;
+    size_t buffer_size = sendfile->settings.chunk_size > SENDFILE_LINE_READ ?
+                             sendfile->settings.chunk_size :
+                             SENDFILE_LINE_READ;
+    uint8_t* buffer = malloc(buffer_size);
+
+    if(sendfile->settings.mode == BunnyConnectSendFileModeLines) {
+        sendfile_send_lines(sendfile, buffer);
+    } else {
+        sendfile_send_chunks(sendfile, buffer);
+    }
+
+    free(buffer);
+
+    sendfile->end_tick = furi_get_tick();
+    if(sendfile->cancel) {
+        sendfile->state = BunnyConnectSendFileStateCancelled;
+    } else if(sendfile->reader_error) {
+        sendfile->state = BunnyConnectSendFileStateError;
+    } else {
+        sendfile->state = BunnyConnectSendFileStateDone;
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Sent %lu/%lu bytes in %lu ms",
+        sendfile->sent,
+        sendfile->total,
+        sendfile->end_tick - sendfile->start_tick);
+
+    if(sendfile->callback) {
+        sendfile->callback(sendfile->context);
+    }
+    return 0;
+}
+
+static FuriThread* sendfile_thread_start(
+    BunnyConnectSendFile* sendfile,
+    const char* name,
+    FuriThreadCallback callback) {
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, name);
+    furi_thread_set_stack_size(thread, SENDFILE_THREAD_STACK);
+    furi_thread_set_context(thread, sendfile);
+    furi_thread_set_callback(thread, callback);
+    furi_thread_start(thread);
+    return thread;
+}
+
+BunnyConnectSendFile* bunnyconnect_sendfile_start(
+    BunnyConnectOutput* output,
+    const char* path,
+    const BunnyConnectSendFileSettings* settings,
+    BunnyConnectSendFileCallback callback,
+    void* context) {
+    furi_assert(output);
+    furi_assert(path);
+    furi_assert(settings);
+
+    BunnyConnectSendFile* sendfile = malloc(sizeof(BunnyConnectSendFile));
+    memset(sendfile, 0, sizeof(BunnyConnectSendFile));
+    sendfile->output = output;
+    sendfile->settings = *settings;
+    sendfile->callback = callback;
+    sendfile->context = context;
+    if(sendfile->settings.chunk_size == 0) {
+        sendfile->settings.chunk_size = SENDFILE_LINE_READ;
+    }
+
+    sendfile->storage = furi_record_open(RECORD_STORAGE);
+    sendfile->file = storage_file_alloc(sendfile->storage);
+    if(!storage_file_open(sendfile->file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_E(TAG, "Failed to open %s", path);
+        storage_file_free(sendfile->file);
+        furi_record_close(RECORD_STORAGE);
+        free(sendfile);
+        return NULL;
+    }
+
+    sendfile->total = storage_file_size(sendfile->file);
+    sendfile->prefetch = furi_stream_buffer_alloc(BUNNYCONNECT_SENDFILE_PREFETCH_SIZE, 1);
+    sendfile->state = BunnyConnectSendFileStateRunning;
+    sendfile->start_tick = furi_get_tick();
+
+    FURI_LOG_I(
+        TAG,
+        "Sending %s (%lu bytes, %s)",
+        path,
+        sendfile->total,
+        bunnyconnect_sendfile_mode_name(sendfile->settings.mode));
+
+    sendfile->reader = sendfile_thread_start(sendfile, "BunnyFileRead", sendfile_reader_thread);
+    sendfile->sender = sendfile_thread_start(sendfile, "BunnyFileSend", sendfile_sender_thread);
+
+    return sendfile;
+}
+
+void bunnyconnect_sendfile_stop(BunnyConnectSendFile* sendfile) {
+    furi_assert(sendfile);
+
+    // A finished transfer keeps its final state
+    if(sendfile->state == BunnyConnectSendFileStateRunning) {
+        sendfile->cancel = true;
+    }
+    furi_thread_join(sendfile->sender);
+    furi_thread_join(sendfile->reader);
+}
+
+void bunnyconnect_sendfile_free(BunnyConnectSendFile* sendfile) {
+    if(!sendfile) return;
+
+    bunnyconnect_sendfile_stop(sendfile);
+    furi_thread_free(sendfile->sender);
+    furi_thread_free(sendfile->reader);
+
+    furi_stream_buffer_free(sendfile->prefetch);
+    storage_file_close(sendfile->file);
+    storage_file_free(sendfile->file);
+    furi_record_close(RECORD_STORAGE);
+    free(sendfile);
+}
+
+void bunnyconnect_sendfile_get_status(
+    BunnyConnectSendFile* sendfile,
+    BunnyConnectSendFileStatus* status) {
+    furi_assert(sendfile);
+    furi_assert(status);
+
+    uint32_t end = sendfile->state == BunnyConnectSendFileStateRunning ? furi_get_tick() :
+                                                                           sendfile->end_tick;
+    uint32_t elapsed = end - sendfile->start_tick;
+
+    status->state = sendfile->state;
+    status->sent = sendfile->sent;
+    status->total = sendfile->total;
+    status->rate =
+        elapsed ? (uint64_t)status->sent * furi_kernel_get_tick_frequency() / elapsed : 0;
+}
+
+const char* bunnyconnect_sendfile_mode_name(BunnyConnectSendFileMode mode) {
+    return mode < BunnyConnectSendFileModeCount ? sendfile_mode_names[mode] : "?";
+}
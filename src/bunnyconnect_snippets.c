@@ -0,0 +1,487 @@
+#include "../lib/bunnyconnect_snippets.h"
+#include <furi.h>
+#include <storage/storage.h>
+#include <toolbox/stream/file_stream.h>
+
+#define TAG "BunnySnippets"
+
+#define SNIPPETS_INDEX_MAGIC   0x49534342UL // "BCSI"
+#define SNIPPETS_INDEX_VERSION 1
+#define SNIPPETS_HEADER_PREFIX "## "
+#define SNIPPETS_READ_CHUNK    64
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t file_count;
+    uint16_t entry_count;
+    uint16_t reserved;
+} SnippetsIndexHeader;
+
+typedef struct {
+    char name[BUNNYCONNECT_SNIPPETS_NAME_SIZE];
+    uint32_t size;
+    uint32_t timestamp;
+    uint16_t first_entry;
+    uint16_t entry_count;
+} SnippetsIndexFile;
+
+typedef struct {
+    char name[BUNNYCONNECT_SNIPPETS_NAME_SIZE];
+    uint16_t file;
+    uint16_t reserved;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t hash;
+} SnippetsIndexEntry;
+
+struct BunnyConnectSnippets {
+    Storage* storage;
+
+    SnippetsIndexFile* files;
+    size_t file_count;
+
+    SnippetsIndexEntry* entries;
+    size_t entry_count;
+    size_t entry_capacity;
+
+    bool dirty;
+};
+
+static uint32_t snippets_hash_update(uint32_t hash, const uint8_t* data, size_t size) {
+    // FNV-1a
+    for(size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+static void snippets_file_path(FuriString* path, const char* name) {
+    furi_string_printf(path, "%s/%s", BUNNYCONNECT_SNIPPETS_PATH, name);
+}
+
+static SnippetsIndexEntry* snippets_entry_add(BunnyConnectSnippets* snippets) {
+    if(snippets->entry_count >= BUNNYCONNECT_SNIPPETS_MAX) return NULL;
+
+    if(snippets->entry_count == snippets->entry_capacity) {
+        size_t capacity = snippets->entry_capacity ? snippets->entry_capacity * 2 : 16;
+        if(capacity > BUNNYCONNECT_SNIPPETS_MAX) capacity = BUNNYCONNECT_SNIPPETS_MAX;
+        SnippetsIndexEntry* entries =
+            realloc(snippets->entries, capacity * sizeof(SnippetsIndexEntry));
+        if(!entries) return NULL;
+        snippets->entries = entries;
+        snippets->entry_capacity = capacity;
+    }
+
+    SnippetsIndexEntry* entry = &snippets->entries[snippets->entry_count++];
+    memset(entry, 0, sizeof(SnippetsIndexEntry));
+    return entry;
+}
+
+static bool snippets_hash_range(Stream* stream, uint32_t offset, uint32_t length, uint32_t* hash) {
+    uint8_t buffer[SNIPPETS_READ_CHUNK];
+    uint32_t result = 2166136261UL;
+
+    if(!stream_seek(stream, offset, StreamOffsetFromStart)) return false;
+
+    while(length > 0) {
+        size_t to_read = length < sizeof(buffer) ? length : sizeof(buffer);
+        size_t read = stream_read(stream, buffer, to_read);
+        if(read != to_read) return false;
+        result = snippets_hash_update(result, buffer, read);
+        length -= read;
+    }
+
+    *hash = result;
+    return true;
+}
+
+static size_t snippets_line_ending_size(FuriString* line) {
+    size_t size = furi_string_size(line);
+    if(size > 0 && furi_string_get_char(line, size - 1) == '\n') {
+        if(size > 1 && furi_string_get_char(line, size - 2) == '\r') return 2;
+        return 1;
+    }
+    return 0;
+}
+
+static void snippets_entry_close(
+    BunnyConnectSnippets* snippets,
+    SnippetsIndexEntry* entry,
+    size_t end,
+    size_t trailing_newline) {
+    if(!entry) return;
+
+    size_t length = end - entry->offset;
+    entry->length = length >= trailing_newline ? length - trailing_newline : 0;
+    if(entry->length > BUNNYCONNECT_SNIPPETS_MAX_LENGTH) {
+        FURI_LOG_W(TAG, "Snippet %s too long, truncated", entry->name);
+        entry->length = BUNNYCONNECT_SNIPPETS_MAX_LENGTH;
+    }
+
+    // Drop empty preamble before the first header
+    if(entry->length == 0 && entry->name[0] == '\0') {
+        snippets->entry_count--;
+    }
+}
+
+static bool snippets_parse_file(
+    BunnyConnectSnippets* snippets,
+    SnippetsIndexFile* file,
+    uint16_t file_index) {
+    FuriString* path = furi_string_alloc();
+    FuriString* line = furi_string_alloc();
+    Stream* stream = file_stream_alloc(snippets->storage);
+    bool success = false;
+
+    file->first_entry = snippets->entry_count;
+    file->entry_count = 0;
+
+    do {
+        snippets_file_path(path, file->name);
+        if(!file_stream_open(stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            FURI_LOG_E(TAG, "Failed to open %s", furi_string_get_cstr(path));
+            break;
+        }
+
+        // Preamble before the first header, named after the file below
+        SnippetsIndexEntry* entry = snippets_entry_add(snippets);
+        if(entry) entry->file = file_index;
+        size_t trailing_newline = 0;
+
+        while(true) {
+            size_t line_start = stream_tell(stream);
+            if(!stream_read_line(stream, line)) break;
+
+            if(furi_string_start_with_str(line, SNIPPETS_HEADER_PREFIX)) {
+                snippets_entry_close(snippets, entry, line_start, trailing_newline);
+
+                entry = snippets_entry_add(snippets);
+                if(!entry) {
+                    FURI_LOG_W(TAG, "Snippet limit reached");
+                    break;
+                }
+                entry->file = file_index;
+                entry->offset = stream_tell(stream);
+
+                furi_string_right(line, strlen(SNIPPETS_HEADER_PREFIX));
+                furi_string_trim(line, " \t\r\n");
+                strlcpy(entry->name, furi_string_get_cstr(line), sizeof(entry->name));
+                if(entry->name[0] == '\0') {
+                    snprintf(
+                        entry->name,
+                        sizeof(entry->name),
+                        "%s #%u",
+                        file->name,
+                        snippets->entry_count - file->first_entry);
+                }
+                trailing_newline = 0;
+            } else {
+                trailing_newline = snippets_line_ending_size(line);
+            }
+        }
+
+        snippets_entry_close(snippets, entry, stream_size(stream), trailing_newline);
+
+        file->entry_count = snippets->entry_count - file->first_entry;
+        for(size_t i = file->first_entry; i < snippets->entry_count; i++) {
+            SnippetsIndexEntry* parsed = &snippets->entries[i];
+            if(parsed->name[0] == '\0') {
+                furi_string_set_str(path, file->name);
+                size_t ext = furi_string_search_rchar(path, '.', 0);
+                if(ext != FURI_STRING_FAILURE) furi_string_left(path, ext);
+                strlcpy(parsed->name, furi_string_get_cstr(path), sizeof(parsed->name));
+            }
+            if(!snippets_hash_range(stream, parsed->offset, parsed->length, &parsed->hash)) {
+                FURI_LOG_E(TAG, "Failed to hash %s", parsed->name);
+                break;
+            }
+        }
+
+        success = true;
+    } while(false);
+
+    file_stream_close(stream);
+    stream_free(stream);
+    furi_string_free(line);
+    furi_string_free(path);
+
+    FURI_LOG_D(TAG, "Parsed %s: %u snippets", file->name, file->entry_count);
+    return success;
+}
+
+static bool snippets_index_load(
+    BunnyConnectSnippets* snippets,
+    SnippetsIndexFile** files,
+    size_t* file_count,
+    SnippetsIndexEntry** entries,
+    size_t* entry_count) {
+    File* file = storage_file_alloc(snippets->storage);
+    bool success = false;
+
+    *files = NULL;
+    *entries = NULL;
+    *file_count = 0;
+    *entry_count = 0;
+
+    do {
+        if(!storage_file_open(
+               file, BUNNYCONNECT_SNIPPETS_INDEX_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+
+        SnippetsIndexHeader header;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != SNIPPETS_INDEX_MAGIC || header.version != SNIPPETS_INDEX_VERSION) {
+            FURI_LOG_W(TAG, "Index format mismatch, rebuilding");
+            break;
+        }
+        if(header.file_count > BUNNYCONNECT_SNIPPETS_MAX_FILES ||
+           header.entry_count > BUNNYCONNECT_SNIPPETS_MAX) {
+            break;
+        }
+
+        // File and entry tables are stored back to back, read them in one go
+        size_t files_size = header.file_count * sizeof(SnippetsIndexFile);
+        size_t entries_size = header.entry_count * sizeof(SnippetsIndexEntry);
+        uint8_t* tables = malloc(files_size + entries_size + 1);
+        if(storage_file_read(file, tables, files_size + entries_size) !=
+           files_size + entries_size) {
+            free(tables);
+            break;
+        }
+
+        *files = malloc(files_size + 1);
+        memcpy(*files, tables, files_size);
+        *entries = malloc(entries_size + 1);
+        memcpy(*entries, tables + files_size, entries_size);
+        free(tables);
+
+        *file_count = header.file_count;
+        *entry_count = header.entry_count;
+        success = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return success;
+}
+
+static bool snippets_index_save(BunnyConnectSnippets* snippets) {
+    File* file = storage_file_alloc(snippets->storage);
+    bool success = false;
+
+    do {
+        if(!storage_file_open(
+               file, BUNNYCONNECT_SNIPPETS_INDEX_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            FURI_LOG_E(TAG, "Failed to write index");
+            break;
+        }
+
+        SnippetsIndexHeader header = {
+            .magic = SNIPPETS_INDEX_MAGIC,
+            .version = SNIPPETS_INDEX_VERSION,
+            .file_count = snippets->file_count,
+            .entry_count = snippets->entry_count,
+        };
+        size_t files_size = snippets->file_count * sizeof(SnippetsIndexFile);
+        size_t entries_size = snippets->entry_count * sizeof(SnippetsIndexEntry);
+
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(storage_file_write(file, snippets->files, files_size) != files_size) break;
+        if(storage_file_write(file, snippets->entries, entries_size) != entries_size) break;
+
+        snippets->dirty = false;
+        success = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return success;
+}
+
+static bool snippets_has_extension(const char* name) {
+    size_t name_len = strlen(name);
+    size_t ext_len = strlen(BUNNYCONNECT_SNIPPETS_EXTENSION);
+    return name_len > ext_len &&
+           strcmp(name + name_len - ext_len, BUNNYCONNECT_SNIPPETS_EXTENSION) == 0;
+}
+
+BunnyConnectSnippets* bunnyconnect_snippets_alloc(void) {
+    BunnyConnectSnippets* snippets = malloc(sizeof(BunnyConnectSnippets));
+    memset(snippets, 0, sizeof(BunnyConnectSnippets));
+
+    snippets->storage = furi_record_open(RECORD_STORAGE);
+    snippets->files = malloc(BUNNYCONNECT_SNIPPETS_MAX_FILES * sizeof(SnippetsIndexFile));
+
+    return snippets;
+}
+
+void bunnyconnect_snippets_free(BunnyConnectSnippets* snippets) {
+    if(!snippets) return;
+
+    if(snippets->dirty) {
+        snippets_index_save(snippets);
+    }
+
+    free(snippets->files);
+    free(snippets->entries);
+    furi_record_close(RECORD_STORAGE);
+    free(snippets);
+}
+
+bool bunnyconnect_snippets_sync(BunnyConnectSnippets* snippets) {
+    furi_assert(snippets);
+
+    uint32_t start = furi_get_tick();
+
+    SnippetsIndexFile* old_files;
+    SnippetsIndexEntry* old_entries;
+    size_t old_file_count;
+    size_t old_entry_count;
+
+    if(snippets->entry_count == 0 && snippets->file_count == 0) {
+        // Nothing in memory yet, start from the on-SD index
+        snippets_index_load(
+            snippets, &old_files, &old_file_count, &old_entries, &old_entry_count);
+    } else {
+        old_files = malloc(snippets->file_count * sizeof(SnippetsIndexFile) + 1);
+        memcpy(old_files, snippets->files, snippets->file_count * sizeof(SnippetsIndexFile));
+        old_file_count = snippets->file_count;
+        old_entries = snippets->entries;
+        old_entry_count = snippets->entry_count;
+        snippets->entries = NULL;
+        snippets->entry_capacity = 0;
+    }
+
+    snippets->file_count = 0;
+    snippets->entry_count = 0;
+
+    storage_simply_mkdir(snippets->storage, BUNNYCONNECT_SNIPPETS_PATH);
+
+    File* dir = storage_file_alloc(snippets->storage);
+    FuriString* path = furi_string_alloc();
+    char name[BUNNYCONNECT_SNIPPETS_NAME_SIZE];
+    FileInfo info;
+    size_t parsed = 0;
+    bool success = storage_dir_open(dir, BUNNYCONNECT_SNIPPETS_PATH);
+
+    while(success && snippets->file_count < BUNNYCONNECT_SNIPPETS_MAX_FILES &&
+          storage_dir_read(dir, &info, name, sizeof(name))) {
+        if(file_info_is_dir(&info) || !snippets_has_extension(name)) continue;
+
+        SnippetsIndexFile* file = &snippets->files[snippets->file_count];
+        uint16_t file_index = snippets->file_count;
+        memset(file, 0, sizeof(SnippetsIndexFile));
+        strlcpy(file->name, name, sizeof(file->name));
+        file->size = info.size;
+
+        snippets_file_path(path, name);
+        storage_common_timestamp(snippets->storage, furi_string_get_cstr(path), &file->timestamp);
+
+        const SnippetsIndexFile* cached = NULL;
+        for(size_t i = 0; i < old_file_count; i++) {
+            if(strcmp(old_files[i].name, file->name) == 0) {
+                cached = &old_files[i];
+                break;
+            }
+        }
+
+        if(cached && cached->size == file->size && cached->timestamp == file->timestamp &&
+           cached->first_entry + cached->entry_count <= old_entry_count) {
+            file->first_entry = snippets->entry_count;
+            for(size_t i = 0; i < cached->entry_count; i++) {
+                SnippetsIndexEntry* entry = snippets_entry_add(snippets);
+                if(!entry) break;
+                *entry = old_entries[cached->first_entry + i];
+                entry->file = file_index;
+            }
+            file->entry_count = snippets->entry_count - file->first_entry;
+        } else {
+            snippets_parse_file(snippets, file, file_index);
+            parsed++;
+        }
+
+        snippets->file_count++;
+    }
+
+    if(success && (parsed > 0 || snippets->file_count != old_file_count)) {
+        snippets->dirty = true;
+    }
+
+    storage_dir_close(dir);
+    storage_file_free(dir);
+    furi_string_free(path);
+    free(old_files);
+    free(old_entries);
+
+    if(snippets->dirty) {
+        snippets_index_save(snippets);
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Synced %u snippets from %u files (%u parsed) in %lu ms",
+        snippets->entry_count,
+        snippets->file_count,
+        parsed,
+        furi_get_tick() - start);
+
+    return success;
+}
+
+size_t bunnyconnect_snippets_get_count(BunnyConnectSnippets* snippets) {
+    furi_assert(snippets);
+    return snippets->entry_count;
+}
+
+const char* bunnyconnect_snippets_get_name(BunnyConnectSnippets* snippets, size_t index) {
+    furi_assert(snippets);
+    if(index >= snippets->entry_count) return NULL;
+    return snippets->entries[index].name;
+}
+
+char* bunnyconnect_snippets_load(BunnyConnectSnippets* snippets, size_t index, size_t* length) {
+    furi_assert(snippets);
+    if(index >= snippets->entry_count) return NULL;
+
+    SnippetsIndexEntry* entry = &snippets->entries[index];
+    SnippetsIndexFile* file = &snippets->files[entry->file];
+    FuriString* path = furi_string_alloc();
+    Stream* stream = file_stream_alloc(snippets->storage);
+    char* body = malloc(entry->length + 1);
+    bool success = false;
+
+    do {
+        snippets_file_path(path, file->name);
+        if(!file_stream_open(stream, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+        if(!stream_seek(stream, entry->offset, StreamOffsetFromStart)) break;
+        if(stream_read(stream, (uint8_t*)body, entry->length) != entry->length) break;
+
+        uint32_t hash = snippets_hash_update(2166136261UL, (uint8_t*)body, entry->length);
+        if(hash != entry->hash) {
+            FURI_LOG_W(TAG, "Snippet %s changed on SD, index is stale", entry->name);
+            // Force a reparse of this file on the next sync
+            file->timestamp = 0;
+            snippets->dirty = true;
+            break;
+        }
+
+        body[entry->length] = '\0';
+        *length = entry->length;
+        success = true;
+    } while(false);
+
+    file_stream_close(stream);
+    stream_free(stream);
+    furi_string_free(path);
+
+    if(!success) {
+        free(body);
+        body = NULL;
+    }
+    return body;
+}
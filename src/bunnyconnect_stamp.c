@@ -0,0 +1,399 @@
+#include "../lib/bunnyconnect_stamp.h"
+#include <furi.h>
+
+#define STAMP_MORE     0x40 // Another payload byte follows
+#define STAMP_BITS     6
+#define STAMP_UNKNOWN  "    -.--- "
+#define STAMP_SECONDS  100000UL // Shown seconds wrap after 27 hours
+
+_Static_assert(
+    sizeof(STAMP_UNKNOWN) - 1 == BUNNYCONNECT_STAMP_PREFIX,
+    "Unknown stamp must be as wide as a known one");
+_Static_assert(
+    BUNNYCONNECT_STAMP_PREFIX >= 2 * BUNNYCONNECT_STAMP_MAX - 2,
+    "A prefix must not be shorter than the markers it replaces");
+
+bool bunnyconnect_stamp_is_lead(uint8_t c) {
+    return c == BUNNYCONNECT_STAMP_DELTA || c == BUNNYCONNECT_STAMP_ABS;
+}
+
+size_t bunnyconnect_stamp_encode(uint8_t lead, uint32_t ms, uint8_t* out) {
+    furi_assert(bunnyconnect_stamp_is_lead(lead));
+    furi_assert(out);
+
+    uint32_t max = lead == BUNNYCONNECT_STAMP_ABS ? BUNNYCONNECT_STAMP_ABS_MAX :
+                                                    BUNNYCONNECT_STAMP_DELTA_MAX;
+    ms = MIN(ms, max);
+    size_t groups = 1;
+    while(groups < BUNNYCONNECT_STAMP_MAX - 1 && (ms >> (STAMP_BITS * groups)) != 0) {
+        groups++;
+    }
+
+    out[0] = lead;
+    for(size_t i = 0; i < groups; i++) {
+        uint8_t bits = (ms >> (STAMP_BITS * (groups - 1 - i))) & 0x3F;
+        out[1 + i] = BUNNYCONNECT_STAMP_PAYLOAD | bits | (i + 1 < groups ? STAMP_MORE : 0);
+    }
+    return 1 + groups;
+}
+
+bool bunnyconnect_stamp_clock_feed(BunnyConnectStampClock* clock, uint8_t c) {
+    furi_assert(clock);
+
+    if(!clock->lead) {
+        if(!bunnyconnect_stamp_is_lead(c)) return false;
+        clock->lead = c;
+        clock->value = 0;
+        return true;
+    }
+
+    // The lead again is text, anything else but payload ends a cut marker
+    if(!(c & BUNNYCONNECT_STAMP_PAYLOAD)) {
+        bool text = c == clock->lead;
+        clock->lead = 0;
+        return text ? false : bunnyconnect_stamp_clock_feed(clock, c);
+    }
+
+    clock->value = (clock->value << STAMP_BITS) | (c & 0x3F);
+    if(c & STAMP_MORE) return true;
+
+    if(clock->lead == BUNNYCONNECT_STAMP_ABS) {
+        clock->ms = clock->value;
+        clock->known = true;
+    } else if(clock->known) {
+        clock->ms += clock->value;
+    }
+    clock->lead = 0;
+    return true;
+}
+
+static void stamp_line_add(BunnyConnectStampLine* line, uint8_t lead, uint32_t value) {
+    line->stamped = true;
+    if(lead == BUNNYCONNECT_STAMP_ABS) {
+        line->has_abs = true;
+        line->abs = value;
+    } else {
+        line->has_delta = true;
+        line->delta = value;
+    }
+}
+
+static size_t stamp_parse(const char* text, size_t i, size_t len, BunnyConnectStampLine* line) {
+    memset(line, 0, sizeof(BunnyConnectStampLine));
+    while(i < len && bunnyconnect_stamp_is_lead(text[i])) {
+        // A doubled lead is text, so is one whose double the snapshot cut off
+        if(i + 1 < len && !((uint8_t)text[i + 1] & BUNNYCONNECT_STAMP_PAYLOAD)) break;
+        uint8_t lead = text[i++];
+        uint32_t value = 0;
+        while(i < len) {
+            uint8_t c = text[i++];
+            value = (value << STAMP_BITS) | (c & 0x3F);
+            if(!(c & STAMP_MORE)) break;
+        }
+
+        stamp_line_add(line, lead, value);
+    }
+    return i;
+}
+
+// Line text with doubled leads made single, out never runs ahead of text
+static size_t stamp_copy_text(char* out, const char* text, size_t len) {
+    size_t copied = 0;
+    for(size_t i = 0; i < len; i++) {
+        out[copied++] = text[i];
+        if(bunnyconnect_stamp_is_lead(text[i]) && i + 1 < len && text[i + 1] == text[i]) i++;
+    }
+    return copied;
+}
+
+static size_t stamp_line_end(const char* text, size_t i, size_t len) {
+    const char* newline = memchr(text + i, '\n', len - i);
+    return newline ? (size_t)(newline - text) + 1 : len;
+}
+
+static void stamp_walk_line(BunnyConnectStampWalk* walk, const BunnyConnectStampLine* line) {
+    if(walk->line == walk->base_line) {
+        walk->ms = walk->base_ms;
+        walk->known = true;
+    } else if(line->has_abs) {
+        walk->ms = line->abs;
+        walk->known = true;
+    } else if(line->has_delta && walk->known) {
+        walk->ms += line->delta;
+    }
+    walk->line++;
+}
+
+// Follow the delta chain to the first absolute marker, true once it is found
+static bool stamp_chain_line(
+    BunnyConnectStampWalk* walk,
+    const BunnyConnectStampLine* line,
+    size_t n,
+    size_t* first,
+    uint32_t* sum) {
+    if(!line->stamped) return false;
+
+    // A stamped line without a delta cuts the chain to earlier lines
+    if(*first == BUNNYCONNECT_STAMP_NO_LINE || !line->has_delta) {
+        *first = n;
+        *sum = 0;
+    } else {
+        *sum += line->delta;
+    }
+    if(line->has_abs) {
+        walk->base_line = *first;
+        walk->base_ms = line->abs - *sum;
+        return true;
+    }
+    return false;
+}
+
+// Time of the first stamped line that an absolute marker can be traced back to
+static void stamp_find_base(
+    const char* text,
+    size_t start,
+    size_t len,
+    BunnyConnectStampWalk* walk) {
+    size_t first = BUNNYCONNECT_STAMP_NO_LINE;
+    uint32_t sum = 0;
+    walk->base_line = BUNNYCONNECT_STAMP_NO_LINE;
+
+    for(size_t i = start, n = 0; i < len; n++) {
+        BunnyConnectStampLine line;
+        size_t body = stamp_parse(text, i, len, &line);
+        i = stamp_line_end(text, body, len);
+        if(stamp_chain_line(walk, &line, n, &first, &sum)) return;
+    }
+}
+
+static size_t stamp_strip(char* text, size_t start, size_t len) {
+    size_t out = 0;
+    for(size_t i = start; i < len;) {
+        BunnyConnectStampLine line;
+        size_t body = stamp_parse(text, i, len, &line);
+        i = stamp_line_end(text, body, len);
+        out += stamp_copy_text(text + out, text + body, i - body);
+    }
+    text[out] = '\0';
+    return out;
+}
+
+// "sssss.mmm " for a line, unterminated
+static void stamp_prefix(
+    const BunnyConnectStampWalk* walk,
+    const BunnyConnectStampLine* line,
+    char* out) {
+    if(line->stamped && walk->known) {
+        char prefix[BUNNYCONNECT_STAMP_PREFIX + 1];
+        snprintf(
+            prefix,
+            sizeof(prefix),
+            "%5lu.%03lu ",
+            (walk->ms / 1000) % STAMP_SECONDS,
+            walk->ms % 1000);
+        memcpy(out, prefix, BUNNYCONNECT_STAMP_PREFIX);
+    } else {
+        memcpy(out, STAMP_UNKNOWN, BUNNYCONNECT_STAMP_PREFIX);
+    }
+}
+
+size_t bunnyconnect_stamp_unescape(uint8_t* data, size_t len, uint8_t* held) {
+    furi_assert(data || !len);
+    furi_assert(held);
+
+    size_t out = 0;
+    for(size_t i = 0; i < len; i++) {
+        uint8_t c = data[i];
+        if(*held && c == *held) {
+            *held = 0;
+            continue;
+        }
+        *held = bunnyconnect_stamp_is_lead(c) ? c : 0;
+        data[out++] = c;
+    }
+    return out;
+}
+
+size_t bunnyconnect_stamp_render(char* text, size_t len, size_t size, bool show, bool cut) {
+    furi_assert(text);
+    furi_assert(len < size);
+
+    // Payload bytes of a cut marker are not text. Anywhere else bytes of 0x80
+    // and up are, e.g. UTF-8.
+    size_t start = 0;
+    while(cut && start < len && ((uint8_t)text[start] & BUNNYCONNECT_STAMP_PAYLOAD)) {
+        start++;
+    }
+    if(!show) return stamp_strip(text, start, len);
+
+    BunnyConnectStampWalk walk = {0};
+    stamp_find_base(text, start, len, &walk);
+
+    // Every line grows by the prefix minus its markers
+    size_t total = 0;
+    for(size_t i = start; i < len;) {
+        BunnyConnectStampLine line;
+        size_t body = stamp_parse(text, i, len, &line);
+        i = stamp_line_end(text, body, len);
+        total += BUNNYCONNECT_STAMP_PREFIX + (i - body);
+    }
+
+    // Drop the oldest lines until the rest fits, their stamps still move the clock
+    while(start < len && total > size - 1) {
+        BunnyConnectStampLine line;
+        size_t body = stamp_parse(text, start, len, &line);
+        stamp_walk_line(&walk, &line);
+        start = stamp_line_end(text, body, len);
+        total -= BUNNYCONNECT_STAMP_PREFIX + (start - body);
+    }
+
+    // Move the input to the end, the output then never overtakes it
+    size_t in = size - 1 - (len - start);
+    memmove(text + in, text + start, len - start);
+    len = size - 1;
+
+    size_t out = 0;
+    while(in < len) {
+        BunnyConnectStampLine line;
+        size_t body = stamp_parse(text, in, len, &line);
+        stamp_walk_line(&walk, &line);
+        in = stamp_line_end(text, body, len);
+
+        // A prefix is never shorter than the markers it replaces, the copy
+        // moves text towards the front
+        if(out + BUNNYCONNECT_STAMP_PREFIX + (in - body) > in) break; // Corrupt markers
+        size_t body_len =
+            stamp_copy_text(text + out + BUNNYCONNECT_STAMP_PREFIX, text + body, in - body);
+        stamp_prefix(&walk, &line, text + out);
+        out += BUNNYCONNECT_STAMP_PREFIX + body_len;
+    }
+    text[out] = '\0';
+    return out;
+}
+
+void bunnyconnect_stamp_stream_init(BunnyConnectStampStream* stream, bool show, bool cut) {
+    furi_assert(stream);
+    memset(stream, 0, sizeof(BunnyConnectStampStream));
+    stream->show = show;
+    stream->skip = cut;
+    stream->walk.base_line = BUNNYCONNECT_STAMP_NO_LINE;
+    stream->chain = BUNNYCONNECT_STAMP_NO_LINE;
+}
+
+// Markers at a line start, true if c belongs to one. A lead still set on
+// false is text, c may be its double.
+static bool stamp_stream_marker(BunnyConnectStampStream* stream, uint8_t c) {
+    if(stream->skip) {
+        if(c & BUNNYCONNECT_STAMP_PAYLOAD) return true;
+        stream->skip = false;
+    }
+    if(stream->text) return false;
+
+    if(stream->lead) {
+        if(c & BUNNYCONNECT_STAMP_PAYLOAD) {
+            stream->payload = true;
+            stream->value = (stream->value << STAMP_BITS) | (c & 0x3F);
+            if(!(c & STAMP_MORE)) {
+                stamp_line_add(&stream->line, stream->lead, stream->value);
+                stream->lead = 0;
+            }
+            return true;
+        }
+        if(!stream->payload) return false;
+        stream->lead = 0; // Cut short, c starts afresh
+    }
+    if(!bunnyconnect_stamp_is_lead(c)) return false;
+    stream->lead = c;
+    stream->value = 0;
+    stream->payload = false;
+    return true;
+}
+
+static void stamp_stream_line_end(BunnyConnectStampStream* stream) {
+    stream->text = false;
+    memset(&stream->line, 0, sizeof(BunnyConnectStampLine));
+}
+
+void bunnyconnect_stamp_stream_scan(
+    BunnyConnectStampStream* stream,
+    const uint8_t* data,
+    size_t len) {
+    furi_assert(stream);
+    furi_assert(data || !len);
+
+    for(size_t i = 0; i < len && !stream->found; i++) {
+        if(stamp_stream_marker(stream, data[i])) continue;
+        if(!stream->text) {
+            stream->text = true;
+            stream->lead = 0;
+            stream->found = stamp_chain_line(
+                &stream->walk,
+                &stream->line,
+                stream->walk.line,
+                &stream->chain,
+                &stream->chain_sum);
+            stream->walk.line++;
+        }
+        if(data[i] == '\n') stamp_stream_line_end(stream);
+    }
+}
+
+void bunnyconnect_stamp_stream_restart(
+    BunnyConnectStampStream* stream,
+    bool keep_base,
+    bool cut) {
+    furi_assert(stream);
+    BunnyConnectStampWalk walk = stream->walk;
+    bunnyconnect_stamp_stream_init(stream, stream->show, cut);
+    if(keep_base) {
+        stream->walk.base_line = walk.base_line;
+        stream->walk.base_ms = walk.base_ms;
+    }
+}
+
+size_t bunnyconnect_stamp_stream_render(
+    BunnyConnectStampStream* stream,
+    const uint8_t* data,
+    size_t len,
+    char* out,
+    size_t size,
+    size_t* used) {
+    furi_assert(stream);
+    furi_assert(data || !len);
+    furi_assert(out);
+    furi_assert(size > BUNNYCONNECT_STAMP_PREFIX + 1);
+    furi_assert(used);
+
+    // A byte adds at most a prefix, a lead held back as text and itself
+    size_t written = 0;
+    size_t i = 0;
+    for(; i < len && written + BUNNYCONNECT_STAMP_PREFIX + 2 <= size; i++) {
+        uint8_t c = data[i];
+        if(stamp_stream_marker(stream, c)) continue;
+
+        if(!stream->text) {
+            stream->text = true;
+            stamp_walk_line(&stream->walk, &stream->line);
+            if(stream->show) {
+                stamp_prefix(&stream->walk, &stream->line, out + written);
+                written += BUNNYCONNECT_STAMP_PREFIX;
+            }
+            if(stream->lead) {
+                bool pair = c == stream->lead;
+                out[written++] = stream->lead;
+                stream->lead = 0;
+                if(pair) continue;
+            }
+        }
+
+        if(stream->held && c == stream->held) {
+            stream->held = 0;
+            continue;
+        }
+        stream->held = bunnyconnect_stamp_is_lead(c) ? c : 0;
+        out[written++] = c;
+        if(c == '\n') stamp_stream_line_end(stream);
+    }
+    *used = i;
+    return written;
+}
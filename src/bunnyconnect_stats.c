@@ -0,0 +1,149 @@
+#include "../lib/bunnyconnect_stats.h"
+#include "../lib/bunnyconnect_trace.h"
+#include <gui/elements.h>
+#include <furi.h>
+
+#define STATS_HEADER_HEIGHT 11
+#define STATS_LINE_HEIGHT   10
+#define STATS_VISIBLE_LINES ((64 - STATS_HEADER_HEIGHT) / STATS_LINE_HEIGHT)
+
+struct BunnyConnectStats {
+    View* view;
+    BunnyConnectStatsCallback callback;
+    void* context;
+};
+
+typedef struct {
+    uint32_t values[BunnyConnectCounterCount];
+    uint32_t deltas[BunnyConnectCounterCount];
+    bool primed; // Values hold a previous update
+    bool valid; // Deltas need two updates
+    size_t scroll;
+} BunnyConnectStatsModel;
+
+static bool bunnyconnect_stats_is_gauge(BunnyConnectCounter counter) {
+    return counter == BunnyConnectCounterCdcQueuePeak ||
+           counter == BunnyConnectCounterHidQueuePeak;
+}
+
+static void bunnyconnect_stats_draw_callback(Canvas* canvas, void* _model) {
+    BunnyConnectStatsModel* model = _model;
+    char line[24];
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawBegin, BunnyConnectTraceViewStats);
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 9, "Stats");
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(canvas, 124, 9, AlignRight, AlignBottom, "OK: dump");
+    canvas_draw_line(canvas, 0, STATS_HEADER_HEIGHT - 1, 127, STATS_HEADER_HEIGHT - 1);
+
+    for(size_t i = 0; i < STATS_VISIBLE_LINES; i++) {
+        size_t counter = model->scroll + i;
+        if(counter >= BunnyConnectCounterCount) break;
+        int32_t y = STATS_HEADER_HEIGHT + (i + 1) * STATS_LINE_HEIGHT - 1;
+
+        canvas_draw_str(canvas, 0, y, bunnyconnect_counters_name(counter));
+        snprintf(line, sizeof(line), "%lu", model->values[counter]);
+        canvas_draw_str_aligned(canvas, 88, y, AlignRight, AlignBottom, line);
+        if(model->valid && !bunnyconnect_stats_is_gauge(counter)) {
+            snprintf(line, sizeof(line), "+%lu", model->deltas[counter]);
+            canvas_draw_str_aligned(canvas, 124, y, AlignRight, AlignBottom, line);
+        }
+    }
+
+    elements_scrollbar_pos(
+        canvas,
+        128,
+        STATS_HEADER_HEIGHT,
+        64 - STATS_HEADER_HEIGHT,
+        model->scroll,
+        BunnyConnectCounterCount - STATS_VISIBLE_LINES + 1);
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawEnd, BunnyConnectTraceViewStats);
+}
+
+static bool bunnyconnect_stats_input_callback(InputEvent* event, void* context) {
+    BunnyConnectStats* stats = context;
+    furi_assert(stats);
+
+    if(event->type != InputTypeShort && event->type != InputTypeRepeat) return false;
+
+    if(event->key == InputKeyOk) {
+        if(event->type == InputTypeShort && stats->callback) {
+            stats->callback(stats->context);
+        }
+        return true;
+    }
+    if(event->key != InputKeyUp && event->key != InputKeyDown) return false;
+
+    with_view_model(
+        stats->view,
+        BunnyConnectStatsModel * model,
+        {
+            if(event->key == InputKeyUp && model->scroll > 0) {
+                model->scroll--;
+            } else if(
+                event->key == InputKeyDown &&
+                model->scroll + STATS_VISIBLE_LINES < BunnyConnectCounterCount) {
+                model->scroll++;
+            }
+        },
+        true);
+    return true;
+}
+
+BunnyConnectStats* bunnyconnect_stats_alloc(void) {
+    BunnyConnectStats* stats = malloc(sizeof(BunnyConnectStats));
+    stats->callback = NULL;
+    stats->context = NULL;
+    stats->view = view_alloc();
+    view_set_context(stats->view, stats);
+    view_allocate_model(stats->view, ViewModelTypeLocking, sizeof(BunnyConnectStatsModel));
+    view_set_draw_callback(stats->view, bunnyconnect_stats_draw_callback);
+    view_set_input_callback(stats->view, bunnyconnect_stats_input_callback);
+
+    with_view_model(
+        stats->view,
+        BunnyConnectStatsModel * model,
+        { memset(model, 0, sizeof(BunnyConnectStatsModel)); },
+        false);
+    return stats;
+}
+
+void bunnyconnect_stats_free(BunnyConnectStats* stats) {
+    furi_assert(stats);
+    view_free(stats->view);
+    free(stats);
+}
+
+View* bunnyconnect_stats_get_view(BunnyConnectStats* stats) {
+    furi_assert(stats);
+    return stats->view;
+}
+
+void bunnyconnect_stats_set_dump_callback(
+    BunnyConnectStats* stats,
+    BunnyConnectStatsCallback callback,
+    void* context) {
+    furi_assert(stats);
+    stats->callback = callback;
+    stats->context = context;
+}
+
+void bunnyconnect_stats_update(BunnyConnectStats* stats, const uint32_t* values) {
+    furi_assert(stats);
+    furi_assert(values);
+    with_view_model(
+        stats->view,
+        BunnyConnectStatsModel * model,
+        {
+            for(size_t i = 0; i < BunnyConnectCounterCount; i++) {
+                model->deltas[i] = values[i] - model->values[i];
+                model->values[i] = values[i];
+            }
+            model->valid = model->primed;
+            model->primed = true;
+        },
+        true);
+}
@@ -0,0 +1,298 @@
+#include "../lib/bunnyconnect_tabs.h"
+#include "../lib/bunnyconnect_stamp.h"
+#include <furi.h>
+#include <storage/storage.h>
+#include <stdatomic.h>
+
+#define TAG "BunnyTabs"
+
+#define TABS_ALIGN_SLACK  4 // Per region, the arena word aligns each carve
+#define TABS_ANCHOR_LINES 16 // Absolute stamp every so many lines, deltas between
+#define TABS_SAVE_CHUNK   64 // Ring bytes read at a time while saving logs
+#define TABS_SAVE_TEXT    128 // Rendered bytes written at a time
+
+typedef struct {
+    BunnyConnectScrollback* scrollback;
+    size_t capacity;
+    atomic_uint_least32_t rx_bytes;
+    atomic_uint_least32_t rx_chunks;
+    atomic_bool has_stamps; // Set by the producer on the first marker
+
+    // Producer only
+    bool line_start; // The next byte starts a line
+    bool stamping; // Last append was stamped
+    bool stamped; // last_ms is set
+    uint8_t anchor_in; // Lines until the next absolute stamp
+    uint32_t last_ms;
+} BunnyConnectTab;
+
+struct BunnyConnectTabs {
+    BunnyConnectTab tabs[BunnyConnectTabCount];
+    atomic_uint_least8_t active; // GUI thread writes, producers read
+    atomic_bool stamping; // GUI thread writes, producers read
+    uint32_t start_tick;
+};
+
+static const struct {
+    const char* name;
+    const char* log;
+    uint8_t shift; // Share of the budget scrollback, as a right shift
+} tab_info[BunnyConnectTabCount] = {
+    [BunnyConnectTabCdc] = {"CDC", BUNNYCONNECT_TABS_LOG_DIR "/cdc.log", 0},
+    [BunnyConnectTabUart] = {"UART", BUNNYCONNECT_TABS_LOG_DIR "/uart.log", 1},
+    [BunnyConnectTabLoopback] = {"LOOP", BUNNYCONNECT_TABS_LOG_DIR "/loop.log", 2},
+};
+
+size_t bunnyconnect_tabs_size(size_t scrollback) {
+    size_t size = sizeof(BunnyConnectTabs) + TABS_ALIGN_SLACK;
+    for(size_t i = 0; i < BunnyConnectTabCount; i++) {
+        size += (scrollback >> tab_info[i].shift) + BUNNYCONNECT_SCROLLBACK_OVERHEAD +
+                TABS_ALIGN_SLACK;
+    }
+    return size;
+}
+
+BunnyConnectTabs* bunnyconnect_tabs_alloc(BunnyConnectArena* arena, size_t scrollback) {
+    furi_assert(arena);
+
+    BunnyConnectTabs* tabs = bunnyconnect_arena_carve(arena, "tabs", sizeof(BunnyConnectTabs));
+    for(size_t i = 0; i < BunnyConnectTabCount; i++) {
+        BunnyConnectTab* tab = &tabs->tabs[i];
+        tab->capacity = scrollback >> tab_info[i].shift;
+        tab->scrollback = bunnyconnect_scrollback_alloc(arena, tab_info[i].name, tab->capacity);
+        atomic_init(&tab->rx_bytes, 0);
+        atomic_init(&tab->rx_chunks, 0);
+        atomic_init(&tab->has_stamps, false);
+        tab->line_start = true;
+    }
+    atomic_init(&tabs->active, BunnyConnectTabCdc);
+    atomic_init(&tabs->stamping, false);
+    tabs->start_tick = furi_get_tick();
+    return tabs;
+}
+
+const char* bunnyconnect_tabs_name(BunnyConnectTabId id) {
+    return id < BunnyConnectTabCount ? tab_info[id].name : "?";
+}
+
+// Delta to the previous stamped line, plus an absolute time now and then
+static void tabs_stamp(BunnyConnectTab* tab, uint32_t now) {
+    uint8_t marker[2 * BUNNYCONNECT_STAMP_MAX];
+    size_t len = 0;
+    uint32_t delta = now - tab->last_ms;
+
+    if(tab->stamped) {
+        len += bunnyconnect_stamp_encode(BUNNYCONNECT_STAMP_DELTA, delta, marker);
+    }
+    if(!tab->stamped || !tab->anchor_in || delta > BUNNYCONNECT_STAMP_DELTA_MAX) {
+        len += bunnyconnect_stamp_encode(BUNNYCONNECT_STAMP_ABS, now, marker + len);
+        tab->anchor_in = TABS_ANCHOR_LINES;
+    }
+    tab->anchor_in--;
+    if(!tab->stamped) atomic_store_explicit(&tab->has_stamps, true, memory_order_relaxed);
+    tab->stamped = true;
+    tab->last_ms = now;
+    bunnyconnect_scrollback_write(tab->scrollback, marker, len);
+}
+
+// Lead bytes that are text go in twice, they must not start a marker
+static void tabs_write(BunnyConnectTab* tab, const uint8_t* data, size_t len) {
+    while(len > 0) {
+        size_t part = 0;
+        while(part < len && !bunnyconnect_stamp_is_lead(data[part])) {
+            part++;
+        }
+        if(part == len) {
+            bunnyconnect_scrollback_write(tab->scrollback, data, len);
+            return;
+        }
+        uint8_t pair[] = {data[part], data[part]};
+        if(part) bunnyconnect_scrollback_write(tab->scrollback, data, part);
+        bunnyconnect_scrollback_write(tab->scrollback, pair, sizeof(pair));
+        data += part + 1;
+        len -= part + 1;
+    }
+}
+
+bool bunnyconnect_tabs_append(
+    BunnyConnectTabs* tabs,
+    BunnyConnectTabId id,
+    const uint8_t* data,
+    size_t len) {
+    furi_assert(tabs);
+    furi_assert(id < BunnyConnectTabCount);
+    if(!len) return false;
+
+    BunnyConnectTab* tab = &tabs->tabs[id];
+    atomic_fetch_add_explicit(&tab->rx_bytes, len, memory_order_relaxed);
+    atomic_fetch_add_explicit(&tab->rx_chunks, 1, memory_order_relaxed);
+
+    bool stamping = atomic_load_explicit(&tabs->stamping, memory_order_relaxed);
+    if(stamping && !tab->stamping) {
+        tab->anchor_in = 0; // Times resume with an anchor
+    }
+    tab->stamping = stamping;
+
+    if(!stamping) {
+        tabs_write(tab, data, len);
+        tab->line_start = data[len - 1] == '\n';
+    } else {
+        // One write per line, each line that starts here gets its stamp first
+        uint32_t now = furi_get_tick() - tabs->start_tick;
+        while(len > 0) {
+            if(tab->line_start) tabs_stamp(tab, now);
+            const uint8_t* newline = memchr(data, '\n', len);
+            size_t part = newline ? (size_t)(newline - data) + 1 : len;
+            tabs_write(tab, data, part);
+            tab->line_start = newline != NULL;
+            data += part;
+            len -= part;
+        }
+    }
+    return atomic_load_explicit(&tabs->active, memory_order_relaxed) == id;
+}
+
+BunnyConnectScrollback*
+    bunnyconnect_tabs_get_scrollback(BunnyConnectTabs* tabs, BunnyConnectTabId id) {
+    furi_assert(tabs);
+    furi_assert(id < BunnyConnectTabCount);
+    return tabs->tabs[id].scrollback;
+}
+
+size_t bunnyconnect_tabs_snapshot(
+    BunnyConnectTabs* tabs,
+    BunnyConnectTabId id,
+    char* out,
+    size_t size,
+    bool* cut) {
+    furi_assert(tabs);
+    furi_assert(id < BunnyConnectTabCount);
+    furi_assert(cut);
+
+    BunnyConnectTab* tab = &tabs->tabs[id];
+    size_t len = bunnyconnect_scrollback_snapshot(tab->scrollback, out, size);
+
+    // Neither wrapped nor cut to size, the copy starts with the first byte written.
+    // Checked after the copy, later writes only make it err towards cut.
+    uint32_t tail, head;
+    bunnyconnect_scrollback_get_window(tab->scrollback, &tail, &head);
+    *cut = atomic_load_explicit(&tab->has_stamps, memory_order_relaxed) &&
+           (tail != 0 || len + 1 >= size);
+    return len;
+}
+
+void bunnyconnect_tabs_set_stamping(BunnyConnectTabs* tabs, bool stamping) {
+    furi_assert(tabs);
+    atomic_store_explicit(&tabs->stamping, stamping, memory_order_relaxed);
+}
+
+BunnyConnectTabId bunnyconnect_tabs_get_active(BunnyConnectTabs* tabs) {
+    furi_assert(tabs);
+    return atomic_load_explicit(&tabs->active, memory_order_relaxed);
+}
+
+BunnyConnectTabId bunnyconnect_tabs_step(BunnyConnectTabs* tabs, bool next) {
+    furi_assert(tabs);
+    uint8_t active = atomic_load_explicit(&tabs->active, memory_order_relaxed);
+    active = (active + (next ? 1 : BunnyConnectTabCount - 1)) % BunnyConnectTabCount;
+    atomic_store_explicit(&tabs->active, active, memory_order_relaxed);
+    return active;
+}
+
+void bunnyconnect_tabs_get_stats(
+    BunnyConnectTabs* tabs,
+    BunnyConnectTabId id,
+    BunnyConnectTabStats* stats) {
+    furi_assert(tabs);
+    furi_assert(id < BunnyConnectTabCount);
+    furi_assert(stats);
+    stats->rx_bytes = atomic_load_explicit(&tabs->tabs[id].rx_bytes, memory_order_relaxed);
+    stats->rx_chunks = atomic_load_explicit(&tabs->tabs[id].rx_chunks, memory_order_relaxed);
+}
+
+// Chunks of the ring are rendered as they are read, the producer keeps writing
+// meanwhile. A lap past the read position skips ahead to the new tail.
+static bool tabs_save_tab(BunnyConnectTab* tab, File* file, bool stamps, size_t* written) {
+    uint8_t chunk[TABS_SAVE_CHUNK];
+    char text[TABS_SAVE_TEXT];
+    BunnyConnectStampStream stream;
+    uint32_t tail, head;
+    *written = 0;
+
+    // Until the ring wraps it starts with the first byte ever written, not a cut marker
+    bool has_stamps = atomic_load_explicit(&tab->has_stamps, memory_order_relaxed);
+    bunnyconnect_scrollback_get_window(tab->scrollback, &tail, &head);
+    bunnyconnect_stamp_stream_init(&stream, stamps, has_stamps && tail != 0);
+
+    // Times ahead of the first absolute marker need it found first
+    bool keep_base = true;
+    for(uint32_t pos = tail; stamps && pos != head && !stream.found;) {
+        size_t len = MIN(head - pos, sizeof(chunk));
+        if(!bunnyconnect_scrollback_read(tab->scrollback, pos, chunk, len)) {
+            keep_base = false;
+            break;
+        }
+        bunnyconnect_stamp_stream_scan(&stream, chunk, len);
+        pos += len;
+    }
+    bunnyconnect_stamp_stream_restart(&stream, keep_base, has_stamps && tail != 0);
+
+    for(uint32_t pos = tail; pos != head;) {
+        size_t len = MIN(head - pos, sizeof(chunk));
+        if(!bunnyconnect_scrollback_read(tab->scrollback, pos, chunk, len)) {
+            uint32_t now;
+            bunnyconnect_scrollback_get_window(tab->scrollback, &pos, &now);
+            if((int32_t)(head - pos) <= 0) break;
+            FURI_LOG_W(TAG, "Log lapped while saving, %lu B skipped", pos - tail);
+            bool cut = stream.text;
+            bunnyconnect_stamp_stream_restart(&stream, false, has_stamps);
+            if(cut && storage_file_write(file, "\n", 1) != 1) return false;
+            continue;
+        }
+        pos += len;
+
+        for(size_t done = 0; done < len;) {
+            size_t used;
+            size_t text_len = bunnyconnect_stamp_stream_render(
+                &stream, chunk + done, len - done, text, sizeof(text), &used);
+            if(storage_file_write(file, text, text_len) != text_len) return false;
+            *written += text_len;
+            done += used;
+        }
+        tail = pos;
+    }
+    return true;
+}
+
+bool bunnyconnect_tabs_save_logs(
+    BunnyConnectTabs* tabs,
+    Storage* storage,
+    bool stamps,
+    size_t* saved) {
+    furi_assert(tabs);
+    furi_assert(storage);
+    if(saved) *saved = 0;
+    storage_simply_mkdir(storage, BUNNYCONNECT_TABS_LOG_DIR);
+
+    File* file = storage_file_alloc(storage);
+    bool success = true;
+    for(size_t i = 0; i < BunnyConnectTabCount; i++) {
+        if(!bunnyconnect_scrollback_get_fill(tabs->tabs[i].scrollback)) continue;
+
+        const char* path = tab_info[i].log;
+        size_t len = 0;
+        bool written = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                       tabs_save_tab(&tabs->tabs[i], file, stamps, &len);
+        storage_file_close(file);
+        if(written) {
+            if(saved) (*saved)++;
+            FURI_LOG_I(TAG, "Saved %u B to %s", len, path);
+        } else {
+            FURI_LOG_E(TAG, "Failed to write %s", path);
+            success = false;
+        }
+    }
+
+    storage_file_free(file);
+    return success;
+}
@@ -0,0 +1,411 @@
+#include "../lib/bunnyconnect_terminal.h"
+#include "../lib/bunnyconnect_trace.h"
+#include <gui/elements.h>
+#include <furi.h>
+
+#define TERMINAL_STATUS_HEIGHT 10
+#define TERMINAL_LINE_HEIGHT   9
+#define TERMINAL_TEXT_WIDTH    122 // Leaves room for the scrollbar
+#define TERMINAL_VISIBLE_LINES ((64 - TERMINAL_STATUS_HEIGHT) / TERMINAL_LINE_HEIGHT)
+
+struct BunnyConnectTerminal {
+    View* view;
+    BunnyConnectTerminalTabCallback tab_callback;
+    void* tab_context;
+    BunnyConnectTerminalFilterCallback filter_callback;
+    void* filter_context;
+    BunnyConnectTerminalStampCallback stamp_callback;
+    void* stamp_context;
+    BunnyConnectTerminalSelectCallback select_callback;
+    void* select_context;
+};
+
+typedef struct {
+    char* text; // Caller owned, NULL while detached
+    size_t text_size;
+    char status[BUNNYCONNECT_TERMINAL_STATUS_SIZE];
+    size_t scroll; // Lines up from the end, 0 follows new output
+    bool selecting;
+    size_t select; // Picked text line, counted up from the last one
+} BunnyConnectTerminalModel;
+
+// Length of the wrapped line starting at text, sets next to the following one
+static size_t terminal_wrap_line(Canvas* canvas, const char* text, const char** next) {
+    size_t width = 0;
+    size_t len = 0;
+
+    while(text[len] != '\0' && text[len] != '\n') {
+        width += canvas_glyph_width(canvas, text[len]);
+        if(width > TERMINAL_TEXT_WIDTH && len > 0) break;
+        len++;
+    }
+
+    *next = text + len + (text[len] == '\n' ? 1 : 0);
+    return len;
+}
+
+static size_t terminal_count_lines(Canvas* canvas, const char* text) {
+    size_t lines = 0;
+    while(*text != '\0') {
+        terminal_wrap_line(canvas, text, &text);
+        lines++;
+    }
+    return lines;
+}
+
+// Text lines, before wrapping, a final newline does not start another one
+static size_t terminal_count_text_lines(const char* text) {
+    size_t lines = 0;
+    const char* line = text;
+    for(; *text != '\0'; text++) {
+        if(*text == '\n') {
+            lines++;
+            line = text + 1;
+        }
+    }
+    return lines + (*line != '\0' ? 1 : 0);
+}
+
+// Wrapped rows of a text line, counted from the top
+static void terminal_find_rows(
+    Canvas* canvas,
+    const char* text,
+    size_t line,
+    size_t* first,
+    size_t* last) {
+    size_t current = 0;
+    bool line_start = true;
+    *first = 0;
+    *last = 0;
+    for(size_t row = 0; *text != '\0'; row++) {
+        terminal_wrap_line(canvas, text, &text);
+        if(current == line) {
+            if(line_start) *first = row;
+            *last = row;
+        }
+        line_start = text[-1] == '\n';
+        if(line_start && ++current > line) return;
+    }
+}
+
+static void terminal_draw(Canvas* canvas, BunnyConnectTerminalModel* model) {
+    char line[64];
+
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontSecondary);
+
+    // Status bar
+    canvas_set_color(canvas, ColorBlack);
+    canvas_draw_box(canvas, 0, 0, 128, TERMINAL_STATUS_HEIGHT - 1);
+    canvas_set_color(canvas, ColorWhite);
+    canvas_draw_str(canvas, 2, TERMINAL_STATUS_HEIGHT - 2, model->status);
+    canvas_set_color(canvas, ColorBlack);
+    if(!model->text) return;
+
+    size_t total = terminal_count_lines(canvas, model->text);
+    size_t max_scroll = total > TERMINAL_VISIBLE_LINES ? total - TERMINAL_VISIBLE_LINES : 0;
+    if(model->scroll > max_scroll) model->scroll = max_scroll;
+    size_t first = max_scroll - model->scroll;
+
+    // Keep the picked line in view, its top row if it is taller than the screen
+    size_t select_first = 0;
+    size_t select_last = 0;
+    size_t lines = model->selecting ? terminal_count_text_lines(model->text) : 0;
+    if(lines > 0) {
+        if(model->select >= lines) model->select = lines - 1;
+        terminal_find_rows(
+            canvas, model->text, lines - 1 - model->select, &select_first, &select_last);
+        if(select_last >= first + TERMINAL_VISIBLE_LINES) {
+            first = select_last + 1 - TERMINAL_VISIBLE_LINES;
+        }
+        if(select_first < first) first = select_first;
+        model->scroll = max_scroll - first;
+    }
+
+    const char* text = model->text;
+    for(size_t i = 0; *text != '\0' && i < first + TERMINAL_VISIBLE_LINES; i++) {
+        const char* start = text;
+        size_t len = terminal_wrap_line(canvas, text, &text);
+        if(i < first) continue;
+
+        if(len >= sizeof(line)) len = sizeof(line) - 1;
+        memcpy(line, start, len);
+        line[len] = '\0';
+        int32_t y = TERMINAL_STATUS_HEIGHT + (i - first + 1) * TERMINAL_LINE_HEIGHT - 1;
+        if(lines > 0 && i >= select_first && i <= select_last) {
+            canvas_draw_box(
+                canvas,
+                0,
+                y - TERMINAL_LINE_HEIGHT + 2,
+                TERMINAL_TEXT_WIDTH,
+                TERMINAL_LINE_HEIGHT);
+            canvas_set_color(canvas, ColorWhite);
+        }
+        canvas_draw_str(canvas, 0, y, line);
+        canvas_set_color(canvas, ColorBlack);
+    }
+
+    if(max_scroll > 0) {
+        elements_scrollbar_pos(
+            canvas,
+            128,
+            TERMINAL_STATUS_HEIGHT,
+            64 - TERMINAL_STATUS_HEIGHT,
+            first,
+            max_scroll + 1);
+    }
+}
+
+static void bunnyconnect_terminal_draw_callback(Canvas* canvas, void* _model) {
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawBegin, BunnyConnectTraceViewTerminal);
+    terminal_draw(canvas, _model);
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceDrawEnd, BunnyConnectTraceViewTerminal);
+}
+
+// Keys while a line is picked, every one of them is taken
+static bool terminal_select_input(BunnyConnectTerminal* terminal, InputEvent* event) {
+    bool step = event->type == InputTypeShort || event->type == InputTypeRepeat;
+    BunnyConnectTerminalSelectEvent select_event;
+
+    if(event->key == InputKeyBack && event->type == InputTypeShort) {
+        select_event = BunnyConnectTerminalSelectEnd;
+    } else if(event->key == InputKeyOk && event->type == InputTypeShort) {
+        select_event = BunnyConnectTerminalSelectSendCdc;
+    } else if(event->key == InputKeyOk && event->type == InputTypeLong) {
+        select_event = BunnyConnectTerminalSelectSendHid;
+    } else if(event->key == InputKeyLeft && step) {
+        select_event = BunnyConnectTerminalSelectFieldPrev;
+    } else if(event->key == InputKeyRight && step) {
+        select_event = BunnyConnectTerminalSelectFieldNext;
+    } else if((event->key == InputKeyUp || event->key == InputKeyDown) && step) {
+        select_event = BunnyConnectTerminalSelectMove;
+    } else {
+        return true;
+    }
+
+    size_t line = 0;
+    with_view_model(
+        terminal->view,
+        BunnyConnectTerminalModel * model,
+        {
+            if(select_event == BunnyConnectTerminalSelectMove) {
+                size_t lines = terminal_count_text_lines(model->text);
+                if(event->key == InputKeyUp && model->select + 1 < lines) {
+                    model->select++;
+                } else if(event->key == InputKeyDown && model->select > 0) {
+                    model->select--;
+                }
+            }
+            if(select_event == BunnyConnectTerminalSelectSendCdc ||
+               select_event == BunnyConnectTerminalSelectSendHid ||
+               select_event == BunnyConnectTerminalSelectEnd) {
+                model->selecting = false;
+            }
+            line = model->select;
+        },
+        true);
+
+    // Outside the model lock, the callback updates the status bar
+    if(terminal->select_callback) {
+        terminal->select_callback(terminal->select_context, select_event, line);
+    }
+    return true;
+}
+
+static bool bunnyconnect_terminal_input_callback(InputEvent* event, void* context) {
+    BunnyConnectTerminal* terminal = context;
+    furi_assert(terminal);
+
+    bool selecting = false;
+    with_view_model(
+        terminal->view,
+        BunnyConnectTerminalModel * model,
+        { selecting = model->selecting; },
+        false);
+    if(selecting) return terminal_select_input(terminal, event);
+
+    if(event->key == InputKeyDown && event->type == InputTypeLong) {
+        if(!terminal->select_callback) return true;
+        with_view_model(
+            terminal->view,
+            BunnyConnectTerminalModel * model,
+            {
+                selecting = model->text && model->text[0] != '\0';
+                model->selecting = selecting;
+                model->select = 0;
+            },
+            true);
+        if(selecting) {
+            terminal->select_callback(
+                terminal->select_context, BunnyConnectTerminalSelectStart, 0);
+        }
+        return true;
+    }
+    if(event->key == InputKeyOk) {
+        bool edit = event->type == InputTypeLong;
+        if((edit || event->type == InputTypeShort) && terminal->filter_callback) {
+            terminal->filter_callback(terminal->filter_context, edit);
+        }
+        return true;
+    }
+    if((event->key == InputKeyLeft || event->key == InputKeyRight) &&
+       event->type == InputTypeLong) {
+        if(terminal->stamp_callback) terminal->stamp_callback(terminal->stamp_context);
+        return true;
+    }
+    if(event->type != InputTypeShort && event->type != InputTypeRepeat) return false;
+
+    if(event->key == InputKeyLeft || event->key == InputKeyRight) {
+        if(event->type == InputTypeShort && terminal->tab_callback) {
+            terminal->tab_callback(terminal->tab_context, event->key == InputKeyRight);
+        }
+        return true;
+    }
+    if(event->key != InputKeyUp && event->key != InputKeyDown) return false;
+
+    with_view_model(
+        terminal->view,
+        BunnyConnectTerminalModel * model,
+        {
+            if(event->key == InputKeyUp) {
+                model->scroll++; // Clamped on draw
+            } else if(model->scroll > 0) {
+                model->scroll--;
+            }
+        },
+        true);
+    return true;
+}
+
+BunnyConnectTerminal* bunnyconnect_terminal_alloc(void) {
+    BunnyConnectTerminal* terminal = malloc(sizeof(BunnyConnectTerminal));
+    terminal->tab_callback = NULL;
+    terminal->tab_context = NULL;
+    terminal->filter_callback = NULL;
+    terminal->filter_context = NULL;
+    terminal->stamp_callback = NULL;
+    terminal->stamp_context = NULL;
+    terminal->select_callback = NULL;
+    terminal->select_context = NULL;
+    terminal->view = view_alloc();
+    view_set_context(terminal->view, terminal);
+    view_allocate_model(terminal->view, ViewModelTypeLocking, sizeof(BunnyConnectTerminalModel));
+    view_set_draw_callback(terminal->view, bunnyconnect_terminal_draw_callback);
+    view_set_input_callback(terminal->view, bunnyconnect_terminal_input_callback);
+
+    with_view_model(
+        terminal->view,
+        BunnyConnectTerminalModel * model,
+        {
+            model->text = NULL;
+            model->text_size = 0;
+            model->status[0] = '\0';
+            model->scroll = 0;
+            model->selecting = false;
+            model->select = 0;
+        },
+        false);
+
+    return terminal;
+}
+
+void bunnyconnect_terminal_free(BunnyConnectTerminal* terminal) {
+    furi_assert(terminal);
+    view_free(terminal->view);
+    free(terminal);
+}
+
+View* bunnyconnect_terminal_get_view(BunnyConnectTerminal* terminal) {
+    furi_assert(terminal);
+    return terminal->view;
+}
+
+void bunnyconnect_terminal_set_buffer(BunnyConnectTerminal* terminal, char* buffer, size_t size) {
+    furi_assert(terminal);
+    furi_assert(!buffer || size > 0);
+
+    with_view_model(
+        terminal->view,
+        BunnyConnectTerminalModel * model,
+        {
+            model->text = buffer;
+            model->text_size = buffer ? size : 0;
+            model->scroll = 0;
+            model->selecting = false;
+            if(buffer) buffer[0] = '\0';
+        },
+        true);
+}
+
+char* bunnyconnect_terminal_text_acquire(BunnyConnectTerminal* terminal, size_t* size) {
+    furi_assert(terminal);
+    furi_assert(size);
+
+    BunnyConnectTerminalModel* model = view_get_model(terminal->view);
+    if(!model->text) {
+        view_commit_model(terminal->view, false);
+        return NULL;
+    }
+    *size = model->text_size;
+    return model->text;
+}
+
+void bunnyconnect_terminal_text_commit(BunnyConnectTerminal* terminal) {
+    furi_assert(terminal);
+    view_commit_model(terminal->view, true);
+}
+
+void bunnyconnect_terminal_set_tab_callback(
+    BunnyConnectTerminal* terminal,
+    BunnyConnectTerminalTabCallback callback,
+    void* context) {
+    furi_assert(terminal);
+    terminal->tab_callback = callback;
+    terminal->tab_context = context;
+}
+
+void bunnyconnect_terminal_set_filter_callback(
+    BunnyConnectTerminal* terminal,
+    BunnyConnectTerminalFilterCallback callback,
+    void* context) {
+    furi_assert(terminal);
+    terminal->filter_callback = callback;
+    terminal->filter_context = context;
+}
+
+void bunnyconnect_terminal_set_stamp_callback(
+    BunnyConnectTerminal* terminal,
+    BunnyConnectTerminalStampCallback callback,
+    void* context) {
+    furi_assert(terminal);
+    terminal->stamp_callback = callback;
+    terminal->stamp_context = context;
+}
+
+void bunnyconnect_terminal_set_select_callback(
+    BunnyConnectTerminal* terminal,
+    BunnyConnectTerminalSelectCallback callback,
+    void* context) {
+    furi_assert(terminal);
+    terminal->select_callback = callback;
+    terminal->select_context = context;
+}
+
+void bunnyconnect_terminal_set_status(BunnyConnectTerminal* terminal, const char* status) {
+    furi_assert(terminal);
+    with_view_model(
+        terminal->view,
+        BunnyConnectTerminalModel * model,
+        { strlcpy(model->status, status ? status : "", sizeof(model->status)); },
+        true);
+}
+
+void bunnyconnect_terminal_render(BunnyConnectTerminal* terminal, Canvas* canvas) {
+    furi_assert(terminal);
+    furi_assert(canvas);
+    with_view_model(
+        terminal->view,
+        BunnyConnectTerminalModel * model,
+        { terminal_draw(canvas, model); },
+        false);
+}
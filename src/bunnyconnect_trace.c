@@ -0,0 +1,109 @@
+#include "../lib/bunnyconnect_trace.h"
+#include <furi.h>
+#include <furi_hal_cortex.h>
+#include <storage/storage.h>
+#include <stdatomic.h>
+
+#define TAG "BunnyTrace"
+
+#define TRACE_MAGIC   0x52544342UL // "BCTR"
+#define TRACE_VERSION 1
+#define TRACE_MASK    (BUNNYCONNECT_TRACE_RECORDS - 1)
+
+_Static_assert(
+    (BUNNYCONNECT_TRACE_RECORDS & TRACE_MASK) == 0,
+    "Trace ring size must be a power of two");
+_Static_assert(sizeof(BunnyConnectTraceRecord) == 8, "Trace record layout changed");
+
+// File header, followed by the records
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t cycles_per_us;
+    uint32_t count;
+} __attribute__((packed)) TraceFileHeader;
+
+static BunnyConnectTraceRecord* trace_ring = NULL;
+static atomic_uint_least32_t trace_head;
+static atomic_bool trace_enabled;
+
+void bunnyconnect_trace_set_enabled(bool enabled) {
+    if(enabled && !trace_ring) {
+        trace_ring = malloc(sizeof(BunnyConnectTraceRecord) * BUNNYCONNECT_TRACE_RECORDS);
+        atomic_store(&trace_head, 0);
+    }
+    atomic_store(&trace_enabled, enabled);
+    FURI_LOG_I(TAG, "Tracing %s", enabled ? "on" : "off");
+}
+
+bool bunnyconnect_trace_is_enabled(void) {
+    return atomic_load_explicit(&trace_enabled, memory_order_relaxed);
+}
+
+void bunnyconnect_trace_record(BunnyConnectTraceEvent event, uint32_t arg) {
+    if(!atomic_load_explicit(&trace_enabled, memory_order_relaxed)) return;
+
+    uint32_t index = atomic_fetch_add_explicit(&trace_head, 1, memory_order_relaxed);
+    BunnyConnectTraceRecord* record = &trace_ring[index & TRACE_MASK];
+    record->cycles = furi_hal_cortex_timer_get(0).start; // DWT cycle counter
+    record->event = event;
+    record->arg = arg;
+}
+
+bool bunnyconnect_trace_save(Storage* storage, const char* path, size_t* records) {
+    furi_assert(storage);
+    furi_assert(path);
+    if(records) *records = 0;
+    if(!trace_ring) return false;
+
+    // Pause so the ring holds still, a writer past the flag check finishes in
+    // a few cycles and at worst leaves one stale record
+    bool was_enabled = atomic_exchange(&trace_enabled, false);
+
+    uint32_t head = atomic_load(&trace_head);
+    uint32_t count = MIN(head, (uint32_t)BUNNYCONNECT_TRACE_RECORDS);
+    uint32_t start = head - count;
+
+    TraceFileHeader header = {
+        .magic = TRACE_MAGIC,
+        .version = TRACE_VERSION,
+        .record_size = sizeof(BunnyConnectTraceRecord),
+        .cycles_per_us = furi_hal_cortex_instructions_per_microsecond(),
+        .count = count,
+    };
+
+    File* file = storage_file_alloc(storage);
+    bool success = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                   storage_file_write(file, &header, sizeof(header)) == sizeof(header);
+
+    // Oldest first: the tail of the ring up to its end, then the wrapped part
+    size_t index = start & TRACE_MASK;
+    size_t first = MIN(count, BUNNYCONNECT_TRACE_RECORDS - index);
+    const void* parts[2] = {&trace_ring[index], &trace_ring[0]};
+    size_t sizes[2] = {
+        first * sizeof(BunnyConnectTraceRecord),
+        (count - first) * sizeof(BunnyConnectTraceRecord),
+    };
+    for(size_t i = 0; i < 2 && success; i++) {
+        if(sizes[i]) success = storage_file_write(file, parts[i], sizes[i]) == sizes[i];
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    atomic_store(&trace_enabled, was_enabled);
+    if(success) {
+        if(records) *records = count;
+        FURI_LOG_I(TAG, "Saved %lu records to %s", count, path);
+    } else {
+        FURI_LOG_E(TAG, "Failed to write %s", path);
+    }
+    return success;
+}
+
+void bunnyconnect_trace_free(void) {
+    atomic_store(&trace_enabled, false);
+    free(trace_ring);
+    trace_ring = NULL;
+}
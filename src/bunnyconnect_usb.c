@@ -0,0 +1,578 @@
+#include "../lib/bunnyconnect_usb.h"
+#include "../lib/bunnyconnect_counters.h"
+#include "../lib/bunnyconnect_trace.h"
+#include <furi.h>
+#include <furi_hal_usb.h>
+#include <usb.h>
+#include <usb_cdc.h>
+#include <usb_hid.h>
+#include <stddef.h>
+
+#define TAG "BunnyUsb"
+
+#define USB_EP0_SIZE 8
+
+// Interface numbers, the CDC pair is grouped by an IAD
+#define USB_CDC_COMM_INTERFACE 0
+#define USB_CDC_DATA_INTERFACE 1
+#define USB_HID_INTERFACE      2
+#define USB_INTERFACE_COUNT    3
+
+// Endpoints, IN and OUT of the same number share one callback slot
+#define USB_CDC_RX_EP     0x01
+#define USB_CDC_TX_EP     0x81
+#define USB_CDC_NOTIFY_EP 0x82
+#define USB_HID_EP        0x83
+
+#define USB_CDC_NOTIFY_SIZE 8
+#define USB_HID_EP_SIZE     8
+#define USB_HID_INTERVAL    10
+#define USB_HID_REPORT_KEYS 6
+#define USB_HID_TIMEOUT_MS  30
+#define USB_CDC_RX_BUFFER   512
+
+typedef struct {
+    struct usb_config_descriptor config;
+    struct usb_iad_descriptor cdc_iad;
+    struct usb_interface_descriptor cdc_comm;
+    struct usb_cdc_header_desc cdc_header;
+    struct usb_cdc_call_mgmt_desc cdc_call_mgmt;
+    struct usb_cdc_acm_desc cdc_acm;
+    struct usb_cdc_union_desc cdc_union;
+    struct usb_endpoint_descriptor cdc_notify_ep;
+    struct usb_interface_descriptor cdc_data;
+    struct usb_endpoint_descriptor cdc_rx_ep;
+    struct usb_endpoint_descriptor cdc_tx_ep;
+    struct usb_interface_descriptor hid;
+    struct usb_hid_descriptor hid_desc;
+    struct usb_endpoint_descriptor hid_ep;
+} __attribute__((packed)) BunnyConnectUsbConfigDescriptor;
+
+typedef struct {
+    uint8_t modifiers;
+    uint8_t reserved;
+    uint8_t keys[USB_HID_REPORT_KEYS];
+} __attribute__((packed)) BunnyConnectUsbKeyboardReport;
+
+// Boot keyboard report: modifiers, reserved byte, 5 LED outputs, 6 key slots
+static const uint8_t usb_hid_report_desc[] = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, // Generic Desktop, Keyboard, Application
+    0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, // Modifier keys
+    0x25, 0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02, //
+    0x95, 0x01, 0x75, 0x08, 0x81, 0x01, // Reserved byte
+    0x95, 0x05, 0x75, 0x01, 0x05, 0x08, 0x19, 0x01, // LED output
+    0x29, 0x05, 0x91, 0x02, //
+    0x95, 0x01, 0x75, 0x03, 0x91, 0x01, // LED padding
+    0x95, 0x06, 0x75, 0x08, 0x15, 0x00, 0x25, 0x65, // Key array
+    0x05, 0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00, //
+    0xC0, // End collection
+};
+
+// Descriptor tables are checked at build time: every struct must have its USB
+// specified length, the total must add up, and endpoints must not collide.
+_Static_assert(sizeof(struct usb_config_descriptor) == 9, "config descriptor size");
+_Static_assert(sizeof(struct usb_iad_descriptor) == 8, "IAD size");
+_Static_assert(sizeof(struct usb_interface_descriptor) == 9, "interface descriptor size");
+_Static_assert(sizeof(struct usb_endpoint_descriptor) == 7, "endpoint descriptor size");
+_Static_assert(sizeof(struct usb_cdc_header_desc) == 5, "CDC header size");
+_Static_assert(sizeof(struct usb_cdc_call_mgmt_desc) == 5, "CDC call management size");
+_Static_assert(sizeof(struct usb_cdc_acm_desc) == 4, "CDC ACM size");
+_Static_assert(sizeof(struct usb_cdc_union_desc) == 5, "CDC union size");
+_Static_assert(sizeof(struct usb_hid_descriptor) == 9, "HID descriptor size");
+_Static_assert(sizeof(BunnyConnectUsbConfigDescriptor) == 100, "config total length");
+_Static_assert(
+    offsetof(BunnyConnectUsbConfigDescriptor, hid) -
+            offsetof(BunnyConnectUsbConfigDescriptor, cdc_comm) ==
+        2 * 9 + 5 + 5 + 4 + 5 + 3 * 7,
+    "CDC function must be contiguous");
+_Static_assert(sizeof(usb_hid_report_desc) == 63, "boot keyboard report descriptor");
+_Static_assert(sizeof(BunnyConnectUsbKeyboardReport) == USB_HID_EP_SIZE, "boot keyboard report");
+_Static_assert((USB_CDC_RX_EP & 0x7F) == (USB_CDC_TX_EP & 0x7F), "CDC data endpoints pair");
+_Static_assert(
+    (USB_CDC_TX_EP & 0x7F) != (USB_CDC_NOTIFY_EP & 0x7F) &&
+        (USB_CDC_TX_EP & 0x7F) != (USB_HID_EP & 0x7F) &&
+        (USB_CDC_NOTIFY_EP & 0x7F) != (USB_HID_EP & 0x7F),
+    "endpoint numbers must be unique");
+_Static_assert((USB_HID_EP & 0x7F) < 8, "STM32 USB has 8 endpoints");
+_Static_assert(CDC_DATA_SZ <= 64, "full-speed bulk packet limit");
+
+static const struct usb_string_descriptor usb_manuf_desc = USB_STRING_DESC("Flipper Devices Inc.");
+static const struct usb_string_descriptor usb_prod_desc = USB_STRING_DESC("BunnyConnect");
+
+static const struct usb_device_descriptor usb_device_desc = {
+    .bLength = sizeof(struct usb_device_descriptor),
+    .bDescriptorType = USB_DTYPE_DEVICE,
+    .bcdUSB = VERSION_BCD(2, 0, 0),
+    .bDeviceClass = USB_CLASS_IAD,
+    .bDeviceSubClass = USB_SUBCLASS_IAD,
+    .bDeviceProtocol = USB_PROTO_IAD,
+    .bMaxPacketSize0 = USB_EP0_SIZE,
+    .idVendor = BUNNYCONNECT_USB_VID,
+    .idProduct = BUNNYCONNECT_USB_PID,
+    .bcdDevice = VERSION_BCD(1, 0, 0),
+    .iManufacturer = 1,
+    .iProduct = 2,
+    .iSerialNumber = NO_DESCRIPTOR,
+    .bNumConfigurations = 1,
+};
+
+static const BunnyConnectUsbConfigDescriptor usb_config_desc = {
+    .config =
+        {
+            .bLength = sizeof(struct usb_config_descriptor),
+            .bDescriptorType = USB_DTYPE_CONFIGURATION,
+            .wTotalLength = sizeof(BunnyConnectUsbConfigDescriptor),
+            .bNumInterfaces = USB_INTERFACE_COUNT,
+            .bConfigurationValue = 1,
+            .iConfiguration = NO_DESCRIPTOR,
+            .bmAttributes = USB_CFG_ATTR_RESERVED | USB_CFG_ATTR_SELFPOWERED,
+            .bMaxPower = USB_CFG_POWER_MA(100),
+        },
+    .cdc_iad =
+        {
+            .bLength = sizeof(struct usb_iad_descriptor),
+            .bDescriptorType = USB_DTYPE_INTERFASEASSOC,
+            .bFirstInterface = USB_CDC_COMM_INTERFACE,
+            .bInterfaceCount = 2,
+            .bFunctionClass = USB_CLASS_CDC,
+            .bFunctionSubClass = USB_CDC_SUBCLASS_ACM,
+            .bFunctionProtocol = USB_CDC_PROTO_V25TER,
+            .iFunction = NO_DESCRIPTOR,
+        },
+    .cdc_comm =
+        {
+            .bLength = sizeof(struct usb_interface_descriptor),
+            .bDescriptorType = USB_DTYPE_INTERFACE,
+            .bInterfaceNumber = USB_CDC_COMM_INTERFACE,
+            .bAlternateSetting = 0,
+            .bNumEndpoints = 1,
+            .bInterfaceClass = USB_CLASS_CDC,
+            .bInterfaceSubClass = USB_CDC_SUBCLASS_ACM,
+            .bInterfaceProtocol = USB_CDC_PROTO_V25TER,
+            .iInterface = NO_DESCRIPTOR,
+        },
+    .cdc_header =
+        {
+            .bFunctionLength = sizeof(struct usb_cdc_header_desc),
+            .bDescriptorType = USB_DTYPE_CS_INTERFACE,
+            .bDescriptorSubType = USB_DTYPE_CDC_HEADER,
+            .bcdCDC = VERSION_BCD(1, 1, 0),
+        },
+    .cdc_call_mgmt =
+        {
+            .bFunctionLength = sizeof(struct usb_cdc_call_mgmt_desc),
+            .bDescriptorType = USB_DTYPE_CS_INTERFACE,
+            .bDescriptorSubType = USB_DTYPE_CDC_CALL_MANAGEMENT,
+            .bmCapabilities = 0,
+            .bDataInterface = USB_CDC_DATA_INTERFACE,
+        },
+    .cdc_acm =
+        {
+            .bFunctionLength = sizeof(struct usb_cdc_acm_desc),
+            .bDescriptorType = USB_DTYPE_CS_INTERFACE,
+            .bDescriptorSubType = USB_DTYPE_CDC_ACM,
+            .bmCapabilities = USB_CDC_CAP_LINE,
+        },
+    .cdc_union =
+        {
+            .bFunctionLength = sizeof(struct usb_cdc_union_desc),
+            .bDescriptorType = USB_DTYPE_CS_INTERFACE,
+            .bDescriptorSubType = USB_DTYPE_CDC_UNION,
+            .bMasterInterface0 = USB_CDC_COMM_INTERFACE,
+            .bSlaveInterface0 = USB_CDC_DATA_INTERFACE,
+        },
+    .cdc_notify_ep =
+        {
+            .bLength = sizeof(struct usb_endpoint_descriptor),
+            .bDescriptorType = USB_DTYPE_ENDPOINT,
+            .bEndpointAddress = USB_CDC_NOTIFY_EP,
+            .bmAttributes = USB_EPTYPE_INTERRUPT,
+            .wMaxPacketSize = USB_CDC_NOTIFY_SIZE,
+            .bInterval = 0xFF,
+        },
+    .cdc_data =
+        {
+            .bLength = sizeof(struct usb_interface_descriptor),
+            .bDescriptorType = USB_DTYPE_INTERFACE,
+            .bInterfaceNumber = USB_CDC_DATA_INTERFACE,
+            .bAlternateSetting = 0,
+            .bNumEndpoints = 2,
+            .bInterfaceClass = USB_CLASS_CDC_DATA,
+            .bInterfaceSubClass = USB_SUBCLASS_NONE,
+            .bInterfaceProtocol = USB_PROTO_NONE,
+            .iInterface = NO_DESCRIPTOR,
+        },
+    .cdc_rx_ep =
+        {
+            .bLength = sizeof(struct usb_endpoint_descriptor),
+            .bDescriptorType = USB_DTYPE_ENDPOINT,
+            .bEndpointAddress = USB_CDC_RX_EP,
+            .bmAttributes = USB_EPTYPE_BULK,
+            .wMaxPacketSize = CDC_DATA_SZ,
+            .bInterval = 0x01,
+        },
+    .cdc_tx_ep =
+        {
+            .bLength = sizeof(struct usb_endpoint_descriptor),
+            .bDescriptorType = USB_DTYPE_ENDPOINT,
+            .bEndpointAddress = USB_CDC_TX_EP,
+            .bmAttributes = USB_EPTYPE_BULK,
+            .wMaxPacketSize = CDC_DATA_SZ,
+            .bInterval = 0x01,
+        },
+    .hid =
+        {
+            .bLength = sizeof(struct usb_interface_descriptor),
+            .bDescriptorType = USB_DTYPE_INTERFACE,
+            .bInterfaceNumber = USB_HID_INTERFACE,
+            .bAlternateSetting = 0,
+            .bNumEndpoints = 1,
+            .bInterfaceClass = USB_CLASS_HID,
+            .bInterfaceSubClass = USB_HID_SUBCLASS_BOOT,
+            .bInterfaceProtocol = USB_HID_PROTO_KEYBOARD,
+            .iInterface = NO_DESCRIPTOR,
+        },
+    .hid_desc =
+        {
+            .bLength = sizeof(struct usb_hid_descriptor),
+            .bDescriptorType = USB_DTYPE_HID,
+            .bcdHID = VERSION_BCD(1, 1, 1),
+            .bCountryCode = 0,
+            .bNumDescriptors = 1,
+            .bDescriptorType0 = USB_DTYPE_HID_REPORT,
+            .wDescriptorLength0 = sizeof(usb_hid_report_desc),
+        },
+    .hid_ep =
+        {
+            .bLength = sizeof(struct usb_endpoint_descriptor),
+            .bDescriptorType = USB_DTYPE_ENDPOINT,
+            .bEndpointAddress = USB_HID_EP,
+            .bmAttributes = USB_EPTYPE_INTERRUPT,
+            .wMaxPacketSize = USB_HID_EP_SIZE,
+            .bInterval = USB_HID_INTERVAL,
+        },
+};
+
+static struct {
+    usbd_device* dev;
+    volatile bool configured;
+    volatile bool suspended;
+
+    CdcCallbacks* callbacks;
+    void* context;
+    struct usb_cdc_line_coding line_coding;
+    volatile uint8_t ctrl_line;
+    FuriStreamBuffer* rx;
+
+    FuriSemaphore* hid_semaphore; // Taken while a report is in flight
+    BunnyConnectUsbKeyboardReport pressed; // Keys held down, sending thread only
+    BunnyConnectUsbKeyboardReport report; // Last sent, written only under the semaphore
+    BunnyConnectUsbKeyboardReport get_report; // GET_REPORT data stage, read after we return
+    uint8_t led_state;
+} usb;
+
+static void usb_cdc_notify_state(void) {
+    if(usb.callbacks && usb.callbacks->state_callback) {
+        bool connected = usb.configured && !usb.suspended;
+        usb.callbacks->state_callback(
+            usb.context, connected ? CdcStateConnected : CdcStateDisconnected);
+    }
+}
+
+static void usb_cdc_ep_callback(usbd_device* dev, uint8_t event, uint8_t ep) {
+    UNUSED(ep);
+
+    if(event == usbd_evt_eptx) {
+        if(usb.callbacks && usb.callbacks->tx_ep_callback) {
+            usb.callbacks->tx_ep_callback(usb.context);
+        }
+    } else if(event == usbd_evt_eprx) {
+        uint8_t packet[CDC_DATA_SZ];
+        int32_t size = usbd_ep_read(dev, USB_CDC_RX_EP, packet, sizeof(packet));
+        if(size > 0) {
+            size_t sent = furi_stream_buffer_send(usb.rx, packet, size, 0);
+            if(sent < (size_t)size) {
+                bunnyconnect_counters_add(BunnyConnectCounterRxDropped, size - sent);
+            }
+        }
+        if(usb.callbacks && usb.callbacks->rx_ep_callback) {
+            usb.callbacks->rx_ep_callback(usb.context);
+        }
+    }
+}
+
+static void usb_hid_ep_callback(usbd_device* dev, uint8_t event, uint8_t ep) {
+    UNUSED(dev);
+    UNUSED(ep);
+
+    if(event == usbd_evt_eptx) {
+        furi_semaphore_release(usb.hid_semaphore);
+    }
+}
+
+static usbd_respond usb_ep_config(usbd_device* dev, uint8_t cfg) {
+    switch(cfg) {
+    case 0:
+        usbd_ep_deconfig(dev, USB_CDC_RX_EP);
+        usbd_ep_deconfig(dev, USB_CDC_TX_EP);
+        usbd_ep_deconfig(dev, USB_CDC_NOTIFY_EP);
+        usbd_ep_deconfig(dev, USB_HID_EP);
+        usbd_reg_endpoint(dev, USB_CDC_RX_EP, NULL);
+        usbd_reg_endpoint(dev, USB_HID_EP, NULL);
+        usb.configured = false;
+        usb_cdc_notify_state();
+        return usbd_ack;
+    case 1:
+        usbd_ep_config(dev, USB_CDC_RX_EP, USB_EPTYPE_BULK | USB_EPTYPE_DBLBUF, CDC_DATA_SZ);
+        usbd_ep_config(dev, USB_CDC_TX_EP, USB_EPTYPE_BULK | USB_EPTYPE_DBLBUF, CDC_DATA_SZ);
+        usbd_ep_config(dev, USB_CDC_NOTIFY_EP, USB_EPTYPE_INTERRUPT, USB_CDC_NOTIFY_SIZE);
+        usbd_ep_config(dev, USB_HID_EP, USB_EPTYPE_INTERRUPT, USB_HID_EP_SIZE);
+        usbd_reg_endpoint(dev, USB_CDC_RX_EP, usb_cdc_ep_callback);
+        usbd_reg_endpoint(dev, USB_HID_EP, usb_hid_ep_callback);
+        usb.configured = true;
+        usb.suspended = false;
+        furi_semaphore_release(usb.hid_semaphore);
+        usb_cdc_notify_state();
+        return usbd_ack;
+    default:
+        return usbd_fail;
+    }
+}
+
+static usbd_respond usb_cdc_control(usbd_device* dev, usbd_ctlreq* req) {
+    switch(req->bRequest) {
+    case USB_CDC_SET_CONTROL_LINE_STATE:
+        usb.ctrl_line = req->wValue;
+        if(usb.callbacks && usb.callbacks->ctrl_line_callback) {
+            usb.callbacks->ctrl_line_callback(usb.context, usb.ctrl_line);
+        }
+        return usbd_ack;
+    case USB_CDC_SET_LINE_CODING:
+        memcpy(&usb.line_coding, req->data, sizeof(usb.line_coding));
+        if(usb.callbacks && usb.callbacks->config_callback) {
+            usb.callbacks->config_callback(usb.context, &usb.line_coding);
+        }
+        return usbd_ack;
+    case USB_CDC_GET_LINE_CODING:
+        dev->status.data_ptr = &usb.line_coding;
+        dev->status.data_count = sizeof(usb.line_coding);
+        return usbd_ack;
+    default:
+        return usbd_fail;
+    }
+}
+
+static usbd_respond usb_hid_control(usbd_device* dev, usbd_ctlreq* req) {
+    switch(req->bRequest) {
+    case USB_HID_SETIDLE:
+    case USB_HID_SETPROTOCOL:
+        return usbd_ack;
+    case USB_HID_GETREPORT:
+        // A thread holding the semaphore may be mid-copy, answer with no keys then
+        if(furi_semaphore_acquire(usb.hid_semaphore, 0) == FuriStatusOk) {
+            usb.get_report = usb.report;
+            furi_semaphore_release(usb.hid_semaphore);
+        } else {
+            memset(&usb.get_report, 0, sizeof(usb.get_report));
+        }
+        dev->status.data_ptr = &usb.get_report;
+        dev->status.data_count = sizeof(usb.get_report);
+        return usbd_ack;
+    case USB_HID_SETREPORT:
+        // Host LED state: num, caps, scroll lock
+        if(req->wLength) usb.led_state = req->data[0];
+        return usbd_ack;
+    default:
+        return usbd_fail;
+    }
+}
+
+static usbd_respond usb_hid_get_descriptor(usbd_device* dev, usbd_ctlreq* req) {
+    switch(req->wValue >> 8) {
+    case USB_DTYPE_HID:
+        dev->status.data_ptr = (uint8_t*)&usb_config_desc.hid_desc;
+        dev->status.data_count = sizeof(usb_config_desc.hid_desc);
+        return usbd_ack;
+    case USB_DTYPE_HID_REPORT:
+        dev->status.data_ptr = (uint8_t*)usb_hid_report_desc;
+        dev->status.data_count = sizeof(usb_hid_report_desc);
+        return usbd_ack;
+    default:
+        return usbd_fail;
+    }
+}
+
+static usbd_respond usb_control(usbd_device* dev, usbd_ctlreq* req, usbd_rqc_callback* callback) {
+    UNUSED(callback);
+    uint8_t type = req->bmRequestType & (USB_REQ_TYPE | USB_REQ_RECIPIENT);
+
+    if(type == (USB_REQ_INTERFACE | USB_REQ_CLASS)) {
+        if(req->wIndex == USB_CDC_COMM_INTERFACE) return usb_cdc_control(dev, req);
+        if(req->wIndex == USB_HID_INTERFACE) return usb_hid_control(dev, req);
+    } else if(
+        type == (USB_REQ_INTERFACE | USB_REQ_STANDARD) && req->wIndex == USB_HID_INTERFACE &&
+        req->bRequest == USB_STD_GET_DESCRIPTOR) {
+        return usb_hid_get_descriptor(dev, req);
+    }
+
+    return usbd_fail;
+}
+
+static void usb_init(usbd_device* dev, FuriHalUsbInterface* intf, void* ctx) {
+    UNUSED(intf);
+    UNUSED(ctx);
+
+    usb.dev = dev;
+    usb.configured = false;
+    usb.suspended = false;
+    usb.ctrl_line = 0;
+    usb.line_coding.dwDTERate = 115200;
+    usb.line_coding.bDataBits = 8;
+    memset(&usb.pressed, 0, sizeof(usb.pressed));
+    memset(&usb.report, 0, sizeof(usb.report));
+    if(!usb.rx) usb.rx = furi_stream_buffer_alloc(USB_CDC_RX_BUFFER, 1);
+    if(!usb.hid_semaphore) usb.hid_semaphore = furi_semaphore_alloc(1, 1);
+
+    usbd_reg_config(dev, usb_ep_config);
+    usbd_reg_control(dev, usb_control);
+    usbd_connect(dev, true);
+
+    FURI_LOG_I(TAG, "Composite CDC+HID interface up");
+}
+
+static void usb_deinit(usbd_device* dev) {
+    usbd_reg_config(dev, NULL);
+    usbd_reg_control(dev, NULL);
+
+    usb.configured = false;
+    usb_cdc_notify_state();
+    usb.dev = NULL;
+
+    furi_stream_buffer_free(usb.rx);
+    usb.rx = NULL;
+    furi_semaphore_free(usb.hid_semaphore);
+    usb.hid_semaphore = NULL;
+}
+
+static void usb_wakeup(usbd_device* dev) {
+    UNUSED(dev);
+    usb.suspended = false;
+    usb_cdc_notify_state();
+}
+
+static void usb_suspend(usbd_device* dev) {
+    UNUSED(dev);
+    usb.suspended = true;
+    usb_cdc_notify_state();
+    // A report in flight will not complete
+    if(usb.hid_semaphore) furi_semaphore_release(usb.hid_semaphore);
+}
+
+FuriHalUsbInterface bunnyconnect_usb_composite = {
+    .init = usb_init,
+    .deinit = usb_deinit,
+    .wakeup = usb_wakeup,
+    .suspend = usb_suspend,
+    .dev_descr = (struct usb_device_descriptor*)&usb_device_desc,
+    .str_manuf_descr = (void*)&usb_manuf_desc,
+    .str_prod_descr = (void*)&usb_prod_desc,
+    .str_serial_descr = NULL,
+    .cfg_descr = (void*)&usb_config_desc,
+};
+
+void bunnyconnect_usb_cdc_set_callbacks(uint8_t if_num, CdcCallbacks* callbacks, void* context) {
+    furi_assert(if_num == 0);
+    UNUSED(if_num);
+
+    usb.callbacks = NULL;
+    usb.context = context;
+    usb.callbacks = callbacks;
+
+    if(callbacks && usb.configured && !usb.suspended) {
+        usb_cdc_notify_state();
+        if(callbacks->ctrl_line_callback) {
+            callbacks->ctrl_line_callback(context, usb.ctrl_line);
+        }
+    }
+}
+
+uint8_t bunnyconnect_usb_cdc_get_ctrl_line_state(uint8_t if_num) {
+    furi_assert(if_num == 0);
+    UNUSED(if_num);
+    return usb.ctrl_line;
+}
+
+void bunnyconnect_usb_cdc_send(uint8_t if_num, uint8_t* buffer, uint16_t size) {
+    furi_assert(if_num == 0);
+    furi_assert(size <= CDC_DATA_SZ);
+    UNUSED(if_num);
+
+    if(usb.dev && usb.configured) {
+        BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceCdcTx, size);
+        usbd_ep_write(usb.dev, USB_CDC_TX_EP, buffer, size);
+    }
+}
+
+int32_t bunnyconnect_usb_cdc_receive(uint8_t if_num, uint8_t* buffer, uint16_t size) {
+    furi_assert(if_num == 0);
+    UNUSED(if_num);
+
+    if(!usb.rx) return 0;
+    return furi_stream_buffer_receive(usb.rx, buffer, size, 0);
+}
+
+bool bunnyconnect_usb_hid_is_connected(void) {
+    return usb.dev && usb.configured && !usb.suspended;
+}
+
+static bool usb_hid_send_report(void) {
+    if(!bunnyconnect_usb_hid_is_connected()) return false;
+
+    if(furi_semaphore_acquire(usb.hid_semaphore, furi_ms_to_ticks(USB_HID_TIMEOUT_MS)) !=
+       FuriStatusOk) {
+        return false;
+    }
+    usb.report = usb.pressed;
+    usbd_ep_write(usb.dev, USB_HID_EP, &usb.report, sizeof(usb.report));
+    return true;
+}
+
+bool bunnyconnect_usb_hid_kb_press(uint16_t key) {
+    uint8_t code = key & 0xFF;
+
+    if(code) {
+        for(size_t i = 0; i < USB_HID_REPORT_KEYS; i++) {
+            if(usb.pressed.keys[i] == code) break;
+            if(usb.pressed.keys[i] == 0) {
+                usb.pressed.keys[i] = code;
+                break;
+            }
+        }
+    }
+    usb.pressed.modifiers |= key >> 8;
+
+    bool sent = usb_hid_send_report();
+    if(sent && code) bunnyconnect_counters_add(BunnyConnectCounterHidKeys, 1);
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceHidPress, key);
+    return sent;
+}
+
+bool bunnyconnect_usb_hid_kb_release(uint16_t key) {
+    uint8_t code = key & 0xFF;
+
+    if(code) {
+        for(size_t i = 0; i < USB_HID_REPORT_KEYS; i++) {
+            if(usb.pressed.keys[i] == code) usb.pressed.keys[i] = 0;
+        }
+    }
+    usb.pressed.modifiers &= ~(key >> 8);
+
+    bool sent = usb_hid_send_report();
+    BUNNYCONNECT_TRACE_EVENT(BunnyConnectTraceHidRelease, key);
+    return sent;
+}
+
+bool bunnyconnect_usb_hid_kb_release_all(void) {
+    memset(&usb.pressed, 0, sizeof(usb.pressed));
+    return usb_hid_send_report();
+}
@@ -0,0 +1,605 @@
+#include "../lib/bunnyconnect_ymodem.h"
+#include <furi.h>
+#include <storage/storage.h>
+#include <stdlib.h>
+
+#define TAG "BunnyYmodem"
+
+#define YMODEM_SOH 0x01
+#define YMODEM_STX 0x02
+#define YMODEM_EOT 0x04
+#define YMODEM_ACK 0x06
+#define YMODEM_NAK 0x15
+#define YMODEM_CAN 0x18
+#define YMODEM_CRC 'C'
+#define YMODEM_G   'G'
+#define YMODEM_PAD 0x1A
+
+#define YMODEM_BLOCK_SIZE     128
+#define YMODEM_BLOCK_SIZE_1K  1024
+#define YMODEM_HEADER_SIZE    3
+#define YMODEM_CRC_SIZE       2
+#define YMODEM_PACKET_MAX     (YMODEM_HEADER_SIZE + YMODEM_BLOCK_SIZE_1K + YMODEM_CRC_SIZE)
+#define YMODEM_RX_BUFFER_SIZE (2 * YMODEM_PACKET_MAX)
+
+#define YMODEM_POLL_MS        50
+#define YMODEM_BYTE_TIMEOUT   1000 // Gap allowed inside a packet
+#define YMODEM_ACK_TIMEOUT    10000
+#define YMODEM_START_TIMEOUT  60000 // Time for the peer to start its side
+#define YMODEM_START_INTERVAL 1000 // Receiver start character repeat
+#define YMODEM_MAX_RETRIES    10
+#define YMODEM_CAN_COUNT      5
+#define YMODEM_THREAD_STACK   2048
+
+typedef enum {
+    YmodemPacketData,
+    YmodemPacketEot,
+    YmodemPacketCancel,
+    YmodemPacketTimeout,
+    YmodemPacketBad,
+} YmodemPacket;
+
+struct BunnyConnectYmodem {
+    BunnyConnectOutput* output;
+    BunnyConnectYmodemCallback callback;
+    void* context;
+
+    Storage* storage;
+    File* file;
+    FuriStreamBuffer* rx;
+    FuriThread* thread;
+    FuriMutex* mutex; // Guards name
+    uint8_t* packet;
+
+    volatile bool cancel;
+    volatile BunnyConnectYmodemState state;
+    volatile bool streaming;
+    volatile uint32_t files;
+    volatile uint32_t done;
+    volatile uint32_t total;
+    volatile uint32_t blocks;
+    volatile uint32_t retries;
+    const char* error;
+    char name[BUNNYCONNECT_YMODEM_NAME_SIZE];
+
+    uint32_t start_tick;
+    volatile uint32_t end_tick;
+};
+
+static uint16_t ymodem_crc16(const uint8_t* data, size_t size) {
+    // CRC-16/XMODEM: polynomial 0x1021, initial value 0
+    uint16_t crc = 0;
+    for(size_t i = 0; i < size; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for(uint8_t bit = 0; bit < 8; bit++) {
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static void ymodem_set_name(BunnyConnectYmodem* ymodem, const char* name) {
+    furi_mutex_acquire(ymodem->mutex, FuriWaitForever);
+    strlcpy(ymodem->name, name, sizeof(ymodem->name));
+    furi_mutex_release(ymodem->mutex);
+}
+
+static void ymodem_fail(BunnyConnectYmodem* ymodem, const char* error) {
+    // Timeouts after a cancel are not errors
+    if(ymodem->error || ymodem->cancel) return;
+    ymodem->error = error;
+    FURI_LOG_E(TAG, "%s", error);
+}
+
+static bool ymodem_write(BunnyConnectYmodem* ymodem, const uint8_t* data, size_t size) {
+    size_t written = 0;
+    while(written < size && !ymodem->cancel) {
+        written += bunnyconnect_output_write(
+            ymodem->output, BunnyConnectOutputCdc, data + written, size - written, YMODEM_POLL_MS);
+    }
+    return written == size;
+}
+
+static bool ymodem_putc(BunnyConnectYmodem* ymodem, uint8_t byte) {
+    return ymodem_write(ymodem, &byte, 1);
+}
+
+// Read exactly size bytes, waiting at most timeout_ms for each gap
+static bool
+    ymodem_read(BunnyConnectYmodem* ymodem, uint8_t* data, size_t size, uint32_t timeout_ms) {
+    size_t received = 0;
+    uint32_t idle = 0;
+
+    while(received < size && !ymodem->cancel) {
+        size_t got = furi_stream_buffer_receive(
+            ymodem->rx, data + received, size - received, furi_ms_to_ticks(YMODEM_POLL_MS));
+        if(got) {
+            received += got;
+            idle = 0;
+        } else if((idle += YMODEM_POLL_MS) >= timeout_ms) {
+            break;
+        }
+    }
+
+    return received == size;
+}
+
+static int ymodem_getc(BunnyConnectYmodem* ymodem, uint32_t timeout_ms) {
+    uint8_t byte;
+    return ymodem_read(ymodem, &byte, 1, timeout_ms) ? byte : -1;
+}
+
+// Drop line noise until the peer goes quiet
+static void ymodem_purge(BunnyConnectYmodem* ymodem) {
+    while(ymodem_getc(ymodem, YMODEM_BYTE_TIMEOUT) >= 0) {
+    }
+}
+
+static void ymodem_send_cancel(BunnyConnectYmodem* ymodem) {
+    uint8_t sequence[YMODEM_CAN_COUNT];
+    memset(sequence, YMODEM_CAN, sizeof(sequence));
+
+    // Must go out even when cancelling locally
+    bool cancel = ymodem->cancel;
+    ymodem->cancel = false;
+    ymodem_write(ymodem, sequence, sizeof(sequence));
+    ymodem->cancel = cancel;
+}
+
+// A single CAN may be line noise, two in a row end the session
+static bool ymodem_is_cancel(BunnyConnectYmodem* ymodem, int byte) {
+    return byte == YMODEM_CAN && ymodem_getc(ymodem, YMODEM_BYTE_TIMEOUT) == YMODEM_CAN;
+}
+
+static YmodemPacket
+    ymodem_receive_packet(BunnyConnectYmodem* ymodem, uint32_t timeout_ms, size_t* size) {
+    uint8_t* packet = ymodem->packet;
+
+    int start = ymodem_getc(ymodem, timeout_ms);
+    if(start < 0) return YmodemPacketTimeout;
+    if(start == YMODEM_EOT) return YmodemPacketEot;
+    if(ymodem_is_cancel(ymodem, start)) return YmodemPacketCancel;
+    if(start != YMODEM_SOH && start != YMODEM_STX) return YmodemPacketBad;
+
+    *size = start == YMODEM_STX ? YMODEM_BLOCK_SIZE_1K : YMODEM_BLOCK_SIZE;
+    packet[0] = start;
+    size_t remaining = YMODEM_HEADER_SIZE - 1 + *size + YMODEM_CRC_SIZE;
+    if(!ymodem_read(ymodem, packet + 1, remaining, YMODEM_BYTE_TIMEOUT)) {
+        return YmodemPacketBad;
+    }
+
+    const uint8_t* data = packet + YMODEM_HEADER_SIZE;
+    uint16_t crc = (data[*size] << 8) | data[*size + 1];
+    if((packet[1] ^ packet[2]) != 0xFF || ymodem_crc16(data, *size) != crc) {
+        return YmodemPacketBad;
+    }
+
+    return YmodemPacketData;
+}
+
+static bool ymodem_send_packet(BunnyConnectYmodem* ymodem, uint8_t seq, size_t size) {
+    uint8_t* packet = ymodem->packet;
+    uint8_t* data = packet + YMODEM_HEADER_SIZE;
+    uint16_t crc = ymodem_crc16(data, size);
+
+    packet[0] = size == YMODEM_BLOCK_SIZE_1K ? YMODEM_STX : YMODEM_SOH;
+    packet[1] = seq;
+    packet[2] = ~seq;
+    data[size] = crc >> 8;
+    data[size + 1] = crc & 0xFF;
+
+    for(uint8_t attempt = 0; attempt < YMODEM_MAX_RETRIES && !ymodem->cancel; attempt++) {
+        if(attempt) ymodem->retries++;
+        if(!ymodem_write(ymodem, packet, YMODEM_HEADER_SIZE + size + YMODEM_CRC_SIZE)) break;
+        ymodem->blocks++;
+        if(ymodem->streaming) return true;
+
+        int reply = ymodem_getc(ymodem, YMODEM_ACK_TIMEOUT);
+        if(reply == YMODEM_ACK) return true;
+        if(ymodem_is_cancel(ymodem, reply)) {
+            ymodem->cancel = true;
+            return false;
+        }
+    }
+
+    ymodem_fail(ymodem, "No ACK from receiver");
+    return false;
+}
+
+// Wait for the receiver to ask for the next file, it selects the variant
+static bool ymodem_send_wait_start(BunnyConnectYmodem* ymodem) {
+    uint32_t waited = 0;
+
+    while(!ymodem->cancel && waited < YMODEM_START_TIMEOUT) {
+        int byte = ymodem_getc(ymodem, YMODEM_START_INTERVAL);
+        if(byte == YMODEM_CRC || byte == YMODEM_G) {
+            ymodem->streaming = byte == YMODEM_G;
+            return true;
+        }
+        if(ymodem_is_cancel(ymodem, byte)) {
+            ymodem->cancel = true;
+            return false;
+        }
+        waited += YMODEM_START_INTERVAL;
+    }
+
+    ymodem_fail(ymodem, "Receiver not ready");
+    return false;
+}
+
+static bool ymodem_send_header(BunnyConnectYmodem* ymodem, const char* name, uint32_t size) {
+    uint8_t* data = ymodem->packet + YMODEM_HEADER_SIZE;
+    memset(data, 0, YMODEM_BLOCK_SIZE);
+
+    // "name\0size", an empty name ends the batch
+    if(name) {
+        size_t length = strlen(name) + 1;
+        memcpy(data, name, length);
+        snprintf((char*)data + length, YMODEM_BLOCK_SIZE - length, "%lu", size);
+    }
+
+    return ymodem_send_packet(ymodem, 0, YMODEM_BLOCK_SIZE);
+}
+
+static bool ymodem_send_eot(BunnyConnectYmodem* ymodem) {
+    for(uint8_t attempt = 0; attempt < YMODEM_MAX_RETRIES && !ymodem->cancel; attempt++) {
+        if(!ymodem_putc(ymodem, YMODEM_EOT)) break;
+        // The receiver normally NAKs the first EOT to rule out noise
+        if(ymodem_getc(ymodem, YMODEM_ACK_TIMEOUT) == YMODEM_ACK) return true;
+    }
+
+    ymodem_fail(ymodem, "EOT not acknowledged");
+    return false;
+}
+
+static bool ymodem_send_file(BunnyConnectYmodem* ymodem) {
+    uint8_t* data = ymodem->packet + YMODEM_HEADER_SIZE;
+    uint8_t seq = 1;
+
+    if(!ymodem_send_wait_start(ymodem)) return false;
+    if(!ymodem_send_header(ymodem, ymodem->name, ymodem->total)) return false;
+    if(!ymodem_send_wait_start(ymodem)) return false;
+
+    while(!ymodem->cancel && ymodem->done < ymodem->total) {
+        uint32_t remaining = ymodem->total - ymodem->done;
+        size_t size = remaining > YMODEM_BLOCK_SIZE ? YMODEM_BLOCK_SIZE_1K : YMODEM_BLOCK_SIZE;
+        size_t chunk = remaining < size ? remaining : size;
+
+        if(storage_file_read(ymodem->file, data, chunk) != chunk) {
+            ymodem_fail(ymodem, "SD read failed");
+            return false;
+        }
+        memset(data + chunk, YMODEM_PAD, size - chunk);
+
+        if(!ymodem_send_packet(ymodem, seq++, size)) return false;
+        ymodem->done += chunk;
+    }
+
+    if(ymodem->cancel || !ymodem_send_eot(ymodem)) return false;
+    ymodem->files++;
+
+    // Close the batch with an empty header
+    if(!ymodem_send_wait_start(ymodem)) return false;
+    return ymodem_send_header(ymodem, NULL, 0);
+}
+
+static bool ymodem_receive_open(BunnyConnectYmodem* ymodem, const char* name) {
+    // Only the base name is used, the peer cannot pick the directory
+    const char* base = strrchr(name, '/');
+    base = base ? base + 1 : name;
+    if(base[0] == '\0' || base[0] == '.') {
+        ymodem_fail(ymodem, "Invalid file name");
+        return false;
+    }
+
+    FuriString* path = furi_string_alloc_printf("%s/%s", BUNNYCONNECT_YMODEM_RECEIVE_PATH, base);
+    bool opened = storage_file_open(
+        ymodem->file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    furi_string_free(path);
+
+    if(!opened) {
+        ymodem_fail(ymodem, "Cannot create file");
+        return false;
+    }
+
+    ymodem_set_name(ymodem, base);
+    return true;
+}
+
+static bool ymodem_receive_data(BunnyConnectYmodem* ymodem) {
+    const uint8_t* data = ymodem->packet + YMODEM_HEADER_SIZE;
+    uint8_t expected = 1;
+    uint8_t errors = 0;
+    bool eot = false;
+
+    while(!ymodem->cancel) {
+        size_t size = 0;
+        YmodemPacket packet = ymodem_receive_packet(ymodem, YMODEM_ACK_TIMEOUT, &size);
+
+        if(packet == YmodemPacketCancel) {
+            ymodem->cancel = true;
+            return false;
+        }
+
+        if(packet == YmodemPacketEot) {
+            // NAK the first EOT, a second one confirms the end of file
+            if(!eot) {
+                eot = true;
+                ymodem_putc(ymodem, YMODEM_NAK);
+                continue;
+            }
+            ymodem_putc(ymodem, YMODEM_ACK);
+            return true;
+        }
+        eot = false;
+
+        if(packet != YmodemPacketData) {
+            // Streaming has no way to resend a block
+            if(ymodem->streaming || ++errors > YMODEM_MAX_RETRIES) {
+                ymodem_fail(ymodem, "Too many bad blocks");
+                return false;
+            }
+            ymodem->retries++;
+            ymodem_purge(ymodem);
+            ymodem_putc(ymodem, YMODEM_NAK);
+            continue;
+        }
+
+        uint8_t seq = ymodem->packet[1];
+        if(seq == (uint8_t)(expected - 1)) {
+            // Our ACK was lost and the sender repeated the block
+            ymodem->retries++;
+            ymodem_putc(ymodem, YMODEM_ACK);
+            if(seq == 0) {
+                ymodem_putc(ymodem, ymodem->streaming ? YMODEM_G : YMODEM_CRC);
+            }
+            continue;
+        }
+        if(seq != expected) {
+            ymodem_fail(ymodem, "Block out of sequence");
+            return false;
+        }
+
+        // The last block is padded, trim it to the announced size
+        size_t chunk = size;
+        if(ymodem->total && ymodem->total - ymodem->done < chunk) {
+            chunk = ymodem->total - ymodem->done;
+        }
+        if(storage_file_write(ymodem->file, data, chunk) != chunk) {
+            ymodem_fail(ymodem, "SD write failed");
+            return false;
+        }
+
+        ymodem->done += chunk;
+        ymodem->blocks++;
+        expected++;
+        errors = 0;
+        if(!ymodem->streaming) {
+            ymodem_putc(ymodem, YMODEM_ACK);
+        }
+    }
+
+    return false;
+}
+
+static bool ymodem_receive_batch(BunnyConnectYmodem* ymodem) {
+    const char* header = (const char*)ymodem->packet + YMODEM_HEADER_SIZE;
+    uint8_t start = ymodem->streaming ? YMODEM_G : YMODEM_CRC;
+
+    storage_simply_mkdir(ymodem->storage, BUNNYCONNECT_YMODEM_RECEIVE_PATH);
+
+    while(!ymodem->cancel) {
+        // Keep asking for a header until the sender starts
+        YmodemPacket packet = YmodemPacketTimeout;
+        size_t size = 0;
+        for(uint32_t waited = 0; waited < YMODEM_START_TIMEOUT && !ymodem->cancel;
+            waited += YMODEM_START_INTERVAL) {
+            ymodem_putc(ymodem, start);
+            packet = ymodem_receive_packet(ymodem, YMODEM_START_INTERVAL, &size);
+            if(packet != YmodemPacketTimeout) break;
+        }
+
+        if(packet == YmodemPacketCancel) {
+            ymodem->cancel = true;
+            return false;
+        }
+        if(packet != YmodemPacketData || ymodem->packet[1] != 0) {
+            ymodem_fail(ymodem, "No file header");
+            return false;
+        }
+
+        // An empty name ends the batch
+        if(header[0] == '\0') {
+            ymodem_putc(ymodem, YMODEM_ACK);
+            return true;
+        }
+
+        size_t name_length = strnlen(header, size - 1);
+        ymodem->total = strtoul(header + name_length + 1, NULL, 10);
+        ymodem->done = 0;
+        if(!ymodem_receive_open(ymodem, header)) return false;
+
+        FURI_LOG_I(TAG, "Receiving %s (%lu bytes)", ymodem->name, ymodem->total);
+        ymodem_putc(ymodem, YMODEM_ACK);
+        ymodem_putc(ymodem, start);
+
+        bool received = ymodem_receive_data(ymodem);
+        storage_file_close(ymodem->file);
+        if(!received) return false;
+        ymodem->files++;
+    }
+
+    return false;
+}
+
+static void ymodem_finish(BunnyConnectYmodem* ymodem, bool success) {
+    ymodem->end_tick = furi_get_tick();
+
+    if(success) {
+        ymodem->state = BunnyConnectYmodemStateDone;
+    } else if(ymodem->cancel && !ymodem->error) {
+        ymodem->state = BunnyConnectYmodemStateCancelled;
+    } else {
+        ymodem_fail(ymodem, "Transfer failed");
+        ymodem->state = BunnyConnectYmodemStateError;
+    }
+
+    if(!success) {
+        ymodem_send_cancel(ymodem);
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Session ended: %lu files, %lu blocks, %lu retries in %lu ms",
+        ymodem->files,
+        ymodem->blocks,
+        ymodem->retries,
+        ymodem->end_tick - ymodem->start_tick);
+
+    if(ymodem->callback) {
+        ymodem->callback(ymodem->context);
+    }
+}
+
+static int32_t ymodem_send_thread(void* context) {
+    BunnyConnectYmodem* ymodem = context;
+    ymodem_finish(ymodem, ymodem_send_file(ymodem));
+    return 0;
+}
+
+static int32_t ymodem_receive_thread(void* context) {
+    BunnyConnectYmodem* ymodem = context;
+    ymodem_finish(ymodem, ymodem_receive_batch(ymodem));
+    return 0;
+}
+
+static BunnyConnectYmodem* ymodem_alloc(
+    BunnyConnectOutput* output,
+    BunnyConnectYmodemCallback callback,
+    void* context) {
+    BunnyConnectYmodem* ymodem = malloc(sizeof(BunnyConnectYmodem));
+    memset(ymodem, 0, sizeof(BunnyConnectYmodem));
+    ymodem->output = output;
+    ymodem->callback = callback;
+    ymodem->context = context;
+    ymodem->storage = furi_record_open(RECORD_STORAGE);
+    ymodem->file = storage_file_alloc(ymodem->storage);
+    ymodem->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    return ymodem;
+}
+
+static void
+    ymodem_start(BunnyConnectYmodem* ymodem, const char* name, FuriThreadCallback callback) {
+    ymodem->rx = furi_stream_buffer_alloc(YMODEM_RX_BUFFER_SIZE, 1);
+    ymodem->packet = malloc(YMODEM_PACKET_MAX);
+    ymodem->state = BunnyConnectYmodemStateRunning;
+    ymodem->start_tick = furi_get_tick();
+
+    ymodem->thread = furi_thread_alloc();
+    furi_thread_set_name(ymodem->thread, name);
+    furi_thread_set_stack_size(ymodem->thread, YMODEM_THREAD_STACK);
+    furi_thread_set_context(ymodem->thread, ymodem);
+    furi_thread_set_callback(ymodem->thread, callback);
+    furi_thread_start(ymodem->thread);
+}
+
+BunnyConnectYmodem* bunnyconnect_ymodem_send_start(
+    BunnyConnectOutput* output,
+    const char* path,
+    BunnyConnectYmodemCallback callback,
+    void* context) {
+    furi_assert(output);
+    furi_assert(path);
+
+    BunnyConnectYmodem* ymodem = ymodem_alloc(output, callback, context);
+    if(!storage_file_open(ymodem->file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_E(TAG, "Failed to open %s", path);
+        bunnyconnect_ymodem_free(ymodem);
+        return NULL;
+    }
+
+    const char* name = strrchr(path, '/');
+    ymodem_set_name(ymodem, name ? name + 1 : path);
+    ymodem->total = storage_file_size(ymodem->file);
+
+    FURI_LOG_I(TAG, "Sending %s (%lu bytes)", path, ymodem->total);
+    ymodem_start(ymodem, "BunnyYmodemTx", ymodem_send_thread);
+    return ymodem;
+}
+
+BunnyConnectYmodem* bunnyconnect_ymodem_receive_start(
+    BunnyConnectOutput* output,
+    bool streaming,
+    BunnyConnectYmodemCallback callback,
+    void* context) {
+    furi_assert(output);
+
+    BunnyConnectYmodem* ymodem = ymodem_alloc(output, callback, context);
+    ymodem->streaming = streaming;
+
+    FURI_LOG_I(TAG, "Waiting for %s sender", streaming ? "YMODEM-g" : "YMODEM");
+    ymodem_start(ymodem, "BunnyYmodemRx", ymodem_receive_thread);
+    return ymodem;
+}
+
+void bunnyconnect_ymodem_feed(BunnyConnectYmodem* ymodem, const uint8_t* data, size_t size) {
+    furi_assert(ymodem);
+
+    if(furi_stream_buffer_send(ymodem->rx, data, size, 0) != size) {
+        FURI_LOG_W(TAG, "RX overflow");
+    }
+}
+
+void bunnyconnect_ymodem_stop(BunnyConnectYmodem* ymodem) {
+    furi_assert(ymodem);
+
+    if(ymodem->state == BunnyConnectYmodemStateRunning) {
+        ymodem->cancel = true;
+    }
+    if(ymodem->thread) {
+        furi_thread_join(ymodem->thread);
+    }
+}
+
+void bunnyconnect_ymodem_free(BunnyConnectYmodem* ymodem) {
+    if(!ymodem) return;
+
+    if(ymodem->thread) {
+        bunnyconnect_ymodem_stop(ymodem);
+        furi_thread_free(ymodem->thread);
+    }
+    if(ymodem->rx) {
+        furi_stream_buffer_free(ymodem->rx);
+    }
+    free(ymodem->packet);
+
+    storage_file_close(ymodem->file);
+    storage_file_free(ymodem->file);
+    furi_record_close(RECORD_STORAGE);
+    furi_mutex_free(ymodem->mutex);
+    free(ymodem);
+}
+
+void bunnyconnect_ymodem_get_status(BunnyConnectYmodem* ymodem, BunnyConnectYmodemStatus* status) {
+    furi_assert(ymodem);
+    furi_assert(status);
+
+    uint32_t end = ymodem->state == BunnyConnectYmodemStateRunning ? furi_get_tick() :
+                                                                     ymodem->end_tick;
+    uint32_t elapsed = end - ymodem->start_tick;
+
+    status->state = ymodem->state;
+    status->streaming = ymodem->streaming;
+    status->files = ymodem->files;
+    status->done = ymodem->done;
+    status->total = ymodem->total;
+    status->rate =
+        elapsed ? (uint64_t)ymodem->done * furi_kernel_get_tick_frequency() / elapsed : 0;
+    status->blocks = ymodem->blocks;
+    status->retries = ymodem->retries;
+    status->error = ymodem->error;
+
+    furi_mutex_acquire(ymodem->mutex, FuriWaitForever);
+    strlcpy(status->name, ymodem->name, sizeof(status->name));
+    furi_mutex_release(ymodem->mutex);
+}
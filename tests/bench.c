@@ -0,0 +1,54 @@
+// Host run of the device benchmark. Prints the BCBENCH and BCFRAME lines and
+// appends them to bench.txt under the SD stand-in, the same layout as
+// apps_data/bunnyconnect on the device, so tools/benchdiff.py takes either.
+// Times come from the shim cycle counter, compare host runs with host runs.
+//
+//   bench_host [sd_root]
+
+#include "../lib/bunnyconnect_bench.h"
+#include <stdio.h>
+#include <sys/stat.h>
+
+static bool bench_append(Storage* storage, const char* line, size_t len) {
+    fputs(line, stdout);
+    File* file = storage_file_alloc(storage);
+    bool saved = storage_file_open(file, BUNNYCONNECT_BENCH_PATH, FSAM_WRITE, FSOM_OPEN_APPEND) &&
+                 storage_file_write(file, line, len) == len;
+    storage_file_close(file);
+    storage_file_free(file);
+    return saved;
+}
+
+int main(int argc, char** argv) {
+    const char* root = argc > 1 ? argv[1] : "bench-sd";
+    mkdir(root, 0755);
+    furi_shim_storage_set_root(root);
+
+    Gui* gui = furi_shim_gui_alloc();
+    uint32_t ns_per_op[BunnyConnectBenchCount];
+    if(!bunnyconnect_bench_run(gui, ns_per_op)) {
+        fprintf(stderr, "bench: scratch arena does not fit\n");
+        furi_shim_gui_free(gui);
+        return 1;
+    }
+
+    BunnyConnectBenchFrameResult frames[BunnyConnectBenchFrameCount];
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool saved = bunnyconnect_bench_frames(gui, storage, BUNNYCONNECT_FRAMES_PATH, frames);
+
+    char line[BUNNYCONNECT_BENCH_LINE_SIZE];
+    size_t len = bunnyconnect_bench_format(ns_per_op, furi_get_tick(), line, sizeof(line));
+    saved = bench_append(storage, line, len) && saved;
+    for(size_t i = 0; i < BunnyConnectBenchFrameCount; i++) {
+        len = bunnyconnect_bench_frame_format(i, &frames[i], line, sizeof(line));
+        saved = bench_append(storage, line, len) && saved;
+    }
+    furi_record_close(RECORD_STORAGE);
+    furi_shim_gui_free(gui);
+
+    if(!saved) {
+        fprintf(stderr, "bench: writing under %s failed\n", root);
+        return 1;
+    }
+    return 0;
+}
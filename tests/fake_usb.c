@@ -0,0 +1,191 @@
+#include "fake_usb.h"
+#include "../lib/bunnyconnect_usb.h"
+
+#define FAKE_HOST_BUFFER  (64 * 1024)
+#define FAKE_HID_KEYS_MAX 4096
+#define FAKE_FLAG_PACKET  (1UL << 0)
+#define FAKE_FLAG_STOP    (1UL << 1)
+
+static struct {
+    FuriThread* host;
+    FuriStreamBuffer* received;
+    FuriMutex* mutex;
+
+    CdcCallbacks* callbacks;
+    void* context;
+    bool configured;
+    uint8_t ctrl_line;
+    uint32_t packet_delay_us;
+
+    uint8_t packet[CDC_DATA_SZ];
+    uint16_t packet_size;
+    uint32_t generation; // Bumped when the host drops the interface
+    uint32_t packets;
+    uint32_t zlps;
+
+    uint16_t keys[FAKE_HID_KEYS_MAX];
+    size_t key_count;
+} fake;
+
+static int32_t fake_usb_host_thread(void* context) {
+    UNUSED(context);
+    uint8_t packet[CDC_DATA_SZ];
+
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(
+            FAKE_FLAG_PACKET | FAKE_FLAG_STOP, FuriFlagWaitAny, FuriWaitForever);
+        if(flags & FAKE_FLAG_STOP) break;
+
+        furi_shim_critical_enter();
+        uint32_t generation = fake.generation;
+        uint16_t size = fake.packet_size;
+        memcpy(packet, fake.packet, size);
+        furi_shim_critical_exit();
+
+        if(fake.packet_delay_us) furi_delay_us(fake.packet_delay_us);
+        size_t taken = 0;
+        while(taken < size && !(furi_thread_flags_get() & FAKE_FLAG_STOP)) {
+            taken += furi_stream_buffer_send(fake.received, packet + taken, size - taken, 10);
+        }
+
+        furi_shim_critical_enter();
+        if(generation == fake.generation && fake.configured) {
+            fake.packets++;
+            if(size == 0) fake.zlps++;
+            if(fake.callbacks && fake.callbacks->tx_ep_callback) {
+                fake.callbacks->tx_ep_callback(fake.context);
+            }
+        }
+        furi_shim_critical_exit();
+    }
+
+    return 0;
+}
+
+void fake_usb_start(void) {
+    memset(&fake, 0, sizeof(fake));
+    fake.received = furi_stream_buffer_alloc(FAKE_HOST_BUFFER, 1);
+    fake.mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    fake.host = furi_thread_alloc_ex("FakeUsbHost", 1024, fake_usb_host_thread, NULL);
+    furi_thread_start(fake.host);
+}
+
+void fake_usb_stop(void) {
+    furi_thread_flags_set(furi_thread_get_id(fake.host), FAKE_FLAG_STOP);
+    furi_thread_join(fake.host);
+    furi_thread_free(fake.host);
+    furi_mutex_free(fake.mutex);
+    furi_stream_buffer_free(fake.received);
+}
+
+void fake_usb_plug(bool configured) {
+    furi_shim_critical_enter();
+    fake.configured = configured;
+    if(!configured) {
+        fake.ctrl_line = 0;
+        fake.generation++;
+    }
+    if(fake.callbacks && fake.callbacks->state_callback) {
+        fake.callbacks->state_callback(
+            fake.context, configured ? CdcStateConnected : CdcStateDisconnected);
+    }
+    furi_shim_critical_exit();
+}
+
+void fake_usb_set_ctrl_line(uint8_t state) {
+    furi_shim_critical_enter();
+    fake.ctrl_line = state;
+    if(fake.callbacks && fake.callbacks->ctrl_line_callback) {
+        fake.callbacks->ctrl_line_callback(fake.context, state);
+    }
+    furi_shim_critical_exit();
+}
+
+void fake_usb_set_packet_delay(uint32_t us) {
+    fake.packet_delay_us = us;
+}
+
+size_t fake_usb_host_read(uint8_t* data, size_t size, uint32_t timeout) {
+    size_t read = 0;
+    uint32_t start = furi_get_tick();
+    while(read < size) {
+        read += furi_stream_buffer_receive(fake.received, data + read, size - read, 10);
+        if(furi_get_tick() - start >= timeout) break;
+    }
+    return read;
+}
+
+uint32_t fake_usb_get_packets(void) {
+    return fake.packets;
+}
+
+uint32_t fake_usb_get_zlps(void) {
+    return fake.zlps;
+}
+
+size_t fake_usb_hid_read(uint16_t* keys, size_t max) {
+    furi_mutex_acquire(fake.mutex, FuriWaitForever);
+    size_t count = MIN(max, fake.key_count);
+    memcpy(keys, fake.keys, count * sizeof(uint16_t));
+    furi_mutex_release(fake.mutex);
+    return count;
+}
+
+/* bunnyconnect_usb.h */
+
+// Only compared by address, power switching never runs its callbacks here
+FuriHalUsbInterface bunnyconnect_usb_composite;
+
+void bunnyconnect_usb_cdc_set_callbacks(uint8_t if_num, CdcCallbacks* callbacks, void* context) {
+    furi_check(if_num == 0);
+    furi_shim_critical_enter();
+    fake.callbacks = callbacks;
+    fake.context = context;
+    if(callbacks && fake.configured) {
+        if(callbacks->state_callback) callbacks->state_callback(context, CdcStateConnected);
+        if(callbacks->ctrl_line_callback) callbacks->ctrl_line_callback(context, fake.ctrl_line);
+    }
+    furi_shim_critical_exit();
+}
+
+uint8_t bunnyconnect_usb_cdc_get_ctrl_line_state(uint8_t if_num) {
+    furi_check(if_num == 0);
+    return fake.ctrl_line;
+}
+
+void bunnyconnect_usb_cdc_send(uint8_t if_num, uint8_t* buffer, uint16_t size) {
+    furi_check(if_num == 0);
+    furi_check(size <= CDC_DATA_SZ);
+    furi_shim_critical_enter();
+    memcpy(fake.packet, buffer, size);
+    fake.packet_size = size;
+    furi_shim_critical_exit();
+    furi_thread_flags_set(furi_thread_get_id(fake.host), FAKE_FLAG_PACKET);
+}
+
+int32_t bunnyconnect_usb_cdc_receive(uint8_t if_num, uint8_t* buffer, uint16_t size) {
+    UNUSED(if_num);
+    UNUSED(buffer);
+    UNUSED(size);
+    return 0;
+}
+
+bool bunnyconnect_usb_hid_is_connected(void) {
+    return fake.configured;
+}
+
+bool bunnyconnect_usb_hid_kb_press(uint16_t key) {
+    furi_mutex_acquire(fake.mutex, FuriWaitForever);
+    if(fake.key_count < FAKE_HID_KEYS_MAX) fake.keys[fake.key_count++] = key;
+    furi_mutex_release(fake.mutex);
+    return true;
+}
+
+bool bunnyconnect_usb_hid_kb_release(uint16_t key) {
+    UNUSED(key);
+    return true;
+}
+
+bool bunnyconnect_usb_hid_kb_release_all(void) {
+    return true;
+}
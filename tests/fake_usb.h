@@ -0,0 +1,30 @@
+#pragma once
+
+#include <furi.h>
+
+// Stand-in for the composite USB device under bunnyconnect_usb.h. A host
+// thread takes each CDC packet, optionally after a delay, and completes it
+// the way the TX endpoint interrupt would. Callbacks run under the critical
+// section lock, as interrupts would be masked against it on the device.
+
+void fake_usb_start(void);
+void fake_usb_stop(void);
+
+// Host configures or drops the interface
+void fake_usb_plug(bool configured);
+
+// Host changes DTR/RTS
+void fake_usb_set_ctrl_line(uint8_t state);
+
+// Time the host takes per CDC packet
+void fake_usb_set_packet_delay(uint32_t us);
+
+// Bytes the host received over CDC, in order
+size_t fake_usb_host_read(uint8_t* data, size_t size, uint32_t timeout);
+
+// Packets the host received, zero-length ones included
+uint32_t fake_usb_get_packets(void);
+uint32_t fake_usb_get_zlps(void);
+
+// Keys pressed over HID so far, modifiers included
+size_t fake_usb_hid_read(uint16_t* keys, size_t max);
@@ -0,0 +1,75 @@
+#include "fake_usbd.h"
+
+#define FAKE_USBD_EP_COUNT 8
+
+static struct {
+    uint8_t data[FAKE_USBD_EP_COUNT][FAKE_USBD_PACKET_MAX];
+    int32_t size[FAKE_USBD_EP_COUNT];
+    uint32_t writes[FAKE_USBD_EP_COUNT];
+} fake_usbd;
+
+int32_t fake_usbd_get_write(uint8_t ep, uint8_t* data) {
+    uint8_t index = ep & (FAKE_USBD_EP_COUNT - 1);
+    if(fake_usbd.size[index] > 0) memcpy(data, fake_usbd.data[index], fake_usbd.size[index]);
+    return fake_usbd.size[index];
+}
+
+uint32_t fake_usbd_get_writes(uint8_t ep) {
+    return fake_usbd.writes[ep & (FAKE_USBD_EP_COUNT - 1)];
+}
+
+void fake_usbd_reset(void) {
+    memset(&fake_usbd, 0, sizeof(fake_usbd));
+    for(size_t i = 0; i < FAKE_USBD_EP_COUNT; i++) {
+        fake_usbd.size[i] = -1;
+    }
+}
+
+void usbd_reg_control(usbd_device* dev, usbd_ctl_callback callback) {
+    dev->control_callback = callback;
+}
+
+void usbd_reg_config(usbd_device* dev, usbd_cfg_callback callback) {
+    dev->config_callback = callback;
+}
+
+void usbd_reg_endpoint(usbd_device* dev, uint8_t ep, usbd_evt_callback callback) {
+    dev->endpoint[ep & (FAKE_USBD_EP_COUNT - 1)] = callback;
+}
+
+bool usbd_ep_config(usbd_device* dev, uint8_t ep, uint8_t eptype, uint16_t epsize) {
+    UNUSED(dev);
+    UNUSED(eptype);
+    furi_check((ep & 0x7F) < FAKE_USBD_EP_COUNT);
+    furi_check(epsize <= FAKE_USBD_PACKET_MAX);
+    return true;
+}
+
+void usbd_ep_deconfig(usbd_device* dev, uint8_t ep) {
+    UNUSED(dev);
+    UNUSED(ep);
+}
+
+// Like the PMA copy on the device, the data is taken before returning
+int32_t usbd_ep_write(usbd_device* dev, uint8_t ep, const void* buf, uint16_t blen) {
+    UNUSED(dev);
+    uint8_t index = ep & (FAKE_USBD_EP_COUNT - 1);
+    furi_check(blen <= FAKE_USBD_PACKET_MAX);
+    memcpy(fake_usbd.data[index], buf, blen);
+    fake_usbd.size[index] = blen;
+    fake_usbd.writes[index]++;
+    return blen;
+}
+
+int32_t usbd_ep_read(usbd_device* dev, uint8_t ep, void* buf, uint16_t blen) {
+    UNUSED(dev);
+    UNUSED(ep);
+    UNUSED(buf);
+    UNUSED(blen);
+    return 0;
+}
+
+void usbd_connect(usbd_device* dev, bool connect) {
+    UNUSED(dev);
+    UNUSED(connect);
+}
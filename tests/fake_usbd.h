@@ -0,0 +1,19 @@
+#pragma once
+
+#include <furi.h>
+#include <usb.h>
+
+// Stand-in for the libusb_stm32 core under the composite interface in
+// src/bunnyconnect_usb.c. Endpoint writes are kept so a test can look at
+// what would have gone out on the wire.
+
+#define FAKE_USBD_PACKET_MAX 64
+
+// Data of the last write to an endpoint, returns its size or -1 if none
+int32_t fake_usbd_get_write(uint8_t ep, uint8_t* data);
+
+// Writes to an endpoint since the device was set up
+uint32_t fake_usbd_get_writes(uint8_t ep);
+
+// Forget every recorded write
+void fake_usbd_reset(void);
@@ -0,0 +1,458 @@
+#include <gui/canvas.h>
+#include <gui/elements.h>
+#include <stdio.h>
+
+#define CANVAS_STR_SIZE   64
+#define CANVAS_ROW_BYTES  (FURI_SHIM_CANVAS_WIDTH / 8)
+#define FNV_OFFSET_BASIS  2166136261UL
+#define FNV_PRIME         16777619UL
+
+struct Canvas {
+    Font font;
+    Color color;
+    uint32_t counts[CanvasOpCount];
+    uint32_t digest;
+    char strs[FURI_SHIM_CANVAS_STR_MAX][CANVAS_STR_SIZE];
+    size_t str_count;
+    // Rows top down, leftmost pixel in the high bit as in a PBM
+    uint8_t pixels[FURI_SHIM_CANVAS_HEIGHT][CANVAS_ROW_BYTES];
+    // The firmware layout for canvas_get_buffer: 8-row pages of vertical bytes
+    uint8_t pages[FURI_SHIM_CANVAS_HEIGHT / 8][FURI_SHIM_CANVAS_WIDTH];
+};
+
+static void canvas_fnv(Canvas* canvas, const void* data, size_t len) {
+    const uint8_t* bytes = data;
+    for(size_t i = 0; i < len; i++) {
+        canvas->digest = (canvas->digest ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+// One op and its integer arguments
+static void canvas_record(Canvas* canvas, CanvasOp op, size_t argc, const int32_t* argv) {
+    furi_check(canvas);
+    canvas->counts[op]++;
+    uint8_t id = op;
+    canvas_fnv(canvas, &id, sizeof(id));
+    canvas_fnv(canvas, argv, argc * sizeof(int32_t));
+}
+
+static void canvas_keep_str(Canvas* canvas, const char* str) {
+    canvas_fnv(canvas, str, strlen(str));
+    if(canvas->str_count < FURI_SHIM_CANVAS_STR_MAX) {
+        strlcpy(canvas->strs[canvas->str_count], str, CANVAS_STR_SIZE);
+    }
+    canvas->str_count++;
+}
+
+/* Raster, clipped to the screen in the current color */
+
+static void canvas_pixel(Canvas* canvas, int32_t x, int32_t y) {
+    if(x < 0 || y < 0 || x >= FURI_SHIM_CANVAS_WIDTH || y >= FURI_SHIM_CANVAS_HEIGHT) return;
+    uint8_t* byte = &canvas->pixels[y][x / 8];
+    uint8_t bit = 0x80 >> (x % 8);
+    switch(canvas->color) {
+    case ColorBlack:
+        *byte |= bit;
+        break;
+    case ColorWhite:
+        *byte &= ~bit;
+        break;
+    case ColorXOR:
+        *byte ^= bit;
+        break;
+    }
+}
+
+static void canvas_fill(Canvas* canvas, int32_t x, int32_t y, int32_t width, int32_t height) {
+    for(int32_t row = MAX(y, 0); row < MIN(y + height, FURI_SHIM_CANVAS_HEIGHT); row++) {
+        for(int32_t col = MAX(x, 0); col < MIN(x + width, FURI_SHIM_CANVAS_WIDTH); col++) {
+            canvas_pixel(canvas, col, row);
+        }
+    }
+}
+
+// Outline with corner pixels left out, radius 0 is a plain frame
+static void canvas_outline(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    int32_t width,
+    int32_t height,
+    int32_t radius) {
+    if(width <= 0 || height <= 0) return;
+    canvas_fill(canvas, x + radius, y, width - 2 * radius, 1);
+    if(height > 1) canvas_fill(canvas, x + radius, y + height - 1, width - 2 * radius, 1);
+    canvas_fill(canvas, x, y + radius + 1, 1, height - 2 * radius - 2);
+    if(width > 1) canvas_fill(canvas, x + width - 1, y + radius + 1, 1, height - 2 * radius - 2);
+    // Corner arcs as a diagonal step per unit of radius
+    for(int32_t i = 0; i < radius; i++) {
+        int32_t dx = radius - i;
+        int32_t dy = i + 1;
+        canvas_pixel(canvas, x + dx - 1, y + dy);
+        canvas_pixel(canvas, x + width - dx, y + dy);
+        canvas_pixel(canvas, x + dx - 1, y + height - 1 - dy);
+        canvas_pixel(canvas, x + width - dx, y + height - 1 - dy);
+    }
+}
+
+static size_t canvas_glyph_height(Canvas* canvas) {
+    return canvas->font == FontBigNumbers ? 2 * FURI_SHIM_CANVAS_GLYPH_HEIGHT :
+                                            FURI_SHIM_CANVAS_GLYPH_HEIGHT;
+}
+
+// A solid cell one column narrower than the advance, spaces stay blank
+static void canvas_raster_glyph(Canvas* canvas, int32_t x, int32_t y, uint16_t ch) {
+    if(ch == ' ') return;
+    int32_t height = canvas_glyph_height(canvas);
+    canvas_fill(canvas, x, y - height, canvas_glyph_width(canvas, ch) - 1, height);
+}
+
+static void canvas_raster_str(Canvas* canvas, int32_t x, int32_t y, const char* str) {
+    for(; *str != '\0'; str++) {
+        canvas_raster_glyph(canvas, x, y, *str);
+        x += canvas_glyph_width(canvas, *str);
+    }
+}
+
+// Midpoint circle, filled with spans for a disc
+static void canvas_raster_circle(Canvas* canvas, int32_t cx, int32_t cy, int32_t r, bool fill) {
+    int32_t x = r;
+    int32_t y = 0;
+    int32_t error = 1 - r;
+    while(x >= y) {
+        if(fill) {
+            canvas_fill(canvas, cx - x, cy + y, 2 * x + 1, 1);
+            if(y) canvas_fill(canvas, cx - x, cy - y, 2 * x + 1, 1);
+            canvas_fill(canvas, cx - y, cy + x, 2 * y + 1, 1);
+            canvas_fill(canvas, cx - y, cy - x, 2 * y + 1, 1);
+        } else {
+            const int32_t points[][2] = {
+                {x, y}, {y, x}, {-y, x}, {-x, y}, {-x, -y}, {-y, -x}, {y, -x}, {x, -y}};
+            for(size_t i = 0; i < COUNT_OF(points); i++) {
+                canvas_pixel(canvas, cx + points[i][0], cy + points[i][1]);
+            }
+        }
+        y++;
+        if(error < 0) {
+            error += 2 * y + 1;
+        } else {
+            x--;
+            error += 2 * (y - x) + 1;
+        }
+    }
+}
+
+/* Host only */
+
+Canvas* furi_shim_canvas_alloc(void) {
+    Canvas* canvas = malloc(sizeof(Canvas));
+    furi_shim_canvas_reset(canvas);
+    return canvas;
+}
+
+void furi_shim_canvas_free(Canvas* canvas) {
+    free(canvas);
+}
+
+void furi_shim_canvas_reset(Canvas* canvas) {
+    memset(canvas, 0, sizeof(Canvas));
+    canvas->font = FontSecondary;
+    canvas->color = ColorBlack;
+    canvas->digest = FNV_OFFSET_BASIS;
+}
+
+uint32_t furi_shim_canvas_get_count(Canvas* canvas, CanvasOp op) {
+    furi_check(op < CanvasOpCount);
+    return canvas->counts[op];
+}
+
+uint32_t furi_shim_canvas_get_total(Canvas* canvas) {
+    uint32_t total = 0;
+    for(size_t i = 0; i < CanvasOpCount; i++) {
+        total += canvas->counts[i];
+    }
+    return total;
+}
+
+uint32_t furi_shim_canvas_get_digest(Canvas* canvas) {
+    return canvas->digest;
+}
+
+const char* furi_shim_canvas_get_str(Canvas* canvas, size_t index) {
+    return index < MIN(canvas->str_count, (size_t)FURI_SHIM_CANVAS_STR_MAX) ?
+               canvas->strs[index] :
+               NULL;
+}
+
+bool furi_shim_canvas_get_pixel(Canvas* canvas, int32_t x, int32_t y) {
+    if(x < 0 || y < 0 || x >= FURI_SHIM_CANVAS_WIDTH || y >= FURI_SHIM_CANVAS_HEIGHT) {
+        return false;
+    }
+    return canvas->pixels[y][x / 8] & (0x80 >> (x % 8));
+}
+
+size_t furi_shim_canvas_get_ink(Canvas* canvas) {
+    size_t ink = 0;
+    for(size_t y = 0; y < FURI_SHIM_CANVAS_HEIGHT; y++) {
+        for(size_t i = 0; i < CANVAS_ROW_BYTES; i++) {
+            ink += __builtin_popcount(canvas->pixels[y][i]);
+        }
+    }
+    return ink;
+}
+
+bool furi_shim_canvas_save_pbm(Canvas* canvas, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if(!file) return false;
+    bool success = fprintf(file, "P4\n%d %d\n", FURI_SHIM_CANVAS_WIDTH, FURI_SHIM_CANVAS_HEIGHT) >
+                       0 &&
+                   fwrite(canvas->pixels, sizeof(canvas->pixels), 1, file) == 1;
+    return (fclose(file) == 0) && success;
+}
+
+/* Canvas API */
+
+void canvas_clear(Canvas* canvas) {
+    canvas_record(canvas, CanvasOpClear, 0, NULL);
+    memset(canvas->pixels, 0, sizeof(canvas->pixels));
+}
+
+uint8_t* canvas_get_buffer(Canvas* canvas) {
+    memset(canvas->pages, 0, sizeof(canvas->pages));
+    for(int32_t y = 0; y < FURI_SHIM_CANVAS_HEIGHT; y++) {
+        for(int32_t x = 0; x < FURI_SHIM_CANVAS_WIDTH; x++) {
+            if(furi_shim_canvas_get_pixel(canvas, x, y)) {
+                canvas->pages[y / 8][x] |= 1 << (y % 8);
+            }
+        }
+    }
+    return &canvas->pages[0][0];
+}
+
+size_t canvas_get_buffer_size(const Canvas* canvas) {
+    return sizeof(canvas->pages);
+}
+
+size_t canvas_width(const Canvas* canvas) {
+    UNUSED(canvas);
+    return FURI_SHIM_CANVAS_WIDTH;
+}
+
+size_t canvas_height(const Canvas* canvas) {
+    UNUSED(canvas);
+    return FURI_SHIM_CANVAS_HEIGHT;
+}
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    int32_t argv[] = {color};
+    canvas_record(canvas, CanvasOpSetColor, COUNT_OF(argv), argv);
+    canvas->color = color;
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    furi_check(font < FontTotalNumber);
+    int32_t argv[] = {font};
+    canvas_record(canvas, CanvasOpSetFont, COUNT_OF(argv), argv);
+    canvas->font = font;
+}
+
+size_t canvas_glyph_width(Canvas* canvas, uint16_t symbol) {
+    UNUSED(symbol);
+    return canvas->font == FontBigNumbers ? 2 * FURI_SHIM_CANVAS_GLYPH_WIDTH :
+                                            FURI_SHIM_CANVAS_GLYPH_WIDTH;
+}
+
+size_t canvas_string_width(Canvas* canvas, const char* str) {
+    size_t width = 0;
+    for(; *str != '\0'; str++) {
+        width += canvas_glyph_width(canvas, *str);
+    }
+    return width;
+}
+
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str) {
+    furi_check(str);
+    int32_t argv[] = {x, y};
+    canvas_record(canvas, CanvasOpStr, COUNT_OF(argv), argv);
+    canvas_keep_str(canvas, str);
+    canvas_raster_str(canvas, x, y, str);
+}
+
+// Recorded as a plain string where it lands, as the firmware resolves it
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str) {
+    furi_check(str);
+    int32_t width = canvas_string_width(canvas, str);
+    if(horizontal == AlignRight) {
+        x -= width;
+    } else if(horizontal == AlignCenter) {
+        x -= width / 2;
+    }
+    if(vertical == AlignTop) {
+        y += canvas_glyph_height(canvas);
+    } else if(vertical == AlignCenter) {
+        y += canvas_glyph_height(canvas) / 2;
+    }
+    canvas_draw_str(canvas, x, y, str);
+}
+
+void canvas_draw_glyph(Canvas* canvas, int32_t x, int32_t y, uint16_t ch) {
+    int32_t argv[] = {x, y, ch};
+    canvas_record(canvas, CanvasOpGlyph, COUNT_OF(argv), argv);
+    canvas_raster_glyph(canvas, x, y, ch);
+}
+
+void canvas_draw_box(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    int32_t argv[] = {x, y, width, height};
+    canvas_record(canvas, CanvasOpBox, COUNT_OF(argv), argv);
+    canvas_fill(canvas, x, y, width, height);
+}
+
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    int32_t argv[] = {x, y, width, height};
+    canvas_record(canvas, CanvasOpFrame, COUNT_OF(argv), argv);
+    canvas_outline(canvas, x, y, width, height, 0);
+}
+
+void canvas_draw_rframe(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    size_t height,
+    size_t radius) {
+    int32_t argv[] = {x, y, width, height, radius};
+    canvas_record(canvas, CanvasOpRFrame, COUNT_OF(argv), argv);
+    canvas_outline(canvas, x, y, width, height, radius);
+}
+
+// Bresenham, both ends included
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    int32_t argv[] = {x1, y1, x2, y2};
+    canvas_record(canvas, CanvasOpLine, COUNT_OF(argv), argv);
+
+    int32_t dx = abs(x2 - x1);
+    int32_t dy = -abs(y2 - y1);
+    int32_t sx = x1 < x2 ? 1 : -1;
+    int32_t sy = y1 < y2 ? 1 : -1;
+    int32_t error = dx + dy;
+    while(true) {
+        canvas_pixel(canvas, x1, y1);
+        if(x1 == x2 && y1 == y2) break;
+        int32_t twice = 2 * error;
+        if(twice >= dy) {
+            error += dy;
+            x1 += sx;
+        }
+        if(twice <= dx) {
+            error += dx;
+            y1 += sy;
+        }
+    }
+}
+
+void canvas_draw_circle(Canvas* canvas, int32_t x, int32_t y, size_t radius) {
+    int32_t argv[] = {x, y, radius};
+    canvas_record(canvas, CanvasOpCircle, COUNT_OF(argv), argv);
+    canvas_raster_circle(canvas, x, y, radius, false);
+}
+
+void canvas_draw_disc(Canvas* canvas, int32_t x, int32_t y, size_t radius) {
+    int32_t argv[] = {x, y, radius};
+    canvas_record(canvas, CanvasOpDisc, COUNT_OF(argv), argv);
+    canvas_raster_circle(canvas, x, y, radius, true);
+}
+
+/* Elements */
+
+void elements_scrollbar_pos(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t height,
+    size_t pos,
+    size_t total) {
+    int32_t argv[] = {x, y, height, pos, total};
+    canvas_record(canvas, CanvasOpScrollbar, COUNT_OF(argv), argv);
+
+    // Dotted track on the right edge with a three pixel wide thumb
+    if(total == 0) return;
+    for(size_t row = 0; row < height; row += 2) {
+        canvas_pixel(canvas, x - 2, y + row);
+    }
+    size_t thumb = MAX(height / total, 1U);
+    size_t top = total > 1 ? pos * (height - thumb) / (total - 1) : 0;
+    canvas_fill(canvas, x - 3, y + top, 3, thumb);
+}
+
+// Frame and box with the four corner pixels left out, as the firmware draws them
+void elements_slightly_rounded_frame(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    size_t height) {
+    int32_t argv[] = {x, y, width, height, 1};
+    canvas_record(canvas, CanvasOpRFrame, COUNT_OF(argv), argv);
+    canvas_fill(canvas, x + 1, y, width - 2, 1);
+    canvas_fill(canvas, x + 1, y + height - 1, width - 2, 1);
+    canvas_fill(canvas, x, y + 1, 1, height - 2);
+    canvas_fill(canvas, x + width - 1, y + 1, 1, height - 2);
+}
+
+void elements_slightly_rounded_box(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    size_t height) {
+    int32_t argv[] = {x, y, width, height};
+    canvas_record(canvas, CanvasOpBox, COUNT_OF(argv), argv);
+    canvas_fill(canvas, x + 1, y, width - 2, height);
+    canvas_fill(canvas, x, y + 1, 1, height - 2);
+    canvas_fill(canvas, x + width - 1, y + 1, 1, height - 2);
+}
+
+void elements_progress_bar(Canvas* canvas, int32_t x, int32_t y, size_t width, float progress) {
+    furi_check(progress >= 0.0f && progress <= 1.0f);
+    const size_t height = 9;
+    canvas_draw_rframe(canvas, x, y, width, height, 3);
+    size_t fill = (width - 2) * progress;
+    if(fill) canvas_draw_box(canvas, x + 1, y + 1, fill, height - 2);
+}
+
+void elements_multiline_text_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* text) {
+    furi_check(text);
+    int32_t line_height = canvas_glyph_height(canvas) + 2;
+    int32_t lines = 1;
+    for(const char* c = text; *c != '\0'; c++) {
+        if(*c == '\n') lines++;
+    }
+    if(vertical == AlignBottom) {
+        y -= lines * line_height;
+    } else if(vertical == AlignCenter) {
+        y -= lines * line_height / 2;
+    }
+
+    char line[CANVAS_STR_SIZE];
+    while(true) {
+        const char* end = strchr(text, '\n');
+        size_t len = end ? (size_t)(end - text) : strlen(text);
+        strlcpy(line, text, MIN(len + 1, sizeof(line)));
+        canvas_draw_str_aligned(canvas, x, y, horizontal, AlignTop, line);
+        if(!end) break;
+        text = end + 1;
+        y += line_height;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <gui/icon_i.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RECORD_DIALOGS "dialogs"
+
+typedef struct DialogsApp DialogsApp;
+
+typedef struct {
+    const char* extension;
+    const char* base_path;
+    bool skip_assets;
+    bool hide_dot_files;
+    const Icon* icon;
+    bool hide_ext;
+    void* item_loader_callback;
+    void* item_loader_context;
+} DialogsFileBrowserOptions;
+
+void dialog_file_browser_set_basic_options(
+    DialogsFileBrowserOptions* options,
+    const char* extension,
+    const Icon* icon);
+
+// The host browser is always cancelled
+bool dialog_file_browser_show(
+    DialogsApp* context,
+    FuriString* result_path,
+    FuriString* path,
+    const DialogsFileBrowserOptions* options);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,71 @@
+#include "toolbox/stream/file_stream.h"
+
+struct Stream {
+    File* file;
+};
+
+Stream* file_stream_alloc(Storage* storage) {
+    Stream* stream = malloc(sizeof(Stream));
+    stream->file = storage_file_alloc(storage);
+    return stream;
+}
+
+bool file_stream_open(
+    Stream* stream,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    return storage_file_open(stream->file, path, access_mode, open_mode);
+}
+
+bool file_stream_close(Stream* stream) {
+    return storage_file_close(stream->file);
+}
+
+void stream_free(Stream* stream) {
+    storage_file_free(stream->file);
+    free(stream);
+}
+
+size_t stream_read(Stream* stream, uint8_t* data, size_t size) {
+    return storage_file_read(stream->file, data, size);
+}
+
+size_t stream_write(Stream* stream, const uint8_t* data, size_t size) {
+    return storage_file_write(stream->file, data, size);
+}
+
+bool stream_seek(Stream* stream, int32_t offset, StreamOffset offset_type) {
+    int64_t position = offset;
+    if(offset_type == StreamOffsetFromCurrent) position += stream_tell(stream);
+    if(offset_type == StreamOffsetFromEnd) position += stream_size(stream);
+    if(position < 0 || (uint64_t)position > stream_size(stream)) return false;
+    return storage_file_seek(stream->file, position, true);
+}
+
+size_t stream_tell(Stream* stream) {
+    return storage_file_tell(stream->file);
+}
+
+size_t stream_size(Stream* stream) {
+    return storage_file_size(stream->file);
+}
+
+bool stream_eof(Stream* stream) {
+    return storage_file_eof(stream->file);
+}
+
+bool stream_rewind(Stream* stream) {
+    return storage_file_seek(stream->file, 0, true);
+}
+
+// Keeps the newline, false only when nothing was left to read
+bool stream_read_line(Stream* stream, FuriString* str_result) {
+    furi_string_reset(str_result);
+    uint8_t c;
+    while(stream_read(stream, &c, 1) == 1) {
+        furi_string_push_back(str_result, c);
+        if(c == '\n') break;
+    }
+    return !furi_string_empty(str_result);
+}
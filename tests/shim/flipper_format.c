@@ -0,0 +1,158 @@
+#include "flipper_format/flipper_format.h"
+#include "toolbox/stream/file_stream.h"
+
+struct FlipperFormat {
+    Stream* stream;
+};
+
+FlipperFormat* flipper_format_file_alloc(Storage* storage) {
+    FlipperFormat* flipper_format = malloc(sizeof(FlipperFormat));
+    flipper_format->stream = file_stream_alloc(storage);
+    return flipper_format;
+}
+
+void flipper_format_free(FlipperFormat* flipper_format) {
+    stream_free(flipper_format->stream);
+    free(flipper_format);
+}
+
+bool flipper_format_file_open_existing(FlipperFormat* flipper_format, const char* path) {
+    return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING);
+}
+
+bool flipper_format_file_open_always(FlipperFormat* flipper_format, const char* path) {
+    return file_stream_open(flipper_format->stream, path, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS);
+}
+
+bool flipper_format_file_close(FlipperFormat* flipper_format) {
+    return file_stream_close(flipper_format->stream);
+}
+
+bool flipper_format_rewind(FlipperFormat* flipper_format) {
+    return stream_rewind(flipper_format->stream);
+}
+
+// Value of the next line with this key, comments skipped
+static bool
+    flipper_format_seek_key(FlipperFormat* flipper_format, const char* key, FuriString* value) {
+    FuriString* line = furi_string_alloc();
+    size_t key_len = strlen(key);
+    bool found = false;
+
+    while(stream_read_line(flipper_format->stream, line)) {
+        const char* text = furi_string_get_cstr(line);
+        if(text[0] == '#') continue;
+        if(strncmp(text, key, key_len) != 0 || text[key_len] != ':') continue;
+
+        furi_string_set_str(value, text + key_len + 1);
+        furi_string_trim(value, " \t\r\n");
+        found = true;
+        break;
+    }
+
+    furi_string_free(line);
+    return found;
+}
+
+static bool flipper_format_write_line(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char* value) {
+    FuriString* line = furi_string_alloc_printf(
+        strcmp(key, "#") == 0 ? "%s %s\n" : "%s: %s\n", key, value);
+    size_t size = furi_string_size(line);
+    bool success = stream_write(
+                       flipper_format->stream, (const uint8_t*)furi_string_get_cstr(line), size) ==
+                   size;
+    furi_string_free(line);
+    return success;
+}
+
+bool flipper_format_read_header(
+    FlipperFormat* flipper_format,
+    FuriString* filetype,
+    uint32_t* version) {
+    return flipper_format_read_string(flipper_format, "Filetype", filetype) &&
+           flipper_format_read_uint32(flipper_format, "Version", version, 1);
+}
+
+bool flipper_format_write_header_cstr(
+    FlipperFormat* flipper_format,
+    const char* filetype,
+    const uint32_t version) {
+    return flipper_format_write_string_cstr(flipper_format, "Filetype", filetype) &&
+           flipper_format_write_uint32(flipper_format, "Version", &version, 1);
+}
+
+bool flipper_format_write_comment_cstr(FlipperFormat* flipper_format, const char* data) {
+    return flipper_format_write_line(flipper_format, "#", data);
+}
+
+bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, FuriString* data) {
+    return flipper_format_seek_key(flipper_format, key, data);
+}
+
+bool flipper_format_write_string_cstr(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char* data) {
+    return flipper_format_write_line(flipper_format, key, data);
+}
+
+bool flipper_format_read_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint32_t* data,
+    const uint16_t data_size) {
+    furi_check(data_size == 1);
+    FuriString* value = furi_string_alloc();
+    bool success = flipper_format_seek_key(flipper_format, key, value);
+    if(success) {
+        char* end;
+        *data = strtoul(furi_string_get_cstr(value), &end, 10);
+        success = end != furi_string_get_cstr(value) && *end == '\0';
+    }
+    furi_string_free(value);
+    return success;
+}
+
+bool flipper_format_write_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint32_t* data,
+    const uint16_t data_size) {
+    furi_check(data_size == 1);
+    char value[16];
+    snprintf(value, sizeof(value), "%lu", *data);
+    return flipper_format_write_line(flipper_format, key, value);
+}
+
+bool flipper_format_read_bool(
+    FlipperFormat* flipper_format,
+    const char* key,
+    bool* data,
+    const uint16_t data_size) {
+    furi_check(data_size == 1);
+    FuriString* value = furi_string_alloc();
+    bool success = flipper_format_seek_key(flipper_format, key, value);
+    if(success) {
+        if(furi_string_cmp_str(value, "true") == 0) {
+            *data = true;
+        } else if(furi_string_cmp_str(value, "false") == 0) {
+            *data = false;
+        } else {
+            success = false;
+        }
+    }
+    furi_string_free(value);
+    return success;
+}
+
+bool flipper_format_write_bool(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const bool* data,
+    const uint16_t data_size) {
+    furi_check(data_size == 1);
+    return flipper_format_write_line(flipper_format, key, *data ? "true" : "false");
+}
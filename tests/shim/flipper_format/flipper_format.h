@@ -0,0 +1,60 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// "Key: value" lines, looked up forward from the current position like the
+// firmware's reader; single values only
+
+typedef struct FlipperFormat FlipperFormat;
+
+FlipperFormat* flipper_format_file_alloc(Storage* storage);
+void flipper_format_free(FlipperFormat* flipper_format);
+bool flipper_format_file_open_existing(FlipperFormat* flipper_format, const char* path);
+bool flipper_format_file_open_always(FlipperFormat* flipper_format, const char* path);
+bool flipper_format_file_close(FlipperFormat* flipper_format);
+bool flipper_format_rewind(FlipperFormat* flipper_format);
+
+bool flipper_format_read_header(
+    FlipperFormat* flipper_format,
+    FuriString* filetype,
+    uint32_t* version);
+bool flipper_format_write_header_cstr(
+    FlipperFormat* flipper_format,
+    const char* filetype,
+    const uint32_t version);
+bool flipper_format_write_comment_cstr(FlipperFormat* flipper_format, const char* data);
+
+bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, FuriString* data);
+bool flipper_format_write_string_cstr(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const char* data);
+bool flipper_format_read_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint32_t* data,
+    const uint16_t data_size);
+bool flipper_format_write_uint32(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const uint32_t* data,
+    const uint16_t data_size);
+bool flipper_format_read_bool(
+    FlipperFormat* flipper_format,
+    const char* key,
+    bool* data,
+    const uint16_t data_size);
+bool flipper_format_write_bool(
+    FlipperFormat* flipper_format,
+    const char* key,
+    const bool* data,
+    const uint16_t data_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,1151 @@
+#define FURI_SHIM_NO_PRINTF
+#define _GNU_SOURCE
+#include "furi.h"
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+// Absolute deadline for a wait of timeout ticks, NULL means forever
+static struct timespec* shim_deadline(struct timespec* deadline, uint32_t timeout) {
+    if(timeout == FuriWaitForever) return NULL;
+    clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_sec += timeout / 1000;
+    deadline->tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if(deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+// false once the deadline has passed
+static bool shim_cond_wait(pthread_cond_t* cond, pthread_mutex_t* lock, struct timespec* until) {
+    if(!until) return pthread_cond_wait(cond, lock) == 0;
+    return pthread_cond_timedwait(cond, lock, until) != ETIMEDOUT;
+}
+
+void furi_shim_crash(const char* file, int line, const char* message) {
+    fprintf(stderr, "furi_crash at %s:%d: %s\n", file, line, message ? message : "");
+    fflush(stderr);
+    abort();
+}
+
+static pthread_mutex_t shim_critical = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+void furi_shim_critical_enter(void) {
+    pthread_mutex_lock(&shim_critical);
+}
+
+void furi_shim_critical_exit(void) {
+    pthread_mutex_unlock(&shim_critical);
+}
+
+/* Logging */
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...) {
+    static const char levels[] = " EWIDT";
+    const char* env = getenv("FURI_LOG_LEVEL");
+    int limit = env ? atoi(env) : FuriLogLevelWarn;
+    if((int)level > limit) return;
+
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    furi_shim_vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    fprintf(stderr, "[%c][%s] %s\n", levels[level], tag, line);
+}
+
+/* printf */
+
+int furi_shim_vsnprintf(char* out, size_t size, const char* format, va_list args) {
+    size_t len = 0;
+    char spec[32];
+    char piece[512];
+
+    for(const char* p = format; *p;) {
+        int n;
+        if(*p != '%') {
+            n = 1;
+            piece[0] = *p++;
+            piece[1] = '\0';
+        } else {
+            const char* start = p++;
+            while(*p && strchr("-+ #0", *p)) p++;
+            int star[2] = {0, 0};
+            int stars = 0;
+            if(*p == '*') {
+                star[stars++] = va_arg(args, int);
+                p++;
+            }
+            while(*p >= '0' && *p <= '9') p++;
+            if(*p == '.') {
+                p++;
+                if(*p == '*') {
+                    star[stars++] = va_arg(args, int);
+                    p++;
+                }
+                while(*p >= '0' && *p <= '9') p++;
+            }
+            // Length modifiers are dropped, the target's int and long are both 32 bits
+            while(*p && strchr("hlzjt", *p)) p++;
+            char conversion = *p ? *p++ : '\0';
+
+            size_t spec_len = 0;
+            for(const char* s = start; s < p && spec_len < sizeof(spec) - 1; s++) {
+                if(!strchr("hlzjt", *s)) spec[spec_len++] = *s;
+            }
+            spec[spec_len] = '\0';
+
+#define SHIM_PIECE(value)                                                           \
+    (stars == 2 ? snprintf(piece, sizeof(piece), spec, star[0], star[1], value) :   \
+     stars == 1 ? snprintf(piece, sizeof(piece), spec, star[0], value) :           \
+                  snprintf(piece, sizeof(piece), spec, value))
+
+            switch(conversion) {
+            case 'd':
+            case 'i':
+                n = SHIM_PIECE((int32_t)va_arg(args, long));
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            case 'c':
+                n = SHIM_PIECE((uint32_t)va_arg(args, unsigned long));
+                break;
+            case 'f':
+            case 'g':
+            case 'e':
+                n = SHIM_PIECE(va_arg(args, double));
+                break;
+            case 's':
+                n = SHIM_PIECE(va_arg(args, const char*));
+                break;
+            case 'p':
+                n = SHIM_PIECE(va_arg(args, void*));
+                break;
+            case '%':
+                n = 1;
+                piece[0] = '%';
+                piece[1] = '\0';
+                break;
+            default:
+                n = 0;
+                break;
+            }
+#undef SHIM_PIECE
+            if(n < 0) n = 0;
+            if((size_t)n >= sizeof(piece)) n = sizeof(piece) - 1;
+        }
+
+        if(size > 0 && len < size - 1) {
+            size_t copy = MIN((size_t)n, size - 1 - len);
+            memcpy(out + len, piece, copy);
+        }
+        len += n;
+    }
+
+    if(size > 0) out[MIN(len, size - 1)] = '\0';
+    return len;
+}
+
+int furi_shim_snprintf(char* out, size_t size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int len = furi_shim_vsnprintf(out, size, format, args);
+    va_end(args);
+    return len;
+}
+
+size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if(size) {
+        size_t copy = MIN(len, size - 1);
+        memcpy(dst, src, copy);
+        dst[copy] = '\0';
+    }
+    return len;
+}
+
+size_t strlcat(char* dst, const char* src, size_t size) {
+    size_t used = strnlen(dst, size);
+    if(used == size) return size + strlen(src);
+    return used + strlcpy(dst + used, src, size - used);
+}
+
+/* Kernel */
+
+static uint64_t shim_now_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+static uint64_t shim_start_us;
+
+static void shim_tick_init(void) {
+    shim_start_us = shim_now_us();
+}
+
+uint32_t furi_get_tick(void) {
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, shim_tick_init);
+    return (shim_now_us() - shim_start_us) / 1000;
+}
+
+uint32_t furi_kernel_get_tick_frequency(void) {
+    return 1000;
+}
+
+uint32_t furi_ms_to_ticks(uint32_t milliseconds) {
+    return milliseconds;
+}
+
+void furi_delay_tick(uint32_t ticks) {
+    furi_delay_ms(ticks);
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    furi_delay_us(milliseconds * 1000);
+}
+
+void furi_delay_us(uint32_t microseconds) {
+    struct timespec delay = {
+        .tv_sec = microseconds / 1000000,
+        .tv_nsec = (long)(microseconds % 1000000) * 1000,
+    };
+    while(nanosleep(&delay, &delay) && errno == EINTR) {
+    }
+}
+
+size_t memmgr_get_free_heap(void) {
+    return 1024 * 1024;
+}
+
+size_t memmgr_get_minimum_free_heap(void) {
+    return 1024 * 1024;
+}
+
+size_t memmgr_heap_get_max_free_block(void) {
+    return 1024 * 1024;
+}
+
+/* Mutex */
+
+struct FuriMutex {
+    pthread_mutex_t lock;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex* mutex = malloc(sizeof(FuriMutex));
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(
+        &attr,
+        type == FuriMutexTypeRecursive ? PTHREAD_MUTEX_RECURSIVE : PTHREAD_MUTEX_ERRORCHECK);
+    pthread_mutex_init(&mutex->lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return mutex;
+}
+
+void furi_mutex_free(FuriMutex* mutex) {
+    furi_check(pthread_mutex_destroy(&mutex->lock) == 0);
+    free(mutex);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    int result;
+    if(timeout == FuriWaitForever) {
+        result = pthread_mutex_lock(&mutex->lock);
+    } else if(timeout == 0) {
+        result = pthread_mutex_trylock(&mutex->lock);
+    } else {
+        struct timespec deadline;
+        result = pthread_mutex_timedlock(&mutex->lock, shim_deadline(&deadline, timeout));
+    }
+    if(result == 0) return FuriStatusOk;
+    return result == ETIMEDOUT || result == EBUSY ? FuriStatusErrorTimeout :
+                                                    FuriStatusErrorResource;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    return pthread_mutex_unlock(&mutex->lock) == 0 ? FuriStatusOk : FuriStatusErrorResource;
+}
+
+/* Semaphore */
+
+struct FuriSemaphore {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint32_t count;
+    uint32_t max_count;
+};
+
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count) {
+    furi_check(max_count && initial_count <= max_count);
+    FuriSemaphore* semaphore = malloc(sizeof(FuriSemaphore));
+    pthread_mutex_init(&semaphore->lock, NULL);
+    pthread_cond_init(&semaphore->changed, NULL);
+    semaphore->count = initial_count;
+    semaphore->max_count = max_count;
+    return semaphore;
+}
+
+void furi_semaphore_free(FuriSemaphore* semaphore) {
+    pthread_cond_destroy(&semaphore->changed);
+    pthread_mutex_destroy(&semaphore->lock);
+    free(semaphore);
+}
+
+FuriStatus furi_semaphore_acquire(FuriSemaphore* semaphore, uint32_t timeout) {
+    struct timespec deadline;
+    struct timespec* until = shim_deadline(&deadline, timeout);
+    FuriStatus status = FuriStatusOk;
+
+    pthread_mutex_lock(&semaphore->lock);
+    while(semaphore->count == 0) {
+        if(timeout == 0 || !shim_cond_wait(&semaphore->changed, &semaphore->lock, until)) {
+            status = timeout == 0 ? FuriStatusErrorResource : FuriStatusErrorTimeout;
+            break;
+        }
+    }
+    if(status == FuriStatusOk) semaphore->count--;
+    pthread_mutex_unlock(&semaphore->lock);
+    return status;
+}
+
+FuriStatus furi_semaphore_release(FuriSemaphore* semaphore) {
+    FuriStatus status = FuriStatusOk;
+    pthread_mutex_lock(&semaphore->lock);
+    if(semaphore->count < semaphore->max_count) {
+        semaphore->count++;
+        pthread_cond_broadcast(&semaphore->changed);
+    } else {
+        status = FuriStatusErrorResource;
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return status;
+}
+
+uint32_t furi_semaphore_get_count(FuriSemaphore* semaphore) {
+    pthread_mutex_lock(&semaphore->lock);
+    uint32_t count = semaphore->count;
+    pthread_mutex_unlock(&semaphore->lock);
+    return count;
+}
+
+/* Event flag */
+
+struct FuriEventFlag {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint32_t flags;
+};
+
+FuriEventFlag* furi_event_flag_alloc(void) {
+    FuriEventFlag* instance = malloc(sizeof(FuriEventFlag));
+    pthread_mutex_init(&instance->lock, NULL);
+    pthread_cond_init(&instance->changed, NULL);
+    instance->flags = 0;
+    return instance;
+}
+
+void furi_event_flag_free(FuriEventFlag* instance) {
+    pthread_cond_destroy(&instance->changed);
+    pthread_mutex_destroy(&instance->lock);
+    free(instance);
+}
+
+uint32_t furi_event_flag_set(FuriEventFlag* instance, uint32_t flags) {
+    pthread_mutex_lock(&instance->lock);
+    instance->flags |= flags;
+    uint32_t result = instance->flags;
+    pthread_cond_broadcast(&instance->changed);
+    pthread_mutex_unlock(&instance->lock);
+    return result;
+}
+
+uint32_t furi_event_flag_clear(FuriEventFlag* instance, uint32_t flags) {
+    pthread_mutex_lock(&instance->lock);
+    uint32_t result = instance->flags;
+    instance->flags &= ~flags;
+    pthread_mutex_unlock(&instance->lock);
+    return result;
+}
+
+uint32_t furi_event_flag_get(FuriEventFlag* instance) {
+    pthread_mutex_lock(&instance->lock);
+    uint32_t result = instance->flags;
+    pthread_mutex_unlock(&instance->lock);
+    return result;
+}
+
+// Shared by event flags and thread flags
+static uint32_t shim_flags_wait(
+    pthread_mutex_t* lock,
+    pthread_cond_t* changed,
+    uint32_t* current,
+    uint32_t flags,
+    uint32_t options,
+    uint32_t timeout) {
+    struct timespec deadline;
+    struct timespec* until = shim_deadline(&deadline, timeout);
+    uint32_t result;
+
+    pthread_mutex_lock(lock);
+    while(true) {
+        uint32_t match = *current & flags;
+        bool done = (options & FuriFlagWaitAll) ? match == flags : match != 0;
+        if(done) {
+            result = *current;
+            if(!(options & FuriFlagNoClear)) *current &= ~flags;
+            break;
+        }
+        if(timeout == 0 || !shim_cond_wait(changed, lock, until)) {
+            result = timeout == 0 ? FuriFlagErrorResource : FuriFlagErrorTimeout;
+            break;
+        }
+    }
+    pthread_mutex_unlock(lock);
+    return result;
+}
+
+uint32_t furi_event_flag_wait(
+    FuriEventFlag* instance,
+    uint32_t flags,
+    uint32_t options,
+    uint32_t timeout) {
+    return shim_flags_wait(
+        &instance->lock, &instance->changed, &instance->flags, flags, options, timeout);
+}
+
+/* Stream buffer */
+
+struct FuriStreamBuffer {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint8_t* data;
+    size_t size;
+    size_t trigger_level;
+    size_t head;
+    size_t count;
+};
+
+FuriStreamBuffer* furi_stream_buffer_alloc(size_t size, size_t trigger_level) {
+    furi_check(size);
+    FuriStreamBuffer* buffer = malloc(sizeof(FuriStreamBuffer));
+    pthread_mutex_init(&buffer->lock, NULL);
+    pthread_cond_init(&buffer->changed, NULL);
+    buffer->data = malloc(size);
+    buffer->size = size;
+    buffer->trigger_level = trigger_level ? trigger_level : 1;
+    buffer->head = 0;
+    buffer->count = 0;
+    return buffer;
+}
+
+void furi_stream_buffer_free(FuriStreamBuffer* buffer) {
+    pthread_cond_destroy(&buffer->changed);
+    pthread_mutex_destroy(&buffer->lock);
+    free(buffer->data);
+    free(buffer);
+}
+
+// Like FreeRTOS: waits for room for all of it, then writes what fits
+size_t furi_stream_buffer_send(
+    FuriStreamBuffer* buffer,
+    const void* data,
+    size_t length,
+    uint32_t timeout) {
+    struct timespec deadline;
+    struct timespec* until = shim_deadline(&deadline, timeout);
+    const uint8_t* bytes = data;
+
+    pthread_mutex_lock(&buffer->lock);
+    while(buffer->size - buffer->count < MIN(length, buffer->size) && timeout != 0) {
+        if(!shim_cond_wait(&buffer->changed, &buffer->lock, until)) break;
+    }
+    size_t sent = MIN(length, buffer->size - buffer->count);
+    for(size_t i = 0; i < sent; i++) {
+        buffer->data[(buffer->head + buffer->count + i) % buffer->size] = bytes[i];
+    }
+    buffer->count += sent;
+    if(sent) pthread_cond_broadcast(&buffer->changed);
+    pthread_mutex_unlock(&buffer->lock);
+    return sent;
+}
+
+size_t furi_stream_buffer_receive(
+    FuriStreamBuffer* buffer,
+    void* data,
+    size_t length,
+    uint32_t timeout) {
+    struct timespec deadline;
+    struct timespec* until = shim_deadline(&deadline, timeout);
+    uint8_t* bytes = data;
+
+    pthread_mutex_lock(&buffer->lock);
+    size_t wanted = MIN(length, buffer->trigger_level);
+    while(buffer->count < wanted && timeout != 0) {
+        if(!shim_cond_wait(&buffer->changed, &buffer->lock, until)) break;
+    }
+    size_t received = MIN(length, buffer->count);
+    for(size_t i = 0; i < received; i++) {
+        bytes[i] = buffer->data[(buffer->head + i) % buffer->size];
+    }
+    buffer->head = (buffer->head + received) % buffer->size;
+    buffer->count -= received;
+    if(received) pthread_cond_broadcast(&buffer->changed);
+    pthread_mutex_unlock(&buffer->lock);
+    return received;
+}
+
+size_t furi_stream_buffer_bytes_available(FuriStreamBuffer* buffer) {
+    pthread_mutex_lock(&buffer->lock);
+    size_t count = buffer->count;
+    pthread_mutex_unlock(&buffer->lock);
+    return count;
+}
+
+size_t furi_stream_buffer_spaces_available(FuriStreamBuffer* buffer) {
+    return buffer->size - furi_stream_buffer_bytes_available(buffer);
+}
+
+bool furi_stream_buffer_is_full(FuriStreamBuffer* buffer) {
+    return furi_stream_buffer_spaces_available(buffer) == 0;
+}
+
+bool furi_stream_buffer_is_empty(FuriStreamBuffer* buffer) {
+    return furi_stream_buffer_bytes_available(buffer) == 0;
+}
+
+FuriStatus furi_stream_buffer_reset(FuriStreamBuffer* buffer) {
+    pthread_mutex_lock(&buffer->lock);
+    buffer->head = 0;
+    buffer->count = 0;
+    pthread_cond_broadcast(&buffer->changed);
+    pthread_mutex_unlock(&buffer->lock);
+    return FuriStatusOk;
+}
+
+/* Message queue */
+
+struct FuriMessageQueue {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint8_t* data;
+    uint32_t msg_count;
+    uint32_t msg_size;
+    uint32_t head;
+    uint32_t count;
+};
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    FuriMessageQueue* queue = malloc(sizeof(FuriMessageQueue));
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->changed, NULL);
+    queue->data = malloc((size_t)msg_count * msg_size);
+    queue->msg_count = msg_count;
+    queue->msg_size = msg_size;
+    queue->head = 0;
+    queue->count = 0;
+    return queue;
+}
+
+void furi_message_queue_free(FuriMessageQueue* queue) {
+    pthread_cond_destroy(&queue->changed);
+    pthread_mutex_destroy(&queue->lock);
+    free(queue->data);
+    free(queue);
+}
+
+FuriStatus furi_message_queue_put(FuriMessageQueue* queue, const void* msg, uint32_t timeout) {
+    struct timespec deadline;
+    struct timespec* until = shim_deadline(&deadline, timeout);
+    FuriStatus status = FuriStatusOk;
+
+    pthread_mutex_lock(&queue->lock);
+    while(queue->count == queue->msg_count) {
+        if(timeout == 0 || !shim_cond_wait(&queue->changed, &queue->lock, until)) {
+            status = timeout == 0 ? FuriStatusErrorResource : FuriStatusErrorTimeout;
+            break;
+        }
+    }
+    if(status == FuriStatusOk) {
+        uint32_t slot = (queue->head + queue->count) % queue->msg_count;
+        memcpy(queue->data + (size_t)slot * queue->msg_size, msg, queue->msg_size);
+        queue->count++;
+        pthread_cond_broadcast(&queue->changed);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return status;
+}
+
+FuriStatus furi_message_queue_get(FuriMessageQueue* queue, void* msg, uint32_t timeout) {
+    struct timespec deadline;
+    struct timespec* until = shim_deadline(&deadline, timeout);
+    FuriStatus status = FuriStatusOk;
+
+    pthread_mutex_lock(&queue->lock);
+    while(queue->count == 0) {
+        if(timeout == 0 || !shim_cond_wait(&queue->changed, &queue->lock, until)) {
+            status = timeout == 0 ? FuriStatusErrorResource : FuriStatusErrorTimeout;
+            break;
+        }
+    }
+    if(status == FuriStatusOk) {
+        memcpy(msg, queue->data + (size_t)queue->head * queue->msg_size, queue->msg_size);
+        queue->head = (queue->head + 1) % queue->msg_count;
+        queue->count--;
+        pthread_cond_broadcast(&queue->changed);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return status;
+}
+
+uint32_t furi_message_queue_get_count(FuriMessageQueue* queue) {
+    pthread_mutex_lock(&queue->lock);
+    uint32_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+/* Thread */
+
+struct FuriThread {
+    pthread_t handle;
+    bool started;
+    char name[32];
+    size_t stack_size;
+    FuriThreadCallback callback;
+    void* context;
+    int32_t return_code;
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint32_t flags;
+};
+
+static __thread FuriThread* shim_current_thread;
+
+static void shim_thread_init(FuriThread* thread) {
+    memset(thread, 0, sizeof(FuriThread));
+    pthread_mutex_init(&thread->lock, NULL);
+    pthread_cond_init(&thread->changed, NULL);
+}
+
+FuriThread* furi_thread_alloc(void) {
+    FuriThread* thread = malloc(sizeof(FuriThread));
+    shim_thread_init(thread);
+    return thread;
+}
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context) {
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, name);
+    furi_thread_set_stack_size(thread, stack_size);
+    furi_thread_set_callback(thread, callback);
+    furi_thread_set_context(thread, context);
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    furi_check(!thread->started);
+    pthread_cond_destroy(&thread->changed);
+    pthread_mutex_destroy(&thread->lock);
+    free(thread);
+}
+
+void furi_thread_set_name(FuriThread* thread, const char* name) {
+    strlcpy(thread->name, name ? name : "", sizeof(thread->name));
+}
+
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size) {
+    thread->stack_size = stack_size;
+}
+
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback) {
+    thread->callback = callback;
+}
+
+void furi_thread_set_context(FuriThread* thread, void* context) {
+    thread->context = context;
+}
+
+void furi_thread_set_priority(FuriThread* thread, FuriThreadPriority priority) {
+    UNUSED(thread);
+    UNUSED(priority);
+}
+
+static void* shim_thread_body(void* context) {
+    FuriThread* thread = context;
+    shim_current_thread = thread;
+    thread->return_code = thread->callback(thread->context);
+    return NULL;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    furi_check(thread->callback && !thread->started);
+    thread->started = true;
+    thread->flags = 0;
+    furi_check(pthread_create(&thread->handle, NULL, shim_thread_body, thread) == 0);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    if(!thread->started) return true;
+    pthread_join(thread->handle, NULL);
+    thread->started = false;
+    return true;
+}
+
+int32_t furi_thread_get_return_code(FuriThread* thread) {
+    return thread->return_code;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+FuriThreadId furi_thread_get_current_id(void) {
+    // Threads not started through the shim, the test main included
+    if(!shim_current_thread) {
+        shim_current_thread = furi_thread_alloc();
+        furi_thread_set_name(shim_current_thread, "main");
+    }
+    return shim_current_thread;
+}
+
+uint32_t furi_thread_get_stack_space(FuriThreadId thread_id) {
+    return thread_id->stack_size;
+}
+
+void furi_thread_yield(void) {
+    sched_yield();
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    pthread_mutex_lock(&thread_id->lock);
+    thread_id->flags |= flags;
+    uint32_t result = thread_id->flags;
+    pthread_cond_broadcast(&thread_id->changed);
+    pthread_mutex_unlock(&thread_id->lock);
+    return result;
+}
+
+uint32_t furi_thread_flags_clear(uint32_t flags) {
+    FuriThread* thread = furi_thread_get_current_id();
+    pthread_mutex_lock(&thread->lock);
+    uint32_t result = thread->flags;
+    thread->flags &= ~flags;
+    pthread_mutex_unlock(&thread->lock);
+    return result;
+}
+
+uint32_t furi_thread_flags_get(void) {
+    FuriThread* thread = furi_thread_get_current_id();
+    pthread_mutex_lock(&thread->lock);
+    uint32_t result = thread->flags;
+    pthread_mutex_unlock(&thread->lock);
+    return result;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    FuriThread* thread = furi_thread_get_current_id();
+    return shim_flags_wait(
+        &thread->lock, &thread->changed, &thread->flags, flags, options, timeout);
+}
+
+/* Timer */
+
+struct FuriTimer {
+    FuriTimerCallback callback;
+    FuriTimerType type;
+    void* context;
+
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    pthread_t handle;
+    bool started; // Thread exists
+    bool running;
+    bool quit;
+    uint32_t ticks;
+    uint32_t generation; // Bumped on every start and stop
+};
+
+static void* shim_timer_body(void* context) {
+    FuriTimer* timer = context;
+    pthread_mutex_lock(&timer->lock);
+    while(!timer->quit) {
+        if(!timer->running) {
+            pthread_cond_wait(&timer->changed, &timer->lock);
+            continue;
+        }
+        uint32_t generation = timer->generation;
+        struct timespec deadline;
+        shim_deadline(&deadline, timer->ticks);
+        while(!timer->quit && generation == timer->generation &&
+              shim_cond_wait(&timer->changed, &timer->lock, &deadline)) {
+        }
+        if(timer->quit || generation != timer->generation) continue;
+
+        if(timer->type == FuriTimerTypeOnce) timer->running = false;
+        pthread_mutex_unlock(&timer->lock);
+        timer->callback(timer->context);
+        pthread_mutex_lock(&timer->lock);
+    }
+    pthread_mutex_unlock(&timer->lock);
+    return NULL;
+}
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context) {
+    FuriTimer* timer = malloc(sizeof(FuriTimer));
+    memset(timer, 0, sizeof(FuriTimer));
+    timer->callback = func;
+    timer->type = type;
+    timer->context = context;
+    pthread_mutex_init(&timer->lock, NULL);
+    pthread_cond_init(&timer->changed, NULL);
+    return timer;
+}
+
+void furi_timer_free(FuriTimer* timer) {
+    pthread_mutex_lock(&timer->lock);
+    timer->quit = true;
+    pthread_cond_broadcast(&timer->changed);
+    pthread_mutex_unlock(&timer->lock);
+    if(timer->started) pthread_join(timer->handle, NULL);
+    pthread_cond_destroy(&timer->changed);
+    pthread_mutex_destroy(&timer->lock);
+    free(timer);
+}
+
+FuriStatus furi_timer_start(FuriTimer* timer, uint32_t ticks) {
+    pthread_mutex_lock(&timer->lock);
+    if(!timer->started) {
+        timer->started = pthread_create(&timer->handle, NULL, shim_timer_body, timer) == 0;
+    }
+    timer->ticks = ticks;
+    timer->running = true;
+    timer->generation++;
+    pthread_cond_broadcast(&timer->changed);
+    pthread_mutex_unlock(&timer->lock);
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_restart(FuriTimer* timer, uint32_t ticks) {
+    return furi_timer_start(timer, ticks);
+}
+
+FuriStatus furi_timer_stop(FuriTimer* timer) {
+    pthread_mutex_lock(&timer->lock);
+    timer->running = false;
+    timer->generation++;
+    pthread_cond_broadcast(&timer->changed);
+    pthread_mutex_unlock(&timer->lock);
+    return FuriStatusOk;
+}
+
+uint32_t furi_timer_is_running(FuriTimer* timer) {
+    pthread_mutex_lock(&timer->lock);
+    uint32_t running = timer->running;
+    pthread_mutex_unlock(&timer->lock);
+    return running;
+}
+
+/* PubSub */
+
+#define SHIM_PUBSUB_MAX 8
+
+struct FuriPubSubSubscription {
+    FuriPubSubCallback callback;
+    void* context;
+};
+
+struct FuriPubSub {
+    pthread_mutex_t lock;
+    FuriPubSubSubscription subscriptions[SHIM_PUBSUB_MAX];
+};
+
+FuriPubSub* furi_pubsub_alloc(void) {
+    FuriPubSub* pubsub = malloc(sizeof(FuriPubSub));
+    memset(pubsub, 0, sizeof(FuriPubSub));
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&pubsub->lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return pubsub;
+}
+
+void furi_pubsub_free(FuriPubSub* pubsub) {
+    pthread_mutex_destroy(&pubsub->lock);
+    free(pubsub);
+}
+
+FuriPubSubSubscription*
+    furi_pubsub_subscribe(FuriPubSub* pubsub, FuriPubSubCallback callback, void* context) {
+    FuriPubSubSubscription* subscription = NULL;
+    pthread_mutex_lock(&pubsub->lock);
+    for(size_t i = 0; i < SHIM_PUBSUB_MAX; i++) {
+        if(pubsub->subscriptions[i].callback) continue;
+        subscription = &pubsub->subscriptions[i];
+        subscription->callback = callback;
+        subscription->context = context;
+        break;
+    }
+    pthread_mutex_unlock(&pubsub->lock);
+    furi_check(subscription);
+    return subscription;
+}
+
+void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* subscription) {
+    pthread_mutex_lock(&pubsub->lock);
+    subscription->callback = NULL;
+    subscription->context = NULL;
+    pthread_mutex_unlock(&pubsub->lock);
+}
+
+void furi_pubsub_publish(FuriPubSub* pubsub, void* message) {
+    pthread_mutex_lock(&pubsub->lock);
+    for(size_t i = 0; i < SHIM_PUBSUB_MAX; i++) {
+        FuriPubSubSubscription* subscription = &pubsub->subscriptions[i];
+        if(subscription->callback) subscription->callback(message, subscription->context);
+    }
+    pthread_mutex_unlock(&pubsub->lock);
+}
+
+/* Record */
+
+#define SHIM_RECORD_MAX 8
+
+static struct {
+    const char* name;
+    void* data;
+} shim_records[SHIM_RECORD_MAX];
+
+static pthread_mutex_t shim_records_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void furi_record_create(const char* name, void* data) {
+    pthread_mutex_lock(&shim_records_lock);
+    size_t free_slot = SHIM_RECORD_MAX;
+    for(size_t i = 0; i < SHIM_RECORD_MAX; i++) {
+        if(shim_records[i].name && strcmp(shim_records[i].name, name) == 0) {
+            free_slot = i;
+            break;
+        }
+        if(!shim_records[i].name && free_slot == SHIM_RECORD_MAX) free_slot = i;
+    }
+    furi_check(free_slot < SHIM_RECORD_MAX);
+    shim_records[free_slot].name = name;
+    shim_records[free_slot].data = data;
+    pthread_mutex_unlock(&shim_records_lock);
+}
+
+bool furi_record_destroy(const char* name) {
+    bool found = false;
+    pthread_mutex_lock(&shim_records_lock);
+    for(size_t i = 0; i < SHIM_RECORD_MAX; i++) {
+        if(shim_records[i].name && strcmp(shim_records[i].name, name) == 0) {
+            shim_records[i].name = NULL;
+            shim_records[i].data = NULL;
+            found = true;
+        }
+    }
+    pthread_mutex_unlock(&shim_records_lock);
+    return found;
+}
+
+// Weak so the storage shim can hand out its instance without a create call
+FURI_WEAK void* furi_shim_record_default(const char* name) {
+    UNUSED(name);
+    return NULL;
+}
+
+void* furi_record_open(const char* name) {
+    void* data = NULL;
+    pthread_mutex_lock(&shim_records_lock);
+    for(size_t i = 0; i < SHIM_RECORD_MAX; i++) {
+        if(shim_records[i].name && strcmp(shim_records[i].name, name) == 0) {
+            data = shim_records[i].data;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&shim_records_lock);
+    if(!data) data = furi_shim_record_default(name);
+    furi_check(data);
+    return data;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+/* String */
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+static void shim_string_reserve(FuriString* string, size_t size) {
+    if(size + 1 <= string->capacity) return;
+    size_t capacity = string->capacity ? string->capacity : 16;
+    while(capacity < size + 1) capacity *= 2;
+    string->data = realloc(string->data, capacity);
+    string->capacity = capacity;
+}
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = malloc(sizeof(FuriString));
+    memset(string, 0, sizeof(FuriString));
+    shim_string_reserve(string, 0);
+    string->data[0] = '\0';
+    return string;
+}
+
+FuriString* furi_string_alloc_set_str(const char cstr[]) {
+    FuriString* string = furi_string_alloc();
+    furi_string_set_str(string, cstr);
+    return string;
+}
+
+FuriString* furi_string_alloc_printf(const char format[], ...) {
+    FuriString* string = furi_string_alloc();
+    va_list args;
+    va_start(args, format);
+    furi_string_vprintf(string, format, args);
+    va_end(args);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->data);
+    free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+void furi_string_set(FuriString* string, FuriString* source) {
+    furi_string_set_str(string, source->data);
+}
+
+void furi_string_set_str(FuriString* string, const char cstr[]) {
+    size_t size = strlen(cstr);
+    shim_string_reserve(string, size);
+    memmove(string->data, cstr, size + 1);
+    string->size = size;
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+bool furi_string_empty(const FuriString* string) {
+    return string->size == 0;
+}
+
+char furi_string_get_char(const FuriString* string, size_t index) {
+    furi_check(index < string->size);
+    return string->data[index];
+}
+
+void furi_string_push_back(FuriString* string, char c) {
+    shim_string_reserve(string, string->size + 1);
+    string->data[string->size++] = c;
+    string->data[string->size] = '\0';
+}
+
+void furi_string_cat_str(FuriString* string, const char cstr[]) {
+    size_t size = strlen(cstr);
+    shim_string_reserve(string, string->size + size);
+    memcpy(string->data + string->size, cstr, size + 1);
+    string->size += size;
+}
+
+static int shim_string_cat_vprintf(FuriString* string, const char format[], va_list args) {
+    va_list copy;
+    va_copy(copy, args);
+    int size = furi_shim_vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    shim_string_reserve(string, string->size + size);
+    furi_shim_vsnprintf(string->data + string->size, size + 1, format, args);
+    string->size += size;
+    return size;
+}
+
+int furi_string_vprintf(FuriString* string, const char format[], va_list args) {
+    furi_string_reset(string);
+    return shim_string_cat_vprintf(string, format, args);
+}
+
+int furi_string_printf(FuriString* string, const char format[], ...) {
+    va_list args;
+    va_start(args, format);
+    int size = furi_string_vprintf(string, format, args);
+    va_end(args);
+    return size;
+}
+
+int furi_string_cat_printf(FuriString* string, const char format[], ...) {
+    va_list args;
+    va_start(args, format);
+    int size = shim_string_cat_vprintf(string, format, args);
+    va_end(args);
+    return size;
+}
+
+int furi_string_cmp_str(const FuriString* string, const char cstr[]) {
+    return strcmp(string->data, cstr);
+}
+
+bool furi_string_start_with_str(const FuriString* string, const char start[]) {
+    return strncmp(string->data, start, strlen(start)) == 0;
+}
+
+bool furi_string_end_with_str(const FuriString* string, const char end[]) {
+    size_t size = strlen(end);
+    return size <= string->size && strcmp(string->data + string->size - size, end) == 0;
+}
+
+size_t furi_string_search_rchar(const FuriString* string, char c, size_t start) {
+    for(size_t i = string->size; i > start; i--) {
+        if(string->data[i - 1] == c) return i - 1;
+    }
+    return FURI_STRING_FAILURE;
+}
+
+void furi_string_left(FuriString* string, size_t index) {
+    if(index < string->size) {
+        string->size = index;
+        string->data[index] = '\0';
+    }
+}
+
+void furi_string_right(FuriString* string, size_t index) {
+    index = MIN(index, string->size);
+    memmove(string->data, string->data + index, string->size - index + 1);
+    string->size -= index;
+}
+
+void furi_string_trim(FuriString* string, const char chars[]) {
+    size_t start = 0;
+    while(start < string->size && strchr(chars, string->data[start])) start++;
+    size_t end = string->size;
+    while(end > start && strchr(chars, string->data[end - 1])) end--;
+    furi_string_left(string, end);
+    furi_string_right(string, start);
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+// Host stand-in for the parts of the furi core the app modules use. Threads,
+// locks and queues map onto pthreads; nothing here tries to behave like the
+// FreeRTOS scheduler beyond what the unit tests need.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UNUSED(x)    (void)(x)
+#define COUNT_OF(x)  (sizeof(x) / sizeof(x[0]))
+#define FURI_PACKED  __attribute__((packed))
+#define FURI_WEAK    __attribute__((weak))
+#define FURI_NORETURN __attribute__((noreturn))
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define CLAMP(x, upper, lower) (MIN(upper, MAX(x, lower)))
+
+FURI_NORETURN void furi_shim_crash(const char* file, int line, const char* message);
+
+#define furi_crash(message)   furi_shim_crash(__FILE__, __LINE__, message)
+#define furi_check(x)         ((x) ? (void)0 : furi_shim_crash(__FILE__, __LINE__, #x))
+#define furi_assert(x)        furi_check(x)
+#define furi_kernel_is_irq_or_masked() false
+
+// One global lock, enough for the short sections the modules guard
+void furi_shim_critical_enter(void);
+void furi_shim_critical_exit(void);
+#define FURI_CRITICAL_ENTER() furi_shim_critical_enter()
+#define FURI_CRITICAL_EXIT()  furi_shim_critical_exit()
+
+/* Logging */
+
+typedef enum {
+    FuriLogLevelError = 1,
+    FuriLogLevelWarn,
+    FuriLogLevelInfo,
+    FuriLogLevelDebug,
+    FuriLogLevelTrace,
+} FuriLogLevel;
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...);
+
+#define FURI_LOG_E(tag, format, ...) \
+    furi_log_print_format(FuriLogLevelError, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) \
+    furi_log_print_format(FuriLogLevelWarn, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, format, ...) \
+    furi_log_print_format(FuriLogLevelInfo, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, format, ...) \
+    furi_log_print_format(FuriLogLevelDebug, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_T(tag, format, ...) \
+    furi_log_print_format(FuriLogLevelTrace, tag, format, ##__VA_ARGS__)
+
+/* printf
+ *
+ * The modules print uint32_t with %lu and size_t with %u, which is right on
+ * the 32-bit target. Every integer conversion here reads a full vararg slot
+ * and keeps the low 32 bits, so the same format strings work on a 64-bit host.
+ */
+
+int furi_shim_snprintf(char* out, size_t size, const char* format, ...);
+int furi_shim_vsnprintf(char* out, size_t size, const char* format, va_list args);
+
+#ifndef FURI_SHIM_NO_PRINTF
+#define snprintf  furi_shim_snprintf
+#define vsnprintf furi_shim_vsnprintf
+#endif
+
+size_t strlcpy(char* dst, const char* src, size_t size);
+size_t strlcat(char* dst, const char* src, size_t size);
+
+/* Kernel */
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+    FuriStatusErrorResource = -3,
+    FuriStatusErrorParameter = -4,
+} FuriStatus;
+
+typedef enum {
+    FuriFlagWaitAny = 0x00000000U,
+    FuriFlagWaitAll = 0x00000001U,
+    FuriFlagNoClear = 0x00000002U,
+    FuriFlagError = 0x80000000U,
+    FuriFlagErrorUnknown = 0xFFFFFFFFU,
+    FuriFlagErrorTimeout = 0xFFFFFFFEU,
+    FuriFlagErrorResource = 0xFFFFFFFDU,
+    FuriFlagErrorParameter = 0xFFFFFFFCU,
+} FuriFlag;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+// One tick per millisecond, counted from the first call
+uint32_t furi_get_tick(void);
+uint32_t furi_kernel_get_tick_frequency(void);
+uint32_t furi_ms_to_ticks(uint32_t milliseconds);
+void furi_delay_tick(uint32_t ticks);
+void furi_delay_ms(uint32_t milliseconds);
+void furi_delay_us(uint32_t microseconds);
+
+size_t memmgr_get_free_heap(void);
+size_t memmgr_get_minimum_free_heap(void);
+size_t memmgr_heap_get_max_free_block(void);
+
+/* Mutex */
+
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+
+typedef struct FuriMutex FuriMutex;
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* mutex);
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* mutex);
+
+/* Semaphore */
+
+typedef struct FuriSemaphore FuriSemaphore;
+
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count);
+void furi_semaphore_free(FuriSemaphore* semaphore);
+FuriStatus furi_semaphore_acquire(FuriSemaphore* semaphore, uint32_t timeout);
+FuriStatus furi_semaphore_release(FuriSemaphore* semaphore);
+uint32_t furi_semaphore_get_count(FuriSemaphore* semaphore);
+
+/* Event flag */
+
+typedef struct FuriEventFlag FuriEventFlag;
+
+FuriEventFlag* furi_event_flag_alloc(void);
+void furi_event_flag_free(FuriEventFlag* instance);
+uint32_t furi_event_flag_set(FuriEventFlag* instance, uint32_t flags);
+uint32_t furi_event_flag_clear(FuriEventFlag* instance, uint32_t flags);
+uint32_t furi_event_flag_get(FuriEventFlag* instance);
+uint32_t furi_event_flag_wait(
+    FuriEventFlag* instance,
+    uint32_t flags,
+    uint32_t options,
+    uint32_t timeout);
+
+/* Stream buffer */
+
+typedef struct FuriStreamBuffer FuriStreamBuffer;
+
+FuriStreamBuffer* furi_stream_buffer_alloc(size_t size, size_t trigger_level);
+void furi_stream_buffer_free(FuriStreamBuffer* stream_buffer);
+size_t furi_stream_buffer_send(
+    FuriStreamBuffer* stream_buffer,
+    const void* data,
+    size_t length,
+    uint32_t timeout);
+size_t furi_stream_buffer_receive(
+    FuriStreamBuffer* stream_buffer,
+    void* data,
+    size_t length,
+    uint32_t timeout);
+size_t furi_stream_buffer_bytes_available(FuriStreamBuffer* stream_buffer);
+size_t furi_stream_buffer_spaces_available(FuriStreamBuffer* stream_buffer);
+bool furi_stream_buffer_is_full(FuriStreamBuffer* stream_buffer);
+bool furi_stream_buffer_is_empty(FuriStreamBuffer* stream_buffer);
+FuriStatus furi_stream_buffer_reset(FuriStreamBuffer* stream_buffer);
+
+/* Message queue */
+
+typedef struct FuriMessageQueue FuriMessageQueue;
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size);
+void furi_message_queue_free(FuriMessageQueue* instance);
+FuriStatus
+    furi_message_queue_put(FuriMessageQueue* instance, const void* msg_ptr, uint32_t timeout);
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg_ptr, uint32_t timeout);
+uint32_t furi_message_queue_get_count(FuriMessageQueue* instance);
+
+/* Thread */
+
+typedef enum {
+    FuriThreadPriorityNone = 0,
+    FuriThreadPriorityIdle = 1,
+    FuriThreadPriorityLowest = 14,
+    FuriThreadPriorityLow = 15,
+    FuriThreadPriorityNormal = 16,
+    FuriThreadPriorityHigh = 17,
+    FuriThreadPriorityHighest = 18,
+    FuriThreadPriorityIsr = 32,
+} FuriThreadPriority;
+
+typedef struct FuriThread FuriThread;
+typedef FuriThread* FuriThreadId;
+typedef int32_t (*FuriThreadCallback)(void* context);
+
+FuriThread* furi_thread_alloc(void);
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_set_name(FuriThread* thread, const char* name);
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size);
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback);
+void furi_thread_set_context(FuriThread* thread, void* context);
+void furi_thread_set_priority(FuriThread* thread, FuriThreadPriority priority);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+int32_t furi_thread_get_return_code(FuriThread* thread);
+FuriThreadId furi_thread_get_id(FuriThread* thread);
+FuriThreadId furi_thread_get_current_id(void);
+uint32_t furi_thread_get_stack_space(FuriThreadId thread_id);
+void furi_thread_yield(void);
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+uint32_t furi_thread_flags_clear(uint32_t flags);
+uint32_t furi_thread_flags_get(void);
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+/* Timer */
+
+typedef void (*FuriTimerCallback)(void* context);
+
+typedef enum {
+    FuriTimerTypeOnce = 0,
+    FuriTimerTypePeriodic = 1,
+} FuriTimerType;
+
+typedef struct FuriTimer FuriTimer;
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context);
+void furi_timer_free(FuriTimer* instance);
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks);
+FuriStatus furi_timer_restart(FuriTimer* instance, uint32_t ticks);
+FuriStatus furi_timer_stop(FuriTimer* instance);
+uint32_t furi_timer_is_running(FuriTimer* instance);
+
+/* PubSub */
+
+typedef void (*FuriPubSubCallback)(const void* message, void* context);
+typedef struct FuriPubSub FuriPubSub;
+typedef struct FuriPubSubSubscription FuriPubSubSubscription;
+
+FuriPubSub* furi_pubsub_alloc(void);
+void furi_pubsub_free(FuriPubSub* pubsub);
+FuriPubSubSubscription*
+    furi_pubsub_subscribe(FuriPubSub* pubsub, FuriPubSubCallback callback, void* callback_context);
+void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_subscription);
+void furi_pubsub_publish(FuriPubSub* pubsub, void* message);
+
+/* Record */
+
+#define RECORD_STORAGE      "storage"
+#define RECORD_INPUT_EVENTS "input_events"
+#define RECORD_GUI          "gui"
+#define RECORD_NOTIFICATION "notification"
+
+void furi_record_create(const char* name, void* data);
+bool furi_record_destroy(const char* name);
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
+
+/* String */
+
+typedef struct FuriString FuriString;
+
+#define FURI_STRING_FAILURE ((size_t)-1)
+
+FuriString* furi_string_alloc(void);
+FuriString* furi_string_alloc_set_str(const char cstr[]);
+FuriString* furi_string_alloc_printf(const char format[], ...);
+void furi_string_free(FuriString* string);
+void furi_string_reset(FuriString* string);
+void furi_string_set(FuriString* string, FuriString* source);
+void furi_string_set_str(FuriString* string, const char cstr[]);
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+bool furi_string_empty(const FuriString* string);
+char furi_string_get_char(const FuriString* string, size_t index);
+void furi_string_push_back(FuriString* string, char c);
+void furi_string_cat_str(FuriString* string, const char cstr[]);
+int furi_string_printf(FuriString* string, const char format[], ...);
+int furi_string_vprintf(FuriString* string, const char format[], va_list args);
+int furi_string_cat_printf(FuriString* string, const char format[], ...);
+int furi_string_cmp_str(const FuriString* string, const char cstr[]);
+bool furi_string_start_with_str(const FuriString* string, const char start[]);
+bool furi_string_end_with_str(const FuriString* string, const char end[]);
+size_t furi_string_search_rchar(const FuriString* string, char c, size_t start);
+void furi_string_left(FuriString* string, size_t index);
+void furi_string_right(FuriString* string, size_t index);
+void furi_string_trim(FuriString* string, const char chars[]);
+
+/* Paths */
+
+#define STORAGE_EXT_PATH_PREFIX      "/ext"
+#define STORAGE_APP_DATA_PATH_PREFIX "/data"
+#define EXT_PATH(path)               STORAGE_EXT_PATH_PREFIX "/" path
+#define APP_DATA_PATH(path)          STORAGE_APP_DATA_PATH_PREFIX "/" path
+
+#ifdef __cplusplus
+}
+#endif
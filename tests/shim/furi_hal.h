@@ -0,0 +1,7 @@
+#pragma once
+
+#include <furi_hal_cortex.h>
+#include <furi_hal_power.h>
+#include <furi_hal_serial.h>
+#include <furi_hal_usb.h>
+#include <furi_hal_usb_hid.h>
@@ -0,0 +1,36 @@
+#include "furi_hal_cortex.h"
+#include <time.h>
+
+#define CORTEX_MHZ 64
+
+static uint32_t cortex_cycles(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t ns = (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+    return (uint32_t)(ns * CORTEX_MHZ / 1000);
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return CORTEX_MHZ;
+}
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us) {
+    FuriHalCortexTimer cortex_timer = {
+        .start = cortex_cycles(),
+        .value = timeout_us * CORTEX_MHZ,
+    };
+    return cortex_timer;
+}
+
+bool furi_hal_cortex_timer_is_expired(FuriHalCortexTimer cortex_timer) {
+    return cortex_cycles() - cortex_timer.start >= cortex_timer.value;
+}
+
+void furi_hal_cortex_timer_wait(FuriHalCortexTimer cortex_timer) {
+    while(!furi_hal_cortex_timer_is_expired(cortex_timer)) {
+    }
+}
+
+void furi_hal_cortex_delay_us(uint32_t microseconds) {
+    furi_hal_cortex_timer_wait(furi_hal_cortex_timer_get(microseconds));
+}
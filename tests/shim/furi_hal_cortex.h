@@ -0,0 +1,23 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cycle counter of a 64 MHz core, derived from the host monotonic clock
+typedef struct {
+    uint32_t start;
+    uint32_t value;
+} FuriHalCortexTimer;
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us);
+bool furi_hal_cortex_timer_is_expired(FuriHalCortexTimer cortex_timer);
+void furi_hal_cortex_timer_wait(FuriHalCortexTimer cortex_timer);
+void furi_hal_cortex_delay_us(uint32_t microseconds);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A full battery on USB power, charging done
+uint8_t furi_hal_power_get_pct(void);
+bool furi_hal_power_is_charging(void);
+
+#ifdef __cplusplus
+}
+#endif
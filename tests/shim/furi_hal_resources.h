@@ -0,0 +1,5 @@
+#pragma once
+
+// No pins or resources on the host, the header only has to exist
+
+#include <furi.h>
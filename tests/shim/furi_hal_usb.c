@@ -0,0 +1,62 @@
+#include <furi_hal_usb.h>
+
+static struct {
+    FuriHalUsbInterface* interface;
+    bool enabled;
+    bool locked;
+    bool failing;
+    uint32_t switches;
+} usb;
+
+bool furi_hal_usb_set_config(FuriHalUsbInterface* new_if, void* ctx) {
+    UNUSED(ctx);
+    if(usb.locked || usb.failing) return false;
+    usb.interface = new_if;
+    usb.enabled = new_if != NULL;
+    usb.switches++;
+    return true;
+}
+
+FuriHalUsbInterface* furi_hal_usb_get_config(void) {
+    return usb.enabled ? usb.interface : NULL;
+}
+
+void furi_hal_usb_lock(void) {
+    usb.locked = true;
+}
+
+void furi_hal_usb_unlock(void) {
+    usb.locked = false;
+}
+
+bool furi_hal_usb_is_locked(void) {
+    return usb.locked;
+}
+
+void furi_hal_usb_disable(void) {
+    usb.enabled = false;
+    usb.switches++;
+}
+
+void furi_hal_usb_enable(void) {
+    usb.enabled = usb.interface != NULL;
+}
+
+void furi_hal_usb_reinit(void) {
+}
+
+void furi_shim_usb_reset(FuriHalUsbInterface* interface) {
+    usb.interface = interface;
+    usb.enabled = interface != NULL;
+    usb.locked = false;
+    usb.failing = false;
+    usb.switches = 0;
+}
+
+void furi_shim_usb_set_failing(bool failing) {
+    usb.failing = failing;
+}
+
+uint32_t furi_shim_usb_get_switches(void) {
+    return usb.switches;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <furi.h>
+#include <usb.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct FuriHalUsbInterface FuriHalUsbInterface;
+
+struct FuriHalUsbInterface {
+    void (*init)(usbd_device* dev, FuriHalUsbInterface* intf, void* ctx);
+    void (*deinit)(usbd_device* dev);
+    void (*wakeup)(usbd_device* dev);
+    void (*suspend)(usbd_device* dev);
+    struct usb_device_descriptor* dev_descr;
+    void* str_manuf_descr;
+    void* str_prod_descr;
+    void* str_serial_descr;
+    void* cfg_descr;
+};
+
+// Active interface switching, the host keeps only the active pointer
+bool furi_hal_usb_set_config(FuriHalUsbInterface* new_if, void* ctx);
+FuriHalUsbInterface* furi_hal_usb_get_config(void);
+void furi_hal_usb_lock(void);
+void furi_hal_usb_unlock(void);
+bool furi_hal_usb_is_locked(void);
+void furi_hal_usb_disable(void);
+void furi_hal_usb_enable(void);
+void furi_hal_usb_reinit(void);
+
+// Host only: start from interface, or NULL for USB off
+void furi_shim_usb_reset(FuriHalUsbInterface* interface);
+// Host only: make furi_hal_usb_set_config fail, e.g. another app holds USB
+void furi_shim_usb_set_failing(bool failing);
+// Host only: furi_hal_usb_set_config and furi_hal_usb_disable calls since the reset
+uint32_t furi_shim_usb_get_switches(void);
+
+#ifdef __cplusplus
+}
+#endif
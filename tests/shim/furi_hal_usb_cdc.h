@@ -0,0 +1,38 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CDC_DATA_SZ 64
+
+struct usb_cdc_line_coding {
+    uint32_t dwDTERate;
+    uint8_t bCharFormat;
+    uint8_t bParityType;
+    uint8_t bDataBits;
+} __attribute__((packed));
+
+typedef enum {
+    CdcStateDisconnected,
+    CdcStateConnected,
+} CdcState;
+
+typedef enum {
+    CdcCtrlLineDTR = (1 << 0),
+    CdcCtrlLineRTS = (1 << 1),
+} CdcCtrlLine;
+
+typedef struct {
+    void (*tx_ep_callback)(void* context);
+    void (*rx_ep_callback)(void* context);
+    void (*state_callback)(void* context, uint8_t state);
+    void (*ctrl_line_callback)(void* context, uint8_t state);
+    void (*config_callback)(void* context, struct usb_cdc_line_coding* config);
+} CdcCallbacks;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Usage IDs from the HID keyboard page, only the ones the app types
+#define KEY_MOD_LEFT_SHIFT 0x0200
+
+enum HidKeyboardKeys {
+    HID_KEYBOARD_NONE = 0x00,
+    HID_KEYBOARD_A = 0x04,
+    HID_KEYBOARD_1 = 0x1E,
+    HID_KEYBOARD_0 = 0x27,
+    HID_KEYBOARD_RETURN = 0x28,
+    HID_KEYBOARD_ESCAPE = 0x29,
+    HID_KEYBOARD_DELETE = 0x2A,
+    HID_KEYBOARD_TAB = 0x2B,
+    HID_KEYBOARD_SPACEBAR = 0x2C,
+    HID_KEYBOARD_MINUS = 0x2D,
+    HID_KEYBOARD_DOT = 0x37,
+    HID_KEYBOARD_SLASH = 0x38,
+};
+
+#define HID_ASCII_LETTER(c) (HID_KEYBOARD_A + ((c) - 'a'))
+
+// Letters, digits and a few punctuation keys, everything else types nothing
+static const uint16_t hid_asciimap[] = {
+    ['\t'] = HID_KEYBOARD_TAB,
+    ['\n'] = HID_KEYBOARD_RETURN,
+    [' '] = HID_KEYBOARD_SPACEBAR,
+    ['-'] = HID_KEYBOARD_MINUS,
+    ['.'] = HID_KEYBOARD_DOT,
+    ['/'] = HID_KEYBOARD_SLASH,
+    ['0'] = HID_KEYBOARD_0,
+    ['1'] = HID_KEYBOARD_1,
+    ['2'] = HID_KEYBOARD_1 + 1,
+    ['3'] = HID_KEYBOARD_1 + 2,
+    ['4'] = HID_KEYBOARD_1 + 3,
+    ['5'] = HID_KEYBOARD_1 + 4,
+    ['6'] = HID_KEYBOARD_1 + 5,
+    ['7'] = HID_KEYBOARD_1 + 6,
+    ['8'] = HID_KEYBOARD_1 + 7,
+    ['9'] = HID_KEYBOARD_1 + 8,
+    ['A'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('a'),
+    ['B'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('b'),
+    ['C'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('c'),
+    ['D'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('d'),
+    ['E'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('e'),
+    ['F'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('f'),
+    ['G'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('g'),
+    ['H'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('h'),
+    ['I'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('i'),
+    ['J'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('j'),
+    ['K'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('k'),
+    ['L'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('l'),
+    ['M'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('m'),
+    ['N'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('n'),
+    ['O'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('o'),
+    ['P'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('p'),
+    ['Q'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('q'),
+    ['R'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('r'),
+    ['S'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('s'),
+    ['T'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('t'),
+    ['U'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('u'),
+    ['V'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('v'),
+    ['W'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('w'),
+    ['X'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('x'),
+    ['Y'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('y'),
+    ['Z'] = KEY_MOD_LEFT_SHIFT | HID_ASCII_LETTER('z'),
+    ['a'] = HID_ASCII_LETTER('a'),
+    ['b'] = HID_ASCII_LETTER('b'),
+    ['c'] = HID_ASCII_LETTER('c'),
+    ['d'] = HID_ASCII_LETTER('d'),
+    ['e'] = HID_ASCII_LETTER('e'),
+    ['f'] = HID_ASCII_LETTER('f'),
+    ['g'] = HID_ASCII_LETTER('g'),
+    ['h'] = HID_ASCII_LETTER('h'),
+    ['i'] = HID_ASCII_LETTER('i'),
+    ['j'] = HID_ASCII_LETTER('j'),
+    ['k'] = HID_ASCII_LETTER('k'),
+    ['l'] = HID_ASCII_LETTER('l'),
+    ['m'] = HID_ASCII_LETTER('m'),
+    ['n'] = HID_ASCII_LETTER('n'),
+    ['o'] = HID_ASCII_LETTER('o'),
+    ['p'] = HID_ASCII_LETTER('p'),
+    ['q'] = HID_ASCII_LETTER('q'),
+    ['r'] = HID_ASCII_LETTER('r'),
+    ['s'] = HID_ASCII_LETTER('s'),
+    ['t'] = HID_ASCII_LETTER('t'),
+    ['u'] = HID_ASCII_LETTER('u'),
+    ['v'] = HID_ASCII_LETTER('v'),
+    ['w'] = HID_ASCII_LETTER('w'),
+    ['x'] = HID_ASCII_LETTER('x'),
+    ['y'] = HID_ASCII_LETTER('y'),
+    ['z'] = HID_ASCII_LETTER('z'),
+    [127] = HID_KEYBOARD_NONE,
+};
+
+#define HID_ASCII_TO_KEY(x) \
+    (((uint8_t)(x) < 128) ? hid_asciimap[(uint8_t)(x)] : HID_KEYBOARD_NONE)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,39 @@
+#include <gui/gui.h>
+
+struct Gui {
+    Canvas* canvas;
+    bool direct; // Held by gui_direct_draw_acquire
+};
+
+Gui* furi_shim_gui_alloc(void) {
+    Gui* gui = malloc(sizeof(Gui));
+    gui->canvas = furi_shim_canvas_alloc();
+    gui->direct = false;
+    return gui;
+}
+
+void furi_shim_gui_free(Gui* gui) {
+    furi_check(gui);
+    furi_check(!gui->direct);
+    furi_shim_canvas_free(gui->canvas);
+    free(gui);
+}
+
+Canvas* furi_shim_gui_get_canvas(Gui* gui) {
+    furi_check(gui);
+    return gui->canvas;
+}
+
+Canvas* gui_direct_draw_acquire(Gui* gui) {
+    furi_check(gui);
+    furi_check(!gui->direct);
+    gui->direct = true;
+    furi_shim_canvas_reset(gui->canvas);
+    return gui->canvas;
+}
+
+void gui_direct_draw_release(Gui* gui) {
+    furi_check(gui);
+    furi_check(gui->direct);
+    gui->direct = false;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+// Host canvas: every call is recorded as an op so tests can count draws per
+// op and compare whole frames by digest, and rasterised into a 1-bpp
+// framebuffer of the screen size that can be read back or saved as a PBM.
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ColorWhite = 0x00,
+    ColorBlack = 0x01,
+    ColorXOR = 0x02,
+} Color;
+
+typedef enum {
+    AlignLeft,
+    AlignRight,
+    AlignTop,
+    AlignBottom,
+    AlignCenter,
+} Align;
+
+typedef enum {
+    FontPrimary,
+    FontSecondary,
+    FontKeyboard,
+    FontBigNumbers,
+    FontTotalNumber,
+} Font;
+
+typedef struct Canvas Canvas;
+
+void canvas_clear(Canvas* canvas);
+uint8_t* canvas_get_buffer(Canvas* canvas);
+size_t canvas_get_buffer_size(const Canvas* canvas);
+size_t canvas_width(const Canvas* canvas);
+size_t canvas_height(const Canvas* canvas);
+void canvas_set_color(Canvas* canvas, Color color);
+void canvas_set_font(Canvas* canvas, Font font);
+size_t canvas_glyph_width(Canvas* canvas, uint16_t symbol);
+size_t canvas_string_width(Canvas* canvas, const char* str);
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str);
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str);
+void canvas_draw_glyph(Canvas* canvas, int32_t x, int32_t y, uint16_t ch);
+void canvas_draw_box(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height);
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height);
+void canvas_draw_rframe(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    size_t height,
+    size_t radius);
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+void canvas_draw_circle(Canvas* canvas, int32_t x, int32_t y, size_t radius);
+void canvas_draw_disc(Canvas* canvas, int32_t x, int32_t y, size_t radius);
+
+/* Host only */
+
+typedef enum {
+    CanvasOpClear,
+    CanvasOpSetColor,
+    CanvasOpSetFont,
+    CanvasOpStr,
+    CanvasOpBox,
+    CanvasOpFrame,
+    CanvasOpLine,
+    CanvasOpCircle,
+    CanvasOpDisc,
+    CanvasOpScrollbar, // elements_scrollbar_pos, recorded as one op
+    CanvasOpGlyph,
+    CanvasOpRFrame,
+    CanvasOpCount,
+} CanvasOp;
+
+#define FURI_SHIM_CANVAS_STR_MAX 16 // Strings kept per frame, later ones are only counted
+
+// Glyphs are a fixed width per font, close to the firmware fonts' average.
+// There is no font data, a glyph rasterises as a solid cell above the baseline.
+#define FURI_SHIM_CANVAS_GLYPH_WIDTH  5
+#define FURI_SHIM_CANVAS_GLYPH_HEIGHT 7
+
+#define FURI_SHIM_CANVAS_WIDTH  128
+#define FURI_SHIM_CANVAS_HEIGHT 64
+
+Canvas* furi_shim_canvas_alloc(void);
+void furi_shim_canvas_free(Canvas* canvas);
+
+// Start a new frame: counts, digest, kept strings and pixels are cleared
+void furi_shim_canvas_reset(Canvas* canvas);
+uint32_t furi_shim_canvas_get_count(Canvas* canvas, CanvasOp op);
+
+// Ops drawn since the last reset
+uint32_t furi_shim_canvas_get_total(Canvas* canvas);
+
+// FNV-1a over every op and its arguments, string contents included
+uint32_t furi_shim_canvas_get_digest(Canvas* canvas);
+
+// The index-th string drawn since the last reset, NULL past the kept ones
+const char* furi_shim_canvas_get_str(Canvas* canvas, size_t index);
+
+// Framebuffer pixel, false off screen
+bool furi_shim_canvas_get_pixel(Canvas* canvas, int32_t x, int32_t y);
+
+// Pixels set in the framebuffer
+size_t furi_shim_canvas_get_ink(Canvas* canvas);
+
+// Write the framebuffer to a host path as a binary PBM (P4)
+bool furi_shim_canvas_save_pbm(Canvas* canvas, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <gui/canvas.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void elements_scrollbar_pos(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t height,
+    size_t pos,
+    size_t total);
+void elements_slightly_rounded_frame(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    size_t height);
+void elements_slightly_rounded_box(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    size_t width,
+    size_t height);
+
+// A rounded frame and a box for the filled part
+void elements_progress_bar(Canvas* canvas, int32_t x, int32_t y, size_t width, float progress);
+
+// Lines split at '\n', each recorded as a string
+void elements_multiline_text_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* text);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <gui/canvas.h>
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Gui Gui;
+
+Canvas* gui_direct_draw_acquire(Gui* gui);
+void gui_direct_draw_release(Gui* gui);
+
+/* Host only, a screen made of one host canvas */
+
+Gui* furi_shim_gui_alloc(void);
+void furi_shim_gui_free(Gui* gui);
+
+// The canvas direct draw hands out, to read back what was drawn
+Canvas* furi_shim_gui_get_canvas(Gui* gui);
+
+#ifdef __cplusplus
+}
+#endif
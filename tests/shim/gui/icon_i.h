@@ -0,0 +1,7 @@
+#pragma once
+
+// The app draws no icons on the host, the type only has to exist
+
+#include <gui/canvas.h>
+
+typedef struct Icon Icon;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Submenu Submenu;
+typedef void (*SubmenuItemCallback)(void* context, uint32_t index);
+
+Submenu* submenu_alloc(void);
+void submenu_free(Submenu* submenu);
+View* submenu_get_view(Submenu* submenu);
+void submenu_add_item(
+    Submenu* submenu,
+    const char* label,
+    uint32_t index,
+    SubmenuItemCallback callback,
+    void* callback_context);
+void submenu_change_item_label(Submenu* submenu, uint32_t index, const char* label);
+void submenu_reset(Submenu* submenu);
+void submenu_set_selected_item(Submenu* submenu, uint32_t index);
+uint32_t submenu_get_selected_item(Submenu* submenu);
+void submenu_set_header(Submenu* submenu, const char* header);
+
+/* Host only */
+
+// Label of the item with this index, NULL if there is none
+const char* furi_shim_submenu_get_label(Submenu* submenu, uint32_t index);
+
+// Index of the first item whose label starts with prefix, UINT32_MAX if none
+uint32_t furi_shim_submenu_find(Submenu* submenu, const char* prefix);
+
+#ifdef __cplusplus
+}
+#endif
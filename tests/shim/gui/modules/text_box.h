@@ -0,0 +1,7 @@
+#pragma once
+
+// The app includes it without using a text box, the header only has to exist
+
+#include <gui/view.h>
+
+typedef struct TextBox TextBox;
@@ -0,0 +1,5 @@
+#pragma once
+
+// The app includes it without using scenes, the header only has to exist
+
+#include <furi.h>
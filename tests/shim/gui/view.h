@@ -0,0 +1,53 @@
+#pragma once
+
+#include <gui/canvas.h>
+#include <input/input.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct View View;
+
+typedef void (*ViewDrawCallback)(Canvas* canvas, void* model);
+typedef bool (*ViewInputCallback)(InputEvent* event, void* context);
+
+typedef enum {
+    ViewModelTypeNone,
+    ViewModelTypeLockFree,
+    ViewModelTypeLocking,
+} ViewModelType;
+
+View* view_alloc(void);
+void view_free(View* view);
+void view_set_draw_callback(View* view, ViewDrawCallback callback);
+void view_set_input_callback(View* view, ViewInputCallback callback);
+void view_set_context(View* view, void* context);
+void view_allocate_model(View* view, ViewModelType type, size_t size);
+void* view_get_model(View* view);
+void view_commit_model(View* view, bool update);
+
+#define with_view_model(view, type, code, update) \
+    {                                             \
+        type = view_get_model(view);              \
+        {code};                                   \
+        view_commit_model(view, update);          \
+    }
+
+/* Host only, what the view port and dispatcher do on the device */
+
+// Draw callback under the model lock, timed
+void furi_shim_view_draw(View* view, Canvas* canvas);
+
+// Input callback, false if the view has none or left the event
+bool furi_shim_view_input(View* view, InputEvent* event);
+
+// Commits that asked for a redraw since alloc
+uint32_t furi_shim_view_get_updates(View* view);
+
+// Wall time of the last draw callback in nanoseconds
+uint64_t furi_shim_view_get_draw_ns(View* view);
+
+#ifdef __cplusplus
+}
+#endif
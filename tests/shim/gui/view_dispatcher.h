@@ -0,0 +1,64 @@
+#pragma once
+
+#include <gui/gui.h>
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ViewDispatcher ViewDispatcher;
+
+typedef bool (*ViewDispatcherCustomEventCallback)(void* context, uint32_t event);
+typedef bool (*ViewDispatcherNavigationEventCallback)(void* context);
+
+typedef enum {
+    ViewDispatcherTypeDesktop,
+    ViewDispatcherTypeWindow,
+    ViewDispatcherTypeFullscreen,
+} ViewDispatcherType;
+
+ViewDispatcher* view_dispatcher_alloc(void);
+void view_dispatcher_free(ViewDispatcher* view_dispatcher);
+void view_dispatcher_send_custom_event(ViewDispatcher* view_dispatcher, uint32_t event);
+void view_dispatcher_set_custom_event_callback(
+    ViewDispatcher* view_dispatcher,
+    ViewDispatcherCustomEventCallback callback);
+void view_dispatcher_set_navigation_event_callback(
+    ViewDispatcher* view_dispatcher,
+    ViewDispatcherNavigationEventCallback callback);
+void view_dispatcher_set_event_callback_context(ViewDispatcher* view_dispatcher, void* context);
+void view_dispatcher_run(ViewDispatcher* view_dispatcher);
+void view_dispatcher_stop(ViewDispatcher* view_dispatcher);
+void view_dispatcher_add_view(ViewDispatcher* view_dispatcher, uint32_t view_id, View* view);
+void view_dispatcher_remove_view(ViewDispatcher* view_dispatcher, uint32_t view_id);
+void view_dispatcher_switch_to_view(ViewDispatcher* view_dispatcher, uint32_t view_id);
+void view_dispatcher_attach_to_gui(
+    ViewDispatcher* view_dispatcher,
+    Gui* gui,
+    ViewDispatcherType type);
+
+/* Host only, the event loop is driven by the test */
+
+// Called by view_dispatcher_run in place of the loop, stops it on return
+typedef void (*FuriShimViewDispatcherScript)(ViewDispatcher* view_dispatcher, void* context);
+
+void furi_shim_view_dispatcher_set_script(FuriShimViewDispatcherScript script, void* context);
+
+// Input to the current view, Back it leaves goes to the navigation callback.
+// Custom events sent meanwhile, from any thread, are handled before it returns.
+void furi_shim_view_dispatcher_input(
+    ViewDispatcher* view_dispatcher,
+    InputKey key,
+    InputType type);
+
+// Handle the custom events sent so far
+void furi_shim_view_dispatcher_drain(ViewDispatcher* view_dispatcher);
+
+// View switched to last and the number of views added, to catch leaks
+View* furi_shim_view_dispatcher_get_current(ViewDispatcher* view_dispatcher);
+size_t furi_shim_view_dispatcher_get_views(ViewDispatcher* view_dispatcher);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,349 @@
+// Submenu, popup and widget with the behaviour the app relies on and a plain
+// text draw, not the firmware layout
+
+#include <gui/elements.h>
+#include <gui/modules/popup.h>
+#include <gui/modules/submenu.h>
+#include <gui/modules/widget.h>
+
+#define SUBMENU_ITEMS 32
+#define SUBMENU_LABEL 64
+#define SUBMENU_ROWS  4
+#define MODULE_TEXT   256
+
+/* Submenu */
+
+typedef struct {
+    char label[SUBMENU_LABEL];
+    uint32_t index;
+    SubmenuItemCallback callback;
+    void* callback_context;
+} SubmenuItem;
+
+struct Submenu {
+    View* view;
+    SubmenuItem items[SUBMENU_ITEMS];
+    size_t count;
+    size_t selected;
+    char header[SUBMENU_LABEL];
+    bool in_callback;
+};
+
+typedef struct {
+    Submenu* submenu;
+} SubmenuModel;
+
+static void submenu_draw_callback(Canvas* canvas, void* model) {
+    Submenu* submenu = ((SubmenuModel*)model)->submenu;
+    int32_t y = 10;
+    if(submenu->header[0]) {
+        canvas_draw_str(canvas, 0, y, submenu->header);
+        y += 12;
+    }
+    size_t first = submenu->selected < SUBMENU_ROWS ? 0 : submenu->selected - SUBMENU_ROWS + 1;
+    for(size_t i = first; i < submenu->count && i < first + SUBMENU_ROWS; i++, y += 12) {
+        if(i == submenu->selected) canvas_draw_str(canvas, 0, y, ">");
+        canvas_draw_str(canvas, 8, y, submenu->items[i].label);
+    }
+}
+
+static bool submenu_input_callback(InputEvent* event, void* context) {
+    Submenu* submenu = context;
+    if(event->type != InputTypeShort && event->type != InputTypeRepeat) return false;
+    if(!submenu->count) return false;
+
+    switch(event->key) {
+    case InputKeyUp:
+        submenu->selected = (submenu->selected + submenu->count - 1) % submenu->count;
+        break;
+    case InputKeyDown:
+        submenu->selected = (submenu->selected + 1) % submenu->count;
+        break;
+    case InputKeyOk: {
+        // Like the firmware, nothing of the submenu is touched after the callback
+        SubmenuItem item = submenu->items[submenu->selected];
+        if(item.callback) {
+            submenu->in_callback = true;
+            item.callback(item.callback_context, item.index);
+            // Only reached if the callback left the submenu alive
+            submenu->in_callback = false;
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+    view_commit_model(submenu->view, true);
+    return true;
+}
+
+Submenu* submenu_alloc(void) {
+    Submenu* submenu = malloc(sizeof(Submenu));
+    memset(submenu, 0, sizeof(Submenu));
+    submenu->view = view_alloc();
+    view_allocate_model(submenu->view, ViewModelTypeLockFree, sizeof(SubmenuModel));
+    ((SubmenuModel*)view_get_model(submenu->view))->submenu = submenu;
+    view_commit_model(submenu->view, false);
+    view_set_context(submenu->view, submenu);
+    view_set_draw_callback(submenu->view, submenu_draw_callback);
+    view_set_input_callback(submenu->view, submenu_input_callback);
+    return submenu;
+}
+
+void submenu_free(Submenu* submenu) {
+    furi_check(submenu);
+    // The caller would return into freed memory on the device
+    furi_check(!submenu->in_callback);
+    view_free(submenu->view);
+    free(submenu);
+}
+
+View* submenu_get_view(Submenu* submenu) {
+    furi_check(submenu);
+    return submenu->view;
+}
+
+void submenu_add_item(
+    Submenu* submenu,
+    const char* label,
+    uint32_t index,
+    SubmenuItemCallback callback,
+    void* callback_context) {
+    furi_check(submenu && label);
+    furi_check(submenu->count < SUBMENU_ITEMS);
+    SubmenuItem* item = &submenu->items[submenu->count++];
+    strlcpy(item->label, label, sizeof(item->label));
+    item->index = index;
+    item->callback = callback;
+    item->callback_context = callback_context;
+}
+
+static SubmenuItem* submenu_item(Submenu* submenu, uint32_t index) {
+    for(size_t i = 0; i < submenu->count; i++) {
+        if(submenu->items[i].index == index) return &submenu->items[i];
+    }
+    return NULL;
+}
+
+void submenu_change_item_label(Submenu* submenu, uint32_t index, const char* label) {
+    furi_check(submenu && label);
+    SubmenuItem* item = submenu_item(submenu, index);
+    if(item) strlcpy(item->label, label, sizeof(item->label));
+}
+
+void submenu_reset(Submenu* submenu) {
+    furi_check(submenu);
+    submenu->count = 0;
+    submenu->selected = 0;
+    submenu->header[0] = '\0';
+}
+
+void submenu_set_selected_item(Submenu* submenu, uint32_t index) {
+    furi_check(submenu);
+    for(size_t i = 0; i < submenu->count; i++) {
+        if(submenu->items[i].index == index) submenu->selected = i;
+    }
+}
+
+uint32_t submenu_get_selected_item(Submenu* submenu) {
+    furi_check(submenu);
+    return submenu->count ? submenu->items[submenu->selected].index : 0;
+}
+
+void submenu_set_header(Submenu* submenu, const char* header) {
+    furi_check(submenu);
+    strlcpy(submenu->header, header ? header : "", sizeof(submenu->header));
+}
+
+const char* furi_shim_submenu_get_label(Submenu* submenu, uint32_t index) {
+    furi_check(submenu);
+    SubmenuItem* item = submenu_item(submenu, index);
+    return item ? item->label : NULL;
+}
+
+uint32_t furi_shim_submenu_find(Submenu* submenu, const char* prefix) {
+    furi_check(submenu);
+    for(size_t i = 0; i < submenu->count; i++) {
+        if(strncmp(submenu->items[i].label, prefix, strlen(prefix)) == 0) {
+            return submenu->items[i].index;
+        }
+    }
+    return UINT32_MAX;
+}
+
+/* Popup */
+
+struct Popup {
+    View* view;
+    char header[MODULE_TEXT];
+    char text[MODULE_TEXT];
+    PopupCallback callback;
+    void* context;
+    uint32_t timeout_ms;
+};
+
+typedef struct {
+    Popup* popup;
+} PopupModel;
+
+static void popup_draw_callback(Canvas* canvas, void* model) {
+    Popup* popup = ((PopupModel*)model)->popup;
+    canvas_draw_str_aligned(canvas, 64, 10, AlignCenter, AlignTop, popup->header);
+    elements_multiline_text_aligned(canvas, 64, 32, AlignCenter, AlignCenter, popup->text);
+}
+
+Popup* popup_alloc(void) {
+    Popup* popup = malloc(sizeof(Popup));
+    memset(popup, 0, sizeof(Popup));
+    popup->view = view_alloc();
+    view_allocate_model(popup->view, ViewModelTypeLockFree, sizeof(PopupModel));
+    ((PopupModel*)view_get_model(popup->view))->popup = popup;
+    view_commit_model(popup->view, false);
+    view_set_draw_callback(popup->view, popup_draw_callback);
+    return popup;
+}
+
+void popup_free(Popup* popup) {
+    furi_check(popup);
+    view_free(popup->view);
+    free(popup);
+}
+
+View* popup_get_view(Popup* popup) {
+    furi_check(popup);
+    return popup->view;
+}
+
+void popup_set_callback(Popup* popup, PopupCallback callback) {
+    furi_check(popup);
+    popup->callback = callback;
+}
+
+void popup_set_context(Popup* popup, void* context) {
+    furi_check(popup);
+    popup->context = context;
+}
+
+void popup_set_header(
+    Popup* popup,
+    const char* text,
+    uint8_t x,
+    uint8_t y,
+    Align horizontal,
+    Align vertical) {
+    furi_check(popup);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(horizontal);
+    UNUSED(vertical);
+    strlcpy(popup->header, text ? text : "", sizeof(popup->header));
+}
+
+void popup_set_text(
+    Popup* popup,
+    const char* text,
+    uint8_t x,
+    uint8_t y,
+    Align horizontal,
+    Align vertical) {
+    furi_check(popup);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(horizontal);
+    UNUSED(vertical);
+    strlcpy(popup->text, text ? text : "", sizeof(popup->text));
+}
+
+void popup_set_timeout(Popup* popup, uint32_t timeout_in_ms) {
+    furi_check(popup);
+    popup->timeout_ms = timeout_in_ms;
+}
+
+void popup_enable_timeout(Popup* popup) {
+    furi_check(popup);
+}
+
+void popup_disable_timeout(Popup* popup) {
+    furi_check(popup);
+}
+
+void popup_reset(Popup* popup) {
+    furi_check(popup);
+    popup->header[0] = '\0';
+    popup->text[0] = '\0';
+    popup->callback = NULL;
+    popup->context = NULL;
+    popup->timeout_ms = 0;
+}
+
+const char* furi_shim_popup_get_text(Popup* popup) {
+    furi_check(popup);
+    return popup->text;
+}
+
+/* Widget */
+
+struct Widget {
+    View* view;
+    char text[MODULE_TEXT * 4];
+    bool has_text;
+};
+
+typedef struct {
+    Widget* widget;
+} WidgetModel;
+
+static void widget_draw_callback(Canvas* canvas, void* model) {
+    Widget* widget = ((WidgetModel*)model)->widget;
+    if(widget->has_text) {
+        elements_multiline_text_aligned(canvas, 0, 0, AlignLeft, AlignTop, widget->text);
+    }
+}
+
+Widget* widget_alloc(void) {
+    Widget* widget = malloc(sizeof(Widget));
+    memset(widget, 0, sizeof(Widget));
+    widget->view = view_alloc();
+    view_allocate_model(widget->view, ViewModelTypeLockFree, sizeof(WidgetModel));
+    ((WidgetModel*)view_get_model(widget->view))->widget = widget;
+    view_commit_model(widget->view, false);
+    view_set_draw_callback(widget->view, widget_draw_callback);
+    return widget;
+}
+
+void widget_free(Widget* widget) {
+    furi_check(widget);
+    view_free(widget->view);
+    free(widget);
+}
+
+void widget_reset(Widget* widget) {
+    furi_check(widget);
+    widget->has_text = false;
+}
+
+View* widget_get_view(Widget* widget) {
+    furi_check(widget);
+    return widget->view;
+}
+
+void widget_add_text_scroll_element(
+    Widget* widget,
+    uint8_t x,
+    uint8_t y,
+    uint8_t width,
+    uint8_t height,
+    const char* text) {
+    furi_check(widget && text);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(height);
+    strlcpy(widget->text, text, sizeof(widget->text));
+    widget->has_text = true;
+}
+
+const char* furi_shim_widget_get_text(Widget* widget) {
+    furi_check(widget);
+    return widget->has_text ? widget->text : NULL;
+}
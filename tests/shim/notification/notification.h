@@ -0,0 +1,25 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct NotificationApp NotificationApp;
+typedef struct NotificationSequence NotificationSequence;
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence);
+
+/* Host only */
+
+// The record tests create, see furi_record_create
+NotificationApp* furi_shim_notification_alloc(void);
+void furi_shim_notification_free(NotificationApp* app);
+
+// Last sequence played, NULL if none
+const NotificationSequence* furi_shim_notification_get_last(NotificationApp* app);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <notification/notification.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const NotificationSequence sequence_success;
+extern const NotificationSequence sequence_error;
+
+#ifdef __cplusplus
+}
+#endif
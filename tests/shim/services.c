@@ -0,0 +1,116 @@
+// Notification, dialogs and the hardware the app touches outside USB
+
+#include <dialogs/dialogs.h>
+#include <furi_hal_power.h>
+#include <furi_hal_serial.h>
+#include <notification/notification_messages.h>
+
+/* Notification */
+
+struct NotificationSequence {
+    const char* name;
+};
+
+struct NotificationApp {
+    const NotificationSequence* last;
+};
+
+const NotificationSequence sequence_success = {.name = "success"};
+const NotificationSequence sequence_error = {.name = "error"};
+
+NotificationApp* furi_shim_notification_alloc(void) {
+    NotificationApp* app = malloc(sizeof(NotificationApp));
+    app->last = NULL;
+    return app;
+}
+
+void furi_shim_notification_free(NotificationApp* app) {
+    furi_check(app);
+    free(app);
+}
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    furi_check(app && sequence);
+    app->last = sequence;
+}
+
+const NotificationSequence* furi_shim_notification_get_last(NotificationApp* app) {
+    furi_check(app);
+    return app->last;
+}
+
+/* Dialogs */
+
+void dialog_file_browser_set_basic_options(
+    DialogsFileBrowserOptions* options,
+    const char* extension,
+    const Icon* icon) {
+    furi_check(options);
+    memset(options, 0, sizeof(DialogsFileBrowserOptions));
+    options->extension = extension;
+    options->icon = icon;
+    options->skip_assets = true;
+    options->hide_dot_files = true;
+}
+
+bool dialog_file_browser_show(
+    DialogsApp* context,
+    FuriString* result_path,
+    FuriString* path,
+    const DialogsFileBrowserOptions* options) {
+    UNUSED(context);
+    UNUSED(result_path);
+    UNUSED(path);
+    UNUSED(options);
+    return false;
+}
+
+/* Power */
+
+uint8_t furi_hal_power_get_pct(void) {
+    return 100;
+}
+
+bool furi_hal_power_is_charging(void) {
+    return false;
+}
+
+/* Serial */
+
+FuriHalSerialHandle* furi_hal_serial_control_acquire(FuriHalSerialId serial_id) {
+    UNUSED(serial_id);
+    return NULL;
+}
+
+void furi_hal_serial_control_release(FuriHalSerialHandle* handle) {
+    furi_check(handle);
+}
+
+void furi_hal_serial_init(FuriHalSerialHandle* handle, uint32_t baud) {
+    furi_check(handle);
+    UNUSED(baud);
+}
+
+void furi_hal_serial_deinit(FuriHalSerialHandle* handle) {
+    furi_check(handle);
+}
+
+void furi_hal_serial_async_rx_start(
+    FuriHalSerialHandle* handle,
+    FuriHalSerialAsyncRxCallback callback,
+    void* context,
+    bool report_errors) {
+    furi_check(handle);
+    UNUSED(callback);
+    UNUSED(context);
+    UNUSED(report_errors);
+}
+
+void furi_hal_serial_async_rx_stop(FuriHalSerialHandle* handle) {
+    furi_check(handle);
+}
+
+uint8_t furi_hal_serial_async_rx(FuriHalSerialHandle* handle) {
+    furi_check(handle);
+    return 0;
+}
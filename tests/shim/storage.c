@@ -0,0 +1,235 @@
+#define _GNU_SOURCE
+#include "storage/storage.h"
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct Storage {
+    int unused;
+};
+
+struct File {
+    FILE* stream;
+    DIR* dir;
+    char path[512];
+};
+
+static Storage storage_instance;
+static char storage_root[256];
+
+void* furi_shim_record_default(const char* name) {
+    return strcmp(name, RECORD_STORAGE) == 0 ? &storage_instance : NULL;
+}
+
+void furi_shim_storage_set_root(const char* root) {
+    strlcpy(storage_root, root, sizeof(storage_root));
+}
+
+const char* furi_shim_storage_get_root(void) {
+    if(!storage_root[0]) {
+        snprintf(storage_root, sizeof(storage_root), "/tmp/furi-shim-%d", (int)getpid());
+    }
+    return storage_root;
+}
+
+static bool storage_mkdirs(const char* host_path);
+
+// The app data directory always exists on the device
+static void storage_host_path(char* out, size_t size, const char* path) {
+    char data[512];
+    snprintf(data, sizeof(data), "%s" STORAGE_APP_DATA_PATH_PREFIX, furi_shim_storage_get_root());
+    storage_mkdirs(data);
+    snprintf(out, size, "%s%s%s", furi_shim_storage_get_root(), path[0] == '/' ? "" : "/", path);
+}
+
+static bool storage_mkdirs(const char* host_path) {
+    char path[512];
+    strlcpy(path, host_path, sizeof(path));
+    for(char* p = path + 1; *p; p++) {
+        if(*p != '/') continue;
+        *p = '\0';
+        if(mkdir(path, 0755) && errno != EEXIST) return false;
+        *p = '/';
+    }
+    return !mkdir(path, 0755) || errno == EEXIST;
+}
+
+File* storage_file_alloc(Storage* storage) {
+    furi_check(storage);
+    File* file = malloc(sizeof(File));
+    memset(file, 0, sizeof(File));
+    return file;
+}
+
+void storage_file_free(File* file) {
+    storage_file_close(file);
+    storage_dir_close(file);
+    free(file);
+}
+
+bool storage_file_open(
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    storage_file_close(file);
+    storage_host_path(file->path, sizeof(file->path), path);
+
+    struct stat info;
+    bool exists = stat(file->path, &info) == 0 && S_ISREG(info.st_mode);
+    if(open_mode == FSOM_OPEN_EXISTING && !exists) return false;
+    if(open_mode == FSOM_CREATE_NEW && exists) return false;
+
+    const char* mode;
+    if(open_mode == FSOM_CREATE_ALWAYS || open_mode == FSOM_CREATE_NEW) {
+        mode = access_mode & FSAM_READ ? "w+b" : "wb";
+    } else if(open_mode == FSOM_OPEN_APPEND) {
+        mode = access_mode & FSAM_READ ? "a+b" : "ab";
+    } else if(!exists) {
+        mode = access_mode & FSAM_READ ? "w+b" : "wb";
+    } else {
+        mode = access_mode & FSAM_WRITE ? "r+b" : "rb";
+    }
+    file->stream = fopen(file->path, mode);
+    return file->stream != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if(!file->stream) return false;
+    fclose(file->stream);
+    file->stream = NULL;
+    return true;
+}
+
+bool storage_file_is_open(File* file) {
+    return file->stream != NULL;
+}
+
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read) {
+    if(!file->stream) return 0;
+    return fread(buff, 1, bytes_to_read, file->stream);
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    if(!file->stream) return 0;
+    return fwrite(buff, 1, bytes_to_write, file->stream);
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    if(!file->stream) return false;
+    return fseek(file->stream, offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
+
+uint64_t storage_file_tell(File* file) {
+    if(!file->stream) return 0;
+    return ftell(file->stream);
+}
+
+uint64_t storage_file_size(File* file) {
+    if(!file->stream) return 0;
+    long position = ftell(file->stream);
+    fseek(file->stream, 0, SEEK_END);
+    long size = ftell(file->stream);
+    fseek(file->stream, position, SEEK_SET);
+    return size;
+}
+
+bool storage_file_eof(File* file) {
+    if(!file->stream) return true;
+    return storage_file_tell(file) >= storage_file_size(file);
+}
+
+bool storage_file_exists(Storage* storage, const char* path) {
+    FileInfo info;
+    return storage_common_stat(storage, path, &info) == FSE_OK && !file_info_is_dir(&info);
+}
+
+bool storage_dir_open(File* file, const char* path) {
+    storage_dir_close(file);
+    storage_host_path(file->path, sizeof(file->path), path);
+    file->dir = opendir(file->path);
+    return file->dir != NULL;
+}
+
+bool storage_dir_close(File* file) {
+    if(!file->dir) return false;
+    closedir(file->dir);
+    file->dir = NULL;
+    return true;
+}
+
+bool storage_dir_read(File* file, FileInfo* fileinfo, char* name, uint16_t name_length) {
+    if(!file->dir) return false;
+
+    struct dirent* entry;
+    while((entry = readdir(file->dir))) {
+        if(strcmp(entry->d_name, ".") && strcmp(entry->d_name, "..")) break;
+    }
+    if(!entry) return false;
+
+    if(name) strlcpy(name, entry->d_name, name_length);
+    if(fileinfo) {
+        char path[768];
+        struct stat info;
+        snprintf(path, sizeof(path), "%s/%s", file->path, entry->d_name);
+        memset(fileinfo, 0, sizeof(FileInfo));
+        if(stat(path, &info) == 0) {
+            fileinfo->flags = S_ISDIR(info.st_mode) ? FSF_DIRECTORY : 0;
+            fileinfo->size = info.st_size;
+        }
+    }
+    return true;
+}
+
+FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* fileinfo) {
+    UNUSED(storage);
+    char host_path[512];
+    struct stat info;
+    storage_host_path(host_path, sizeof(host_path), path);
+    if(stat(host_path, &info)) return FSE_NOT_EXIST;
+    if(fileinfo) {
+        fileinfo->flags = S_ISDIR(info.st_mode) ? FSF_DIRECTORY : 0;
+        fileinfo->size = info.st_size;
+    }
+    return FSE_OK;
+}
+
+FS_Error storage_common_timestamp(Storage* storage, const char* path, uint32_t* timestamp) {
+    UNUSED(storage);
+    char host_path[512];
+    struct stat info;
+    storage_host_path(host_path, sizeof(host_path), path);
+    if(stat(host_path, &info)) return FSE_NOT_EXIST;
+    // FAT keeps two-second resolution, the host's is finer
+    *timestamp = (uint32_t)info.st_mtim.tv_sec ^ (uint32_t)info.st_mtim.tv_nsec;
+    return FSE_OK;
+}
+
+FS_Error storage_common_remove(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host_path[512];
+    storage_host_path(host_path, sizeof(host_path), path);
+    if(remove(host_path)) return errno == ENOENT ? FSE_NOT_EXIST : FSE_DENIED;
+    return FSE_OK;
+}
+
+FS_Error storage_common_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host_path[512];
+    storage_host_path(host_path, sizeof(host_path), path);
+    if(mkdir(host_path, 0755)) return errno == EEXIST ? FSE_EXIST : FSE_NOT_EXIST;
+    return FSE_OK;
+}
+
+bool storage_simply_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host_path[512];
+    storage_host_path(host_path, sizeof(host_path), path);
+    return storage_mkdirs(host_path);
+}
+
+bool storage_simply_remove(Storage* storage, const char* path) {
+    FS_Error error = storage_common_remove(storage, path);
+    return error == FSE_OK || error == FSE_NOT_EXIST;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// libusb_stm32 device core, the calls are recorded by tests/fake_usbd.c
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "usb_std.h"
+
+#define USB_REQ_DIRECTION (1 << 7)
+#define USB_REQ_HOSTTODEV (0 << 7)
+#define USB_REQ_DEVTOHOST (1 << 7)
+#define USB_REQ_TYPE      (3 << 5)
+#define USB_REQ_STANDARD  (0 << 5)
+#define USB_REQ_CLASS     (1 << 5)
+#define USB_REQ_RECIPIENT (3 << 0)
+#define USB_REQ_DEVICE    (0 << 0)
+#define USB_REQ_INTERFACE (1 << 0)
+
+#define USB_STD_GET_DESCRIPTOR 0x06
+
+enum {
+    usbd_evt_reset,
+    usbd_evt_sof,
+    usbd_evt_susp,
+    usbd_evt_wkup,
+    usbd_evt_eptx,
+    usbd_evt_eprx,
+    usbd_evt_epsetup,
+    usbd_evt_error,
+    usbd_evt_count,
+};
+
+typedef enum {
+    usbd_fail,
+    usbd_ack,
+    usbd_nak,
+} usbd_respond;
+
+typedef struct usbd_device usbd_device;
+
+typedef struct {
+    uint8_t bmRequestType;
+    uint8_t bRequest;
+    uint16_t wValue;
+    uint16_t wIndex;
+    uint16_t wLength;
+    uint8_t data[];
+} usbd_ctlreq;
+
+typedef struct {
+    void* data_buf;
+    void* data_ptr;
+    uint16_t data_count;
+    uint16_t data_maxsize;
+    uint8_t ep0size;
+    uint8_t device_cfg;
+    uint8_t device_state;
+    uint8_t control_state;
+} usbd_status;
+
+typedef void (*usbd_evt_callback)(usbd_device* dev, uint8_t event, uint8_t ep);
+typedef void (*usbd_rqc_callback)(usbd_device* dev, usbd_ctlreq* req);
+typedef usbd_respond (
+    *usbd_ctl_callback)(usbd_device* dev, usbd_ctlreq* req, usbd_rqc_callback* callback);
+typedef usbd_respond (*usbd_cfg_callback)(usbd_device* dev, uint8_t cfg);
+
+struct usbd_device {
+    usbd_ctl_callback control_callback;
+    usbd_cfg_callback config_callback;
+    usbd_evt_callback endpoint[8];
+    usbd_status status;
+};
+
+void usbd_reg_control(usbd_device* dev, usbd_ctl_callback callback);
+void usbd_reg_config(usbd_device* dev, usbd_cfg_callback callback);
+void usbd_reg_endpoint(usbd_device* dev, uint8_t ep, usbd_evt_callback callback);
+bool usbd_ep_config(usbd_device* dev, uint8_t ep, uint8_t eptype, uint16_t epsize);
+void usbd_ep_deconfig(usbd_device* dev, uint8_t ep);
+int32_t usbd_ep_write(usbd_device* dev, uint8_t ep, const void* buf, uint16_t blen);
+int32_t usbd_ep_read(usbd_device* dev, uint8_t ep, void* buf, uint16_t blen);
+void usbd_connect(usbd_device* dev, bool connect);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "usb_std.h"
+
+#define USB_CLASS_CDC        0x02
+#define USB_CLASS_CDC_DATA   0x0A
+#define USB_CDC_SUBCLASS_ACM 0x02
+#define USB_CDC_PROTO_NONE   0x00
+#define USB_CDC_PROTO_V25TER 0x01
+
+#define USB_DTYPE_CDC_HEADER          0x00
+#define USB_DTYPE_CDC_CALL_MANAGEMENT 0x01
+#define USB_DTYPE_CDC_ACM             0x02
+#define USB_DTYPE_CDC_UNION           0x06
+
+#define USB_CDC_SET_LINE_CODING        0x20
+#define USB_CDC_GET_LINE_CODING        0x21
+#define USB_CDC_SET_CONTROL_LINE_STATE 0x22
+
+#define USB_CDC_CAP_LINE 0x02
+
+struct usb_cdc_header_desc {
+    uint8_t bFunctionLength;
+    uint8_t bDescriptorType;
+    uint8_t bDescriptorSubType;
+    uint16_t bcdCDC;
+} __attribute__((packed));
+
+struct usb_cdc_union_desc {
+    uint8_t bFunctionLength;
+    uint8_t bDescriptorType;
+    uint8_t bDescriptorSubType;
+    uint8_t bMasterInterface0;
+    uint8_t bSlaveInterface0;
+} __attribute__((packed));
+
+struct usb_cdc_call_mgmt_desc {
+    uint8_t bFunctionLength;
+    uint8_t bDescriptorType;
+    uint8_t bDescriptorSubType;
+    uint8_t bmCapabilities;
+    uint8_t bDataInterface;
+} __attribute__((packed));
+
+struct usb_cdc_acm_desc {
+    uint8_t bFunctionLength;
+    uint8_t bDescriptorType;
+    uint8_t bDescriptorSubType;
+    uint8_t bmCapabilities;
+} __attribute__((packed));
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "usb_std.h"
+
+#define USB_CLASS_HID            0x03
+#define USB_HID_SUBCLASS_NONBOOT 0x00
+#define USB_HID_SUBCLASS_BOOT    0x01
+#define USB_HID_PROTO_NONBOOT    0x00
+#define USB_HID_PROTO_KEYBOARD   0x01
+
+#define USB_HID_GETREPORT   0x01
+#define USB_HID_SETREPORT   0x09
+#define USB_HID_SETIDLE     0x0A
+#define USB_HID_SETPROTOCOL 0x0B
+
+#define USB_DTYPE_HID        0x21
+#define USB_DTYPE_HID_REPORT 0x22
+
+struct usb_hid_descriptor {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint16_t bcdHID;
+    uint8_t bCountryCode;
+    uint8_t bNumDescriptors;
+    uint8_t bDescriptorType0;
+    uint16_t wDescriptorLength0;
+} __attribute__((packed));
@@ -0,0 +1,110 @@
+#pragma once
+
+// Descriptor layouts and constants from libusb_stm32, the subset the app uses
+
+#include <stdint.h>
+
+#define USB_DTYPE_DEVICE         0x01
+#define USB_DTYPE_CONFIGURATION  0x02
+#define USB_DTYPE_STRING         0x03
+#define USB_DTYPE_INTERFACE      0x04
+#define USB_DTYPE_ENDPOINT       0x05
+#define USB_DTYPE_INTERFASEASSOC 0x0B
+#define USB_DTYPE_CS_INTERFACE   0x24
+
+#define USB_CLASS_PER_INTERFACE 0x00
+#define USB_SUBCLASS_NONE       0x00
+#define USB_PROTO_NONE          0x00
+#define USB_CLASS_IAD           0xEF
+#define USB_SUBCLASS_IAD        0x02
+#define USB_PROTO_IAD           0x01
+
+#define USB_CFG_ATTR_RESERVED    0x80
+#define USB_CFG_ATTR_SELFPOWERED 0x40
+#define USB_CFG_POWER_MA(mA)     ((mA) >> 1)
+
+#define USB_EPDIR_IN         0x80
+#define USB_EPDIR_OUT        0x00
+#define USB_EPTYPE_CONTROL   0x00
+#define USB_EPTYPE_BULK      0x02
+#define USB_EPTYPE_INTERRUPT 0x03
+#define USB_EPTYPE_DBLBUF    0x04
+
+#define NO_DESCRIPTOR 0x00
+
+#define VERSION_BCD(maj, min, rev) (((maj & 0xFF) << 8) | ((min & 0x0F) << 4) | (rev & 0x0F))
+#define USB_STRING_DESC(s)                                                                   \
+    {                                                                                        \
+        .bLength = sizeof(u"" s), .bDescriptorType = USB_DTYPE_STRING, .wString = {u"" s} \
+    }
+
+struct usb_header_descriptor {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+} __attribute__((packed));
+
+struct usb_device_descriptor {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint16_t bcdUSB;
+    uint8_t bDeviceClass;
+    uint8_t bDeviceSubClass;
+    uint8_t bDeviceProtocol;
+    uint8_t bMaxPacketSize0;
+    uint16_t idVendor;
+    uint16_t idProduct;
+    uint16_t bcdDevice;
+    uint8_t iManufacturer;
+    uint8_t iProduct;
+    uint8_t iSerialNumber;
+    uint8_t bNumConfigurations;
+} __attribute__((packed));
+
+struct usb_config_descriptor {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint16_t wTotalLength;
+    uint8_t bNumInterfaces;
+    uint8_t bConfigurationValue;
+    uint8_t iConfiguration;
+    uint8_t bmAttributes;
+    uint8_t bMaxPower;
+} __attribute__((packed));
+
+struct usb_interface_descriptor {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint8_t bInterfaceNumber;
+    uint8_t bAlternateSetting;
+    uint8_t bNumEndpoints;
+    uint8_t bInterfaceClass;
+    uint8_t bInterfaceSubClass;
+    uint8_t bInterfaceProtocol;
+    uint8_t iInterface;
+} __attribute__((packed));
+
+struct usb_iad_descriptor {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint8_t bFirstInterface;
+    uint8_t bInterfaceCount;
+    uint8_t bFunctionClass;
+    uint8_t bFunctionSubClass;
+    uint8_t bFunctionProtocol;
+    uint8_t iFunction;
+} __attribute__((packed));
+
+struct usb_endpoint_descriptor {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint8_t bEndpointAddress;
+    uint8_t bmAttributes;
+    uint16_t wMaxPacketSize;
+    uint8_t bInterval;
+} __attribute__((packed));
+
+struct usb_string_descriptor {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint16_t wString[];
+} __attribute__((packed));
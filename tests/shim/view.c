@@ -0,0 +1,96 @@
+#include <gui/view.h>
+#include <time.h>
+
+struct View {
+    ViewDrawCallback draw_callback;
+    ViewInputCallback input_callback;
+    void* context;
+    ViewModelType model_type;
+    void* model;
+    FuriMutex* model_mutex; // Locking models only
+    uint32_t updates;
+    uint64_t draw_ns; // Last draw callback, model lock excluded
+};
+
+View* view_alloc(void) {
+    View* view = malloc(sizeof(View));
+    memset(view, 0, sizeof(View));
+    return view;
+}
+
+void view_free(View* view) {
+    furi_check(view);
+    if(view->model_mutex) furi_mutex_free(view->model_mutex);
+    free(view->model);
+    free(view);
+}
+
+void view_set_draw_callback(View* view, ViewDrawCallback callback) {
+    furi_check(view);
+    view->draw_callback = callback;
+}
+
+void view_set_input_callback(View* view, ViewInputCallback callback) {
+    furi_check(view);
+    view->input_callback = callback;
+}
+
+void view_set_context(View* view, void* context) {
+    furi_check(view);
+    view->context = context;
+}
+
+void view_allocate_model(View* view, ViewModelType type, size_t size) {
+    furi_check(view);
+    furi_check(view->model_type == ViewModelTypeNone && type != ViewModelTypeNone);
+    view->model_type = type;
+    view->model = malloc(size);
+    memset(view->model, 0, size);
+    if(type == ViewModelTypeLocking) {
+        view->model_mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
+    }
+}
+
+void* view_get_model(View* view) {
+    furi_check(view);
+    if(view->model_mutex) {
+        furi_check(furi_mutex_acquire(view->model_mutex, FuriWaitForever) == FuriStatusOk);
+    }
+    return view->model;
+}
+
+void view_commit_model(View* view, bool update) {
+    furi_check(view);
+    if(view->model_mutex) {
+        furi_check(furi_mutex_release(view->model_mutex) == FuriStatusOk);
+    }
+    if(update) view->updates++;
+}
+
+void furi_shim_view_draw(View* view, Canvas* canvas) {
+    furi_check(view);
+    if(!view->draw_callback) return;
+    void* model = view_get_model(view);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    view->draw_callback(canvas, model);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    view_commit_model(view, false);
+    view->draw_ns = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ULL +
+                    (uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+}
+
+bool furi_shim_view_input(View* view, InputEvent* event) {
+    furi_check(view);
+    return view->input_callback ? view->input_callback(event, view->context) : false;
+}
+
+uint32_t furi_shim_view_get_updates(View* view) {
+    furi_check(view);
+    return view->updates;
+}
+
+uint64_t furi_shim_view_get_draw_ns(View* view) {
+    furi_check(view);
+    return view->draw_ns;
+}
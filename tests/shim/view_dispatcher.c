@@ -0,0 +1,167 @@
+#include <gui/view_dispatcher.h>
+#include <pthread.h>
+
+#define VIEW_DISPATCHER_VIEWS  32
+#define VIEW_DISPATCHER_EVENTS 64
+
+struct ViewDispatcher {
+    View* views[VIEW_DISPATCHER_VIEWS]; // By id
+    View* current;
+    Gui* gui;
+    void* context;
+    ViewDispatcherCustomEventCallback custom_callback;
+    ViewDispatcherNavigationEventCallback navigation_callback;
+    bool running;
+
+    // Custom events from any thread, handled on the script thread
+    pthread_mutex_t lock;
+    uint32_t events[VIEW_DISPATCHER_EVENTS];
+    size_t events_head;
+    size_t events_count;
+};
+
+static FuriShimViewDispatcherScript dispatcher_script;
+static void* dispatcher_script_context;
+
+ViewDispatcher* view_dispatcher_alloc(void) {
+    ViewDispatcher* view_dispatcher = malloc(sizeof(ViewDispatcher));
+    memset(view_dispatcher, 0, sizeof(ViewDispatcher));
+    pthread_mutex_init(&view_dispatcher->lock, NULL);
+    return view_dispatcher;
+}
+
+void view_dispatcher_free(ViewDispatcher* view_dispatcher) {
+    furi_check(view_dispatcher);
+    // The device checks every view was removed first, so does the host
+    furi_check(furi_shim_view_dispatcher_get_views(view_dispatcher) == 0);
+    pthread_mutex_destroy(&view_dispatcher->lock);
+    free(view_dispatcher);
+}
+
+void view_dispatcher_send_custom_event(ViewDispatcher* view_dispatcher, uint32_t event) {
+    furi_check(view_dispatcher);
+    pthread_mutex_lock(&view_dispatcher->lock);
+    furi_check(view_dispatcher->events_count < VIEW_DISPATCHER_EVENTS);
+    size_t tail =
+        (view_dispatcher->events_head + view_dispatcher->events_count) % VIEW_DISPATCHER_EVENTS;
+    view_dispatcher->events[tail] = event;
+    view_dispatcher->events_count++;
+    pthread_mutex_unlock(&view_dispatcher->lock);
+}
+
+void view_dispatcher_set_custom_event_callback(
+    ViewDispatcher* view_dispatcher,
+    ViewDispatcherCustomEventCallback callback) {
+    furi_check(view_dispatcher);
+    view_dispatcher->custom_callback = callback;
+}
+
+void view_dispatcher_set_navigation_event_callback(
+    ViewDispatcher* view_dispatcher,
+    ViewDispatcherNavigationEventCallback callback) {
+    furi_check(view_dispatcher);
+    view_dispatcher->navigation_callback = callback;
+}
+
+void view_dispatcher_set_event_callback_context(ViewDispatcher* view_dispatcher, void* context) {
+    furi_check(view_dispatcher);
+    view_dispatcher->context = context;
+}
+
+void view_dispatcher_run(ViewDispatcher* view_dispatcher) {
+    furi_check(view_dispatcher);
+    view_dispatcher->running = true;
+    furi_shim_view_dispatcher_drain(view_dispatcher);
+    if(dispatcher_script) dispatcher_script(view_dispatcher, dispatcher_script_context);
+    furi_shim_view_dispatcher_drain(view_dispatcher);
+    view_dispatcher->running = false;
+}
+
+void view_dispatcher_stop(ViewDispatcher* view_dispatcher) {
+    furi_check(view_dispatcher);
+    view_dispatcher->running = false;
+}
+
+void view_dispatcher_add_view(ViewDispatcher* view_dispatcher, uint32_t view_id, View* view) {
+    furi_check(view_dispatcher && view);
+    furi_check(view_id < VIEW_DISPATCHER_VIEWS && !view_dispatcher->views[view_id]);
+    view_dispatcher->views[view_id] = view;
+}
+
+void view_dispatcher_remove_view(ViewDispatcher* view_dispatcher, uint32_t view_id) {
+    furi_check(view_dispatcher);
+    furi_check(view_id < VIEW_DISPATCHER_VIEWS && view_dispatcher->views[view_id]);
+    if(view_dispatcher->current == view_dispatcher->views[view_id]) {
+        view_dispatcher->current = NULL;
+    }
+    view_dispatcher->views[view_id] = NULL;
+}
+
+void view_dispatcher_switch_to_view(ViewDispatcher* view_dispatcher, uint32_t view_id) {
+    furi_check(view_dispatcher);
+    furi_check(view_id < VIEW_DISPATCHER_VIEWS && view_dispatcher->views[view_id]);
+    view_dispatcher->current = view_dispatcher->views[view_id];
+}
+
+void view_dispatcher_attach_to_gui(
+    ViewDispatcher* view_dispatcher,
+    Gui* gui,
+    ViewDispatcherType type) {
+    furi_check(view_dispatcher && gui);
+    UNUSED(type);
+    view_dispatcher->gui = gui;
+}
+
+void furi_shim_view_dispatcher_set_script(FuriShimViewDispatcherScript script, void* context) {
+    dispatcher_script = script;
+    dispatcher_script_context = context;
+}
+
+void furi_shim_view_dispatcher_input(
+    ViewDispatcher* view_dispatcher,
+    InputKey key,
+    InputType type) {
+    furi_check(view_dispatcher && view_dispatcher->running);
+    InputEvent event = {.key = key, .type = type};
+    bool consumed =
+        view_dispatcher->current && furi_shim_view_input(view_dispatcher->current, &event);
+    if(!consumed && key == InputKeyBack && type == InputTypeShort) {
+        bool handled = view_dispatcher->navigation_callback &&
+                       view_dispatcher->navigation_callback(view_dispatcher->context);
+        if(!handled) view_dispatcher_stop(view_dispatcher);
+    }
+    furi_shim_view_dispatcher_drain(view_dispatcher);
+}
+
+void furi_shim_view_dispatcher_drain(ViewDispatcher* view_dispatcher) {
+    furi_check(view_dispatcher);
+    while(true) {
+        pthread_mutex_lock(&view_dispatcher->lock);
+        if(!view_dispatcher->events_count) {
+            pthread_mutex_unlock(&view_dispatcher->lock);
+            return;
+        }
+        uint32_t event = view_dispatcher->events[view_dispatcher->events_head];
+        view_dispatcher->events_head = (view_dispatcher->events_head + 1) % VIEW_DISPATCHER_EVENTS;
+        view_dispatcher->events_count--;
+        pthread_mutex_unlock(&view_dispatcher->lock);
+
+        if(view_dispatcher->custom_callback) {
+            view_dispatcher->custom_callback(view_dispatcher->context, event);
+        }
+    }
+}
+
+View* furi_shim_view_dispatcher_get_current(ViewDispatcher* view_dispatcher) {
+    furi_check(view_dispatcher);
+    return view_dispatcher->current;
+}
+
+size_t furi_shim_view_dispatcher_get_views(ViewDispatcher* view_dispatcher) {
+    furi_check(view_dispatcher);
+    size_t views = 0;
+    for(size_t i = 0; i < VIEW_DISPATCHER_VIEWS; i++) {
+        if(view_dispatcher->views[i]) views++;
+    }
+    return views;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+// Minimal host test runner: a file defines test cases, main runs them and
+// returns the failure count for ctest.
+
+#include <furi.h>
+#include <storage/storage.h>
+#include <stdio.h>
+#include <unistd.h>
+
+static int test_failures;
+static int test_checks;
+static const char* test_current;
+
+#define TEST_CHECK(cond)                                                                   \
+    do {                                                                                   \
+        test_checks++;                                                                     \
+        if(!(cond)) {                                                                      \
+            test_failures++;                                                               \
+            fprintf(stderr, "%s:%d: %s: check failed: %s\n", __FILE__, __LINE__,           \
+                    test_current, #cond);                                                  \
+        }                                                                                  \
+    } while(0)
+
+#define TEST_CHECK_EQ(actual, expected)                                                    \
+    do {                                                                                   \
+        long long test_a = (long long)(actual);                                            \
+        long long test_e = (long long)(expected);                                          \
+        test_checks++;                                                                     \
+        if(test_a != test_e) {                                                             \
+            test_failures++;                                                               \
+            fprintf(stderr, "%s:%d: %s: %s is %lld, expected %lld\n", __FILE__, __LINE__,  \
+                    test_current, #actual, test_a, test_e);                                \
+        }                                                                                  \
+    } while(0)
+
+#define TEST_CHECK_STR(actual, expected)                                                   \
+    do {                                                                                   \
+        const char* test_a = (actual);                                                     \
+        const char* test_e = (expected);                                                   \
+        test_checks++;                                                                     \
+        if(strcmp(test_a, test_e) != 0) {                                                  \
+            test_failures++;                                                               \
+            fprintf(stderr, "%s:%d: %s: %s is \"%s\", expected \"%s\"\n", __FILE__,        \
+                    __LINE__, test_current, #actual, test_a, test_e);                      \
+        }                                                                                  \
+    } while(0)
+
+#define TEST_CHECK_MEM(actual, expected, size)                                             \
+    do {                                                                                   \
+        test_checks++;                                                                     \
+        if(memcmp((actual), (expected), (size)) != 0) {                                    \
+            test_failures++;                                                               \
+            fprintf(stderr, "%s:%d: %s: %s differs from %s\n", __FILE__, __LINE__,         \
+                    test_current, #actual, #expected);                                     \
+        }                                                                                  \
+    } while(0)
+
+#define TEST_RUN(test)          \
+    do {                        \
+        test_current = #test;   \
+        test();                 \
+    } while(0)
+
+static inline int test_report(void) {
+    printf("%d checks, %d failed\n", test_checks, test_failures);
+    return test_failures ? 1 : 0;
+}
+
+// Fresh, empty SD card for the calling test
+static inline void test_storage_reset(void) {
+    char root[] = "/tmp/bunnyconnect-test-XXXXXX";
+    furi_check(mkdtemp(root));
+    furi_shim_storage_set_root(root);
+}
+
+// Write a whole file on the SD card stand-in
+static inline void test_storage_write(const char* path, const void* data, size_t size) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    furi_check(storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    furi_check(storage_file_write(file, data, size) == size);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Read a whole file from the SD card stand-in, NUL terminated, NULL if missing
+static inline char* test_storage_read(const char* path, size_t* size) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    char* data = NULL;
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        size_t file_size = storage_file_size(file);
+        data = malloc(file_size + 1);
+        furi_check(storage_file_read(file, data, file_size) == file_size);
+        data[file_size] = '\0';
+        if(size) *size = file_size;
+    }
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return data;
+}
@@ -0,0 +1,103 @@
+#include "test.h"
+#include "../bunnyconnect_i.h"
+
+static void app_run(FuriShimViewDispatcherScript script) {
+    test_storage_reset();
+    BunnyConnectApp* app = bunnyconnect_app_alloc();
+    TEST_CHECK(app);
+    if(!app) return;
+    furi_shim_view_dispatcher_set_script(script, app);
+    TEST_CHECK_EQ(bunnyconnect_app_run(app), 0);
+    bunnyconnect_app_free(app);
+}
+
+static void input(ViewDispatcher* view_dispatcher, InputKey key) {
+    furi_shim_view_dispatcher_input(view_dispatcher, key, InputTypeShort);
+}
+
+// Select the item the way a user finds it, by its label, and press OK
+static void menu_pick(ViewDispatcher* view_dispatcher, Submenu* menu, const char* label) {
+    uint32_t index = furi_shim_submenu_find(menu, label);
+    TEST_CHECK(index != UINT32_MAX);
+    submenu_set_selected_item(menu, index);
+    input(view_dispatcher, InputKeyOk);
+}
+
+static void script_config_label(ViewDispatcher* view_dispatcher, void* context) {
+    BunnyConnectApp* app = context;
+    menu_pick(view_dispatcher, app->main_menu, "Config");
+    TEST_CHECK(app->config_menu);
+    if(!app->config_menu) return;
+    TEST_CHECK(
+        furi_shim_view_dispatcher_get_current(view_dispatcher) ==
+        submenu_get_view(app->config_menu));
+
+    // A toggle that stays in Config relabels its item
+    menu_pick(view_dispatcher, app->config_menu, "Trace: OFF");
+    TEST_CHECK(app->config_menu);
+    if(!app->config_menu) return;
+    TEST_CHECK(furi_shim_submenu_find(app->config_menu, "Trace: ON") != UINT32_MAX);
+    menu_pick(view_dispatcher, app->config_menu, "Trace: ON");
+    TEST_CHECK(furi_shim_submenu_find(app->config_menu, "Trace: OFF") != UINT32_MAX);
+
+    // Back to the main menu releases Config, Back again exits
+    input(view_dispatcher, InputKeyBack);
+    TEST_CHECK(!app->config_menu);
+    TEST_CHECK(
+        furi_shim_view_dispatcher_get_current(view_dispatcher) ==
+        submenu_get_view(app->main_menu));
+    input(view_dispatcher, InputKeyBack);
+}
+
+static void test_config_label(void) {
+    app_run(script_config_label);
+}
+
+static void script_record_disconnected(ViewDispatcher* view_dispatcher, void* context) {
+    BunnyConnectApp* app = context;
+    menu_pick(view_dispatcher, app->main_menu, "Config");
+    TEST_CHECK(app->config_menu);
+    if(!app->config_menu) return;
+
+    // Record needs a connection, the error popup replaces Config and frees it
+    // once the item callback has returned, the label is left alone
+    menu_pick(view_dispatcher, app->config_menu, "Record: OFF");
+    TEST_CHECK(!app->capture);
+    TEST_CHECK_EQ(app->current_view, BunnyConnectViewPopup);
+    TEST_CHECK(app->popup);
+    if(!app->popup) return;
+    TEST_CHECK(
+        furi_shim_view_dispatcher_get_current(view_dispatcher) == popup_get_view(app->popup));
+    TEST_CHECK_STR(furi_shim_popup_get_text(app->popup), "Connect first");
+    TEST_CHECK(!app->config_menu);
+
+    // Config comes back whole
+    input(view_dispatcher, InputKeyBack);
+    TEST_CHECK(!app->popup);
+    menu_pick(view_dispatcher, app->main_menu, "Config");
+    TEST_CHECK(app->config_menu);
+    if(!app->config_menu) return;
+    TEST_CHECK(furi_shim_submenu_find(app->config_menu, "Record: OFF") != UINT32_MAX);
+    input(view_dispatcher, InputKeyBack);
+    input(view_dispatcher, InputKeyBack);
+}
+
+static void test_record_disconnected(void) {
+    app_run(script_record_disconnected);
+}
+
+int main(void) {
+    Gui* gui = furi_shim_gui_alloc();
+    NotificationApp* notifications = furi_shim_notification_alloc();
+    furi_record_create(RECORD_GUI, gui);
+    furi_record_create(RECORD_NOTIFICATION, notifications);
+
+    TEST_RUN(test_config_label);
+    TEST_RUN(test_record_disconnected);
+
+    furi_record_destroy(RECORD_NOTIFICATION);
+    furi_record_destroy(RECORD_GUI);
+    furi_shim_notification_free(notifications);
+    furi_shim_gui_free(gui);
+    return test_report();
+}
@@ -0,0 +1,176 @@
+#include "test.h"
+#include "fake_usb.h"
+#include "../lib/bunnyconnect_cdc.h"
+#include <stdatomic.h>
+
+#define STREAM_BYTES (256UL * 1024)
+#define PATTERN(pos) ((uint8_t)((pos) % 251))
+
+static BunnyConnectCdc* cdc;
+static atomic_bool writer_done;
+
+static void setup(BunnyConnectFlowControl mode) {
+    fake_usb_start();
+    fake_usb_plug(true);
+    fake_usb_set_ctrl_line(CdcCtrlLineDTR | CdcCtrlLineRTS);
+    cdc = bunnyconnect_cdc_alloc(0);
+    bunnyconnect_cdc_set_flow_control(cdc, mode);
+}
+
+static void teardown(void) {
+    bunnyconnect_cdc_free(cdc);
+    fake_usb_stop();
+}
+
+static void test_names(void) {
+    TEST_CHECK_STR(bunnyconnect_cdc_flow_control_name(BunnyConnectFlowControlNone), "Off");
+    TEST_CHECK_STR(
+        bunnyconnect_cdc_flow_control_name(BunnyConnectFlowControlDtrRts), "DTR/RTS (CDC)");
+}
+
+static void test_filter_rx(void) {
+    uint8_t data[] = {'a', BUNNYCONNECT_CDC_XOFF, 'b', BUNNYCONNECT_CDC_XON, 'c'};
+
+    setup(BunnyConnectFlowControlXonXoff);
+    TEST_CHECK_EQ(bunnyconnect_cdc_filter_rx(cdc, data, sizeof(data)), 3);
+    TEST_CHECK_MEM(data, "abc", 3);
+    TEST_CHECK(!bunnyconnect_cdc_is_paused(cdc));
+
+    // Only XON/XOFF mode consumes the bytes
+    bunnyconnect_cdc_set_flow_control(cdc, BunnyConnectFlowControlDtrRts);
+    data[1] = BUNNYCONNECT_CDC_XOFF;
+    TEST_CHECK_EQ(bunnyconnect_cdc_filter_rx(cdc, data, 2), 2);
+    TEST_CHECK(!bunnyconnect_cdc_is_paused(cdc));
+    teardown();
+}
+
+static void test_rts_holds(void) {
+    uint8_t data[256];
+
+    setup(BunnyConnectFlowControlDtrRts);
+
+    // Nothing leaves while the host holds RTS low
+    fake_usb_set_ctrl_line(CdcCtrlLineDTR);
+    TEST_CHECK(bunnyconnect_cdc_is_paused(cdc));
+    TEST_CHECK_EQ(bunnyconnect_cdc_write(cdc, (const uint8_t*)"held", 4, 100), 4);
+    TEST_CHECK_EQ(fake_usb_host_read(data, sizeof(data), 100), 0);
+    TEST_CHECK_EQ(bunnyconnect_cdc_get_pending(cdc), 4);
+
+    fake_usb_set_ctrl_line(CdcCtrlLineDTR | CdcCtrlLineRTS);
+    TEST_CHECK(!bunnyconnect_cdc_is_paused(cdc));
+    TEST_CHECK_EQ(fake_usb_host_read(data, 4, 1000), 4);
+    TEST_CHECK_MEM(data, "held", 4);
+
+    // RTS means nothing in the other modes
+    bunnyconnect_cdc_set_flow_control(cdc, BunnyConnectFlowControlNone);
+    fake_usb_set_ctrl_line(CdcCtrlLineDTR);
+    TEST_CHECK(!bunnyconnect_cdc_is_paused(cdc));
+    teardown();
+}
+
+static int32_t writer_thread(void* context) {
+    UNUSED(context);
+    uint8_t chunk[97];
+    uint32_t pos = 0;
+
+    while(pos < STREAM_BYTES) {
+        size_t len = MIN(sizeof(chunk), STREAM_BYTES - pos);
+        for(size_t i = 0; i < len; i++) {
+            chunk[i] = PATTERN(pos + i);
+        }
+        size_t written = 0;
+        while(written < len) {
+            written += bunnyconnect_cdc_write(cdc, chunk + written, len - written, 100);
+        }
+        pos += len;
+    }
+
+    atomic_store(&writer_done, true);
+    return 0;
+}
+
+// Pause and resume the way the peer would, until the writer is done
+static int32_t throttle_thread(void* context) {
+    BunnyConnectFlowControl mode = (uintptr_t)context;
+    bool on = true;
+
+    while(!atomic_load(&writer_done)) {
+        furi_delay_us(300 + (on ? 0 : 700));
+        on = !on;
+        if(mode == BunnyConnectFlowControlDtrRts) {
+            fake_usb_set_ctrl_line(CdcCtrlLineDTR | (on ? CdcCtrlLineRTS : 0));
+        } else {
+            uint8_t byte = on ? BUNNYCONNECT_CDC_XON : BUNNYCONNECT_CDC_XOFF;
+            bunnyconnect_cdc_filter_rx(cdc, &byte, 1);
+        }
+    }
+
+    // Leave the peer ready for the tail of the stream
+    if(mode == BunnyConnectFlowControlDtrRts) {
+        fake_usb_set_ctrl_line(CdcCtrlLineDTR | CdcCtrlLineRTS);
+    } else {
+        uint8_t byte = BUNNYCONNECT_CDC_XON;
+        bunnyconnect_cdc_filter_rx(cdc, &byte, 1);
+    }
+    return 0;
+}
+
+static void throttled_stream(BunnyConnectFlowControl mode) {
+    uint8_t data[1024];
+    uint32_t pos = 0;
+    size_t bad = 0;
+
+    setup(mode);
+    fake_usb_set_packet_delay(20);
+    atomic_store(&writer_done, false);
+    FuriThread* writer = furi_thread_alloc_ex("Writer", 1024, writer_thread, NULL);
+    FuriThread* throttle =
+        furi_thread_alloc_ex("Throttle", 1024, throttle_thread, (void*)(uintptr_t)mode);
+    furi_thread_start(writer);
+    furi_thread_start(throttle);
+
+    // Every byte arrives once, in order, however often the peer says stop
+    while(pos < STREAM_BYTES) {
+        size_t got = fake_usb_host_read(data, sizeof(data), 2000);
+        if(got == 0) break;
+        for(size_t i = 0; i < got; i++) {
+            if(data[i] != PATTERN(pos + i)) bad++;
+        }
+        pos += got;
+    }
+    furi_thread_join(writer);
+    furi_thread_join(throttle);
+    furi_thread_free(writer);
+    furi_thread_free(throttle);
+
+    TEST_CHECK_EQ(pos, STREAM_BYTES);
+    TEST_CHECK_EQ(bad, 0);
+    TEST_CHECK_EQ(fake_usb_host_read(data, sizeof(data), 50), 0);
+
+    BunnyConnectCdcStats stats;
+    bunnyconnect_cdc_get_stats(cdc, &stats);
+    printf(
+        "%s: %lu pauses\n",
+        bunnyconnect_cdc_flow_control_name(mode),
+        (unsigned long)stats.flow_pauses);
+    TEST_CHECK(stats.flow_pauses > 0);
+    TEST_CHECK_EQ(stats.bytes_sent, STREAM_BYTES);
+    teardown();
+}
+
+static void test_rts_no_loss(void) {
+    throttled_stream(BunnyConnectFlowControlDtrRts);
+}
+
+static void test_xon_xoff_no_loss(void) {
+    throttled_stream(BunnyConnectFlowControlXonXoff);
+}
+
+int main(void) {
+    TEST_RUN(test_names);
+    TEST_RUN(test_filter_rx);
+    TEST_RUN(test_rts_holds);
+    TEST_RUN(test_rts_no_loss);
+    TEST_RUN(test_xon_xoff_no_loss);
+    return test_report();
+}
@@ -0,0 +1,135 @@
+#include "test.h"
+#include "../lib/bunnyconnect_config.h"
+
+// Byte offsets into config.bin: magic, version, size, hash, then the record
+#define CONFIG_RECORD_OFFSET 12
+
+static Storage* storage;
+
+static void test_defaults(void) {
+    BunnyConnectConfig config;
+
+    test_storage_reset();
+    TEST_CHECK_EQ(bunnyconnect_config_load(storage, &config), BunnyConnectConfigSourceDefaults);
+    TEST_CHECK_STR(config.device_name, "BunnyConnect");
+    TEST_CHECK_EQ(config.baud_rate, 115200);
+    TEST_CHECK_EQ(config.output_route, BunnyConnectOutputRouteBoth);
+    TEST_CHECK_EQ(config.memory_budget, BunnyConnectMemoryBudgetDefault);
+    TEST_CHECK(config.usb_power_enabled);
+    TEST_CHECK(!config.timestamps);
+}
+
+static void config_custom(BunnyConnectConfig* config) {
+    bunnyconnect_config_defaults(config);
+    strlcpy(config->device_name, "Bench", sizeof(config->device_name));
+    config->baud_rate = 921600;
+    config->flow_control = BunnyConnectFlowControlXonXoff;
+    config->output_route = BunnyConnectOutputRouteHid;
+    config->line_ending[BunnyConnectOutputCdc] = BunnyConnectLineEndingCrLf;
+    config->sendfile.chunk_size = 512;
+    config->sendfile.line_delay_ms = 7;
+    config->usb_power_enabled = false;
+    config->timestamps = true;
+    config->memory_budget = BunnyConnectMemoryBudgetLarge;
+}
+
+static void config_check_custom(const BunnyConnectConfig* config) {
+    TEST_CHECK_STR(config->device_name, "Bench");
+    TEST_CHECK_EQ(config->baud_rate, 921600);
+    TEST_CHECK_EQ(config->flow_control, BunnyConnectFlowControlXonXoff);
+    TEST_CHECK_EQ(config->output_route, BunnyConnectOutputRouteHid);
+    TEST_CHECK_EQ(config->line_ending[BunnyConnectOutputCdc], BunnyConnectLineEndingCrLf);
+    TEST_CHECK_EQ(config->line_ending[BunnyConnectOutputHid], BunnyConnectLineEndingLf);
+    TEST_CHECK_EQ(config->sendfile.chunk_size, 512);
+    TEST_CHECK_EQ(config->sendfile.line_delay_ms, 7);
+    TEST_CHECK(!config->usb_power_enabled);
+    TEST_CHECK(config->auto_enumerate);
+    TEST_CHECK(config->timestamps);
+    TEST_CHECK_EQ(config->memory_budget, BunnyConnectMemoryBudgetLarge);
+}
+
+static void test_binary_round_trip(void) {
+    BunnyConnectConfig config;
+
+    test_storage_reset();
+    config_custom(&config);
+    TEST_CHECK(bunnyconnect_config_save(storage, &config));
+
+    memset(&config, 0, sizeof(config));
+    TEST_CHECK_EQ(bunnyconnect_config_load(storage, &config), BunnyConnectConfigSourceBinary);
+    config_check_custom(&config);
+}
+
+static void test_corrupt_falls_back_to_text(void) {
+    BunnyConnectConfig config;
+    size_t size;
+
+    test_storage_reset();
+    config_custom(&config);
+    TEST_CHECK(bunnyconnect_config_save(storage, &config));
+
+    // Flip a record byte, the hash no longer matches
+    char* data = test_storage_read(BUNNYCONNECT_CONFIG_PATH, &size);
+    TEST_CHECK(data != NULL);
+    data[CONFIG_RECORD_OFFSET] ^= 0x55;
+    test_storage_write(BUNNYCONNECT_CONFIG_PATH, data, size);
+    free(data);
+
+    TEST_CHECK_EQ(bunnyconnect_config_load(storage, &config), BunnyConnectConfigSourceText);
+    config_check_custom(&config);
+
+    // A short record is rejected the same way
+    test_storage_write(BUNNYCONNECT_CONFIG_PATH, "BCCF", 4);
+    TEST_CHECK_EQ(bunnyconnect_config_load(storage, &config), BunnyConnectConfigSourceText);
+}
+
+static void test_text_any_order(void) {
+    BunnyConnectConfig config;
+    const char* text = "Filetype: BunnyConnect Config\n"
+                       "Version: 1\n"
+                       "# hand edited\n"
+                       "Timestamps: true\n"
+                       "Memory Budget: 0\n"
+                       "Baud Rate: 9600\n"
+                       "Route: 99\n"
+                       "Device Name: Lab\n";
+
+    test_storage_reset();
+    test_storage_write(BUNNYCONNECT_CONFIG_TEXT_PATH, text, strlen(text));
+
+    // Missing and out of range keys keep their defaults
+    TEST_CHECK_EQ(bunnyconnect_config_load(storage, &config), BunnyConnectConfigSourceText);
+    TEST_CHECK_STR(config.device_name, "Lab");
+    TEST_CHECK_EQ(config.baud_rate, 9600);
+    TEST_CHECK(config.timestamps);
+    TEST_CHECK_EQ(config.memory_budget, BunnyConnectMemoryBudgetSmall);
+    TEST_CHECK_EQ(config.output_route, BunnyConnectOutputRouteBoth);
+    TEST_CHECK(config.usb_power_enabled);
+}
+
+static void test_text_wrong_type(void) {
+    BunnyConnectConfig config;
+    const char* text = "Filetype: Something Else\nVersion: 1\nBaud Rate: 9600\n";
+
+    test_storage_reset();
+    test_storage_write(BUNNYCONNECT_CONFIG_TEXT_PATH, text, strlen(text));
+    TEST_CHECK_EQ(bunnyconnect_config_load(storage, &config), BunnyConnectConfigSourceDefaults);
+    TEST_CHECK_EQ(config.baud_rate, 115200);
+}
+
+static void test_budget_names(void) {
+    TEST_CHECK_STR(bunnyconnect_config_memory_budget_name(BunnyConnectMemoryBudgetSmall), "Small");
+    TEST_CHECK_STR(bunnyconnect_config_memory_budget_name(BunnyConnectMemoryBudgetCount), "?");
+}
+
+int main(void) {
+    storage = furi_record_open(RECORD_STORAGE);
+    TEST_RUN(test_defaults);
+    TEST_RUN(test_binary_round_trip);
+    TEST_RUN(test_corrupt_falls_back_to_text);
+    TEST_RUN(test_text_any_order);
+    TEST_RUN(test_text_wrong_type);
+    TEST_RUN(test_budget_names);
+    furi_record_close(RECORD_STORAGE);
+    return test_report();
+}
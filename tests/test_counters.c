@@ -0,0 +1,94 @@
+#include "test.h"
+#include "../lib/bunnyconnect_counters.h"
+
+static void test_add_max(void) {
+    uint32_t values[BunnyConnectCounterCount];
+
+    bunnyconnect_counters_reset();
+    bunnyconnect_counters_add(BunnyConnectCounterRxBytes, 100);
+    bunnyconnect_counters_add(BunnyConnectCounterRxBytes, 28);
+    bunnyconnect_counters_max(BunnyConnectCounterCdcQueuePeak, 50);
+    bunnyconnect_counters_max(BunnyConnectCounterCdcQueuePeak, 20);
+    bunnyconnect_counters_max(BunnyConnectCounterCdcQueuePeak, 70);
+
+    bunnyconnect_counters_snapshot(values);
+    TEST_CHECK_EQ(values[BunnyConnectCounterRxBytes], 128);
+    TEST_CHECK_EQ(values[BunnyConnectCounterCdcQueuePeak], 70);
+    TEST_CHECK_EQ(values[BunnyConnectCounterTxBytes], 0);
+
+    bunnyconnect_counters_reset();
+    bunnyconnect_counters_snapshot(values);
+    TEST_CHECK_EQ(values[BunnyConnectCounterRxBytes], 0);
+    TEST_CHECK_EQ(values[BunnyConnectCounterCdcQueuePeak], 0);
+}
+
+static void test_wrap(void) {
+    uint32_t values[BunnyConnectCounterCount];
+
+    bunnyconnect_counters_reset();
+    bunnyconnect_counters_add(BunnyConnectCounterTxBytes, UINT32_MAX);
+    bunnyconnect_counters_add(BunnyConnectCounterTxBytes, 2);
+    bunnyconnect_counters_snapshot(values);
+    TEST_CHECK_EQ(values[BunnyConnectCounterTxBytes], 1);
+}
+
+#define COUNTERS_THREADS 4
+#define COUNTERS_ADDS    100000
+
+static int32_t counters_thread(void* context) {
+    uint32_t id = (uintptr_t)context;
+    for(uint32_t i = 0; i < COUNTERS_ADDS; i++) {
+        bunnyconnect_counters_add(BunnyConnectCounterRxChunks, 1);
+        bunnyconnect_counters_max(BunnyConnectCounterHidQueuePeak, id * COUNTERS_ADDS + i);
+    }
+    return 0;
+}
+
+static void test_threads(void) {
+    FuriThread* threads[COUNTERS_THREADS];
+    uint32_t values[BunnyConnectCounterCount];
+
+    bunnyconnect_counters_reset();
+    for(size_t i = 0; i < COUNTERS_THREADS; i++) {
+        threads[i] =
+            furi_thread_alloc_ex("Counters", 1024, counters_thread, (void*)(uintptr_t)i);
+        furi_thread_start(threads[i]);
+    }
+    for(size_t i = 0; i < COUNTERS_THREADS; i++) {
+        furi_thread_join(threads[i]);
+        furi_thread_free(threads[i]);
+    }
+
+    bunnyconnect_counters_snapshot(values);
+    TEST_CHECK_EQ(values[BunnyConnectCounterRxChunks], COUNTERS_THREADS * COUNTERS_ADDS);
+    TEST_CHECK_EQ(values[BunnyConnectCounterHidQueuePeak], COUNTERS_THREADS * COUNTERS_ADDS - 1);
+}
+
+static void test_format(void) {
+    uint32_t values[BunnyConnectCounterCount] = {0};
+    char out[512];
+
+    values[BunnyConnectCounterRxBytes] = 4000000000UL;
+    values[BunnyConnectCounterHidQueuePeak] = 12;
+    size_t len = bunnyconnect_counters_format(values, 1234, out, sizeof(out));
+
+    TEST_CHECK_EQ(len, strlen(out));
+    TEST_CHECK(strncmp(out, "BCSTATS v=1 up_ms=1234 rx_bytes=4000000000 rx_chunks=0 ", 55) == 0);
+    TEST_CHECK(strstr(out, " hid_q_peak=12\r\n") == out + len - 16);
+
+    // Every counter has a name on the line
+    for(size_t i = 0; i < BunnyConnectCounterCount; i++) {
+        char key[32];
+        snprintf(key, sizeof(key), " %s=", bunnyconnect_counters_name(i));
+        TEST_CHECK(strstr(out, key) != NULL);
+    }
+    TEST_CHECK_STR(bunnyconnect_counters_name(BunnyConnectCounterCount), "?");
+}
+
+int main(void) {
+    TEST_RUN(test_add_max);
+    TEST_RUN(test_wrap);
+    TEST_RUN(test_threads);
+    TEST_RUN(test_format);
+    return test_report();
+}
@@ -0,0 +1,132 @@
+#include "test.h"
+#include "../lib/bunnyconnect_draw.h"
+
+static Canvas* canvas;
+
+static void check_counts(uint32_t color, uint32_t line, uint32_t box, uint32_t frame) {
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpSetColor), color);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpLine), line);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpBox), box);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpFrame), frame);
+}
+
+static void test_logo(void) {
+    furi_shim_canvas_reset(canvas);
+    bunnyconnect_draw_logo(canvas, 0, 0);
+    check_counts(1, 4, 0, 0);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpCircle), 1);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpDisc), 1);
+    TEST_CHECK_EQ(furi_shim_canvas_get_total(canvas), 7);
+}
+
+static void test_connection_status(void) {
+    furi_shim_canvas_reset(canvas);
+    bunnyconnect_draw_connection_status(canvas, true, 0, 0);
+    check_counts(1, 2, 0, 0);
+    uint32_t connected = furi_shim_canvas_get_digest(canvas);
+
+    furi_shim_canvas_reset(canvas);
+    bunnyconnect_draw_connection_status(canvas, false, 0, 0);
+    check_counts(1, 2, 0, 0);
+    TEST_CHECK(furi_shim_canvas_get_digest(canvas) != connected);
+}
+
+static void test_signal_strength(void) {
+    // A filled box per bar, frames for the rest
+    const uint8_t strengths[] = {0, 25, 50, 100, 255};
+    const uint32_t bars[] = {0, 1, 2, 4, 4};
+    for(size_t i = 0; i < COUNT_OF(strengths); i++) {
+        furi_shim_canvas_reset(canvas);
+        bunnyconnect_draw_signal_strength(canvas, strengths[i], 10, 10);
+        check_counts(1, 0, bars[i], 4 - bars[i]);
+    }
+}
+
+static void test_loading_animation(void) {
+    // Frames repeat every eight, each a line and the hub
+    furi_shim_canvas_reset(canvas);
+    bunnyconnect_draw_loading_animation(canvas, 3, 20, 20);
+    uint32_t digest = furi_shim_canvas_get_digest(canvas);
+    check_counts(1, 1, 0, 0);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpDisc), 1);
+
+    furi_shim_canvas_reset(canvas);
+    bunnyconnect_draw_loading_animation(canvas, 11, 20, 20);
+    TEST_CHECK_EQ(furi_shim_canvas_get_digest(canvas), digest);
+}
+
+static void test_battery_status(void) {
+    furi_shim_canvas_reset(canvas);
+    bunnyconnect_draw_battery_status(canvas, 0, false, 0, 0);
+    check_counts(1, 0, 1, 1);
+
+    furi_shim_canvas_reset(canvas);
+    bunnyconnect_draw_battery_status(canvas, 100, true, 0, 0);
+    check_counts(1, 4, 2, 1);
+}
+
+static void test_menu_item(void) {
+    furi_shim_canvas_reset(canvas);
+    bunnyconnect_draw_menu_item(canvas, "Connect", false, 4, 12);
+    check_counts(1, 0, 0, 0);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpStr), 1);
+
+    furi_shim_canvas_reset(canvas);
+    bunnyconnect_draw_menu_item(canvas, "Connect", true, 4, 12);
+    check_counts(2, 0, 1, 0);
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 0), "Connect");
+}
+
+static void test_raster(void) {
+    // Boxes fill, frames outline, XOR takes a box back out
+    furi_shim_canvas_reset(canvas);
+    canvas_draw_box(canvas, 1, 1, 4, 3);
+    TEST_CHECK_EQ(furi_shim_canvas_get_ink(canvas), 12);
+    canvas_set_color(canvas, ColorXOR);
+    canvas_draw_box(canvas, 1, 1, 4, 3);
+    TEST_CHECK_EQ(furi_shim_canvas_get_ink(canvas), 0);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_draw_frame(canvas, 10, 10, 4, 3);
+    TEST_CHECK_EQ(furi_shim_canvas_get_ink(canvas), 10);
+    TEST_CHECK(!furi_shim_canvas_get_pixel(canvas, 11, 11));
+
+    // Lines include both ends, text is a cell per glyph, off screen is clipped
+    canvas_clear(canvas);
+    canvas_draw_line(canvas, 0, 0, 9, 4);
+    TEST_CHECK_EQ(furi_shim_canvas_get_ink(canvas), 10);
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 9, 4));
+    canvas_clear(canvas);
+    canvas_draw_str(canvas, 0, 7, "a b");
+    TEST_CHECK_EQ(
+        furi_shim_canvas_get_ink(canvas),
+        2 * (FURI_SHIM_CANVAS_GLYPH_WIDTH - 1) * FURI_SHIM_CANVAS_GLYPH_HEIGHT);
+    canvas_clear(canvas);
+    canvas_draw_box(canvas, 126, 62, 10, 10);
+    TEST_CHECK_EQ(furi_shim_canvas_get_ink(canvas), 4);
+    TEST_CHECK(!furi_shim_canvas_get_pixel(canvas, 128, 62));
+
+    // Circles reach their radius on the axes and not on the diagonal
+    canvas_clear(canvas);
+    canvas_draw_disc(canvas, 20, 20, 4);
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 24, 20));
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 20, 16));
+    TEST_CHECK(!furi_shim_canvas_get_pixel(canvas, 24, 24));
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 20, 20));
+    canvas_clear(canvas);
+    canvas_draw_circle(canvas, 20, 20, 4);
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 16, 20));
+    TEST_CHECK(!furi_shim_canvas_get_pixel(canvas, 20, 20));
+}
+
+int main(void) {
+    canvas = furi_shim_canvas_alloc();
+    TEST_RUN(test_logo);
+    TEST_RUN(test_connection_status);
+    TEST_RUN(test_signal_strength);
+    TEST_RUN(test_loading_animation);
+    TEST_RUN(test_battery_status);
+    TEST_RUN(test_menu_item);
+    TEST_RUN(test_raster);
+    furi_shim_canvas_free(canvas);
+    return test_report();
+}
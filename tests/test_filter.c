@@ -0,0 +1,167 @@
+#include "test.h"
+#include "../lib/bunnyconnect_arena.h"
+#include "../lib/bunnyconnect_filter.h"
+#include "../lib/bunnyconnect_scrollback.h"
+#include "../lib/bunnyconnect_stamp.h"
+
+#define RING_SIZE 256
+
+static BunnyConnectArena* arena;
+static BunnyConnectScrollback* ring;
+static BunnyConnectFilter* filter;
+
+static void setup(const char* pattern) {
+    if(arena) bunnyconnect_arena_free(arena);
+    arena = bunnyconnect_arena_alloc(BUNNYCONNECT_SCROLLBACK_OVERHEAD + RING_SIZE);
+    ring = bunnyconnect_scrollback_alloc(arena, "Ring", RING_SIZE);
+    bunnyconnect_filter_set_pattern(filter, pattern);
+}
+
+static void ring_write(const char* text) {
+    bunnyconnect_scrollback_write(ring, (const uint8_t*)text, strlen(text));
+}
+
+static void ring_marker(uint8_t lead, uint32_t ms) {
+    uint8_t marker[BUNNYCONNECT_STAMP_MAX];
+    size_t len = bunnyconnect_stamp_encode(lead, ms, marker);
+    bunnyconnect_scrollback_write(ring, marker, len);
+}
+
+static const char* filter_text(void) {
+    static char out[RING_SIZE + 1];
+    bunnyconnect_filter_render(filter, out, sizeof(out));
+    return out;
+}
+
+static void test_contains(void) {
+    setup("err");
+    ring_write("boot ok\nERROR one\n");
+    ring_write("fine\nan error two\npartial err");
+    bunnyconnect_filter_update(filter, ring);
+
+    // Case-insensitive, the unfinished line waits for its newline
+    TEST_CHECK_EQ(bunnyconnect_filter_get_count(filter), 2);
+    TEST_CHECK_STR(filter_text(), "ERROR one\nan error two\n");
+
+    ring_write(" three\n");
+    bunnyconnect_filter_update(filter, ring);
+    TEST_CHECK_EQ(bunnyconnect_filter_get_count(filter), 3);
+    TEST_CHECK_STR(filter_text(), "ERROR one\nan error two\npartial err three\n");
+}
+
+static void test_glob(void) {
+    setup("rx ?? *ms");
+    ring_write("rx 12 in 5 ms\nrx 123 in 5 ms\nrx 12 in 5 ms!\nRX 99 ms\r\n");
+    bunnyconnect_filter_update(filter, ring);
+
+    // Whole-line match, a CR before the newline is ignored
+    TEST_CHECK_STR(filter_text(), "rx 12 in 5 ms\nRX 99 ms\r\n");
+}
+
+static void test_get_line(void) {
+    uint32_t start, len;
+    uint8_t text[16];
+
+    setup("#");
+    ring_write("#1\nskip\n#22\n");
+    bunnyconnect_filter_update(filter, ring);
+
+    TEST_CHECK(bunnyconnect_filter_get_line(filter, 0, &start, &len));
+    TEST_CHECK_EQ(len, 3);
+    TEST_CHECK(bunnyconnect_scrollback_read(ring, start, text, len));
+    TEST_CHECK_MEM(text, "#22", 3);
+    TEST_CHECK(bunnyconnect_filter_get_line(filter, 1, &start, &len));
+    TEST_CHECK_EQ(start, 0);
+    TEST_CHECK_EQ(len, 2);
+    TEST_CHECK(!bunnyconnect_filter_get_line(filter, 2, &start, &len));
+}
+
+static void test_empty_pattern(void) {
+    setup("");
+    ring_write("anything\n");
+    bunnyconnect_filter_update(filter, ring);
+    TEST_CHECK_EQ(bunnyconnect_filter_get_count(filter), 0);
+    TEST_CHECK_STR(filter_text(), "");
+}
+
+static void test_overwritten(void) {
+    char line[16];
+
+    setup("keep");
+    ring_write("keep 0\n");
+    bunnyconnect_filter_update(filter, ring);
+    TEST_CHECK_EQ(bunnyconnect_filter_get_count(filter), 1);
+
+    // Lap the scan: the first match is gone, the line cut by the tail is not matched
+    for(size_t i = 0; i < RING_SIZE / 8 + 2; i++) {
+        snprintf(line, sizeof(line), "keep %02u\n", (unsigned)(i % 100));
+        ring_write(line);
+    }
+    bunnyconnect_filter_update(filter, ring);
+
+    uint32_t tail, head, start, len;
+    bunnyconnect_scrollback_get_window(ring, &tail, &head);
+    size_t count = bunnyconnect_filter_get_count(filter);
+    TEST_CHECK(count > 0);
+    TEST_CHECK(count <= RING_SIZE / 8);
+    TEST_CHECK(bunnyconnect_filter_get_line(filter, count - 1, &start, &len));
+    TEST_CHECK((int32_t)(start - tail) >= 0);
+    TEST_CHECK_EQ(len, 7);
+}
+
+static void test_stamped(void) {
+    setup("b");
+    ring_marker(BUNNYCONNECT_STAMP_ABS, 1000);
+    ring_write("a\n");
+    ring_marker(BUNNYCONNECT_STAMP_DELTA, 234);
+    ring_write("b\n");
+    bunnyconnect_filter_update(filter, ring);
+
+    // The match keeps its time as an absolute marker ahead of the text
+    char out[RING_SIZE + 1];
+    size_t len = bunnyconnect_filter_render(filter, out, sizeof(out));
+    len = bunnyconnect_stamp_render(out, len, sizeof(out), true, false);
+    TEST_CHECK_STR(out, "    1.234 b\n");
+
+    uint32_t start, line_len;
+    uint8_t text;
+    TEST_CHECK(bunnyconnect_filter_get_line(filter, 0, &start, &line_len));
+    TEST_CHECK_EQ(line_len, 1);
+    TEST_CHECK(bunnyconnect_scrollback_read(ring, start, &text, 1));
+    TEST_CHECK_EQ(text, 'b');
+}
+
+static void test_escaped(void) {
+    setup("\x1E" "k");
+    ring_write("\x1E\x1E" "key\nno\x1E\x1E" "k\n");
+    ring_marker(BUNNYCONNECT_STAMP_ABS, 500);
+    ring_write("\x1E\x1E" "kb\n");
+    bunnyconnect_filter_update(filter, ring);
+
+    // A doubled lead is one byte of text, at a line start it is not a marker
+    char out[RING_SIZE + 1];
+    size_t len = bunnyconnect_filter_render(filter, out, sizeof(out));
+    len = bunnyconnect_stamp_render(out, len, sizeof(out), false, false);
+    TEST_CHECK_STR(out, "\x1E" "key\nno\x1E" "k\n\x1E" "kb\n");
+
+    uint32_t start, line_len;
+    TEST_CHECK(bunnyconnect_filter_get_line(filter, 0, &start, &line_len));
+    TEST_CHECK_EQ(line_len, 4);
+    TEST_CHECK(bunnyconnect_filter_get_line(filter, 2, &start, &line_len));
+    TEST_CHECK_EQ(start, 0);
+    TEST_CHECK_EQ(line_len, 5);
+}
+
+int main(void) {
+    filter = bunnyconnect_filter_alloc();
+    TEST_RUN(test_contains);
+    TEST_RUN(test_glob);
+    TEST_RUN(test_get_line);
+    TEST_RUN(test_empty_pattern);
+    TEST_RUN(test_overwritten);
+    TEST_RUN(test_stamped);
+    TEST_RUN(test_escaped);
+    bunnyconnect_filter_free(filter);
+    bunnyconnect_arena_free(arena);
+    return test_report();
+}
@@ -0,0 +1,106 @@
+#include "test.h"
+#include "../lib/bunnyconnect_histogram.h"
+
+static void test_buckets(void) {
+    uint32_t counts[BUNNYCONNECT_HISTOGRAM_BUCKETS];
+
+    bunnyconnect_histogram_reset();
+    bunnyconnect_histogram_rx_chunk(0);
+    bunnyconnect_histogram_rx_chunk(1);
+    bunnyconnect_histogram_rx_chunk(2);
+    bunnyconnect_histogram_rx_chunk(3);
+    bunnyconnect_histogram_rx_chunk(64);
+    bunnyconnect_histogram_rx_chunk(SIZE_MAX >> 1);
+
+    // 0, 1, 2..3, then 64 in [64, 128) and the overflow in the last bucket
+    bunnyconnect_histogram_snapshot(BunnyConnectHistogramRxSize, counts);
+    TEST_CHECK_EQ(counts[0], 1);
+    TEST_CHECK_EQ(counts[1], 1);
+    TEST_CHECK_EQ(counts[2], 2);
+    TEST_CHECK_EQ(counts[7], 1);
+    TEST_CHECK_EQ(counts[BUNNYCONNECT_HISTOGRAM_BUCKETS - 1], 1);
+
+    // The first chunk has no gap to measure
+    bunnyconnect_histogram_snapshot(BunnyConnectHistogramRxGap, counts);
+    uint32_t gaps = 0;
+    for(size_t i = 0; i < BUNNYCONNECT_HISTOGRAM_BUCKETS; i++) {
+        gaps += counts[i];
+    }
+    TEST_CHECK_EQ(gaps, 5);
+
+    bunnyconnect_histogram_reset();
+    bunnyconnect_histogram_snapshot(BunnyConnectHistogramRxSize, counts);
+    TEST_CHECK_EQ(counts[2], 0);
+}
+
+static void test_gap(void) {
+    uint32_t counts[BUNNYCONNECT_HISTOGRAM_BUCKETS];
+
+    bunnyconnect_histogram_reset();
+    bunnyconnect_histogram_rx_chunk(8);
+    furi_delay_ms(20);
+    bunnyconnect_histogram_rx_chunk(8);
+
+    // 20 ms is in [16384, 32768) us, a slow host may push it one bucket up
+    bunnyconnect_histogram_snapshot(BunnyConnectHistogramRxGap, counts);
+    TEST_CHECK_EQ(counts[15] + counts[16], 1);
+}
+
+static void test_bucket_limit(void) {
+    TEST_CHECK_EQ(bunnyconnect_histogram_bucket_limit(0), 1);
+    TEST_CHECK_EQ(bunnyconnect_histogram_bucket_limit(10), 1024);
+    TEST_CHECK_EQ(
+        bunnyconnect_histogram_bucket_limit(BUNNYCONNECT_HISTOGRAM_BUCKETS - 1), UINT32_MAX);
+}
+
+static void test_percentile(void) {
+    uint32_t counts[BUNNYCONNECT_HISTOGRAM_BUCKETS] = {0};
+
+    TEST_CHECK_EQ(bunnyconnect_histogram_percentile(counts, 50), 0);
+
+    counts[3] = 90;
+    counts[9] = 9;
+    counts[12] = 1;
+    TEST_CHECK_EQ(bunnyconnect_histogram_percentile(counts, 50), 3);
+    TEST_CHECK_EQ(bunnyconnect_histogram_percentile(counts, 90), 3);
+    TEST_CHECK_EQ(bunnyconnect_histogram_percentile(counts, 99), 9);
+    TEST_CHECK_EQ(bunnyconnect_histogram_percentile(counts, 100), 12);
+}
+
+static void test_format(void) {
+    uint32_t counts[BUNNYCONNECT_HISTOGRAM_BUCKETS] = {0};
+    char out[256];
+    char expected[256];
+
+    counts[0] = 4000000000UL;
+    counts[2] = 7;
+    size_t len = bunnyconnect_histogram_format(
+        BunnyConnectHistogramRxGap, counts, 3000000000UL, out, sizeof(out));
+
+    size_t pos = snprintf(
+        expected,
+        sizeof(expected),
+        "BCHIST v=1 up_ms=3000000000 name=rx_gap_us counts=4000000000,0,7");
+    for(size_t i = 3; i < BUNNYCONNECT_HISTOGRAM_BUCKETS; i++) {
+        pos += snprintf(expected + pos, sizeof(expected) - pos, ",0");
+    }
+    snprintf(expected + pos, sizeof(expected) - pos, "\r\n");
+    TEST_CHECK_STR(out, expected);
+    TEST_CHECK_EQ(len, strlen(expected));
+
+    // Cut lines lose their CRLF
+    char small[24];
+    len = bunnyconnect_histogram_format(
+        BunnyConnectHistogramRxSize, counts, 0, small, sizeof(small));
+    TEST_CHECK_EQ(len, sizeof(small) - 1);
+    TEST_CHECK(strstr(small, "\r\n") == NULL);
+}
+
+int main(void) {
+    TEST_RUN(test_buckets);
+    TEST_RUN(test_gap);
+    TEST_RUN(test_bucket_limit);
+    TEST_RUN(test_percentile);
+    TEST_RUN(test_format);
+    return test_report();
+}
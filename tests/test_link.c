@@ -0,0 +1,193 @@
+#include "test.h"
+#include "fake_usb.h"
+#include "../lib/bunnyconnect_cdc.h"
+#include "../lib/bunnyconnect_link.h"
+#include "../lib/bunnyconnect_output.h"
+#include <time.h>
+
+static void test_dtr_drop(void) {
+    BunnyConnectLink* link = bunnyconnect_link_alloc();
+    BunnyConnectLinkStatus status;
+
+    // DTR low before the terminal ever opened the port is not a drop
+    TEST_CHECK_EQ(bunnyconnect_link_update(link, true, false, 0), BunnyConnectLinkActionNone);
+    TEST_CHECK(bunnyconnect_link_is_up(link));
+    bunnyconnect_link_update(link, true, true, 10);
+    bunnyconnect_link_update(link, true, false, 20);
+    bunnyconnect_link_get_status(link, &status);
+    TEST_CHECK_EQ(status.state, BunnyConnectLinkStateDown);
+    TEST_CHECK_EQ(status.drops, 1);
+
+    // Configured but closed never resets the USB, reopening restores the link
+    TEST_CHECK_EQ(bunnyconnect_link_update(link, true, false, 60000), BunnyConnectLinkActionNone);
+    TEST_CHECK_EQ(bunnyconnect_link_update(link, true, true, 60020), BunnyConnectLinkActionNone);
+    bunnyconnect_link_get_status(link, &status);
+    TEST_CHECK_EQ(status.state, BunnyConnectLinkStateUp);
+    TEST_CHECK_EQ(status.reconnect_ms, 60000);
+    TEST_CHECK_EQ(status.attempts, 0);
+    bunnyconnect_link_free(link);
+}
+
+// Step through an outage of ms, return when each reset fired
+static size_t link_outage(BunnyConnectLink* link, uint32_t from, uint32_t ms, uint32_t* resets) {
+    size_t count = 0;
+    for(uint32_t elapsed = 0; elapsed <= ms; elapsed += 10) {
+        if(bunnyconnect_link_update(link, false, false, from + elapsed) ==
+           BunnyConnectLinkActionReset) {
+            resets[count++] = elapsed;
+        }
+    }
+    return count;
+}
+
+static void test_backoff(void) {
+    BunnyConnectLink* link = bunnyconnect_link_alloc();
+    BunnyConnectLinkStatus status;
+    uint32_t resets[32];
+
+    // Gaps double from the minimum and stop at the maximum
+    size_t count = link_outage(link, 1000, 30000, resets);
+    const uint32_t expected[] = {250, 750, 1750, 3750, 7750, 15750, 23750};
+    TEST_CHECK_EQ(count, COUNT_OF(expected));
+    for(size_t i = 0; i < MIN(count, COUNT_OF(expected)); i++) {
+        TEST_CHECK_EQ(resets[i], expected[i]);
+    }
+    bunnyconnect_link_get_status(link, &status);
+    TEST_CHECK_EQ(status.state, BunnyConnectLinkStateReconnecting);
+    TEST_CHECK_EQ(status.attempts, COUNT_OF(expected));
+    TEST_CHECK_EQ(status.backoff_ms, BUNNYCONNECT_LINK_BACKOFF_MAX_MS);
+    TEST_CHECK_EQ(status.down_ms, 30000);
+
+    // Coming back needs no DTR after a reset, the next outage starts over
+    bunnyconnect_link_update(link, true, false, 40000);
+    TEST_CHECK(bunnyconnect_link_is_up(link));
+    count = link_outage(link, 50000, 800, resets);
+    TEST_CHECK_EQ(count, 2);
+    TEST_CHECK_EQ(resets[0], 250);
+    TEST_CHECK_EQ(resets[1], 750);
+    bunnyconnect_link_get_status(link, &status);
+    TEST_CHECK_EQ(status.drops, 2);
+    TEST_CHECK_EQ(status.attempts, 2);
+    TEST_CHECK_EQ(status.reconnect_ms, 39000);
+    bunnyconnect_link_free(link);
+}
+
+static void test_tick_wrap(void) {
+    BunnyConnectLink* link = bunnyconnect_link_alloc();
+    uint32_t resets[4];
+
+    // Deadlines are compared as differences, so the tick may wrap mid-outage
+    size_t count = link_outage(link, UINT32_MAX - 100, 800, resets);
+    TEST_CHECK_EQ(count, 2);
+    TEST_CHECK_EQ(resets[0], 250);
+    bunnyconnect_link_free(link);
+}
+
+static void test_output_held(void) {
+    uint8_t data[64];
+
+    fake_usb_start();
+    fake_usb_plug(true);
+    fake_usb_set_ctrl_line(CdcCtrlLineDTR);
+    BunnyConnectCdc* cdc = bunnyconnect_cdc_alloc(0);
+    BunnyConnectOutput* output = bunnyconnect_output_alloc(cdc);
+    bunnyconnect_output_set_route(output, BunnyConnectOutputRouteCdc);
+
+    TEST_CHECK(bunnyconnect_output_send(output, (const uint8_t*)"up", 2, true));
+    TEST_CHECK_EQ(fake_usb_host_read(data, 3, 1000), 3);
+    TEST_CHECK_MEM(data, "up\n", 3);
+
+    // The host goes away, lines typed meanwhile wait in the queue
+    fake_usb_plug(false);
+    bunnyconnect_output_set_online(output, false);
+    TEST_CHECK(bunnyconnect_output_send(output, (const uint8_t*)"one", 3, true));
+    TEST_CHECK(bunnyconnect_output_send(output, (const uint8_t*)"two", 3, true));
+    TEST_CHECK_EQ(fake_usb_host_read(data, sizeof(data), 200), 0);
+
+    BunnyConnectOutputStats stats;
+    bunnyconnect_output_get_stats(output, BunnyConnectOutputCdc, &stats);
+    TEST_CHECK_EQ(stats.bytes_dropped, 0);
+
+    // Room left is checked with the line ending counted
+    size_t room = stats.capacity - stats.depth;
+    TEST_CHECK(bunnyconnect_output_has_space(output, BunnyConnectOutputCdc, room, false));
+    TEST_CHECK(bunnyconnect_output_has_space(output, BunnyConnectOutputCdc, room - 1, true));
+    TEST_CHECK(!bunnyconnect_output_has_space(output, BunnyConnectOutputCdc, room, true));
+
+    // A line without room for its ending queues nothing, one that fits queues whole
+    uint8_t* fill = malloc(room);
+    memset(fill, 'x', room);
+    TEST_CHECK(!bunnyconnect_output_send(output, fill, room, true));
+    bunnyconnect_output_get_stats(output, BunnyConnectOutputCdc, &stats);
+    TEST_CHECK_EQ(stats.capacity - stats.depth, room);
+    TEST_CHECK_EQ(stats.bytes_dropped, room + 1);
+    TEST_CHECK(bunnyconnect_output_send(output, fill, room - 1, true));
+    bunnyconnect_output_get_stats(output, BunnyConnectOutputCdc, &stats);
+    TEST_CHECK_EQ(stats.depth, stats.capacity);
+
+    // Back online, everything arrives once and in order
+    fake_usb_plug(true);
+    fake_usb_set_ctrl_line(CdcCtrlLineDTR);
+    bunnyconnect_output_set_online(output, true);
+    TEST_CHECK_EQ(fake_usb_host_read(data, 8, 1000), 8);
+    TEST_CHECK_MEM(data, "one\ntwo\n", 8);
+    size_t got = 0;
+    uint8_t last = 0;
+    while(got < room) {
+        size_t len = fake_usb_host_read(data, MIN(room - got, sizeof(data)), 1000);
+        if(!len) break;
+        TEST_CHECK(!memchr(data, '\n', len - 1));
+        last = data[len - 1];
+        got += len;
+    }
+    TEST_CHECK_EQ(got, room);
+    TEST_CHECK_EQ(last, '\n');
+    TEST_CHECK_EQ(fake_usb_host_read(data, sizeof(data), 100), 0);
+    free(fill);
+
+    bunnyconnect_output_free(output);
+    bunnyconnect_cdc_free(cdc);
+    fake_usb_stop();
+}
+
+static double cpu_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void test_output_unconfigured(void) {
+    uint8_t data[16];
+
+    // Enumerated as online but the host never configured the port
+    fake_usb_start();
+    fake_usb_plug(false);
+    BunnyConnectCdc* cdc = bunnyconnect_cdc_alloc(0);
+    BunnyConnectOutput* output = bunnyconnect_output_alloc(cdc);
+    bunnyconnect_output_set_route(output, BunnyConnectOutputRouteCdc);
+    TEST_CHECK(bunnyconnect_output_send(output, (const uint8_t*)"wait", 4, true));
+
+    // The worker sleeps on the CDC events instead of spinning on a write that gives up
+    double start = cpu_seconds();
+    furi_delay_ms(500);
+    TEST_CHECK(cpu_seconds() - start < 0.1);
+    TEST_CHECK_EQ(fake_usb_host_read(data, sizeof(data), 100), 0);
+
+    fake_usb_plug(true);
+    fake_usb_set_ctrl_line(CdcCtrlLineDTR);
+    TEST_CHECK_EQ(fake_usb_host_read(data, 5, 1000), 5);
+    TEST_CHECK_MEM(data, "wait\n", 5);
+
+    bunnyconnect_output_free(output);
+    bunnyconnect_cdc_free(cdc);
+    fake_usb_stop();
+}
+
+int main(void) {
+    TEST_RUN(test_dtr_drop);
+    TEST_RUN(test_backoff);
+    TEST_RUN(test_tick_wrap);
+    TEST_RUN(test_output_held);
+    TEST_RUN(test_output_unconfigured);
+    return test_report();
+}
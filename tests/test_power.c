@@ -0,0 +1,87 @@
+#include "test.h"
+#include "../lib/bunnyconnect_power.h"
+#include "../lib/bunnyconnect_usb.h"
+
+// Stands in for the stock CDC interface qFlipper and the CLI use
+static FuriHalUsbInterface usb_cli;
+
+static void test_exit_unconnected(void) {
+    // Opened and closed without connecting, CLI USB stays up
+    furi_shim_usb_reset(&usb_cli);
+    bunnyconnect_power_init();
+    bunnyconnect_power_deinit();
+    TEST_CHECK(furi_hal_usb_get_config() == &usb_cli);
+    TEST_CHECK_EQ(furi_shim_usb_get_switches(), 0);
+
+    // A failed switch leaves nothing to undo either
+    furi_shim_usb_reset(&usb_cli);
+    furi_shim_usb_set_failing(true);
+    bunnyconnect_power_init();
+    TEST_CHECK(!bunnyconnect_power_set_usb_enabled(true));
+    bunnyconnect_power_deinit();
+    TEST_CHECK(furi_hal_usb_get_config() == &usb_cli);
+    TEST_CHECK_EQ(furi_shim_usb_get_switches(), 0);
+}
+
+static void test_restore(void) {
+    furi_shim_usb_reset(&usb_cli);
+    bunnyconnect_power_init();
+    TEST_CHECK(bunnyconnect_power_set_usb_enabled(true));
+    TEST_CHECK(furi_hal_usb_get_config() == &bunnyconnect_usb_composite);
+
+    BunnyConnectPowerStats stats;
+    bunnyconnect_power_get_stats(&stats);
+    TEST_CHECK(!stats.warm);
+
+    bunnyconnect_power_deinit();
+    TEST_CHECK(furi_hal_usb_get_config() == &usb_cli);
+    TEST_CHECK(!bunnyconnect_power_is_usb_enabled());
+}
+
+static void test_warm_reconnect(void) {
+    // Disconnect keeps the interface, the next Connect finds it and skips the switch
+    furi_shim_usb_reset(&usb_cli);
+    bunnyconnect_power_init();
+    TEST_CHECK(bunnyconnect_power_set_usb_enabled(true));
+    uint32_t switches = furi_shim_usb_get_switches();
+
+    bunnyconnect_power_init();
+    TEST_CHECK(bunnyconnect_power_is_usb_enabled());
+    TEST_CHECK(bunnyconnect_power_set_usb_enabled(true));
+    TEST_CHECK_EQ(furi_shim_usb_get_switches(), switches);
+    BunnyConnectPowerStats stats;
+    bunnyconnect_power_get_stats(&stats);
+    TEST_CHECK(stats.warm);
+
+    // The capture from the first Connect is what exit puts back
+    bunnyconnect_power_deinit();
+    TEST_CHECK(furi_hal_usb_get_config() == &usb_cli);
+}
+
+static void test_power_off(void) {
+    // Turned off in the session, exit still hands USB back
+    furi_shim_usb_reset(&usb_cli);
+    bunnyconnect_power_init();
+    TEST_CHECK(bunnyconnect_power_set_usb_enabled(true));
+    TEST_CHECK(bunnyconnect_power_set_usb_enabled(false));
+    TEST_CHECK(furi_hal_usb_get_config() == NULL);
+
+    bunnyconnect_power_init();
+    bunnyconnect_power_deinit();
+    TEST_CHECK(furi_hal_usb_get_config() == &usb_cli);
+
+    // USB was off before launch, it is off again after
+    furi_shim_usb_reset(NULL);
+    bunnyconnect_power_init();
+    TEST_CHECK(bunnyconnect_power_set_usb_enabled(true));
+    bunnyconnect_power_deinit();
+    TEST_CHECK(furi_hal_usb_get_config() == NULL);
+}
+
+int main(void) {
+    TEST_RUN(test_exit_unconnected);
+    TEST_RUN(test_restore);
+    TEST_RUN(test_warm_reconnect);
+    TEST_RUN(test_power_off);
+    return test_report();
+}
@@ -0,0 +1,255 @@
+#include "test.h"
+#include "../lib/bunnyconnect_arena.h"
+#include "../lib/bunnyconnect_replay.h"
+#include "../lib/bunnyconnect_tabs.h"
+#include "../lib/bunnyconnect_terminal.h"
+
+// Recorded by running this test with a path argument, see main
+#define FIXTURE_PATH   BUNNYCONNECT_TEST_FIXTURES "/capture.bin"
+#define FIXTURE_INPUTS 4
+#define FIXTURE_BYTES  760 // Appended, the NULs are dropped
+
+#define SCROLLBACK 2048
+#define RX_SIZE    64
+#define TEXT_SIZE  (SCROLLBACK + 1)
+
+static BunnyConnectArena* arena;
+static BunnyConnectTabs* tabs;
+static BunnyConnectTerminal* terminal;
+static FuriPubSub* input_events;
+static Canvas* canvas;
+static char text[TEXT_SIZE];
+
+static void session_alloc(void) {
+    arena = bunnyconnect_arena_alloc(bunnyconnect_tabs_size(SCROLLBACK));
+    tabs = bunnyconnect_tabs_alloc(arena, SCROLLBACK);
+    terminal = bunnyconnect_terminal_alloc();
+    bunnyconnect_terminal_set_buffer(terminal, text, sizeof(text));
+}
+
+static void session_free(void) {
+    bunnyconnect_terminal_free(terminal);
+    bunnyconnect_arena_free(arena);
+}
+
+// The input service hands terminal keys to the view
+static void input_callback(const void* message, void* context) {
+    UNUSED(context);
+    InputEvent event = *(const InputEvent*)message;
+    furi_shim_view_input(bunnyconnect_terminal_get_view(terminal), &event);
+}
+
+static void input_press(InputKey key) {
+    InputEvent event = {.key = key, .type = InputTypeShort};
+    furi_pubsub_publish(input_events, &event);
+}
+
+// What the worker does with a CDC chunk, returns the bytes appended
+static size_t session_receive(uint8_t* data, size_t len) {
+    size_t kept = 0;
+    for(size_t i = 0; i < len; i++) {
+        if(data[i] != '\0') data[kept++] = data[i];
+    }
+    bunnyconnect_tabs_append(tabs, BunnyConnectTabCdc, data, kept);
+    return kept;
+}
+
+// The refresh the GUI thread runs, then one frame of the terminal
+static void session_frame(void) {
+    size_t size;
+    char* buffer = bunnyconnect_terminal_text_acquire(terminal, &size);
+    furi_check(buffer);
+    bunnyconnect_scrollback_snapshot(
+        bunnyconnect_tabs_get_scrollback(tabs, BunnyConnectTabCdc), buffer, size);
+    bunnyconnect_terminal_text_commit(terminal);
+    furi_shim_canvas_reset(canvas);
+    furi_shim_view_draw(bunnyconnect_terminal_get_view(terminal), canvas);
+}
+
+static void capture_chunk(BunnyConnectCapture* capture, const char* chunk, size_t len) {
+    uint8_t rx[RX_SIZE];
+    furi_check(len <= sizeof(rx));
+    memcpy(rx, chunk, len);
+    bunnyconnect_capture_rx(capture, rx, len);
+    len = session_receive(rx, len);
+    bunnyconnect_capture_appended(capture, rx, len);
+}
+
+// Boot log in uneven chunks, lines split across them, NULs on the wire and
+// the terminal scrolled back by two lines at the end
+static void capture_session(BunnyConnectCapture* capture) {
+    char line[48];
+    bunnyconnect_capture_set_input(capture, true);
+    for(size_t i = 0; i < 40; i++) {
+        size_t len = snprintf(line, sizeof(line), "boot: stage %02u ok%c\r\n", i, '\0');
+        size_t split = i % 7 + 1;
+        capture_chunk(capture, line, split);
+        capture_chunk(capture, line + split, len - split);
+    }
+    input_press(InputKeyUp);
+    input_press(InputKeyUp);
+    input_press(InputKeyUp);
+    input_press(InputKeyDown);
+}
+
+static BunnyConnectReplay* replay_load_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    furi_check(file);
+    uint8_t data[4096];
+    size_t size = fread(data, 1, sizeof(data), file);
+    furi_check(feof(file));
+    fclose(file);
+
+    test_storage_write(BUNNYCONNECT_CAPTURE_PATH, data, size);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    BunnyConnectReplay* replay =
+        bunnyconnect_replay_load(storage, BUNNYCONNECT_CAPTURE_PATH, true);
+    furi_record_close(RECORD_STORAGE);
+    return replay;
+}
+
+// Feed the replay through the session until it ends
+static bool replay_run(BunnyConnectReplay* replay, BunnyConnectReplayResult* result) {
+    uint8_t rx[RX_SIZE];
+    bool finished = false;
+    while(!finished) {
+        size_t len = bunnyconnect_replay_next(replay, rx, sizeof(rx), &finished);
+        if(len > 0) {
+            len = session_receive(rx, len);
+            bunnyconnect_replay_appended(replay, rx, len);
+        }
+    }
+    return bunnyconnect_replay_get_result(replay, result);
+}
+
+static void test_fixture(void) {
+    BunnyConnectReplayResult result;
+    test_storage_reset();
+    session_alloc();
+
+    BunnyConnectReplay* replay = replay_load_file(FIXTURE_PATH);
+    TEST_CHECK(replay);
+    if(!replay) return;
+    TEST_CHECK(replay_run(replay, &result));
+    bunnyconnect_replay_free(replay);
+
+    // The digest the capture saved is the one the replay reached
+    TEST_CHECK_EQ(result.digest, result.expected_digest);
+    TEST_CHECK_EQ(result.rx_bytes, FIXTURE_BYTES);
+    TEST_CHECK_EQ(result.expected_bytes, FIXTURE_BYTES);
+    TEST_CHECK_EQ(result.rx_chunks, 80);
+    TEST_CHECK_EQ(result.inputs, FIXTURE_INPUTS);
+
+    // Replayed keys left the terminal two lines up from the end
+    session_frame();
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpStr), 7);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpScrollbar), 1);
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 6), "boot: stage 37 ok\r");
+    session_free();
+}
+
+static void test_fixture_diverged(void) {
+    BunnyConnectReplayResult result;
+    test_storage_reset();
+    session_alloc();
+
+    // A byte the capture did not see changes the final state
+    BunnyConnectReplay* replay = replay_load_file(FIXTURE_PATH);
+    TEST_CHECK(replay);
+    if(!replay) return;
+    uint8_t rx[RX_SIZE];
+    bool finished = false;
+    bool changed = false;
+    while(!finished) {
+        size_t len = bunnyconnect_replay_next(replay, rx, sizeof(rx), &finished);
+        if(len > 0 && !changed) {
+            rx[0] ^= 0x20;
+            changed = true;
+        }
+        if(len > 0) {
+            len = session_receive(rx, len);
+            bunnyconnect_replay_appended(replay, rx, len);
+        }
+    }
+    TEST_CHECK(!bunnyconnect_replay_get_result(replay, &result));
+    TEST_CHECK(result.digest != result.expected_digest);
+    TEST_CHECK_EQ(result.rx_bytes, result.expected_bytes);
+    bunnyconnect_replay_free(replay);
+    session_free();
+}
+
+static void test_round_trip(void) {
+    BunnyConnectReplayResult result;
+    test_storage_reset();
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+
+    session_alloc();
+    BunnyConnectCapture* capture = bunnyconnect_capture_alloc(BUNNYCONNECT_CAPTURE_SIZE);
+    capture_session(capture);
+    TEST_CHECK(bunnyconnect_capture_save(capture, storage, BUNNYCONNECT_CAPTURE_PATH));
+    bunnyconnect_capture_free(capture);
+    session_frame();
+    uint32_t digest = furi_shim_canvas_get_digest(canvas);
+    session_free();
+
+    // A fresh session replaying it draws the same frame
+    session_alloc();
+    BunnyConnectReplay* replay =
+        bunnyconnect_replay_load(storage, BUNNYCONNECT_CAPTURE_PATH, true);
+    TEST_CHECK(replay);
+    if(replay) {
+        TEST_CHECK(replay_run(replay, &result));
+        bunnyconnect_replay_free(replay);
+        session_frame();
+        TEST_CHECK_EQ(furi_shim_canvas_get_digest(canvas), digest);
+    }
+    session_free();
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Re-record the fixture: test_replay tests/fixtures/capture.bin
+static int fixture_write(const char* path) {
+    test_storage_reset();
+    session_alloc();
+    BunnyConnectCapture* capture = bunnyconnect_capture_alloc(BUNNYCONNECT_CAPTURE_SIZE);
+    capture_session(capture);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    furi_check(bunnyconnect_capture_save(capture, storage, BUNNYCONNECT_CAPTURE_PATH));
+    furi_record_close(RECORD_STORAGE);
+    bunnyconnect_capture_free(capture);
+    session_free();
+
+    size_t size;
+    char* data = test_storage_read(BUNNYCONNECT_CAPTURE_PATH, &size);
+    FILE* file = fopen(path, "wb");
+    furi_check(file && data);
+    furi_check(fwrite(data, 1, size, file) == size);
+    fclose(file);
+    free(data);
+    printf("Wrote %zu bytes to %s\n", size, path);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    input_events = furi_pubsub_alloc();
+    furi_record_create(RECORD_INPUT_EVENTS, input_events);
+    FuriPubSubSubscription* subscription =
+        furi_pubsub_subscribe(input_events, input_callback, NULL);
+    canvas = furi_shim_canvas_alloc();
+
+    int result;
+    if(argc > 1) {
+        result = fixture_write(argv[1]);
+    } else {
+        TEST_RUN(test_fixture);
+        TEST_RUN(test_fixture_diverged);
+        TEST_RUN(test_round_trip);
+        result = test_report();
+    }
+
+    furi_shim_canvas_free(canvas);
+    furi_pubsub_unsubscribe(input_events, subscription);
+    furi_record_destroy(RECORD_INPUT_EVENTS);
+    furi_pubsub_free(input_events);
+    return result;
+}
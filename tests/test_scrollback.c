@@ -0,0 +1,153 @@
+#include "test.h"
+#include "../lib/bunnyconnect_arena.h"
+#include "../lib/bunnyconnect_scrollback.h"
+
+#define RING_SIZE 64
+
+static BunnyConnectArena* arena;
+
+static BunnyConnectScrollback* ring_alloc(void) {
+    if(arena) bunnyconnect_arena_free(arena);
+    arena = bunnyconnect_arena_alloc(BUNNYCONNECT_SCROLLBACK_OVERHEAD + RING_SIZE);
+    return bunnyconnect_scrollback_alloc(arena, "Ring", RING_SIZE);
+}
+
+static void ring_write(BunnyConnectScrollback* ring, const char* text) {
+    bunnyconnect_scrollback_write(ring, (const uint8_t*)text, strlen(text));
+}
+
+static void test_empty(void) {
+    BunnyConnectScrollback* ring = ring_alloc();
+    char out[RING_SIZE + 1];
+    uint32_t tail, head;
+
+    TEST_CHECK_EQ(bunnyconnect_scrollback_snapshot(ring, out, sizeof(out)), 0);
+    TEST_CHECK_STR(out, "");
+    bunnyconnect_scrollback_get_window(ring, &tail, &head);
+    TEST_CHECK_EQ(tail, 0);
+    TEST_CHECK_EQ(head, 0);
+    TEST_CHECK_EQ(bunnyconnect_scrollback_get_fill(ring), 0);
+}
+
+static void test_write_snapshot(void) {
+    BunnyConnectScrollback* ring = ring_alloc();
+    char out[RING_SIZE + 1];
+
+    ring_write(ring, "hello ");
+    ring_write(ring, "world\n");
+    TEST_CHECK_EQ(bunnyconnect_scrollback_snapshot(ring, out, sizeof(out)), 12);
+    TEST_CHECK_STR(out, "hello world\n");
+    TEST_CHECK_EQ(bunnyconnect_scrollback_get_fill(ring), 12);
+
+    // A short output keeps the newest bytes
+    char small[6];
+    TEST_CHECK_EQ(bunnyconnect_scrollback_snapshot(ring, small, sizeof(small)), 5);
+    TEST_CHECK_STR(small, "orld\n");
+}
+
+static void test_wrap(void) {
+    BunnyConnectScrollback* ring = ring_alloc();
+    char expected[3 * RING_SIZE];
+    char out[RING_SIZE + 1];
+    uint32_t tail, head;
+
+    for(size_t i = 0; i < sizeof(expected); i++) {
+        expected[i] = 'a' + i % 26;
+        bunnyconnect_scrollback_write(ring, (const uint8_t*)&expected[i], 1);
+    }
+
+    TEST_CHECK_EQ(bunnyconnect_scrollback_snapshot(ring, out, sizeof(out)), RING_SIZE);
+    TEST_CHECK_MEM(out, expected + sizeof(expected) - RING_SIZE, RING_SIZE);
+    TEST_CHECK_EQ(bunnyconnect_scrollback_get_fill(ring), RING_SIZE);
+    bunnyconnect_scrollback_get_window(ring, &tail, &head);
+    TEST_CHECK_EQ(head, sizeof(expected));
+    TEST_CHECK_EQ(tail, sizeof(expected) - RING_SIZE);
+}
+
+static void test_oversized_write(void) {
+    BunnyConnectScrollback* ring = ring_alloc();
+    uint8_t data[RING_SIZE * 2 + 5];
+    char out[RING_SIZE + 1];
+
+    for(size_t i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+    ring_write(ring, "xyz");
+    bunnyconnect_scrollback_write(ring, data, sizeof(data));
+
+    // Only the last capacity bytes can be kept
+    TEST_CHECK_EQ(bunnyconnect_scrollback_snapshot(ring, out, sizeof(out)), RING_SIZE);
+    TEST_CHECK_MEM(out, data + sizeof(data) - RING_SIZE, RING_SIZE);
+}
+
+static void test_read(void) {
+    BunnyConnectScrollback* ring = ring_alloc();
+    uint8_t out[RING_SIZE];
+    uint32_t tail, head;
+
+    ring_write(ring, "0123456789");
+    TEST_CHECK(bunnyconnect_scrollback_read(ring, 3, out, 4));
+    TEST_CHECK_MEM(out, "3456", 4);
+    TEST_CHECK(!bunnyconnect_scrollback_read(ring, 0, out, RING_SIZE + 1));
+
+    // Push position 3 out of the ring
+    for(size_t i = 0; i < RING_SIZE / 8; i++) {
+        ring_write(ring, "abcdefgh");
+    }
+    bunnyconnect_scrollback_get_window(ring, &tail, &head);
+    TEST_CHECK_EQ(head, 10 + RING_SIZE);
+    TEST_CHECK(!bunnyconnect_scrollback_read(ring, 3, out, 4));
+    TEST_CHECK(bunnyconnect_scrollback_read(ring, tail, out, 8));
+    TEST_CHECK_MEM(out, "abcdefgh", 8);
+
+    // A read across the physical end of the buffer
+    TEST_CHECK(bunnyconnect_scrollback_read(ring, head - 12, out, 12));
+    TEST_CHECK_MEM(out, "efghabcdefgh", 12);
+}
+
+static void test_chunk_overwrite(void) {
+    BunnyConnectScrollback* ring = ring_alloc();
+    uint8_t chunk[RING_SIZE / 2];
+    char out[RING_SIZE + 1];
+    uint32_t tail, head;
+
+    // Half-ring chunks, the window holds exactly the last two
+    for(size_t i = 0; i < 5; i++) {
+        memset(chunk, '0' + i, sizeof(chunk));
+        bunnyconnect_scrollback_write(ring, chunk, sizeof(chunk));
+    }
+    bunnyconnect_scrollback_get_window(ring, &tail, &head);
+    TEST_CHECK_EQ(head - tail, RING_SIZE);
+    TEST_CHECK_EQ(bunnyconnect_scrollback_snapshot(ring, out, sizeof(out)), RING_SIZE);
+    TEST_CHECK_EQ(out[0], '3');
+    TEST_CHECK_EQ(out[RING_SIZE - 1], '4');
+}
+
+static void test_arena_mark(void) {
+    BunnyConnectScrollback* ring = ring_alloc();
+    BunnyConnectArenaRegion region;
+
+    ring_write(ring, "12345678");
+    bunnyconnect_arena_get_region(arena, 0, &region);
+    TEST_CHECK_STR(region.name, "Ring");
+    TEST_CHECK(region.high_water >= 8);
+    TEST_CHECK(region.high_water < region.size);
+
+    for(size_t i = 0; i < RING_SIZE / 8 + 1; i++) {
+        ring_write(ring, "12345678");
+    }
+    bunnyconnect_arena_get_region(arena, 0, &region);
+    TEST_CHECK_EQ(region.high_water, region.size);
+}
+
+int main(void) {
+    TEST_RUN(test_empty);
+    TEST_RUN(test_write_snapshot);
+    TEST_RUN(test_wrap);
+    TEST_RUN(test_oversized_write);
+    TEST_RUN(test_read);
+    TEST_RUN(test_chunk_overwrite);
+    TEST_RUN(test_arena_mark);
+    bunnyconnect_arena_free(arena);
+    return test_report();
+}
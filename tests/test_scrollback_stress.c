@@ -0,0 +1,148 @@
+#include "test.h"
+#include "../lib/bunnyconnect_arena.h"
+#include "../lib/bunnyconnect_scrollback.h"
+#include <stdatomic.h>
+
+// One producer thread and the consumer on the main thread, as the worker and
+// the GUI use the ring. Stream byte p is p % 251, a prime, so a byte torn by
+// the producer lapping a copy never matches its position.
+#define RING_SIZE    256
+#define STREAM_BYTES (16UL * 1024 * 1024)
+#define PATTERN(pos) ((uint8_t)((pos) % 251))
+
+static BunnyConnectArena* arena;
+static BunnyConnectScrollback* ring;
+static atomic_bool producer_done;
+
+static int32_t producer_thread(void* context) {
+    UNUSED(context);
+    uint8_t chunk[RING_SIZE + 64];
+    uint32_t pos = 0;
+    uint32_t seed = 1;
+
+    while(pos < STREAM_BYTES) {
+        // Mostly small chunks, now and then one larger than the ring
+        seed = seed * 1103515245 + 12345;
+        size_t len = (seed >> 16) % 97 + 1;
+        if((seed >> 8) % 64 == 0) len = sizeof(chunk);
+
+        for(size_t i = 0; i < len; i++) {
+            chunk[i] = PATTERN(pos + i);
+        }
+        bunnyconnect_scrollback_write(ring, chunk, len);
+        pos += len;
+    }
+
+    atomic_store(&producer_done, true);
+    return 0;
+}
+
+static FuriThread* producer_start(void) {
+    if(arena) bunnyconnect_arena_free(arena);
+    arena = bunnyconnect_arena_alloc(BUNNYCONNECT_SCROLLBACK_OVERHEAD + RING_SIZE);
+    ring = bunnyconnect_scrollback_alloc(arena, "Ring", RING_SIZE);
+    atomic_store(&producer_done, false);
+
+    FuriThread* thread = furi_thread_alloc_ex("Producer", 1024, producer_thread, NULL);
+    furi_thread_start(thread);
+    return thread;
+}
+
+static void producer_stop(FuriThread* thread) {
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+}
+
+static void test_snapshot(void) {
+    FuriThread* thread = producer_start();
+    char out[RING_SIZE + 1];
+    size_t snapshots = 0;
+    size_t torn = 0;
+
+    // A snapshot has no position, but every byte must follow the one before it
+    while(!atomic_load(&producer_done)) {
+        size_t len = bunnyconnect_scrollback_snapshot(ring, out, sizeof(out));
+        if(len > RING_SIZE) torn++;
+        for(size_t i = 1; i < len; i++) {
+            if((uint8_t)out[i] != ((uint8_t)out[i - 1] + 1) % 251) {
+                torn++;
+                break;
+            }
+        }
+        snapshots++;
+    }
+    producer_stop(thread);
+
+    printf("snapshot: %zu copies\n", snapshots);
+    TEST_CHECK(snapshots > 0);
+    TEST_CHECK_EQ(torn, 0);
+}
+
+static void test_read(void) {
+    FuriThread* thread = producer_start();
+    uint8_t out[RING_SIZE];
+    size_t reads = 0;
+    size_t lapped = 0;
+    size_t torn = 0;
+    uint32_t seed = 7;
+
+    while(!atomic_load(&producer_done)) {
+        uint32_t tail, head;
+        bunnyconnect_scrollback_get_window(ring, &tail, &head);
+        if(head == tail) continue;
+
+        seed = seed * 1103515245 + 12345;
+        uint32_t pos = tail + (seed >> 16) % (head - tail);
+        size_t len = MIN((seed >> 4) % RING_SIZE + 1, head - pos);
+
+        if(!bunnyconnect_scrollback_read(ring, pos, out, len)) {
+            lapped++;
+            continue;
+        }
+        for(size_t i = 0; i < len; i++) {
+            if(out[i] != PATTERN(pos + i)) {
+                torn++;
+                break;
+            }
+        }
+        reads++;
+    }
+    producer_stop(thread);
+
+    printf("read: %zu good, %zu lapped\n", reads, lapped);
+    TEST_CHECK(reads > 0);
+    TEST_CHECK_EQ(torn, 0);
+}
+
+static void test_read_lapped(void) {
+    FuriThread* thread = producer_start();
+    uint8_t out[RING_SIZE];
+    size_t rounds = 0;
+    size_t refused = 0;
+
+    // Pick the oldest byte and wait until the producer has overwritten it
+    while(!atomic_load(&producer_done)) {
+        uint32_t tail, head, now;
+        bunnyconnect_scrollback_get_window(ring, &tail, &head);
+        do {
+            bunnyconnect_scrollback_get_window(ring, &now, &head);
+        } while((int32_t)(now - tail) <= 0 && !atomic_load(&producer_done));
+        if((int32_t)(now - tail) <= 0) break;
+
+        if(!bunnyconnect_scrollback_read(ring, tail, out, RING_SIZE / 2)) refused++;
+        rounds++;
+    }
+    producer_stop(thread);
+
+    printf("lapped: %zu rounds\n", rounds);
+    TEST_CHECK(rounds > 0);
+    TEST_CHECK_EQ(refused, rounds);
+}
+
+int main(void) {
+    TEST_RUN(test_snapshot);
+    TEST_RUN(test_read);
+    TEST_RUN(test_read_lapped);
+    bunnyconnect_arena_free(arena);
+    return test_report();
+}
@@ -0,0 +1,166 @@
+#include "test.h"
+#include "fake_usb.h"
+#include "../lib/bunnyconnect_snippets.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+
+static void snippets_write(const char* name, const char* text) {
+    char path[128];
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, BUNNYCONNECT_SNIPPETS_PATH);
+    furi_record_close(RECORD_STORAGE);
+    snprintf(path, sizeof(path), "%s/%s", BUNNYCONNECT_SNIPPETS_PATH, name);
+    test_storage_write(path, text, strlen(text));
+}
+
+// Directory order is not defined, look snippets up by name
+static char* snippets_body(BunnyConnectSnippets* snippets, const char* name) {
+    for(size_t i = 0; i < bunnyconnect_snippets_get_count(snippets); i++) {
+        if(strcmp(bunnyconnect_snippets_get_name(snippets, i), name) == 0) {
+            size_t length;
+            return bunnyconnect_snippets_load(snippets, i, &length);
+        }
+    }
+    return NULL;
+}
+
+static void snippets_check_body(
+    BunnyConnectSnippets* snippets,
+    const char* name,
+    const char* expected) {
+    char* body = snippets_body(snippets, name);
+    TEST_CHECK(body != NULL);
+    if(body) TEST_CHECK_STR(body, expected);
+    free(body);
+}
+
+static void test_parse(void) {
+    test_storage_reset();
+    snippets_write(
+        "net.txt",
+        "ip addr\n"
+        "## ping\r\n"
+        "ping -c 1 10.0.0.1\r\n"
+        "\r\n"
+        "##  route  \n"
+        "ip route\n"
+        "ip -6 route\n"
+        "## \n"
+        "anon\n");
+    snippets_write("empty.txt", "## only\nbody");
+    snippets_write("notes.md", "## ignored\n");
+
+    BunnyConnectSnippets* snippets = bunnyconnect_snippets_alloc();
+    TEST_CHECK(bunnyconnect_snippets_sync(snippets));
+    TEST_CHECK_EQ(bunnyconnect_snippets_get_count(snippets), 5);
+    TEST_CHECK(bunnyconnect_snippets_get_name(snippets, 5) == NULL);
+
+    // The preamble takes the file name, the last newline before a header is dropped
+    snippets_check_body(snippets, "net", "ip addr");
+    snippets_check_body(snippets, "ping", "ping -c 1 10.0.0.1\r\n");
+    snippets_check_body(snippets, "route", "ip route\nip -6 route");
+    snippets_check_body(snippets, "net.txt #4", "anon");
+    snippets_check_body(snippets, "only", "body");
+    TEST_CHECK(snippets_body(snippets, "ignored") == NULL);
+    bunnyconnect_snippets_free(snippets);
+}
+
+static void test_index_reuse(void) {
+    test_storage_reset();
+    snippets_write("a.txt", "## one\n1\n## two\n2\n");
+
+    BunnyConnectSnippets* snippets = bunnyconnect_snippets_alloc();
+    TEST_CHECK(bunnyconnect_snippets_sync(snippets));
+    bunnyconnect_snippets_free(snippets);
+
+    size_t size;
+    char* index = test_storage_read(BUNNYCONNECT_SNIPPETS_INDEX_PATH, &size);
+    TEST_CHECK(index != NULL);
+    free(index);
+
+    // A fresh library starts from the index and finds the same snippets
+    snippets = bunnyconnect_snippets_alloc();
+    TEST_CHECK(bunnyconnect_snippets_sync(snippets));
+    TEST_CHECK_EQ(bunnyconnect_snippets_get_count(snippets), 2);
+    snippets_check_body(snippets, "two", "2");
+
+    // A new file is picked up on the next sync
+    snippets_write("b.txt", "## three\n3\n");
+    TEST_CHECK(bunnyconnect_snippets_sync(snippets));
+    TEST_CHECK_EQ(bunnyconnect_snippets_get_count(snippets), 3);
+    snippets_check_body(snippets, "three", "3");
+    bunnyconnect_snippets_free(snippets);
+}
+
+static void test_stale_hash(void) {
+    char host_path[256];
+    struct stat info;
+
+    test_storage_reset();
+    snippets_write("a.txt", "## one\nabc\n");
+    snprintf(
+        host_path,
+        sizeof(host_path),
+        "%s%s/a.txt",
+        furi_shim_storage_get_root(),
+        BUNNYCONNECT_SNIPPETS_PATH);
+    TEST_CHECK(stat(host_path, &info) == 0);
+
+    BunnyConnectSnippets* snippets = bunnyconnect_snippets_alloc();
+    TEST_CHECK(bunnyconnect_snippets_sync(snippets));
+
+    // Same size and timestamp, only the body hash can tell
+    snippets_write("a.txt", "## one\nxyz\n");
+    struct timespec times[2] = {info.st_atim, info.st_mtim};
+    TEST_CHECK(utimensat(AT_FDCWD, host_path, times, 0) == 0);
+    TEST_CHECK(bunnyconnect_snippets_sync(snippets));
+    TEST_CHECK(snippets_body(snippets, "one") == NULL);
+
+    // The failed load marked the file, the next sync parses it again
+    TEST_CHECK(bunnyconnect_snippets_sync(snippets));
+    snippets_check_body(snippets, "one", "xyz");
+    bunnyconnect_snippets_free(snippets);
+}
+
+static void test_max_length(void) {
+    // Longer than the smaller output queue, cut to what one send can take
+    test_storage_reset();
+    size_t size = BUNNYCONNECT_OUTPUT_HID_QUEUE_SIZE + 100;
+    char* text = malloc(size + 1);
+    memcpy(text, "## big\n", 7);
+    memset(text + 7, 'x', size - 7);
+    text[size] = '\0';
+    snippets_write("big.txt", text);
+    free(text);
+
+    BunnyConnectSnippets* snippets = bunnyconnect_snippets_alloc();
+    TEST_CHECK(bunnyconnect_snippets_sync(snippets));
+    size_t length = 0;
+    char* body = bunnyconnect_snippets_load(snippets, 0, &length);
+    TEST_CHECK(body != NULL);
+    TEST_CHECK_EQ(length, BUNNYCONNECT_SNIPPETS_MAX_LENGTH);
+    bunnyconnect_snippets_free(snippets);
+    if(!body) return;
+
+    // Both empty queues take it whole with the longest line ending
+    fake_usb_start();
+    BunnyConnectCdc* cdc = bunnyconnect_cdc_alloc(0);
+    BunnyConnectOutput* output = bunnyconnect_output_alloc(cdc);
+    bunnyconnect_output_set_online(output, false);
+    for(size_t i = 0; i < BunnyConnectOutputCount; i++) {
+        bunnyconnect_output_set_line_ending(output, i, BunnyConnectLineEndingCrLf);
+    }
+    TEST_CHECK(bunnyconnect_output_send(output, (const uint8_t*)body, length, true));
+    bunnyconnect_output_free(output);
+    bunnyconnect_cdc_free(cdc);
+    fake_usb_stop();
+    free(body);
+}
+
+int main(void) {
+    TEST_RUN(test_parse);
+    TEST_RUN(test_index_reuse);
+    TEST_RUN(test_stale_hash);
+    TEST_RUN(test_max_length);
+    return test_report();
+}
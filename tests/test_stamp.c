@@ -0,0 +1,247 @@
+#include "test.h"
+#include "../lib/bunnyconnect_stamp.h"
+
+#define TEXT_SIZE 256
+
+typedef struct {
+    char text[TEXT_SIZE];
+    size_t len;
+} StampText;
+
+static void stream_marker(StampText* stream, uint8_t lead, uint32_t ms) {
+    stream->len += bunnyconnect_stamp_encode(lead, ms, (uint8_t*)stream->text + stream->len);
+}
+
+static void stream_text(StampText* stream, const char* text) {
+    size_t len = strlen(text);
+    memcpy(stream->text + stream->len, text, len);
+    stream->len += len;
+}
+
+static void test_encode(void) {
+    uint8_t out[BUNNYCONNECT_STAMP_MAX];
+
+    TEST_CHECK_EQ(bunnyconnect_stamp_encode(BUNNYCONNECT_STAMP_DELTA, 5, out), 2);
+    TEST_CHECK_MEM(out, "\x1E\x85", 2);
+
+    // 100 = 1 << 6 | 36, high group first with the more bit
+    TEST_CHECK_EQ(bunnyconnect_stamp_encode(BUNNYCONNECT_STAMP_DELTA, 100, out), 3);
+    TEST_CHECK_MEM(out, "\x1E\xC1\xA4", 3);
+
+    // Deltas saturate at three payload bytes, absolute times at five
+    TEST_CHECK_EQ(bunnyconnect_stamp_encode(BUNNYCONNECT_STAMP_DELTA, UINT32_MAX, out), 4);
+    TEST_CHECK_EQ(
+        bunnyconnect_stamp_encode(BUNNYCONNECT_STAMP_ABS, UINT32_MAX, out),
+        BUNNYCONNECT_STAMP_MAX);
+    for(size_t i = 1; i < BUNNYCONNECT_STAMP_MAX; i++) {
+        TEST_CHECK(out[i] & BUNNYCONNECT_STAMP_PAYLOAD);
+        TEST_CHECK(!bunnyconnect_stamp_is_lead(out[i]));
+    }
+}
+
+static uint32_t clock_run(BunnyConnectStampClock* clock, const StampText* stream, size_t* text) {
+    *text = 0;
+    for(size_t i = 0; i < stream->len; i++) {
+        if(!bunnyconnect_stamp_clock_feed(clock, stream->text[i])) (*text)++;
+    }
+    return clock->ms;
+}
+
+static void test_clock(void) {
+    BunnyConnectStampClock clock = {0};
+    StampText stream = {0};
+    size_t text;
+
+    // A delta before any absolute time leaves the clock unknown
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 10);
+    stream_text(&stream, "a\n");
+    clock_run(&clock, &stream, &text);
+    TEST_CHECK(!clock.known);
+    TEST_CHECK_EQ(text, 2);
+
+    stream.len = 0;
+    stream_marker(&stream, BUNNYCONNECT_STAMP_ABS, 123456);
+    stream_text(&stream, "b\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 4000);
+    stream_text(&stream, "c\n");
+    TEST_CHECK_EQ(clock_run(&clock, &stream, &text), 127456);
+    TEST_CHECK(clock.known);
+    TEST_CHECK_EQ(text, 4);
+}
+
+static void test_strip(void) {
+    StampText stream = {0};
+    stream_marker(&stream, BUNNYCONNECT_STAMP_ABS, 1000);
+    stream_text(&stream, "one\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 20);
+    stream_text(&stream, "two\n");
+    stream_text(&stream, "three");
+
+    size_t len = bunnyconnect_stamp_render(stream.text, stream.len, TEXT_SIZE, false, false);
+    TEST_CHECK_EQ(len, 13);
+    TEST_CHECK_STR(stream.text, "one\ntwo\nthree");
+}
+
+static void test_show(void) {
+    StampText stream = {0};
+    stream_marker(&stream, BUNNYCONNECT_STAMP_ABS, 1500);
+    stream_text(&stream, "one\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 250);
+    stream_text(&stream, "two\n");
+    stream_text(&stream, "three\n");
+
+    bunnyconnect_stamp_render(stream.text, stream.len, TEXT_SIZE, true, false);
+    TEST_CHECK_STR(stream.text, "    1.500 one\n    1.750 two\n    -.--- three\n");
+}
+
+static void test_show_backwards(void) {
+    // The ring lost the anchor, a later one times the lines before it
+    StampText stream = {0};
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 100);
+    stream_text(&stream, "a\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 200);
+    stream_text(&stream, "b\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 300);
+    stream_marker(&stream, BUNNYCONNECT_STAMP_ABS, 90000);
+    stream_text(&stream, "c\n");
+
+    bunnyconnect_stamp_render(stream.text, stream.len, TEXT_SIZE, true, false);
+    TEST_CHECK_STR(stream.text, "   89.500 a\n   89.700 b\n   90.000 c\n");
+}
+
+static void test_cut_marker(void) {
+    // A snapshot that starts inside a marker skips its payload
+    StampText stream = {0};
+    stream_marker(&stream, BUNNYCONNECT_STAMP_ABS, 100000);
+    stream_text(&stream, "x\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 1);
+    stream_text(&stream, "y\n");
+
+    size_t len =
+        bunnyconnect_stamp_render(stream.text + 2, stream.len - 2, TEXT_SIZE, false, true);
+    TEST_CHECK_EQ(len, 4);
+    TEST_CHECK_STR(stream.text + 2, "x\ny\n");
+}
+
+static void test_uncut_payload(void) {
+    // Text that starts whole keeps its leading bytes above 0x7F
+    StampText stream = {0};
+    stream_text(&stream, "\xC3\xA9t\xC3\xA9\n");
+    size_t len = bunnyconnect_stamp_render(stream.text, stream.len, TEXT_SIZE, false, false);
+    TEST_CHECK_EQ(len, 6);
+    TEST_CHECK_STR(stream.text, "\xC3\xA9t\xC3\xA9\n");
+
+    StampText shown = {0};
+    stream_text(&shown, "\xC3\xA9\n");
+    bunnyconnect_stamp_render(shown.text, shown.len, TEXT_SIZE, true, false);
+    TEST_CHECK_STR(shown.text, "    -.--- \xC3\xA9\n");
+}
+
+static void test_show_drops_oldest(void) {
+    // Prefixes do not fit, the oldest lines go and the clock still follows them
+    StampText stream = {0};
+    stream_marker(&stream, BUNNYCONNECT_STAMP_ABS, 2000);
+    stream_text(&stream, "first\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 500);
+    stream_text(&stream, "second\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 500);
+    stream_text(&stream, "third\n");
+
+    size_t size = 2 * BUNNYCONNECT_STAMP_PREFIX + 14;
+    TEST_CHECK(stream.len < size);
+    size_t len = bunnyconnect_stamp_render(stream.text, stream.len, size, true, false);
+    TEST_CHECK_STR(stream.text, "    2.500 second\n    3.000 third\n");
+    TEST_CHECK_EQ(len, strlen(stream.text));
+}
+
+static void test_escaped(void) {
+    // Lead bytes that are text come doubled, at a line start and inside one
+    StampText stream = {0};
+    stream_text(&stream, "\x1E\x1E" "a\x1D\x1D" "b\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_ABS, 1000);
+    stream_text(&stream, "\x1D\x1D\x1D\x1D" "c\n");
+
+    BunnyConnectStampClock clock = {0};
+    size_t text;
+    TEST_CHECK_EQ(clock_run(&clock, &stream, &text), 1000);
+    TEST_CHECK_EQ(text, 9);
+
+    StampText shown = stream;
+    size_t len = bunnyconnect_stamp_render(stream.text, stream.len, TEXT_SIZE, false, false);
+    TEST_CHECK_EQ(len, 9);
+    TEST_CHECK_MEM(stream.text, "\x1E" "a\x1D" "b\n\x1D\x1D" "c\n", 10);
+    bunnyconnect_stamp_render(shown.text, shown.len, TEXT_SIZE, true, false);
+    TEST_CHECK_STR(shown.text, "    -.--- \x1E" "a\x1D" "b\n    1.000 \x1D\x1D" "c\n");
+}
+
+static void test_cut_escape(void) {
+    // The snapshot kept only the second half of a pair, it is still text
+    StampText stream = {0};
+    stream_text(&stream, "\x1E" "x\n");
+    size_t len = bunnyconnect_stamp_render(stream.text, stream.len, TEXT_SIZE, false, false);
+    TEST_CHECK_EQ(len, 3);
+    TEST_CHECK_STR(stream.text, "\x1E" "x\n");
+}
+
+static void test_unescape(void) {
+    // A pair split across chunks is carried over
+    uint8_t first[] = {'a', 0x1E, 0x1E, 'b', 0x1D};
+    uint8_t second[] = {0x1D, 0x1E, 0x1E, 0x1E, 0x1E};
+    uint8_t held = 0;
+    TEST_CHECK_EQ(bunnyconnect_stamp_unescape(first, sizeof(first), &held), 4);
+    TEST_CHECK_MEM(first, "a\x1E" "b\x1D", 4);
+    TEST_CHECK_EQ(held, 0x1D);
+    TEST_CHECK_EQ(bunnyconnect_stamp_unescape(second, sizeof(second), &held), 2);
+    TEST_CHECK_MEM(second, "\x1E\x1E", 2);
+}
+
+static void test_stream(void) {
+    // One byte at a time into the smallest output gives the same text as a whole render
+    StampText stream = {0};
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 100);
+    stream_text(&stream, "\x1E\x1E" "a\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_ABS, 5000);
+    stream_text(&stream, "b\x1D\x1D\n");
+    stream_marker(&stream, BUNNYCONNECT_STAMP_DELTA, 25);
+    stream_text(&stream, "c");
+
+    for(size_t show = 0; show < 2; show++) {
+        StampText whole = stream;
+        size_t len = bunnyconnect_stamp_render(whole.text, whole.len, TEXT_SIZE, show, false);
+
+        BunnyConnectStampStream state;
+        bunnyconnect_stamp_stream_init(&state, show, false);
+        bunnyconnect_stamp_stream_scan(&state, (const uint8_t*)stream.text, stream.len);
+        bunnyconnect_stamp_stream_restart(&state, true, false);
+
+        char out[TEXT_SIZE];
+        char text[BUNNYCONNECT_STAMP_PREFIX + 2];
+        size_t out_len = 0;
+        for(size_t i = 0; i < stream.len;) {
+            size_t used;
+            size_t text_len = bunnyconnect_stamp_stream_render(
+                &state, (const uint8_t*)stream.text + i, 1, text, sizeof(text), &used);
+            memcpy(out + out_len, text, text_len);
+            out_len += text_len;
+            i += used;
+        }
+        TEST_CHECK_EQ(out_len, len);
+        TEST_CHECK_MEM(out, whole.text, len);
+    }
+}
+
+int main(void) {
+    TEST_RUN(test_encode);
+    TEST_RUN(test_clock);
+    TEST_RUN(test_strip);
+    TEST_RUN(test_show);
+    TEST_RUN(test_show_backwards);
+    TEST_RUN(test_cut_marker);
+    TEST_RUN(test_uncut_payload);
+    TEST_RUN(test_show_drops_oldest);
+    TEST_RUN(test_escaped);
+    TEST_RUN(test_cut_escape);
+    TEST_RUN(test_unescape);
+    TEST_RUN(test_stream);
+    return test_report();
+}
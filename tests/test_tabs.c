@@ -0,0 +1,125 @@
+#include "test.h"
+#include "../lib/bunnyconnect_stamp.h"
+#include "../lib/bunnyconnect_tabs.h"
+
+#define SCROLLBACK 256
+
+static BunnyConnectArena* arena;
+static BunnyConnectTabs* tabs;
+
+static void setup(void) {
+    if(arena) bunnyconnect_arena_free(arena);
+    arena = bunnyconnect_arena_alloc(bunnyconnect_tabs_size(SCROLLBACK));
+    tabs = bunnyconnect_tabs_alloc(arena, SCROLLBACK);
+}
+
+static void tab_append(BunnyConnectTabId id, const char* text) {
+    bunnyconnect_tabs_append(tabs, id, (const uint8_t*)text, strlen(text));
+}
+
+static const char* tab_text(BunnyConnectTabId id, bool stamps) {
+    static char out[2 * SCROLLBACK + 1];
+    bool cut;
+    size_t len = bunnyconnect_tabs_snapshot(tabs, id, out, sizeof(out), &cut);
+    bunnyconnect_stamp_render(out, len, sizeof(out), stamps, cut);
+    return out;
+}
+
+static void test_active(void) {
+    setup();
+    TEST_CHECK_EQ(bunnyconnect_tabs_get_active(tabs), BunnyConnectTabCdc);
+    TEST_CHECK(bunnyconnect_tabs_append(tabs, BunnyConnectTabCdc, (const uint8_t*)"a", 1));
+    TEST_CHECK(!bunnyconnect_tabs_append(tabs, BunnyConnectTabUart, (const uint8_t*)"b", 1));
+    TEST_CHECK_EQ(bunnyconnect_tabs_step(tabs, false), BunnyConnectTabLoopback);
+    TEST_CHECK_EQ(bunnyconnect_tabs_step(tabs, true), BunnyConnectTabCdc);
+
+    BunnyConnectTabStats stats;
+    tab_append(BunnyConnectTabUart, "cd");
+    bunnyconnect_tabs_get_stats(tabs, BunnyConnectTabUart, &stats);
+    TEST_CHECK_EQ(stats.rx_bytes, 3);
+    TEST_CHECK_EQ(stats.rx_chunks, 2);
+}
+
+static void test_lead_bytes(void) {
+    // Stamp lead bytes from the wire are text whether stamping or not
+    setup();
+    tab_append(BunnyConnectTabCdc, "\x1E" "a\x1D\n");
+    bunnyconnect_tabs_set_stamping(tabs, true);
+    tab_append(BunnyConnectTabCdc, "\x1D\x1D" "b\n");
+    TEST_CHECK_STR(tab_text(BunnyConnectTabCdc, false), "\x1E" "a\x1D\n\x1D\x1D" "b\n");
+
+    BunnyConnectTabStats stats;
+    bunnyconnect_tabs_get_stats(tabs, BunnyConnectTabCdc, &stats);
+    TEST_CHECK_EQ(stats.rx_bytes, 8);
+
+    // The first line has no time, the second one does
+    const char* shown = tab_text(BunnyConnectTabCdc, true);
+    TEST_CHECK_EQ(strlen(shown), 2 * BUNNYCONNECT_STAMP_PREFIX + 8);
+    TEST_CHECK_MEM(shown, "    -.--- \x1E" "a\x1D\n", 14);
+    TEST_CHECK(strncmp(shown + 14, "    -.---", 9) != 0);
+    TEST_CHECK_STR(shown + 14 + BUNNYCONNECT_STAMP_PREFIX, "\x1D\x1D" "b\n");
+}
+
+static void check_saved(BunnyConnectTabId id, const char* path, bool stamps) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    size_t saved;
+    TEST_CHECK(bunnyconnect_tabs_save_logs(tabs, storage, stamps, &saved));
+    furi_record_close(RECORD_STORAGE);
+    TEST_CHECK_EQ(saved, 1);
+
+    size_t size = 0;
+    char* log = test_storage_read(path, &size);
+    TEST_CHECK(log);
+    if(!log) return;
+    const char* expected = tab_text(id, stamps);
+    TEST_CHECK_EQ(size, strlen(expected));
+    TEST_CHECK_STR(log, expected);
+    free(log);
+}
+
+static void test_leading_payload(void) {
+    // Bytes above 0x7F first in an unwrapped ring are text, stamping off or on
+    test_storage_reset();
+    setup();
+    tab_append(BunnyConnectTabUart, "\xC3\xA9t\xC3\xA9\n");
+    TEST_CHECK_STR(tab_text(BunnyConnectTabUart, false), "\xC3\xA9t\xC3\xA9\n");
+    check_saved(BunnyConnectTabUart, BUNNYCONNECT_TABS_LOG_DIR "/uart.log", false);
+
+    test_storage_reset();
+    setup();
+    bunnyconnect_tabs_set_stamping(tabs, true);
+    tab_append(BunnyConnectTabUart, "\xC3\xA9t\n");
+    TEST_CHECK_STR(tab_text(BunnyConnectTabUart, false), "\xC3\xA9t\n");
+    TEST_CHECK_STR(tab_text(BunnyConnectTabUart, true) + BUNNYCONNECT_STAMP_PREFIX, "\xC3\xA9t\n");
+    check_saved(BunnyConnectTabUart, BUNNYCONNECT_TABS_LOG_DIR "/uart.log", false);
+    check_saved(BunnyConnectTabUart, BUNNYCONNECT_TABS_LOG_DIR "/uart.log", true);
+}
+
+static void test_save_logs(void) {
+    // Read in chunks, the log matches a render of the whole ring
+    char line[32];
+    test_storage_reset();
+    setup();
+    bunnyconnect_tabs_set_stamping(tabs, true);
+    for(size_t i = 0; i < 40; i++) {
+        snprintf(line, sizeof(line), "l%02u \x1E\x1D\n", (unsigned)i);
+        tab_append(BunnyConnectTabUart, line);
+        furi_delay_ms(1);
+    }
+
+    // The oldest anchor is overwritten, the first whole lines are timed from a later one
+    const char* path = BUNNYCONNECT_TABS_LOG_DIR "/uart.log";
+    check_saved(BunnyConnectTabUart, path, false);
+    check_saved(BunnyConnectTabUart, path, true);
+    const char* shown = strchr(tab_text(BunnyConnectTabUart, true), '\n');
+    TEST_CHECK(shown && strncmp(shown + 1, "    -.---", 9) != 0);
+}
+
+int main(void) {
+    TEST_RUN(test_active);
+    TEST_RUN(test_lead_bytes);
+    TEST_RUN(test_leading_payload);
+    TEST_RUN(test_save_logs);
+    bunnyconnect_arena_free(arena);
+    return test_report();
+}
@@ -0,0 +1,147 @@
+#include "test.h"
+#include "../lib/bunnyconnect_terminal.h"
+
+#define TEXT_SIZE 1024
+
+static BunnyConnectTerminal* terminal;
+static Canvas* canvas;
+static char text[TEXT_SIZE];
+
+static void terminal_set_text(const char* value) {
+    size_t size;
+    char* buffer = bunnyconnect_terminal_text_acquire(terminal, &size);
+    furi_check(buffer);
+    strlcpy(buffer, value, size);
+    bunnyconnect_terminal_text_commit(terminal);
+}
+
+static void terminal_lines(size_t count) {
+    char all[TEXT_SIZE] = "";
+    char line[16];
+    for(size_t i = 0; i < count; i++) {
+        snprintf(line, sizeof(line), "line %u\n", i);
+        strlcat(all, line, sizeof(all));
+    }
+    terminal_set_text(all);
+}
+
+static void terminal_press(InputKey key, InputType type) {
+    InputEvent event = {.key = key, .type = type};
+    furi_shim_view_input(bunnyconnect_terminal_get_view(terminal), &event);
+}
+
+// One frame through the view, as the GUI draws it
+static void terminal_frame(void) {
+    furi_shim_canvas_reset(canvas);
+    furi_shim_view_draw(bunnyconnect_terminal_get_view(terminal), canvas);
+}
+
+static void select_callback(void* context, BunnyConnectTerminalSelectEvent event, size_t line) {
+    UNUSED(context);
+    UNUSED(event);
+    UNUSED(line);
+}
+
+static void test_status_only(void) {
+    bunnyconnect_terminal_set_buffer(terminal, NULL, 0);
+    bunnyconnect_terminal_set_status(terminal, "CDC 115200");
+    terminal_frame();
+
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpClear), 1);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpSetFont), 1);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpSetColor), 3);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpBox), 1);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpStr), 1);
+    TEST_CHECK_EQ(furi_shim_canvas_get_total(canvas), 7);
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 0), "CDC 115200");
+}
+
+static void test_short_text(void) {
+    bunnyconnect_terminal_set_buffer(terminal, text, sizeof(text));
+    terminal_set_text("one\ntwo\nthree\n");
+    terminal_frame();
+
+    // A string and a color reset per line, no scrollbar while it all fits
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpStr), 4);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpSetColor), 6);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpScrollbar), 0);
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 1), "one");
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 3), "three");
+}
+
+static void test_wrap(void) {
+    bunnyconnect_terminal_set_buffer(terminal, text, sizeof(text));
+    terminal_set_text("abcdefghijklmnopqrstuvwxyz0123\n");
+    terminal_frame();
+
+    // 24 host glyphs fit the text width
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpStr), 3);
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 1), "abcdefghijklmnopqrstuvwx");
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 2), "yz0123");
+}
+
+static void test_scroll(void) {
+    bunnyconnect_terminal_set_buffer(terminal, text, sizeof(text));
+    terminal_lines(20);
+    terminal_frame();
+
+    // Six rows under the status bar, following the end
+    uint32_t digest = furi_shim_canvas_get_digest(canvas);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpStr), 7);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpScrollbar), 1);
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 1), "line 14");
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 6), "line 19");
+
+    // Same state, same frame
+    terminal_frame();
+    TEST_CHECK_EQ(furi_shim_canvas_get_digest(canvas), digest);
+
+    uint32_t updates = furi_shim_view_get_updates(bunnyconnect_terminal_get_view(terminal));
+    terminal_press(InputKeyUp, InputTypeShort);
+    terminal_press(InputKeyUp, InputTypeRepeat);
+    TEST_CHECK_EQ(
+        furi_shim_view_get_updates(bunnyconnect_terminal_get_view(terminal)), updates + 2);
+    terminal_frame();
+    TEST_CHECK(furi_shim_canvas_get_digest(canvas) != digest);
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 6), "line 17");
+
+    // Scrolling past the top is clamped on draw
+    for(size_t i = 0; i < 30; i++) {
+        terminal_press(InputKeyUp, InputTypeRepeat);
+    }
+    terminal_frame();
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 1), "line 0");
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpStr), 7);
+}
+
+static void test_select(void) {
+    bunnyconnect_terminal_set_buffer(terminal, text, sizeof(text));
+    bunnyconnect_terminal_set_select_callback(terminal, select_callback, NULL);
+    terminal_lines(3);
+
+    // The picked line gets a box behind white text
+    terminal_press(InputKeyDown, InputTypeLong);
+    terminal_press(InputKeyUp, InputTypeShort);
+    terminal_frame();
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpBox), 2);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpSetColor), 7);
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpStr), 4);
+
+    terminal_press(InputKeyBack, InputTypeShort);
+    terminal_frame();
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpBox), 1);
+    bunnyconnect_terminal_set_select_callback(terminal, NULL, NULL);
+}
+
+int main(void) {
+    terminal = bunnyconnect_terminal_alloc();
+    canvas = furi_shim_canvas_alloc();
+    TEST_RUN(test_status_only);
+    TEST_RUN(test_short_text);
+    TEST_RUN(test_wrap);
+    TEST_RUN(test_scroll);
+    TEST_RUN(test_select);
+    furi_shim_canvas_free(canvas);
+    bunnyconnect_terminal_free(terminal);
+    return test_report();
+}
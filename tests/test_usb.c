@@ -0,0 +1,172 @@
+#include "test.h"
+#include "fake_usbd.h"
+#include "../lib/bunnyconnect_usb.h"
+#include <usb_cdc.h>
+#include <usb_hid.h>
+#include <furi_hal_usb_hid.h>
+
+#define HID_EP 0x83
+
+static usbd_device dev;
+
+// Walk the configuration the way a host does, by bLength and bDescriptorType
+static void test_descriptors(void) {
+    const uint8_t* config = bunnyconnect_usb_composite.cfg_descr;
+    size_t total = config[2] | config[3] << 8;
+    uint8_t endpoints[16];
+    size_t endpoint_count = 0;
+    uint16_t interfaces = 0; // Bit per interface number seen
+    size_t interface_count = 0;
+    int32_t open_endpoints = 0; // Still due for the current interface
+    const uint8_t* iad = NULL;
+    const uint8_t* cdc_union = NULL;
+    size_t iad_position = 0;
+    size_t position = 0;
+    size_t offset = 0;
+
+    TEST_CHECK_EQ(config[1], USB_DTYPE_CONFIGURATION);
+    while(offset < total) {
+        const uint8_t* desc = config + offset;
+        TEST_CHECK(desc[0] >= 2);
+        if(desc[0] < 2 || offset + desc[0] > total) break;
+
+        switch(desc[1]) {
+        case USB_DTYPE_INTERFACE:
+            TEST_CHECK_EQ(open_endpoints, 0);
+            TEST_CHECK_EQ(desc[3], 0);
+            TEST_CHECK(!(interfaces & (1 << desc[2])));
+            interfaces |= 1 << desc[2];
+            interface_count++;
+            open_endpoints = desc[4];
+            position++;
+            // The IAD must sit right before the interfaces it groups
+            if(iad && desc[2] >= iad[2] && desc[2] < iad[2] + iad[3]) {
+                TEST_CHECK_EQ(position - iad_position, desc[2] - iad[2] + 1);
+                TEST_CHECK(desc[5] == USB_CLASS_CDC || desc[5] == USB_CLASS_CDC_DATA);
+                if(desc[2] == iad[2]) TEST_CHECK_EQ(desc[5], iad[4]);
+            }
+            break;
+        case USB_DTYPE_INTERFASEASSOC:
+            TEST_CHECK(iad == NULL);
+            iad = desc;
+            iad_position = position;
+            break;
+        case USB_DTYPE_ENDPOINT:
+            TEST_CHECK(open_endpoints > 0);
+            open_endpoints--;
+            TEST_CHECK((desc[2] & 0x7F) != 0);
+            TEST_CHECK((desc[2] & 0x7F) < 8);
+            for(size_t i = 0; i < endpoint_count; i++) {
+                TEST_CHECK(endpoints[i] != desc[2]);
+            }
+            if(endpoint_count < COUNT_OF(endpoints)) endpoints[endpoint_count++] = desc[2];
+            break;
+        case USB_DTYPE_CS_INTERFACE:
+            if(desc[2] == USB_DTYPE_CDC_UNION) cdc_union = desc;
+            break;
+        default:
+            break;
+        }
+        offset += desc[0];
+    }
+
+    TEST_CHECK_EQ(offset, total);
+    TEST_CHECK_EQ(open_endpoints, 0);
+    TEST_CHECK_EQ(config[4], interface_count);
+    TEST_CHECK_EQ(interfaces, (1 << interface_count) - 1);
+    TEST_CHECK_EQ(endpoint_count, 4);
+
+    // The CDC function is one IAD over the comm and data interfaces
+    TEST_CHECK(iad != NULL);
+    TEST_CHECK(cdc_union != NULL);
+    if(iad && cdc_union) {
+        TEST_CHECK_EQ(iad[3], 2);
+        TEST_CHECK_EQ(iad[4], USB_CLASS_CDC);
+        TEST_CHECK_EQ(cdc_union[3], iad[2]);
+        TEST_CHECK_EQ(cdc_union[4], iad[2] + 1);
+    }
+
+    // A device with an IAD must say so in its class triple
+    const struct usb_device_descriptor* device = bunnyconnect_usb_composite.dev_descr;
+    TEST_CHECK_EQ(device->bDeviceClass, USB_CLASS_IAD);
+    TEST_CHECK_EQ(device->bDeviceSubClass, USB_SUBCLASS_IAD);
+    TEST_CHECK_EQ(device->bDeviceProtocol, USB_PROTO_IAD);
+}
+
+static usbd_respond control(uint8_t type, uint8_t request, uint16_t value, uint16_t index) {
+    usbd_ctlreq req = {
+        .bmRequestType = type,
+        .bRequest = request,
+        .wValue = value,
+        .wIndex = index,
+    };
+    dev.status.data_ptr = NULL;
+    dev.status.data_count = 0;
+    return dev.control_callback(&dev, &req, NULL);
+}
+
+static void test_hid_report_descriptor(void) {
+    const uint8_t* config = bunnyconnect_usb_composite.cfg_descr;
+    size_t total = config[2] | config[3] << 8;
+    uint16_t length = 0;
+    uint8_t interface = 0;
+
+    for(size_t offset = 0; offset < total; offset += config[offset]) {
+        if(config[offset + 1] == USB_DTYPE_INTERFACE) interface = config[offset + 2];
+        if(config[offset + 1] == USB_DTYPE_HID) {
+            length = config[offset + 7] | config[offset + 8] << 8;
+        }
+    }
+
+    // The length announced in the HID descriptor is what GET_DESCRIPTOR returns
+    TEST_CHECK_EQ(
+        control(
+            USB_REQ_DEVTOHOST | USB_REQ_STANDARD | USB_REQ_INTERFACE,
+            USB_STD_GET_DESCRIPTOR,
+            USB_DTYPE_HID_REPORT << 8,
+            interface),
+        usbd_ack);
+    TEST_CHECK_EQ(dev.status.data_count, length);
+}
+
+static void test_get_report(void) {
+    uint8_t report[8];
+    uint8_t sent[FAKE_USBD_PACKET_MAX];
+    const uint8_t type = USB_REQ_DEVTOHOST | USB_REQ_CLASS | USB_REQ_INTERFACE;
+
+    TEST_CHECK_EQ(control(type, USB_HID_GETREPORT, 0x0100, 2), usbd_ack);
+    TEST_CHECK_EQ(dev.status.data_count, sizeof(report));
+
+    // Shift+A goes out, GET_REPORT answers with no keys while it is in flight
+    TEST_CHECK(bunnyconnect_usb_hid_kb_press(KEY_MOD_LEFT_SHIFT | HID_KEYBOARD_A));
+    TEST_CHECK_EQ(fake_usbd_get_write(HID_EP, sent), sizeof(report));
+    TEST_CHECK_MEM(sent, "\x02\x00\x04\x00\x00\x00\x00\x00", sizeof(report));
+    TEST_CHECK_EQ(control(type, USB_HID_GETREPORT, 0x0100, 2), usbd_ack);
+    TEST_CHECK_MEM(dev.status.data_ptr, "\0\0\0\0\0\0\0\0", sizeof(report));
+
+    // Once the endpoint is done it returns the last report sent
+    dev.endpoint[HID_EP & 0x7F](&dev, usbd_evt_eptx, HID_EP);
+    TEST_CHECK_EQ(control(type, USB_HID_GETREPORT, 0x0100, 2), usbd_ack);
+    TEST_CHECK_MEM(dev.status.data_ptr, sent, sizeof(report));
+
+    // The reply is a copy, the next report does not change it under the host
+    memcpy(report, dev.status.data_ptr, sizeof(report));
+    const void* reply = dev.status.data_ptr;
+    TEST_CHECK(bunnyconnect_usb_hid_kb_release_all());
+    TEST_CHECK_MEM(reply, report, sizeof(report));
+    dev.endpoint[HID_EP & 0x7F](&dev, usbd_evt_eptx, HID_EP);
+    TEST_CHECK_EQ(fake_usbd_get_writes(HID_EP), 2);
+}
+
+int main(void) {
+    fake_usbd_reset();
+    bunnyconnect_usb_composite.init(&dev, &bunnyconnect_usb_composite, NULL);
+    TEST_CHECK_EQ(dev.config_callback(&dev, 1), usbd_ack);
+
+    TEST_RUN(test_descriptors);
+    TEST_RUN(test_hid_report_descriptor);
+    TEST_RUN(test_get_report);
+
+    bunnyconnect_usb_composite.deinit(&dev);
+    return test_report();
+}
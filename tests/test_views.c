@@ -0,0 +1,194 @@
+#include "test.h"
+#include "../lib/bunnyconnect_dashboard.h"
+#include "../lib/bunnyconnect_histview.h"
+#include "../lib/bunnyconnect_keyboard.h"
+#include <sys/stat.h>
+
+#define PBM_SIZE (sizeof("P4\n128 64\n") - 1 + 128 * 64 / 8)
+
+static Canvas* canvas;
+
+// Draw a frame, keep it as a PBM under the build tree and print its draw time
+static void draw_frame(View* view, const char* name) {
+    char path[256];
+    struct stat info;
+
+    furi_shim_canvas_reset(canvas);
+    furi_shim_view_draw(view, canvas);
+    snprintf(path, sizeof(path), "%s/%s.pbm", BUNNYCONNECT_TEST_FRAMES, name);
+    TEST_CHECK(furi_shim_canvas_save_pbm(canvas, path));
+    TEST_CHECK(stat(path, &info) == 0 && info.st_size == PBM_SIZE);
+    printf(
+        "%-16s %8llu ns %5zu px\n",
+        name,
+        (unsigned long long)furi_shim_view_get_draw_ns(view),
+        furi_shim_canvas_get_ink(canvas));
+}
+
+static bool str_drawn(const char* str) {
+    for(size_t i = 0; furi_shim_canvas_get_str(canvas, i); i++) {
+        if(strcmp(furi_shim_canvas_get_str(canvas, i), str) == 0) return true;
+    }
+    return false;
+}
+
+static void input(View* view, InputKey key, InputType type) {
+    InputEvent event = {.key = key, .type = type};
+    furi_shim_view_input(view, &event);
+}
+
+static void test_dashboard(void) {
+    BunnyConnectDashboard* dashboard = bunnyconnect_dashboard_alloc();
+    View* view = bunnyconnect_dashboard_get_view(dashboard);
+
+    // Primed, then three seconds of RX ramping up over a 115200 baud link
+    BunnyConnectDashboardSample sample = {
+        .link_bytes_per_s = 11520,
+        .connected = true,
+        .battery = 80,
+        .hid_depth = 10,
+        .hid_capacity = 512,
+    };
+    bunnyconnect_dashboard_push(dashboard, &sample);
+    const uint32_t rx[] = {500, 1500, 2500};
+    sample.interval_ms = 1000;
+    for(size_t i = 0; i < COUNT_OF(rx); i++) {
+        sample.rx_bytes += rx[i];
+        sample.tx_bytes += 100;
+        bunnyconnect_dashboard_push(dashboard, &sample);
+    }
+
+    draw_frame(view, "dashboard");
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 0), "Link up");
+    TEST_CHECK(str_drawn("22%"));
+    TEST_CHECK(str_drawn("2.5k/s"));
+    TEST_CHECK(str_drawn("100 B/s"));
+    TEST_CHECK(str_drawn("HID q 10/512"));
+
+    // Header rule, the newest RX sample at full height, the oldest scaled to it
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 60, 11));
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 127, 14));
+    TEST_CHECK(!furi_shim_canvas_get_pixel(canvas, 127, 13));
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 125, 30));
+    TEST_CHECK(!furi_shim_canvas_get_pixel(canvas, 125, 29));
+    uint32_t digest = furi_shim_canvas_get_digest(canvas);
+
+    sample.connected = false;
+    bunnyconnect_dashboard_push(dashboard, &sample);
+    draw_frame(view, "dashboard_down");
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 0), "Link down");
+    TEST_CHECK(furi_shim_canvas_get_digest(canvas) != digest);
+    bunnyconnect_dashboard_free(dashboard);
+}
+
+static void histview_dump(void* context) {
+    (*(size_t*)context)++;
+}
+
+static void test_histview(void) {
+    BunnyConnectHistView* histview = bunnyconnect_histview_alloc();
+    View* view = bunnyconnect_histview_get_view(histview);
+    size_t dumps = 0;
+    bunnyconnect_histview_set_dump_callback(histview, histview_dump, &dumps);
+
+    uint32_t counts[BUNNYCONNECT_HISTOGRAM_BUCKETS] = {0};
+    counts[3] = 10;
+    counts[5] = 5;
+    bunnyconnect_histview_update(histview, BunnyConnectHistogramRxSize, counts);
+
+    draw_frame(view, "histogram");
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 0), "RX chunk size");
+    TEST_CHECK(str_drawn("n=15 p50<8 p99<32"));
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpBox), 2);
+
+    // Bars start at x 4, 5 px a bucket, the tallest spans y 13 to 45
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 4 + 3 * 5, 13));
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 4 + 3 * 5, 45));
+    TEST_CHECK(!furi_shim_canvas_get_pixel(canvas, 4 + 3 * 5, 12));
+    TEST_CHECK(!furi_shim_canvas_get_pixel(canvas, 4 + 3 * 5 + 4, 45));
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 4 + 5 * 5, 30));
+    TEST_CHECK(!furi_shim_canvas_get_pixel(canvas, 4 + 5 * 5, 28));
+
+    // Right turns the page, OK dumps
+    uint32_t updates = furi_shim_view_get_updates(view);
+    input(view, InputKeyRight, InputTypeShort);
+    TEST_CHECK_EQ(furi_shim_view_get_updates(view), updates + 1);
+    draw_frame(view, "histogram_gap");
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 0), "RX chunk gap");
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpBox), 0);
+    input(view, InputKeyOk, InputTypeShort);
+    TEST_CHECK_EQ(dumps, 1);
+    bunnyconnect_histview_free(histview);
+}
+
+static void keyboard_done(void* context) {
+    (*(size_t*)context)++;
+}
+
+static bool keyboard_reject(const char* text, FuriString* error, void* context) {
+    UNUSED(text);
+    UNUSED(context);
+    furi_string_set_str(error, "Not this\none");
+    return false;
+}
+
+static void test_keyboard(void) {
+    BunnyConnectKeyboard* keyboard = bunnyconnect_keyboard_alloc();
+    View* view = bunnyconnect_keyboard_get_view(keyboard);
+    char text[32] = "hello";
+    size_t done = 0;
+    bunnyconnect_keyboard_set_header_text(keyboard, "Send");
+    bunnyconnect_keyboard_set_result_callback(
+        keyboard, keyboard_done, &done, text, sizeof(text), false);
+
+    // Text with the cursor at its end, Enter picked, one glyph per letter or digit key
+    draw_frame(view, "keyboard");
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 0), "Send");
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 1), "hello|");
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpGlyph), 37);
+    TEST_CHECK(furi_shim_canvas_get_pixel(canvas, 95, 58));
+
+    // '_' sits left of Enter, then Enter submits
+    input(view, InputKeyLeft, InputTypeShort);
+    input(view, InputKeyOk, InputTypeShort);
+    TEST_CHECK_STR(text, "hello_");
+    input(view, InputKeyRight, InputTypeShort);
+    input(view, InputKeyOk, InputTypeShort);
+    TEST_CHECK_EQ(done, 1);
+
+    // Right past the last key wraps to the switch key, the symbol page has fewer glyphs
+    for(size_t i = 0; i < 4; i++) {
+        input(view, InputKeyRight, InputTypeShort);
+    }
+    input(view, InputKeyOk, InputTypeShort);
+    draw_frame(view, "keyboard_symbols");
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpGlyph), 32);
+    TEST_CHECK_STR(text, "hello_");
+
+    // Text wider than the field scrolls to keep the cursor in view
+    strlcpy(text, "the quick brown fox jumps over", sizeof(text));
+    bunnyconnect_keyboard_set_result_callback(
+        keyboard, keyboard_done, &done, text, sizeof(text), false);
+    draw_frame(view, "keyboard_long");
+    TEST_CHECK_STR(furi_shim_canvas_get_str(canvas, 1), "...");
+
+    // A rejected entry shows the validator message over the keys
+    bunnyconnect_keyboard_set_validator_callback(keyboard, keyboard_reject, NULL);
+    input(view, InputKeyOk, InputTypeShort);
+    TEST_CHECK_EQ(done, 1);
+    draw_frame(view, "keyboard_error");
+    TEST_CHECK_EQ(furi_shim_canvas_get_count(canvas, CanvasOpRFrame), 3);
+    TEST_CHECK(str_drawn("Not this"));
+    TEST_CHECK(str_drawn("one"));
+    bunnyconnect_keyboard_free(keyboard);
+}
+
+int main(void) {
+    mkdir(BUNNYCONNECT_TEST_FRAMES, 0755);
+    canvas = furi_shim_canvas_alloc();
+    TEST_RUN(test_dashboard);
+    TEST_RUN(test_histview);
+    TEST_RUN(test_keyboard);
+    furi_shim_canvas_free(canvas);
+    return test_report();
+}
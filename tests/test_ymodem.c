@@ -0,0 +1,293 @@
+#include "test.h"
+#include "fake_usb.h"
+#include "../lib/bunnyconnect_cdc.h"
+#include "../lib/bunnyconnect_output.h"
+#include "../lib/bunnyconnect_ymodem.h"
+
+// The test plays the peer: it reads what the app sends from the fake host
+// and answers through bunnyconnect_ymodem_feed, as the worker would.
+#define SOH 0x01
+#define STX 0x02
+#define EOT 0x04
+#define ACK 0x06
+#define NAK 0x15
+#define CAN 0x18
+
+#define PACKET_MAX (3 + 1024 + 2)
+#define FILE_SIZE  (2 * 1024 + 100)
+#define WAIT_MS    2000
+
+static BunnyConnectCdc* cdc;
+static BunnyConnectOutput* output;
+
+// Written out bit by bit, independent of the one under test
+static uint16_t crc16_xmodem(const uint8_t* data, size_t size) {
+    uint16_t crc = 0;
+    for(size_t i = 0; i < size; i++) {
+        for(int bit = 7; bit >= 0; bit--) {
+            bool in = (data[i] >> bit) & 1;
+            bool top = crc & 0x8000;
+            crc <<= 1;
+            if(top != in) crc ^= 0x1021;
+        }
+    }
+    return crc;
+}
+
+static void setup(void) {
+    test_storage_reset();
+    fake_usb_start();
+    fake_usb_plug(true);
+    fake_usb_set_ctrl_line(CdcCtrlLineDTR);
+    cdc = bunnyconnect_cdc_alloc(0);
+    output = bunnyconnect_output_alloc(cdc);
+    bunnyconnect_output_set_route(output, BunnyConnectOutputRouteCdc);
+}
+
+static void teardown(void) {
+    bunnyconnect_output_free(output);
+    bunnyconnect_cdc_free(cdc);
+    fake_usb_stop();
+}
+
+static void feed(BunnyConnectYmodem* ymodem, uint8_t byte) {
+    bunnyconnect_ymodem_feed(ymodem, &byte, 1);
+}
+
+static int host_getc(void) {
+    uint8_t byte;
+    return fake_usb_host_read(&byte, 1, WAIT_MS) ? byte : -1;
+}
+
+// Read one block from the app, return its payload size or 0 if it is broken
+static size_t host_read_block(uint8_t* packet, uint8_t seq) {
+    int start = host_getc();
+    if(start != SOH && start != STX) return 0;
+
+    size_t size = start == STX ? 1024 : 128;
+    packet[0] = start;
+    if(fake_usb_host_read(packet + 1, size + 4, WAIT_MS) != size + 4) return 0;
+    if(packet[1] != seq || (packet[1] ^ packet[2]) != 0xFF) return 0;
+
+    uint16_t crc = packet[3 + size] << 8 | packet[3 + size + 1];
+    if(crc != crc16_xmodem(packet + 3, size)) return 0;
+    return size;
+}
+
+static BunnyConnectYmodemState ymodem_wait(BunnyConnectYmodem* ymodem) {
+    BunnyConnectYmodemStatus status;
+    uint32_t start = furi_get_tick();
+    do {
+        bunnyconnect_ymodem_get_status(ymodem, &status);
+        if(status.state != BunnyConnectYmodemStateRunning) break;
+        furi_delay_ms(10);
+    } while(furi_get_tick() - start < WAIT_MS);
+    return status.state;
+}
+
+static void write_source(uint8_t* data) {
+    for(size_t i = 0; i < FILE_SIZE; i++) {
+        data[i] = i * 7 + (i >> 8);
+    }
+    test_storage_write(APP_DATA_PATH("source.bin"), data, FILE_SIZE);
+}
+
+static void test_send(void) {
+    uint8_t source[FILE_SIZE];
+    uint8_t received[FILE_SIZE + 1024];
+    uint8_t packet[PACKET_MAX];
+    size_t done = 0;
+
+    setup();
+    write_source(source);
+    BunnyConnectYmodem* ymodem =
+        bunnyconnect_ymodem_send_start(output, APP_DATA_PATH("source.bin"), NULL, NULL);
+    TEST_CHECK(ymodem != NULL);
+
+    // Block 0 carries "name\0size" in a 128 byte block
+    feed(ymodem, 'C');
+    TEST_CHECK_EQ(host_read_block(packet, 0), 128);
+    TEST_CHECK_STR((char*)packet + 3, "source.bin");
+    TEST_CHECK_STR((char*)packet + 3 + strlen("source.bin") + 1, "2148");
+    feed(ymodem, ACK);
+    feed(ymodem, 'C');
+
+    // 1K blocks while more than 128 bytes are left, then a padded 128 byte block
+    const size_t sizes[] = {1024, 1024, 128};
+    for(size_t i = 0; i < COUNT_OF(sizes); i++) {
+        size_t size = host_read_block(packet, i + 1);
+        TEST_CHECK_EQ(size, sizes[i]);
+        if(size == 0) break;
+        memcpy(received + done, packet + 3, size);
+        done += size;
+        feed(ymodem, ACK);
+    }
+    TEST_CHECK_EQ(done, 2 * 1024 + 128);
+    TEST_CHECK_MEM(received, source, FILE_SIZE);
+    TEST_CHECK_EQ(received[FILE_SIZE], 0x1A);
+    TEST_CHECK_EQ(received[done - 1], 0x1A);
+
+    // The first EOT is NAKed and repeated
+    TEST_CHECK_EQ(host_getc(), EOT);
+    feed(ymodem, NAK);
+    TEST_CHECK_EQ(host_getc(), EOT);
+    feed(ymodem, ACK);
+
+    // An empty header closes the batch
+    feed(ymodem, 'C');
+    TEST_CHECK_EQ(host_read_block(packet, 0), 128);
+    TEST_CHECK_EQ(packet[3], 0);
+    feed(ymodem, ACK);
+
+    TEST_CHECK_EQ(ymodem_wait(ymodem), BunnyConnectYmodemStateDone);
+    BunnyConnectYmodemStatus status;
+    bunnyconnect_ymodem_get_status(ymodem, &status);
+    TEST_CHECK_EQ(status.files, 1);
+    TEST_CHECK_EQ(status.done, FILE_SIZE);
+    TEST_CHECK_EQ(status.retries, 0);
+    bunnyconnect_ymodem_free(ymodem);
+    teardown();
+}
+
+static void test_send_resend(void) {
+    uint8_t source[FILE_SIZE];
+    uint8_t packet[PACKET_MAX];
+
+    setup();
+    write_source(source);
+    BunnyConnectYmodem* ymodem =
+        bunnyconnect_ymodem_send_start(output, APP_DATA_PATH("source.bin"), NULL, NULL);
+
+    feed(ymodem, 'C');
+    TEST_CHECK_EQ(host_read_block(packet, 0), 128);
+    feed(ymodem, ACK);
+    feed(ymodem, 'C');
+
+    // A NAK gets the same block again
+    TEST_CHECK_EQ(host_read_block(packet, 1), 1024);
+    feed(ymodem, NAK);
+    TEST_CHECK_EQ(host_read_block(packet, 1), 1024);
+    TEST_CHECK_MEM(packet + 3, source, 1024);
+
+    bunnyconnect_ymodem_stop(ymodem);
+    BunnyConnectYmodemStatus status;
+    bunnyconnect_ymodem_get_status(ymodem, &status);
+    TEST_CHECK_EQ(status.retries, 1);
+    TEST_CHECK_EQ(status.state, BunnyConnectYmodemStateCancelled);
+    bunnyconnect_ymodem_free(ymodem);
+    teardown();
+}
+
+static void test_send_cancel(void) {
+    uint8_t source[FILE_SIZE];
+    uint8_t packet[PACKET_MAX];
+    uint8_t cancel[] = {CAN, CAN};
+
+    setup();
+    write_source(source);
+    BunnyConnectYmodem* ymodem =
+        bunnyconnect_ymodem_send_start(output, APP_DATA_PATH("source.bin"), NULL, NULL);
+
+    feed(ymodem, 'C');
+    TEST_CHECK_EQ(host_read_block(packet, 0), 128);
+    feed(ymodem, ACK);
+    feed(ymodem, 'C');
+    TEST_CHECK_EQ(host_read_block(packet, 1), 1024);
+
+    // Two CANs in a row end the session, the app answers with its own CANs
+    bunnyconnect_ymodem_feed(ymodem, cancel, sizeof(cancel));
+    TEST_CHECK_EQ(ymodem_wait(ymodem), BunnyConnectYmodemStateCancelled);
+    size_t cans = 0;
+    int byte;
+    while((byte = host_getc()) == CAN) {
+        cans++;
+    }
+    TEST_CHECK_EQ(cans, 5);
+    TEST_CHECK_EQ(byte, -1);
+
+    BunnyConnectYmodemStatus status;
+    bunnyconnect_ymodem_get_status(ymodem, &status);
+    TEST_CHECK(status.error == NULL);
+    bunnyconnect_ymodem_free(ymodem);
+    teardown();
+}
+
+// Frame a block the way a sender would
+static void feed_block(BunnyConnectYmodem* ymodem, uint8_t seq, const uint8_t* data, size_t size) {
+    uint8_t packet[PACKET_MAX];
+    packet[0] = size == 1024 ? STX : SOH;
+    packet[1] = seq;
+    packet[2] = ~seq;
+    memcpy(packet + 3, data, size);
+    uint16_t crc = crc16_xmodem(data, size);
+    packet[3 + size] = crc >> 8;
+    packet[3 + size + 1] = crc & 0xFF;
+    bunnyconnect_ymodem_feed(ymodem, packet, size + 5);
+}
+
+static void test_receive(void) {
+    uint8_t block[1024];
+    uint8_t packet[PACKET_MAX];
+
+    setup();
+    BunnyConnectYmodem* ymodem = bunnyconnect_ymodem_receive_start(output, false, NULL, NULL);
+    TEST_CHECK_EQ(host_getc(), 'C');
+
+    memset(block, 0, 128);
+    memcpy(block, "../x/notes.txt\0" "1100", 19);
+    feed_block(ymodem, 0, block, 128);
+    TEST_CHECK_EQ(host_getc(), ACK);
+    TEST_CHECK_EQ(host_getc(), 'C');
+
+    // A block with a bad CRC is NAKed, the resent one is taken
+    memset(block, 'a', 1024);
+    feed_block(ymodem, 1, block, 1024);
+    TEST_CHECK_EQ(host_getc(), ACK);
+    memset(block, 'b', 128);
+    memcpy(packet, "\x01\x02\xFD", 3);
+    memcpy(packet + 3, block, 128);
+    packet[131] = 0;
+    packet[132] = 0;
+    bunnyconnect_ymodem_feed(ymodem, packet, 133);
+    TEST_CHECK_EQ(host_getc(), NAK);
+    feed_block(ymodem, 2, block, 128);
+    TEST_CHECK_EQ(host_getc(), ACK);
+
+    feed(ymodem, EOT);
+    TEST_CHECK_EQ(host_getc(), NAK);
+    feed(ymodem, EOT);
+    TEST_CHECK_EQ(host_getc(), ACK);
+    TEST_CHECK_EQ(host_getc(), 'C');
+    memset(block, 0, 128);
+    feed_block(ymodem, 0, block, 128);
+    TEST_CHECK_EQ(host_getc(), ACK);
+    TEST_CHECK_EQ(ymodem_wait(ymodem), BunnyConnectYmodemStateDone);
+
+    // Saved under the base name and trimmed to the announced size
+    size_t size;
+    char* data = test_storage_read(BUNNYCONNECT_YMODEM_RECEIVE_PATH "/notes.txt", &size);
+    TEST_CHECK(data != NULL);
+    TEST_CHECK_EQ(size, 1100);
+    if(data) {
+        TEST_CHECK_EQ(data[0], 'a');
+        TEST_CHECK_EQ(data[1023], 'a');
+        TEST_CHECK_EQ(data[1024], 'b');
+        TEST_CHECK_EQ(data[1099], 'b');
+    }
+    free(data);
+
+    BunnyConnectYmodemStatus status;
+    bunnyconnect_ymodem_get_status(ymodem, &status);
+    TEST_CHECK_EQ(status.retries, 1);
+    TEST_CHECK_STR(status.name, "notes.txt");
+    bunnyconnect_ymodem_free(ymodem);
+    teardown();
+}
+
+int main(void) {
+    TEST_RUN(test_send);
+    TEST_RUN(test_send_resend);
+    TEST_RUN(test_send_cancel);
+    TEST_RUN(test_receive);
+    return test_report();
+}
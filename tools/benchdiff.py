@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""Compare the last benchmark run in two BunnyConnect bench.txt files.
+
+Pull apps_data/bunnyconnect/bench.txt (and the frames/ directory next to
+it) after 'Run Benchmark' on each build, then:
+
+    python3 tools/benchdiff.py before/bench.txt after/bench.txt
+
+Timings are compared with the change in percent, frames by hash. A frame
+whose hash changed drew different pixels: open both frames/<name>.pbm to
+see what moved. Exits 1 if any frame changed or a timing got slower than
+--threshold percent, so it can gate a review.
+"""
+
+import argparse
+import sys
+
+
+def parse_fields(line):
+    return dict(field.split("=", 1) for field in line.split()[1:] if "=" in field)
+
+
+def last_run(path):
+    """Fields of the last BCBENCH line and the BCFRAME lines after it."""
+    bench, frames = None, {}
+    with open(path, encoding="ascii", errors="replace") as file:
+        for line in file:
+            if line.startswith("BCBENCH "):
+                bench, frames = parse_fields(line), {}
+            elif line.startswith("BCFRAME ") and bench is not None:
+                fields = parse_fields(line)
+                frames[fields.get("name", "?")] = fields
+    if bench is None:
+        sys.exit(f"{path}: no BCBENCH line")
+    return bench, frames
+
+
+def change(before, after):
+    return (after - before) * 100.0 / before if before else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("before")
+    parser.add_argument("after")
+    parser.add_argument("--threshold", type=float, default=10.0, help="slowdown %% that fails")
+    args = parser.parse_args()
+
+    bench_a, frames_a = last_run(args.before)
+    bench_b, frames_b = last_run(args.after)
+    failed = False
+
+    print(f"{'case':<16}{'before':>10}{'after':>10}{'change':>9}")
+    for name in bench_a:
+        if name in ("v", "up_ms") or name not in bench_b:
+            continue
+        a, b = int(bench_a[name]), int(bench_b[name])
+        delta = change(a, b)
+        slow = delta > args.threshold
+        failed |= slow
+        print(f"{name + ' ns':<16}{a:>10}{b:>10}{delta:>+8.1f}%{'  SLOWER' if slow else ''}")
+
+    for name, fields_a in frames_a.items():
+        fields_b = frames_b.get(name)
+        if fields_b is None:
+            continue
+        a, b = int(fields_a["us"]), int(fields_b["us"])
+        delta = change(a, b)
+        slow = delta > args.threshold
+        redrawn = fields_a["hash"] != fields_b["hash"]
+        failed |= slow or redrawn
+        notes = ("  SLOWER" if slow else "") + (
+            f"  PIXELS ink {fields_a['ink']}->{fields_b['ink']}" if redrawn else ""
+        )
+        print(f"{name + ' us':<16}{a:>10}{b:>10}{delta:>+8.1f}%{notes}")
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Convert a BunnyConnect trace.bin into Chrome trace JSON.
+
+Pull the file from apps_data/bunnyconnect/trace.bin (qFlipper or the SD
+card), then open the output in chrome://tracing or https://ui.perfetto.dev:
+
+    python3 tools/trace2json.py trace.bin > trace.json
+
+The event, view and custom event tables below copy C enums. --check compares
+them with the headers, ctest runs it:
+
+    python3 tools/trace2json.py --check .
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+MAGIC = 0x52544342  # "BCTR"
+HEADER = struct.Struct("<IHHII")
+RECORD = struct.Struct("<IHH")
+
+# Mirrors BunnyConnectTraceEvent: name, track, phase (B/E begin/end, i instant)
+EVENTS = [
+    ("RX chunk", "worker", "i"),
+    ("Append", "worker", "i"),
+    ("Refresh post", "worker", "i"),
+    ("Event", "gui", "B"),
+    ("Event", "gui", "E"),
+    ("Snapshot", "gui", "i"),
+    ("Draw", "draw", "B"),
+    ("Draw", "draw", "E"),
+    ("HID press", "hid", "i"),
+    ("HID release", "hid", "i"),
+    ("CDC TX", "usb", "i"),
+]
+
+TRACKS = ["worker", "gui", "draw", "hid", "usb"]
+VIEWS = ["terminal", "stats", "progress", "keyboard", "dashboard", "histogram"]
+# Mirrors BunnyConnectCustomEvent
+CUSTOM_EVENTS = [
+    "KeyboardDone",
+    "RefreshScreen",
+    "Connect",
+    "Disconnect",
+    "ConnectionFailed",
+    "TogglePower",
+    "ConfigSave",
+    "SnippetSend",
+    "TransferTick",
+    "SendFileDone",
+    "YmodemDone",
+    "LinkStatus",
+    "StatsTick",
+    "StatsDump",
+    "ReplayDone",
+    "HistogramDump",
+    "FilterDone",
+    "ConfigRelease",
+]
+
+
+def event_name(event, arg):
+    name, track, _ = EVENTS[event]
+    if track == "draw":
+        return f"{name} {VIEWS[arg] if arg < len(VIEWS) else arg}"
+    if track == "gui" and name == "Event":
+        return CUSTOM_EVENTS[arg] if arg < len(CUSTOM_EVENTS) else f"Event {arg}"
+    return name
+
+
+def convert(data):
+    if len(data) < HEADER.size:
+        raise ValueError("file too short")
+    magic, version, record_size, cycles_per_us, count = HEADER.unpack_from(data)
+    if magic != MAGIC or version != 1 or record_size != RECORD.size:
+        raise ValueError("not a BunnyConnect trace v1")
+    if len(data) < HEADER.size + count * RECORD.size:
+        raise ValueError("truncated trace")
+
+    events = [
+        {"name": "thread_name", "ph": "M", "pid": 1, "tid": tid, "args": {"name": track}}
+        for tid, track in enumerate(TRACKS)
+    ]
+
+    # The cycle counter wraps about every 67 s at 64 MHz, unwrap it. Records
+    # are in ring order, so a small negative step is preemption, not a wrap.
+    elapsed = 0
+    previous = None
+    for i in range(count):
+        cycles, event, arg = RECORD.unpack_from(data, HEADER.size + i * RECORD.size)
+        if previous is not None:
+            step = (cycles - previous) & 0xFFFFFFFF
+            if step >= 0x80000000:
+                step -= 0x100000000
+            elapsed += step
+        previous = cycles
+        if event >= len(EVENTS):
+            continue
+
+        _, track, phase = EVENTS[event]
+        record = {
+            "name": event_name(event, arg),
+            "ph": phase,
+            "ts": elapsed / cycles_per_us,
+            "pid": 1,
+            "tid": TRACKS.index(track),
+        }
+        if phase == "i":
+            record["s"] = "t"
+            record["args"] = {"arg": arg}
+        events.append(record)
+
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def c_enum(path, type_name, prefix):
+    """Names of a typedef enum in a header, without the prefix or the count entry."""
+    with open(path) as file:
+        source = file.read()
+    match = re.search(r"typedef enum \{([^}]*)\} " + type_name + ";", source)
+    if not match:
+        raise ValueError(f"{path}: no enum {type_name}")
+    names = re.findall(r"^\s*" + prefix + r"(\w+)\s*,", match.group(1), re.MULTILINE)
+    return [name for name in names if not name.endswith("Count")]
+
+
+def check(app_dir):
+    """Compare the tables above with the C enums, return the mismatches."""
+    trace_h = os.path.join(app_dir, "lib", "bunnyconnect_trace.h")
+    app_h = os.path.join(app_dir, "bunnyconnect_i.h")
+    errors = []
+
+    events = c_enum(trace_h, "BunnyConnectTraceEvent", "BunnyConnectTrace")
+    if len(events) != len(EVENTS):
+        errors.append(f"EVENTS has {len(EVENTS)} entries, BunnyConnectTraceEvent {len(events)}")
+
+    views = c_enum(trace_h, "BunnyConnectTraceView", "BunnyConnectTraceView")
+    views = [name.lower() for name in views]
+    if views != VIEWS:
+        errors.append(f"VIEWS is {VIEWS}, BunnyConnectTraceView {views}")
+
+    custom = c_enum(app_h, "BunnyConnectCustomEvent", "BunnyConnectCustomEvent")
+    if custom != CUSTOM_EVENTS:
+        errors.append(f"CUSTOM_EVENTS is {CUSTOM_EVENTS}, BunnyConnectCustomEvent {custom}")
+
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("trace", nargs="?", help="trace.bin from the SD card")
+    parser.add_argument("-o", "--output", help="output file, stdout by default")
+    parser.add_argument(
+        "--check", metavar="APP_DIR", help="compare the enum tables with the C headers"
+    )
+    args = parser.parse_args()
+
+    if args.check:
+        try:
+            errors = check(args.check)
+        except (OSError, ValueError) as error:
+            sys.exit(str(error))
+        for error in errors:
+            print(error, file=sys.stderr)
+        sys.exit(1 if errors else 0)
+    if not args.trace:
+        parser.error("a trace file is required")
+
+    with open(args.trace, "rb") as file:
+        try:
+            result = convert(file.read())
+        except ValueError as error:
+            sys.exit(f"{args.trace}: {error}")
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    json.dump(result, out)
+    if args.output:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()